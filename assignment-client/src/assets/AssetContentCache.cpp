@@ -0,0 +1,227 @@
+//
+//  AssetContentCache.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetContentCache.h"
+
+#include <algorithm>
+
+// the second request for an asset in a while gets its content cached
+static const quint8 ADMISSION_FREQUENCY = 2;
+static const int REQUESTS_BETWEEN_AGING = 10000;
+
+// so that one large asset can't take the place of many popular ones
+static const int MAX_CONTENT_FRACTION = 8;
+
+// what an entry costs beyond its content
+static const qint64 ENTRY_OVERHEAD = 128;
+
+qint64 AssetContentCache::costOf(const Entry& entry) {
+    return ENTRY_OVERHEAD + entry.content.size();
+}
+
+AssetContentCache::Entries::iterator AssetContentCache::touch(const QString& hash) {
+    auto itr = _entriesByHash.find(hash);
+    if (itr == _entriesByHash.end()) {
+        return _entries.end();
+    }
+    _entries.splice(_entries.begin(), _entries, itr.value());
+    return _entries.begin();
+}
+
+AssetContentCache::Entries::iterator AssetContentCache::findOrCreate(const QString& hash) {
+    auto entry = touch(hash);
+    if (entry == _entries.end()) {
+        _entries.push_front(Entry());
+        entry = _entries.begin();
+        entry->hash = hash;
+        _entriesByHash.insert(hash, entry);
+        _bytes += costOf(*entry);
+    }
+    return entry;
+}
+
+void AssetContentCache::countRequest(const QString& hash) {
+    auto& frequency = _frequencies[hash];
+    frequency = std::min(frequency + 1, 255);
+
+    if (++_requestsSinceAging >= REQUESTS_BETWEEN_AGING) {
+        _requestsSinceAging = 0;
+        auto itr = _frequencies.begin();
+        while (itr != _frequencies.end()) {
+            itr.value() /= 2;
+            if (itr.value() == 0) {
+                itr = _frequencies.erase(itr);
+            } else {
+                ++itr;
+            }
+        }
+    }
+}
+
+void AssetContentCache::evict() {
+    while (_bytes > _maxBytes && !_entries.empty()) {
+        const Entry& last = _entries.back();
+        _bytes -= costOf(last);
+        _entriesByHash.remove(last.hash);
+        _entries.pop_back();
+        ++_evictions;
+    }
+}
+
+QByteArray AssetContentCache::findContent(const QString& hash) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // requests are counted even without a cache, they rank the assets of the prefetch manifest
+    countRequest(hash);
+
+    if (!isEnabled()) {
+        return QByteArray();
+    }
+
+    auto entry = touch(hash);
+    if (entry != _entries.end() && !entry->content.isEmpty()) {
+        ++_hits;
+        return entry->content;
+    }
+    ++_misses;
+    return QByteArray();
+}
+
+bool AssetContentCache::shouldAdmit(const QString& hash, qint64 size) const {
+    if (!isEnabled() || size <= 0 || size > _maxBytes / MAX_CONTENT_FRACTION) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _frequencies.value(hash) >= ADMISSION_FREQUENCY;
+}
+
+void AssetContentCache::insertContent(const QString& hash, const QByteArray& content) {
+    if (!isEnabled()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    insertContentLocked(hash, content);
+}
+
+void AssetContentCache::insertContentLocked(const QString& hash, const QByteArray& content) {
+    auto entry = findOrCreate(hash);
+    _bytes -= costOf(*entry);
+    entry->size = content.size();
+    entry->content = content;
+    _bytes += costOf(*entry);
+    ++_admissions;
+    evict();
+}
+
+QByteArray AssetContentCache::loadContent(const QString& hash, const std::function<QByteArray()>& read) {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    // the content may have been loaded since it was looked for
+    auto itr = _entriesByHash.find(hash);
+    if (itr != _entriesByHash.end() && !itr.value()->content.isEmpty()) {
+        return itr.value()->content;
+    }
+
+    auto load = _loads.find(hash);
+    if (load != _loads.end()) {
+        auto pendingContent = load.value();
+        lock.unlock();
+
+        ++_coalescedReads;
+        return pendingContent.get();
+    }
+
+    std::promise<QByteArray> promise;
+    _loads.insert(hash, promise.get_future().share());
+    lock.unlock();
+
+    auto content = read();
+    promise.set_value(content);
+
+    lock.lock();
+    _loads.remove(hash);
+    if (isEnabled() && !content.isEmpty()) {
+        insertContentLocked(hash, content);
+    }
+    return content;
+}
+
+int AssetContentCache::getDemand(const QString& hash) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _frequencies.value(hash);
+}
+
+std::vector<std::pair<QString, int>> AssetContentCache::getMostRequested(int count) const {
+    std::vector<std::pair<QString, int>> mostRequested;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        mostRequested.reserve(_frequencies.size());
+        for (auto itr = _frequencies.cbegin(); itr != _frequencies.cend(); ++itr) {
+            mostRequested.emplace_back(itr.key(), itr.value());
+        }
+    }
+
+    count = std::min(count, (int)mostRequested.size());
+    std::partial_sort(mostRequested.begin(), mostRequested.begin() + count, mostRequested.end(),
+                      [](const std::pair<QString, int>& a, const std::pair<QString, int>& b) {
+        return a.second > b.second;
+    });
+    mostRequested.resize(count);
+    return mostRequested;
+}
+
+bool AssetContentCache::findSize(const QString& hash, qint64& size) {
+    if (!isEnabled()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto entry = touch(hash);
+    if (entry != _entries.end()) {
+        ++_infoHits;
+        size = entry->size;
+        return true;
+    }
+    ++_infoMisses;
+    return false;
+}
+
+void AssetContentCache::insertSize(const QString& hash, qint64 size) {
+    if (!isEnabled()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    findOrCreate(hash)->size = size;
+    evict();
+}
+
+void AssetContentCache::remove(const QString& hash) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto itr = _entriesByHash.find(hash);
+    if (itr != _entriesByHash.end()) {
+        _bytes -= costOf(*itr.value());
+        _entries.erase(itr.value());
+        _entriesByHash.erase(itr);
+    }
+    _frequencies.remove(hash);
+}
+
+qint64 AssetContentCache::getBytes() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _bytes;
+}
+
+int AssetContentCache::getCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (int)_entries.size();
+}
@@ -0,0 +1,112 @@
+//
+//  AssetContentCache.h
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetContentCache_h
+#define hifi_AssetContentCache_h
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+/// Keeps the content and size of the most requested assets in memory, so that the assets everyone in the domain
+/// asks for (the default avatar, the skybox, the spawn area) are not read from disk for every request.
+/// Content is only admitted once an asset has been asked for more than once recently, so that a sweep through
+/// rarely used assets can't push the popular ones out. Assets are content addressed, so an entry never goes stale
+/// and only has to be removed when its file is deleted.
+class AssetContentCache {
+public:
+    AssetContentCache(qint64 maxBytes) : _maxBytes(maxBytes) {}
+
+    bool isEnabled() const { return _maxBytes > 0; }
+
+    // returns the whole content of the asset, or an empty array when it isn't cached,
+    // counting the request towards the asset's admission either way
+    QByteArray findContent(const QString& hash);
+    bool shouldAdmit(const QString& hash, qint64 size) const;
+    void insertContent(const QString& hash, const QByteArray& content);
+
+    // reads the content of an asset with read and caches it. Requests for the asset that arrive while it is
+    // being read wait for that read instead of reading the file again, so a crowd asking for the same new
+    // asset at once costs a single disk read.
+    QByteArray loadContent(const QString& hash, const std::function<QByteArray()>& read);
+
+    // the number of recent requests for an asset
+    int getDemand(const QString& hash) const;
+
+    // the most requested assets lately, most requested first
+    std::vector<std::pair<QString, int>> getMostRequested(int count) const;
+
+    // the size of an asset, answered for AssetGetInfo without a stat of its file
+    bool findSize(const QString& hash, qint64& size);
+    void insertSize(const QString& hash, qint64 size);
+
+    void remove(const QString& hash);
+
+    quint64 getHits() const { return _hits; }
+    quint64 getMisses() const { return _misses; }
+    quint64 getInfoHits() const { return _infoHits; }
+    quint64 getInfoMisses() const { return _infoMisses; }
+    quint64 getEvictions() const { return _evictions; }
+    quint64 getAdmissions() const { return _admissions; }
+    quint64 getCoalescedReads() const { return _coalescedReads; }
+    qint64 getBytes() const;
+    qint64 getMaxBytes() const { return _maxBytes; }
+    int getCount() const;
+
+private:
+    struct Entry {
+        QString hash;
+        qint64 size { 0 };
+        QByteArray content; // empty when only the size is known
+    };
+    using Entries = std::list<Entry>;
+
+    static qint64 costOf(const Entry& entry);
+
+    Entries::iterator touch(const QString& hash);
+    Entries::iterator findOrCreate(const QString& hash);
+    void countRequest(const QString& hash);
+    void insertContentLocked(const QString& hash, const QByteArray& content);
+    void evict();
+
+    const qint64 _maxBytes;
+
+    mutable std::mutex _mutex;
+    Entries _entries; // most recently used first
+    QHash<QString, Entries::iterator> _entriesByHash;
+    qint64 _bytes { 0 };
+
+    // requests per asset, halved every so often so only recent popularity counts
+    QHash<QString, quint8> _frequencies;
+    int _requestsSinceAging { 0 };
+
+    // the reads in progress, by the hash of the asset being read
+    QHash<QString, std::shared_future<QByteArray>> _loads;
+
+    std::atomic<quint64> _hits { 0 };
+    std::atomic<quint64> _misses { 0 };
+    std::atomic<quint64> _infoHits { 0 };
+    std::atomic<quint64> _infoMisses { 0 };
+    std::atomic<quint64> _evictions { 0 };
+    std::atomic<quint64> _admissions { 0 };
+    std::atomic<quint64> _coalescedReads { 0 };
+};
+
+using AssetContentCachePointer = std::shared_ptr<AssetContentCache>;
+
+#endif // hifi_AssetContentCache_h
@@ -0,0 +1,352 @@
+//
+//  AssetFileIO.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetFileIO.h"
+
+#include <algorithm>
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#include <windows.h>
+#else
+#include <cstdio>
+#include <unistd.h>
+#endif
+
+#include <SharedUtil.h>
+#include <ThreadHelpers.h>
+
+#include "AssetServerLogging.h"
+
+void AssetFileIOHistogram::addSample(quint64 value) {
+    int bucket = 0;
+    while (bucket < NUM_BUCKETS - 1 && (value >> (bucket + 1)) > 0) {
+        ++bucket;
+    }
+    ++_buckets[bucket];
+    ++_count;
+    _sum += value;
+
+    quint64 max = _max;
+    while (value > max && !_max.compare_exchange_weak(max, value)) {}
+}
+
+float AssetFileIOHistogram::getMean() const {
+    quint64 count = _count;
+    return count > 0 ? (float)_sum / (float)count : 0.0f;
+}
+
+quint64 AssetFileIOHistogram::getPercentile(float percentile) const {
+    quint64 count = _count;
+    if (count == 0) {
+        return 0;
+    }
+
+    quint64 target = (quint64)(percentile * count);
+    quint64 seen = 0;
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+        seen += _buckets[i];
+        if (seen > target) {
+            return std::min((quint64)2 << i, (quint64)_max);
+        }
+    }
+    return _max;
+}
+
+QJsonObject AssetFileIOHistogram::toJson(const QString& unit) const {
+    QJsonObject json;
+    json["1. Count"] = (double)getCount();
+    json["2. Mean (" + unit + ")"] = getMean();
+    json["3. p50 (" + unit + ")"] = (double)getPercentile(0.50f);
+    json["4. p99 (" + unit + ")"] = (double)getPercentile(0.99f);
+    json["5. Max (" + unit + ")"] = (double)getMax();
+
+    QJsonObject buckets;
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+        quint64 samples = _buckets[i];
+        if (samples > 0) {
+            buckets[QString("< %1").arg((quint64)2 << i, 8, 10, QChar('0'))] = (double)samples;
+        }
+    }
+    json["6. Buckets"] = buckets;
+    return json;
+}
+
+const QString AssetFileIO::TEMPORARY_SUFFIX = ".part";
+
+// moves the file over an existing destination in one step, so readers always see either the old or the new file
+static bool replaceFile(const QString& from, const QString& to) {
+#ifdef Q_OS_WIN
+    return MoveFileExW((LPCWSTR)QDir::toNativeSeparators(from).utf16(), (LPCWSTR)QDir::toNativeSeparators(to).utf16(),
+                       MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return ::rename(QFile::encodeName(from).constData(), QFile::encodeName(to).constData()) == 0;
+#endif
+}
+
+class AssetFileIOCompletion : public QRunnable {
+public:
+    AssetFileIOCompletion(std::function<void()> completion) : _completion(completion) {}
+    void run() override { _completion(); }
+
+private:
+    std::function<void()> _completion;
+};
+
+AssetFileIO::AssetFileIO(int numThreads, QThreadPool* completionPool) :
+    _completionPool(completionPool)
+{
+    for (int i = 0; i < numThreads; ++i) {
+        _threads.emplace_back([this] { run(); });
+    }
+}
+
+AssetFileIO::~AssetFileIO() {
+    stop();
+}
+
+void AssetFileIO::readFile(const QString& path, ReadCompletion completion) {
+    Request request;
+    request.type = ReadFile;
+    request.path = path;
+    request.readCompletion = completion;
+    enqueue(std::move(request));
+}
+
+void AssetFileIO::writeFile(const QString& path, QByteArray data, WriteCompletion completion) {
+    Request request;
+    request.type = WriteFile;
+    request.path = path;
+    request.data = data;
+    request.writeCompletion = completion;
+    enqueue(std::move(request));
+}
+
+void AssetFileIO::writeFileAt(const QString& path, qint64 offset, QByteArray data, WriteCompletion completion,
+                              WriteCondition condition) {
+    Request request;
+    request.type = WriteFileAt;
+    request.path = path;
+    request.offset = offset;
+    request.data = data;
+    request.writeCompletion = completion;
+    request.writeCondition = condition;
+    enqueue(std::move(request));
+}
+
+void AssetFileIO::commitFile(const QString& temporaryPath, const QString& path, WriteCompletion completion,
+                             WriteCondition condition) {
+    Request request;
+    request.type = CommitFile;
+    request.path = temporaryPath;
+    request.destinationPath = path;
+    request.writeCompletion = completion;
+    request.writeCondition = condition;
+    enqueue(std::move(request));
+}
+
+void AssetFileIO::stop() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_stopped) {
+            return;
+        }
+        _stopped = true;
+    }
+    _condition.notify_all();
+
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+    _threads.clear();
+}
+
+void AssetFileIO::enqueue(Request request) {
+    request.queuedTime = usecTimestampNow();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_stopped) {
+            _requests.push_back(std::move(request));
+            _queueDepth.addSample(_requests.size() + _inFlight);
+            _condition.notify_one();
+            return;
+        }
+    }
+
+    // still answer the request so the client gets an error reply instead of waiting on a lost one
+    qCWarning(asset_server) << "Failing a disk request for" << request.path << "after the disk threads stopped.";
+    ++_failures;
+    if (request.type == ReadFile) {
+        auto completion = request.readCompletion;
+        complete([completion] { completion(false, QByteArray()); });
+    } else {
+        auto completion = request.writeCompletion;
+        complete([completion] { completion(false); });
+    }
+}
+
+void AssetFileIO::run() {
+    setThreadName("AssetFileIO");
+
+    while (true) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this] { return _stopped || !_requests.empty(); });
+
+            // the queued requests are still finished when stopping, so no accepted upload is lost
+            if (_requests.empty()) {
+                return;
+            }
+            request = std::move(_requests.front());
+            _requests.pop_front();
+            ++_inFlight;
+        }
+
+        _queueLatency.addSample(usecTimestampNow() - request.queuedTime);
+        process(request);
+        --_inFlight;
+    }
+}
+
+void AssetFileIO::process(Request& request) {
+    if (request.type == ReadFile) {
+        auto start = usecTimestampNow();
+        QFile file { request.path };
+        bool success = file.open(QIODevice::ReadOnly);
+        QByteArray data;
+        if (success) {
+            data = file.readAll();
+            success = data.size() == file.size();
+        }
+        _latency[Read].addSample(usecTimestampNow() - start);
+        _bytes[Read] += data.size();
+        if (!success) {
+            ++_failures;
+        }
+
+        auto completion = request.readCompletion;
+        complete([completion, success, data] { completion(success, data); });
+    } else {
+        bool success = false;
+        if (request.writeCondition && !request.writeCondition()) {
+            qCDebug(asset_server) << "Dropping a write to" << request.path << "that is no longer wanted.";
+        } else if (request.type == WriteFile) {
+            success = write(request.path, request.data);
+        } else if (request.type == WriteFileAt) {
+            success = writeAt(request.path, request.offset, request.data);
+        } else {
+            success = commit(request.path, request.destinationPath);
+        }
+        if (!success) {
+            ++_failures;
+        }
+
+        auto completion = request.writeCompletion;
+        complete([completion, success] { completion(success); });
+    }
+}
+
+void AssetFileIO::complete(std::function<void()> completion) {
+    if (_completionPool) {
+        _completionPool->start(new AssetFileIOCompletion(completion));
+    } else {
+        completion();
+    }
+}
+
+bool AssetFileIO::write(const QString& path, const QByteArray& data) {
+    // each write gets its own temporary file, so concurrent writes of the same path never share one
+    QFile file { path + "." + QString::number(++_nextTemporaryID) + TEMPORARY_SUFFIX };
+
+    auto start = usecTimestampNow();
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.flush()) {
+        qCWarning(asset_server) << "Failed to write" << file.fileName() << "-" << file.errorString();
+        file.remove();
+        return false;
+    }
+    _latency[Write].addSample(usecTimestampNow() - start);
+    _bytes[Write] += data.size();
+    file.close();
+
+    return commit(file.fileName(), path);
+}
+
+bool AssetFileIO::writeAt(const QString& path, qint64 offset, const QByteArray& data) {
+    QFile file { path };
+
+    auto start = usecTimestampNow();
+    if (!file.open(QIODevice::ReadWrite | QIODevice::ExistingOnly) || !file.seek(offset) ||
+        file.write(data) != data.size() || !file.flush()) {
+        qCWarning(asset_server) << "Failed to write at" << offset << "in" << file.fileName() << "-" << file.errorString();
+        return false;
+    }
+    _latency[Write].addSample(usecTimestampNow() - start);
+    _bytes[Write] += data.size();
+    return true;
+}
+
+bool AssetFileIO::commit(const QString& temporaryPath, const QString& path) {
+    QFile file { temporaryPath };
+    if (!file.open(QIODevice::ReadWrite | QIODevice::ExistingOnly)) {
+        qCWarning(asset_server) << "Failed to open" << file.fileName() << "to sync it -" << file.errorString();
+        file.remove();
+        return false;
+    }
+
+    auto start = usecTimestampNow();
+#ifdef Q_OS_WIN
+    bool synced = _commit(file.handle()) == 0;
+#else
+    bool synced = fsync(file.handle()) == 0;
+#endif
+    file.close();
+    _latency[Sync].addSample(usecTimestampNow() - start);
+
+    if (!synced) {
+        qCWarning(asset_server) << "Failed to sync" << file.fileName() << "to disk.";
+        file.remove();
+        return false;
+    }
+
+    // QFile::rename won't replace an existing file, and removing it first would let a concurrent
+    // commit of the same path delete a file that was already acknowledged
+    if (!replaceFile(file.fileName(), path)) {
+        qCWarning(asset_server) << "Failed to move" << file.fileName() << "to" << path;
+        file.remove();
+        return false;
+    }
+    return true;
+}
+
+QJsonObject AssetFileIO::getStats() const {
+    static const double BYTES_PER_MEGABYTE = 1024.0 * 1024.0;
+
+    QJsonObject stats;
+    stats["1. Threads"] = (int)_threads.size();
+    stats["2. In Flight"] = (int)_inFlight;
+    stats["3. Failures"] = (double)_failures;
+    stats["4. Read (MB)"] = (double)_bytes[Read] / BYTES_PER_MEGABYTE;
+    stats["5. Written (MB)"] = (double)_bytes[Write] / BYTES_PER_MEGABYTE;
+    stats["6. Queue Depth"] = _queueDepth.toJson("requests");
+    stats["7. Queue Latency"] = _queueLatency.toJson("us");
+
+    QJsonObject latency;
+    latency["1. Read"] = _latency[Read].toJson("us");
+    latency["2. Write"] = _latency[Write].toJson("us");
+    latency["3. Sync"] = _latency[Sync].toJson("us");
+    stats["8. Latency"] = latency;
+    return stats;
+}
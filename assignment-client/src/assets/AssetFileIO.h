@@ -0,0 +1,144 @@
+//
+//  AssetFileIO.h
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetFileIO_h
+#define hifi_AssetFileIO_h
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+
+class QThreadPool;
+
+/// Counts samples in power of two buckets: bucket 0 holds 0 and 1, bucket n holds [2^n, 2^(n+1)).
+class AssetFileIOHistogram {
+public:
+    static const int NUM_BUCKETS = 24;
+
+    void addSample(quint64 value);
+
+    quint64 getCount() const { return _count; }
+    quint64 getMax() const { return _max; }
+    float getMean() const;
+    quint64 getPercentile(float percentile) const; // upper bound of the bucket holding the percentile
+
+    QJsonObject toJson(const QString& unit) const;
+
+private:
+    std::array<std::atomic<quint64>, NUM_BUCKETS> _buckets {};
+    std::atomic<quint64> _count { 0 };
+    std::atomic<quint64> _sum { 0 };
+    std::atomic<quint64> _max { 0 };
+};
+
+/// Performs the asset server's file reads and writes on a few dedicated disk threads so that a slow disk
+/// or a large upload ties up those threads rather than the transfer pool. Each request is queued and its
+/// completion is run on the given pool once the disk is done, where hashing and replying happen while
+/// the disk threads move on to the next request.
+class AssetFileIO {
+public:
+    using ReadCompletion = std::function<void(bool success, QByteArray data)>;
+    using WriteCompletion = std::function<void(bool success)>;
+    // checked on the disk thread right before a write, the write fails if it returns false
+    using WriteCondition = std::function<bool()>;
+
+    enum Operation {
+        Read = 0,
+        Write,
+        Sync,
+
+        NumOperations
+    };
+
+    // appended to files while they are written, leftovers are from writes interrupted by a crash
+    static const QString TEMPORARY_SUFFIX;
+
+    AssetFileIO(int numThreads, QThreadPool* completionPool);
+    ~AssetFileIO();
+
+    void readFile(const QString& path, ReadCompletion completion);
+
+    // writes the data to a temporary file, syncs it to disk and then moves it into place, so a
+    // crash never leaves a partially written asset under its hash
+    void writeFile(const QString& path, QByteArray data, WriteCompletion completion);
+
+    // writes the data at the given offset of an existing file, without syncing it. The file is never created, so
+    // a write that was queued before the file was removed fails instead of leaving a new file behind.
+    void writeFileAt(const QString& path, qint64 offset, QByteArray data, WriteCompletion completion,
+                     WriteCondition condition = nullptr);
+
+    // syncs a file written with writeFileAt to disk and moves it to its final path
+    void commitFile(const QString& temporaryPath, const QString& path, WriteCompletion completion,
+                    WriteCondition condition = nullptr);
+
+    // finishes the queued requests and stops the disk threads, later requests complete with a failure
+    void stop();
+
+    QJsonObject getStats() const;
+
+private:
+    enum RequestType {
+        ReadFile,
+        WriteFile,
+        WriteFileAt,
+        CommitFile
+    };
+
+    struct Request {
+        RequestType type;
+        QString path;
+        QString destinationPath;
+        qint64 offset { 0 };
+        QByteArray data;
+        ReadCompletion readCompletion;
+        WriteCompletion writeCompletion;
+        WriteCondition writeCondition;
+        quint64 queuedTime;
+    };
+
+    void enqueue(Request request);
+    void run();
+    void process(Request& request);
+    void complete(std::function<void()> completion);
+
+    bool write(const QString& path, const QByteArray& data);
+    bool writeAt(const QString& path, qint64 offset, const QByteArray& data);
+    bool commit(const QString& temporaryPath, const QString& path);
+
+    QThreadPool* _completionPool;
+    std::vector<std::thread> _threads;
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::deque<Request> _requests;
+    bool _stopped { false };
+
+    std::atomic<int> _inFlight { 0 };
+    AssetFileIOHistogram _queueDepth;
+    AssetFileIOHistogram _queueLatency;
+    std::array<AssetFileIOHistogram, NumOperations> _latency;
+    std::array<std::atomic<quint64>, NumOperations> _bytes {};
+    std::atomic<quint64> _failures { 0 };
+    std::atomic<quint64> _nextTemporaryID { 0 };
+};
+
+using AssetFileIOPointer = std::shared_ptr<AssetFileIO>;
+
+#endif // hifi_AssetFileIO_h
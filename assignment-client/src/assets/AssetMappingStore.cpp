@@ -0,0 +1,283 @@
+//
+//  AssetMappingStore.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetMappingStore.h"
+
+#include <algorithm>
+
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include "AssetServerLogging.h"
+
+static const QString JOURNAL_SUFFIX = ".journal";
+
+// the journal is folded into the mapping file once it has more transactions than this, or than there are mappings
+static const int MIN_JOURNAL_LENGTH_TO_COMPACT = 1000;
+
+// commits are synced to disk at most this often, a crash of the process alone loses nothing
+static const quint64 SYNC_INTERVAL_USECS = 100 * USECS_PER_MSEC;
+
+void AssetMappingStore::Transaction::set(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash) {
+    _changes.emplace_back(path, hash);
+}
+
+void AssetMappingStore::Transaction::remove(const AssetUtils::AssetPath& path) {
+    _changes.emplace_back(path, AssetUtils::AssetHash());
+}
+
+bool AssetMappingStore::load(const QString& mapFilePath) {
+    _mapFilePath = mapFilePath;
+    _journalFilePath = mapFilePath + JOURNAL_SUFFIX;
+    _mappings.clear();
+
+    QFile mapFile { mapFilePath };
+    if (mapFile.exists()) {
+        if (!mapFile.open(QIODevice::ReadOnly)) {
+            qCCritical(asset_server) << "Failed to read mapping file at" << mapFilePath;
+            return false;
+        }
+
+        QJsonParseError error;
+        auto jsonDocument = QJsonDocument::fromJson(mapFile.readAll(), &error);
+
+        if (error.error != QJsonParseError::NoError) {
+            qCCritical(asset_server) << "Failed to read mapping file at" << mapFilePath;
+            return false;
+        }
+
+        if (!jsonDocument.isObject()) {
+            qCWarning(asset_server) << "Failed to read mapping file, root value in" << mapFilePath << "is not an object";
+            return false;
+        }
+
+        auto root = jsonDocument.object();
+        for (auto it = root.begin(); it != root.end(); ++it) {
+            auto key = it.key();
+            auto value = it.value();
+
+            if (!value.isString()) {
+                qCWarning(asset_server) << "Skipping" << key << ":" << value << "because it is not a string";
+                continue;
+            }
+
+            if (!AssetUtils::isValidFilePath(key)) {
+                qCWarning(asset_server) << "Will not keep mapping for" << key << "since it is not a valid path.";
+                continue;
+            }
+
+            if (!AssetUtils::isValidHash(value.toString())) {
+                qCWarning(asset_server) << "Will not keep mapping for" << key << "since it does not have a valid hash.";
+                continue;
+            }
+
+            _mappings[key] = value.toString();
+        }
+
+        qCInfo(asset_server) << "Loaded" << _mappings.size() << "mappings from map file at" << mapFilePath;
+    } else {
+        qCInfo(asset_server) << "No existing mappings loaded from file since no file was found at" << mapFilePath;
+    }
+
+    // fold whatever the journal holds into the map file and start over with an empty journal, even if nothing
+    // could be replayed, since appending after a torn last line would corrupt the next change written
+    if (QFileInfo(_journalFilePath).size() > 0) {
+        auto replayed = replayJournal();
+        qCInfo(asset_server) << "Replayed" << replayed << "mapping changes from" << _journalFilePath;
+
+        if (!writeMapFile()) {
+            return false;
+        }
+        QFile::remove(_journalFilePath);
+    }
+
+    return openJournal();
+}
+
+int AssetMappingStore::replayJournal() {
+    QFile journal { _journalFilePath };
+    if (!journal.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+
+    int replayed = 0;
+    while (!journal.atEnd()) {
+        auto line = journal.readLine();
+        if (!line.endsWith('\n')) {
+            // the process stopped while writing this transaction, so it never happened
+            qCWarning(asset_server) << "Ignoring an incomplete mapping change at the end of" << _journalFilePath;
+            break;
+        }
+
+        QJsonParseError error;
+        auto document = QJsonDocument::fromJson(line, &error);
+        if (error.error != QJsonParseError::NoError || !document.isArray()) {
+            qCWarning(asset_server) << "Skipping a mapping change that could not be parsed in" << _journalFilePath
+                << "-" << error.errorString();
+            continue;
+        }
+
+        Transaction transaction;
+        for (const auto& change : document.array()) {
+            auto pair = change.toArray();
+            if (pair.size() != 2 || !pair[0].isString() || !pair[1].isString()) {
+                qCWarning(asset_server) << "Skipping a malformed mapping change in" << _journalFilePath << ":" << change;
+                continue;
+            }
+
+            // the journal is held to the same rules as the mapping file
+            auto path = pair[0].toString();
+            auto hash = pair[1].toString();
+            if (!AssetUtils::isValidFilePath(path)) {
+                qCWarning(asset_server) << "Skipping a mapping change for" << path << "since it is not a valid path.";
+                continue;
+            }
+
+            if (!hash.isEmpty() && !AssetUtils::isValidHash(hash)) {
+                qCWarning(asset_server) << "Skipping a mapping change for" << path << "since it does not have a valid hash.";
+                continue;
+            }
+
+            transaction._changes.emplace_back(path, hash);
+        }
+        apply(transaction);
+        ++replayed;
+    }
+    return replayed;
+}
+
+bool AssetMappingStore::openJournal() {
+    _journal.setFileName(_journalFilePath);
+    if (!_journal.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCCritical(asset_server) << "Failed to open mapping journal at" << _journalFilePath << "-" << _journal.errorString();
+        return false;
+    }
+    _journalLength = 0;
+    return true;
+}
+
+bool AssetMappingStore::commit(const Transaction& transaction) {
+    if (transaction.isEmpty()) {
+        return true;
+    }
+
+    QJsonArray changes;
+    for (const auto& change : transaction._changes) {
+        changes.append(QJsonArray { change.first, change.second });
+    }
+    auto line = QJsonDocument(changes).toJson(QJsonDocument::Compact) + '\n';
+
+    auto position = _journal.size();
+    if (_journal.write(line) != line.size() || !_journal.flush()) {
+        qCWarning(asset_server) << "Failed to write to mapping journal at" << _journalFilePath << "-" << _journal.errorString();
+
+        // drop whatever part of the line made it, so the next transaction starts on its own line
+        _journal.resize(position);
+        return false;
+    }
+
+    apply(transaction);
+    ++_journalLength;
+    _needsSync = true;
+
+    if (_journalLength > std::max(MIN_JOURNAL_LENGTH_TO_COMPACT, (int)_mappings.size())) {
+        // fold the journal into the mapping file, a crash in between only replays changes it already has
+        if (writeMapFile()) {
+            _journal.resize(0);
+            _journalLength = 0;
+            _needsSync = false;
+        }
+    } else if (usecTimestampNow() - _lastSync > SYNC_INTERVAL_USECS) {
+        sync();
+    }
+
+    return true;
+}
+
+void AssetMappingStore::sync() {
+    if (!_needsSync) {
+        return;
+    }
+
+#ifdef Q_OS_WIN
+    bool synced = _commit(_journal.handle()) == 0;
+#else
+    bool synced = fsync(_journal.handle()) == 0;
+#endif
+    if (!synced) {
+        qCWarning(asset_server) << "Failed to sync mapping journal at" << _journalFilePath;
+    }
+
+    _needsSync = false;
+    _lastSync = usecTimestampNow();
+}
+
+void AssetMappingStore::apply(const Transaction& transaction) {
+    for (const auto& change : transaction._changes) {
+        if (change.second.isEmpty()) {
+            _mappings.erase(change.first);
+        } else {
+            _mappings[change.first] = change.second;
+        }
+    }
+}
+
+std::pair<AssetMappingStore::const_iterator, AssetMappingStore::const_iterator>
+        AssetMappingStore::prefixRange(const QString& prefix, const QString& after) const {
+    auto first = after < prefix ? _mappings.lower_bound(prefix) : _mappings.upper_bound(after);
+
+    // no path continues with the last UTF-16 code unit, so this sorts after every path with the prefix
+    auto last = prefix.isEmpty() ? _mappings.cend() : _mappings.lower_bound(prefix + QChar(0xFFFF));
+
+    if (first == _mappings.cend() || (last != _mappings.cend() && last->first < first->first)) {
+        first = last;
+    }
+    return { first, last };
+}
+
+bool AssetMappingStore::writeMapFile() {
+    QSaveFile mapFile { _mapFilePath };
+    if (mapFile.open(QIODevice::WriteOnly)) {
+        QJsonObject root;
+
+        for (const auto& it : _mappings) {
+            root[it.first] = it.second;
+        }
+
+        QJsonDocument jsonDocument { root };
+
+        if (mapFile.write(jsonDocument.toJson()) != -1) {
+            if (mapFile.commit()) {
+                qCDebug(asset_server) << "Wrote JSON mappings to file at" << _mapFilePath;
+                return true;
+            } else {
+                qCWarning(asset_server) << "Failed to commit JSON mappings to file at" << _mapFilePath;
+            }
+        } else {
+            qCWarning(asset_server) << "Failed to write JSON mappings to file at" << _mapFilePath;
+        }
+    } else {
+        qCWarning(asset_server) << "Failed to open map file at" << _mapFilePath;
+    }
+
+    return false;
+}
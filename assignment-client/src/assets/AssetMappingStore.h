@@ -0,0 +1,81 @@
+//
+//  AssetMappingStore.h
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetMappingStore_h
+#define hifi_AssetMappingStore_h
+
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+#include <AssetUtils.h>
+
+/// The asset server's path to hash mappings, ordered by path so a folder is a contiguous range.
+///
+/// Changes are made in transactions that are appended as one line each to a journal next to the mapping
+/// file, so a change costs one short write instead of a rewrite of every mapping. Loading replays the
+/// journal over the mapping file, ignoring a last line cut short by a crash. Once the journal outgrows
+/// the mappings it is folded back into the mapping file.
+class AssetMappingStore {
+public:
+    using Mappings = AssetUtils::Mappings;
+    using const_iterator = Mappings::const_iterator;
+
+    class Transaction {
+    public:
+        void set(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash);
+        void remove(const AssetUtils::AssetPath& path);
+
+        bool isEmpty() const { return _changes.empty(); }
+
+    private:
+        // an empty hash removes the path
+        std::vector<std::pair<AssetUtils::AssetPath, AssetUtils::AssetHash>> _changes;
+
+        friend class AssetMappingStore;
+    };
+
+    bool load(const QString& mapFilePath);
+
+    // persists the transaction to the journal and then applies it, returns false and applies nothing if that fails
+    bool commit(const Transaction& transaction);
+
+    // forces the journal to disk, commits are flushed to the OS as they happen but only synced once in a while
+    void sync();
+
+    const Mappings& getMappings() const { return _mappings; }
+    const_iterator find(const AssetUtils::AssetPath& path) const { return _mappings.find(path); }
+    const_iterator begin() const { return _mappings.cbegin(); }
+    const_iterator end() const { return _mappings.cend(); }
+    const_iterator cbegin() const { return _mappings.cbegin(); }
+    const_iterator cend() const { return _mappings.cend(); }
+    size_t size() const { return _mappings.size(); }
+
+    // the mappings whose path starts with prefix, in path order, starting after the given path
+    std::pair<const_iterator, const_iterator> prefixRange(const QString& prefix, const QString& after = QString()) const;
+
+    int getJournalLength() const { return _journalLength; }
+
+private:
+    bool writeMapFile();
+    bool openJournal();
+    int replayJournal();
+    void apply(const Transaction& transaction);
+
+    QString _mapFilePath;
+    QString _journalFilePath;
+    QFile _journal;
+    int _journalLength { 0 };
+    bool _needsSync { false };
+    quint64 _lastSync { 0 };
+
+    Mappings _mappings;
+};
+
+#endif // hifi_AssetMappingStore_h
@@ -12,6 +12,7 @@
 
 #include "AssetServer.h"
 
+#include <algorithm>
 #include <thread>
 #include <memory>
 
@@ -37,7 +38,9 @@
 
 #include "AssetServerLogging.h"
 #include "BakeAssetTask.h"
+#include "SendAssetChunkListTask.h"
 #include "SendAssetTask.h"
+#include "UploadAssetChunkTask.h"
 #include "UploadAssetTask.h"
 
 static const uint8_t MIN_CORES_FOR_MULTICORE = 4;
@@ -125,12 +128,30 @@ void AssetServer::bakeAsset(const AssetUtils::AssetHash& assetHash, const AssetU
         connect(task.get(), &BakeAssetTask::bakeFailed, this, &AssetServer::handleFailedBake);
         connect(task.get(), &BakeAssetTask::bakeAborted, this, &AssetServer::handleAbortedBake);
 
-        _bakingTaskPool.start(task.get());
+        // assets that clients already asked for are baked first
+        _bakingTaskPool.start(task.get(), _bakeDemand.value(assetHash, 0));
     } else {
         qDebug() << "Already in queue";
     }
 }
 
+void AssetServer::prioritizeBake(const AssetUtils::AssetHash& assetHash) {
+    auto demand = ++_bakeDemand[assetHash];
+
+    // a bake that hasn't started yet is queued again with its new priority
+    auto it = _pendingBakes.find(assetHash);
+    if (it != _pendingBakes.end() && _bakingTaskPool.tryTake(it->get())) {
+        _bakingTaskPool.start(it->get(), demand);
+    }
+}
+
+AssetUtils::AssetHash AssetServer::getServedHash(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash) {
+    // unlike a mapping request this doesn't read the meta file for a redirect target, the baked root file covers most assets
+    auto bakedPath = getBakeMapping(hash, bakedFilenameForAssetType(assetTypeForFilename(path)));
+    auto it = _fileMappings.find(bakedPath);
+    return it != _fileMappings.end() ? it->second : hash;
+}
+
 QString AssetServer::getPathToAssetHash(const AssetUtils::AssetHash& assetHash) {
     return _filesDirectory.absoluteFilePath(assetHash);
 }
@@ -304,11 +325,18 @@ AssetServer::AssetServer(ReceivedMessage& message) :
     // so the ideal is greater than the number of cores on the system.
     static const int TASK_POOL_THREAD_COUNT = 50;
     _transferTaskPool.setMaxThreadCount(TASK_POOL_THREAD_COUNT);
-    _bakingTaskPool.setMaxThreadCount(1);
+
+    // The disk itself only benefits from a few requests in flight at once, the rest wait in its queue
+    // rather than holding transfer threads.
+    static const int FILE_IO_THREAD_COUNT = 4;
+    _fileIO = std::make_shared<AssetFileIO>(FILE_IO_THREAD_COUNT, &_transferTaskPool);
 
     // Queue all requests until the Asset Server is fully setup
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
-    packetReceiver.registerListenerForTypes({ PacketType::AssetGet, PacketType::AssetGetInfo, PacketType::AssetUpload, PacketType::AssetMappingOperation }, this, "queueRequests");
+    packetReceiver.registerListenerForTypes({ PacketType::AssetGet, PacketType::AssetGetInfo, PacketType::AssetUpload,
+                                               PacketType::AssetUploadChunk, PacketType::AssetMappingOperation,
+                                               PacketType::AssetGetChunkList },
+                                             this, "queueRequests");
 
 #ifdef Q_OS_WIN
     updateConsumedCores();
@@ -327,6 +355,10 @@ AssetServer::AssetServer(ReceivedMessage& message) :
 
 void AssetServer::aboutToFinish() {
 
+    // finish the writes that were already accepted
+    _fileIO->stop();
+    _fileMappings.sync();
+
     // remove pending transfer tasks
     _transferTaskPool.clear();
 
@@ -363,6 +395,7 @@ void AssetServer::run() {
 }
 
 static const QString ASSET_FILES_SUBDIR = "files";
+static const QString ASSET_CHUNK_LISTS_SUBDIR = "chunklists";
 
 void AssetServer::completeSetup() {
     auto nodeList = DependencyManager::get<NodeList>();
@@ -392,6 +425,16 @@ void AssetServer::completeSetup() {
                     " (" << maxBandwidth << "bits/s)";
     }
 
+    // get the number of assets baked at once, each by its own oven process
+    static const QString BAKING_WORKERS_OPTION = "baking_workers";
+    auto bakingWorkers = assetServerObject[BAKING_WORKERS_OPTION].toInt(0);
+    if (bakingWorkers <= 0) {
+        // leave half of the cores for serving assets
+        bakingWorkers = std::max((int)std::thread::hardware_concurrency() / 2, 1);
+    }
+    _bakingTaskPool.setMaxThreadCount(bakingWorkers);
+    qCInfo(asset_server) << "Baking up to" << bakingWorkers << "assets at once.";
+
     // get the path to the asset folder from the domain server settings
     static const QString ASSETS_PATH_OPTION = "assets_path";
     auto assetsJSONValue = assetServerObject[ASSETS_PATH_OPTION];
@@ -424,6 +467,13 @@ void AssetServer::completeSetup() {
         return;
     }
 
+    _uploadSessions = std::make_shared<AssetUploadSessions>(_filesDirectory);
+
+    _chunkListsDirectory = QDir(_resourcesDirectory.filePath(ASSET_CHUNK_LISTS_SUBDIR));
+    if (!_chunkListsDirectory.mkpath(".")) {
+        qCWarning(asset_server) << "Unable to create the chunk lists directory, chunk lists will not be kept.";
+    }
+
     // load whatever mappings we currently have from the local file
     if (loadMappingsFromFile()) {
         qCInfo(asset_server) << "Serving files from: " << _filesDirectory.path();
@@ -436,6 +486,14 @@ void AssetServer::completeSetup() {
 
         qCInfo(asset_server) << "There are" << hashedFiles.size() << "asset files in the asset directory.";
 
+        // remove what's left of writes that were interrupted
+        for (const auto& file : files) {
+            if (file.endsWith(AssetFileIO::TEMPORARY_SUFFIX)) {
+                qCInfo(asset_server) << "Removing incomplete asset file" << file;
+                _filesDirectory.remove(file);
+            }
+        }
+
         if (_fileMappings.size() > 0) {
             cleanupUnmappedFiles();
             cleanupBakedFilesForDeletedAssets();
@@ -458,6 +516,29 @@ void AssetServer::completeSetup() {
         _filesizeLimit = assetsFilesizeLimit * BITS_PER_MEGABITS;
     }
 
+    // get the size of the in-memory cache of the most requested assets
+    static const QString HOT_CACHE_SIZE_OPTION = "hot_cache_size";
+    static const int DEFAULT_HOT_CACHE_SIZE_MB = 256;
+    static const qint64 BYTES_PER_MEGABYTE = 1024 * 1024;
+    auto hotCacheSize = assetServerObject[HOT_CACHE_SIZE_OPTION].toInt(DEFAULT_HOT_CACHE_SIZE_MB);
+    _contentCache = std::make_shared<AssetContentCache>(std::max(hotCacheSize, 0) * BYTES_PER_MEGABYTE);
+    qCInfo(asset_server) << "Caching up to" << hotCacheSize << "MB of the most requested assets in memory.";
+
+    // get the assets clients should prefetch when they connect
+    static const QString PREFETCH_MANIFEST_SIZE_OPTION = "prefetch_manifest_size";
+    static const QString PREFETCH_PATHS_OPTION = "prefetch_paths";
+    _prefetchManifestSize = std::max(assetServerObject[PREFETCH_MANIFEST_SIZE_OPTION].toInt(0), 0);
+    for (auto& path : assetServerObject[PREFETCH_PATHS_OPTION].toString().split(',', QString::SkipEmptyParts)) {
+        path = path.trimmed();
+        if (!path.isEmpty()) {
+            _prefetchPaths << (path.endsWith('/') ? path : path + '/');
+        }
+    }
+    if (_prefetchManifestSize > 0) {
+        qCInfo(asset_server) << "Clients prefetch up to" << _prefetchManifestSize << "assets, starting with those in"
+            << _prefetchPaths;
+    }
+
     PathUtils::removeTemporaryApplicationDirs();
     PathUtils::removeTemporaryApplicationDirs("Oven");
 
@@ -466,7 +547,9 @@ void AssetServer::completeSetup() {
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
     packetReceiver.registerListener(PacketType::AssetGet, this, "handleAssetGet");
     packetReceiver.registerListener(PacketType::AssetGetInfo, this, "handleAssetGetInfo");
+    packetReceiver.registerListener(PacketType::AssetGetChunkList, this, "handleAssetGetChunkList");
     packetReceiver.registerListener(PacketType::AssetUpload, this, "handleAssetUpload");
+    packetReceiver.registerListener(PacketType::AssetUploadChunk, this, "handleAssetUploadChunk");
     packetReceiver.registerListener(PacketType::AssetMappingOperation, this, "handleAssetMappingOperation");
 
     replayRequests();
@@ -504,9 +587,15 @@ void AssetServer::replayRequests() {
             case PacketType::AssetGetInfo:
                 handleAssetGetInfo(request.first, request.second);
                 break;
+            case PacketType::AssetGetChunkList:
+                handleAssetGetChunkList(request.first, request.second);
+                break;
             case PacketType::AssetUpload:
                 handleAssetUpload(request.first, request.second);
                 break;
+            case PacketType::AssetUploadChunk:
+                handleAssetUploadChunk(request.first, request.second);
+                break;
             case PacketType::AssetMappingOperation:
                 handleAssetMappingOperation(request.first, request.second);
                 break;
@@ -540,6 +629,8 @@ void AssetServer::cleanupUnmappedFiles() {
 
                 if (removeableFile.remove()) {
                     qCDebug(asset_server) << "\tDeleted" << filename << "from asset files directory since it is unmapped.";
+                    _contentCache->remove(filename);
+                    _chunkListsDirectory.remove(filename);
 
                     removeBakedPathsForDeletedAsset(filename);
                 } else {
@@ -618,6 +709,12 @@ void AssetServer::handleAssetMappingOperation(QSharedPointer<ReceivedMessage> me
         case AssetMappingOperationType::SetBakingEnabled:
             handleSetBakingEnabledOperation(*message, canWriteToAssetServer, *replyPacket);
             break;
+        case AssetMappingOperationType::GetPage:
+            handleGetMappingsPageOperation(*message, *replyPacket);
+            break;
+        case AssetMappingOperationType::GetManifest:
+            handleGetManifestOperation(*replyPacket);
+            break;
     }
 
     auto nodeList = DependencyManager::get<NodeList>();
@@ -680,10 +777,19 @@ void AssetServer::handleGetMappingOperation(ReceivedMessage& message, NLPacketLi
             // include the re-directed path in case the caller needs to make relative path requests for the baked asset
             replyPacket.writeString(bakedAssetPath);
 
+            replyPacket.writePrimitive((qint64)QFileInfo(_filesDirectory.filePath(redirectedAssetHash)).size());
+
         } else {
             replyPacket.write(QByteArray::fromHex(originalAssetHash.toUtf8()));
             replyPacket.writePrimitive(wasRedirected);
 
+            // the size lets clients decide whether the asset is large enough to fetch by chunks
+            replyPacket.writePrimitive((qint64)QFileInfo(_filesDirectory.filePath(originalAssetHash)).size());
+
+            if (!bakingDisabled && _pendingBakes.contains(originalAssetHash)) {
+                prioritizeBake(originalAssetHash);
+            }
+
             auto query = QUrlQuery(url.query());
             bool isSkybox = query.hasQueryItem("skybox");
             if (isSkybox && !loaded) {
@@ -709,19 +815,94 @@ void AssetServer::handleGetAllMappingOperation(NLPacketList& replyPacket) {
     replyPacket.writePrimitive(count);
 
     for (auto it = _fileMappings.cbegin(); it != _fileMappings.cend(); ++ it) {
-        auto mapping = it->first;
-        auto hash = it->second;
-        replyPacket.writeString(mapping);
-        replyPacket.write(QByteArray::fromHex(hash.toUtf8()));
-
-        AssetUtils::BakingStatus status;
-        QString lastBakeErrors;
-        std::tie(status, lastBakeErrors) = getAssetStatus(mapping, hash);
-        replyPacket.writePrimitive(status);
-        if (status == AssetUtils::Error) {
-            replyPacket.writeString(lastBakeErrors);
+        writeMappingEntry(replyPacket, it->first, it->second);
+    }
+}
+
+void AssetServer::handleGetMappingsPageOperation(ReceivedMessage& message, NLPacketList& replyPacket) {
+    auto prefix = message.readString();
+    auto after = message.readString();
+
+    uint32_t limit;
+    message.readPrimitive(&limit);
+    limit = std::min(std::max(limit, (uint32_t)1), AssetUtils::MAX_MAPPINGS_PAGE_SIZE);
+
+    auto range = _fileMappings.prefixRange(prefix, after);
+
+    uint32_t count = 0;
+    auto end = range.first;
+    while (end != range.second && count < limit) {
+        ++end;
+        ++count;
+    }
+
+    replyPacket.writePrimitive(AssetUtils::AssetServerError::NoError);
+    replyPacket.writePrimitive(count);
+
+    AssetUtils::AssetPath lastPath;
+    for (auto it = range.first; it != end; ++it) {
+        writeMappingEntry(replyPacket, it->first, it->second);
+        lastPath = it->first;
+    }
+
+    // the path to continue after, empty once this page reached the last mapping with the prefix
+    replyPacket.writeString(end != range.second ? lastPath : QString());
+}
+
+void AssetServer::handleGetManifestOperation(NLPacketList& replyPacket) {
+    struct ManifestEntry {
+        AssetUtils::AssetHash hash;
+        bool isListed;
+        int demand;
+    };
+    std::vector<ManifestEntry> manifest;
+    QSet<AssetUtils::AssetHash> inManifest;
+
+    // the assets in the configured folders come first, then those everyone has been asking for
+    for (const auto& prefix : _prefetchPaths) {
+        auto range = _fileMappings.prefixRange(prefix);
+        for (auto it = range.first; it != range.second && (int)manifest.size() < _prefetchManifestSize; ++it) {
+            auto hash = getServedHash(it->first, it->second);
+            if (!inManifest.contains(hash)) {
+                inManifest.insert(hash);
+                manifest.push_back({ hash, true, _contentCache->getDemand(hash) });
+            }
         }
     }
+
+    for (const auto& requested : _contentCache->getMostRequested(_prefetchManifestSize)) {
+        if ((int)manifest.size() >= _prefetchManifestSize) {
+            break;
+        }
+        if (!inManifest.contains(requested.first) && _filesDirectory.exists(requested.first)) {
+            inManifest.insert(requested.first);
+            manifest.push_back({ requested.first, false, requested.second });
+        }
+    }
+
+    std::stable_sort(manifest.begin(), manifest.end(), [](const ManifestEntry& a, const ManifestEntry& b) {
+        return a.isListed != b.isListed ? a.isListed : a.demand > b.demand;
+    });
+
+    replyPacket.writePrimitive(AssetUtils::AssetServerError::NoError);
+    replyPacket.writePrimitive((uint32_t)manifest.size());
+    for (const auto& entry : manifest) {
+        replyPacket.write(QByteArray::fromHex(entry.hash.toUtf8()));
+    }
+}
+
+void AssetServer::writeMappingEntry(NLPacketList& replyPacket, const AssetUtils::AssetPath& path,
+                                    const AssetUtils::AssetHash& hash) {
+    replyPacket.writeString(path);
+    replyPacket.write(QByteArray::fromHex(hash.toUtf8()));
+
+    AssetUtils::BakingStatus status;
+    QString lastBakeErrors;
+    std::tie(status, lastBakeErrors) = getAssetStatus(path, hash);
+    replyPacket.writePrimitive(status);
+    if (status == AssetUtils::Error) {
+        replyPacket.writeString(lastBakeErrors);
+    }
 }
 
 void AssetServer::handleSetMappingOperation(ReceivedMessage& message, bool hasWriteAccess, NLPacketList& replyPacket) {
@@ -842,12 +1023,22 @@ void AssetServer::handleAssetGetInfo(QSharedPointer<ReceivedMessage> message, Sh
     replyPacket->write(assetHash);
 
     QString fileName = QString(hexHash);
+    qint64 fileSize = 0;
+
+    if (_contentCache->findSize(fileName, fileSize)) {
+        replyPacket->writePrimitive(AssetUtils::AssetServerError::NoError);
+        replyPacket->writePrimitive(fileSize);
+        nodeList()->sendPacket(std::move(replyPacket), *senderNode);
+        return;
+    }
+
     QFileInfo fileInfo { _filesDirectory.filePath(fileName) };
 
     if (fileInfo.exists() && fileInfo.isReadable()) {
         qCDebug(asset_server) << "Opening file: " << fileInfo.filePath();
         replyPacket->writePrimitive(AssetUtils::AssetServerError::NoError);
         replyPacket->writePrimitive(fileInfo.size());
+        _contentCache->insertSize(fileName, fileInfo.size());
     } else {
         qCDebug(asset_server) << "Asset not found: " << QString(hexHash);
         replyPacket->writePrimitive(AssetUtils::AssetServerError::AssetNotFound);
@@ -857,6 +1048,19 @@ void AssetServer::handleAssetGetInfo(QSharedPointer<ReceivedMessage> message, Sh
     nodeList->sendPacket(std::move(replyPacket), *senderNode);
 }
 
+void AssetServer::handleAssetGetChunkList(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    if (message->getSize() < qint64(AssetUtils::SHA256_HASH_LENGTH + sizeof(MessageID))) {
+        qCDebug(asset_server) << "ERROR bad chunk list request";
+        return;
+    }
+
+    ++_numChunkListRequests;
+
+    // chunking a large asset the first time reads all of it, so it's done on the transfer pool
+    auto task = new SendAssetChunkListTask(message, senderNode, _filesDirectory, _chunkListsDirectory, _fileIO);
+    _transferTaskPool.start(task);
+}
+
 void AssetServer::handleAssetGet(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
 
     auto minSize = qint64(sizeof(MessageID) + AssetUtils::SHA256_HASH_LENGTH + sizeof(AssetUtils::DataOffset) + sizeof(AssetUtils::DataOffset));
@@ -867,7 +1071,7 @@ void AssetServer::handleAssetGet(QSharedPointer<ReceivedMessage> message, Shared
     }
 
     // Queue task
-    auto task = new SendAssetTask(message, senderNode, _filesDirectory);
+    auto task = new SendAssetTask(message, senderNode, _filesDirectory, _contentCache);
     _transferTaskPool.start(task);
 }
 
@@ -881,7 +1085,7 @@ void AssetServer::handleAssetUpload(QSharedPointer<ReceivedMessage> message, Sha
     if (canWriteToAssetServer) {
         qCDebug(asset_server) << "Starting an UploadAssetTask for upload from" << message->getSourceID();
 
-        auto task = new UploadAssetTask(message, senderNode, _filesDirectory, _filesizeLimit);
+        auto task = new UploadAssetTask(message, senderNode, _filesDirectory, _filesizeLimit, _fileIO);
         _transferTaskPool.start(task);
     } else {
         // this is a node the domain told us is not allowed to rez entities
@@ -907,6 +1111,23 @@ void AssetServer::handleAssetUpload(QSharedPointer<ReceivedMessage> message, Sha
     }
 }
 
+void AssetServer::handleAssetUploadChunk(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    bool canWriteToAssetServer = true;
+    if (senderNode) {
+        canWriteToAssetServer = senderNode->getCanWriteToAssetServer();
+    }
+
+    if (canWriteToAssetServer) {
+        auto task = new UploadAssetChunkTask(message, senderNode, _filesDirectory, _filesizeLimit, _fileIO, _uploadSessions);
+        _transferTaskPool.start(task);
+    } else {
+        MessageID messageID;
+        message->readPrimitive(&messageID);
+
+        UploadAssetChunkTask::sendReply(message, senderNode, messageID, AssetUtils::AssetServerError::PermissionDenied);
+    }
+}
+
 void AssetServer::sendStatsPacket() {
     QJsonObject serverStats;
 
@@ -957,97 +1178,81 @@ void AssetServer::sendStatsPacket() {
         serverStats[uuid] = nodeStats;
     });
 
-    // send off the stats packets
-    ThreadedAssignment::addPacketStatsAndSendStatsPacket(serverStats);
-}
-
-static const QString MAP_FILE_NAME = "map.json";
-
-bool AssetServer::loadMappingsFromFile() {
-
-    auto mapFilePath = _resourcesDirectory.absoluteFilePath(MAP_FILE_NAME);
-
-    QFile mapFile { mapFilePath };
-    if (mapFile.exists()) {
-        if (mapFile.open(QIODevice::ReadOnly)) {
-            QJsonParseError error;
-
-            auto jsonDocument = QJsonDocument::fromJson(mapFile.readAll(), &error);
-
-            if (error.error == QJsonParseError::NoError) {
-                if (!jsonDocument.isObject()) {
-                    qCWarning(asset_server) << "Failed to read mapping file, root value in" << mapFilePath << "is not an object";
-                    return false;
-                }
-
-                //_fileMappings = jsonDocument.object().toVariantHash();
-                auto root = jsonDocument.object();
-                for (auto it = root.begin(); it != root.end(); ++it) {
-                    auto key = it.key();
-                    auto value = it.value();
-
-                    if (!value.isString()) {
-                        qCWarning(asset_server) << "Skipping" << key << ":" << value << "because it is not a string";
-                        continue;
-                    }
-
-                    if (!AssetUtils::isValidFilePath(key)) {
-                        qCWarning(asset_server) << "Will not keep mapping for" << key << "since it is not a valid path.";
-                        continue;
-                    }
-
-                    if (!AssetUtils::isValidHash(value.toString())) {
-                        qCWarning(asset_server) << "Will not keep mapping for" << key << "since it does not have a valid hash.";
-                        continue;
-                    }
-
-
-                    qDebug() << "Added " << key << value.toString();
-                    _fileMappings[key] = value.toString();
-                }
-
-                qCInfo(asset_server) << "Loaded" << _fileMappings.size() << "mappings from map file at" << mapFilePath;
-                return true;
+    QJsonObject cacheStats;
+    cacheStats["1. Hits"] = (double)_contentCache->getHits();
+    cacheStats["2. Misses"] = (double)_contentCache->getMisses();
+    cacheStats["3. Info Hits"] = (double)_contentCache->getInfoHits();
+    cacheStats["4. Info Misses"] = (double)_contentCache->getInfoMisses();
+    cacheStats["5. Admissions"] = (double)_contentCache->getAdmissions();
+    cacheStats["6. Evictions"] = (double)_contentCache->getEvictions();
+    cacheStats["7. Entries"] = _contentCache->getCount();
+    cacheStats["8. Size (MB)"] = (double)_contentCache->getBytes() / (1024.0 * 1024.0);
+    cacheStats["9. Coalesced Reads"] = (double)_contentCache->getCoalescedReads();
+    serverStats["Hot Asset Cache"] = cacheStats;
+
+    serverStats["Disk I/O"] = _fileIO->getStats();
+
+    // mapping changes made since the last stats are synced to disk by now at the latest
+    _fileMappings.sync();
+
+    QJsonObject mappingStats;
+    mappingStats["1. Mappings"] = (double)_fileMappings.size();
+    mappingStats["2. Journaled Changes"] = _fileMappings.getJournalLength();
+    serverStats["Mappings"] = mappingStats;
+
+    QJsonObject transferDedupStats;
+    transferDedupStats["1. Chunk List Requests"] = _numChunkListRequests;
+    serverStats["Transfer Dedup"] = transferDedupStats;
+
+    if (_uploadSessions) {
+        _uploadSessions->removeExpired();
+
+        QJsonObject uploadStats;
+        uploadStats["1. Sessions"] = _uploadSessions->getCount();
+        uploadStats["2. Buffered (MB)"] = (double)_uploadSessions->getBufferedBytes() / (1024.0 * 1024.0);
+        serverStats["Chunked Uploads"] = uploadStats;
+    }
+
+    int activeBakes = 0;
+    QVector<QPair<int, QString>> demandedBakes;
+    for (const auto& task : _pendingBakes) {
+        if (task->isBaking()) {
+            ++activeBakes;
+        } else {
+            auto demand = _bakeDemand.value(task->getAssetHash(), 0);
+            if (demand > 0) {
+                demandedBakes.push_back({ demand, task->getAssetPath() });
             }
         }
-
-        qCCritical(asset_server) << "Failed to read mapping file at" << mapFilePath;
-        return false;
-    } else {
-        qCInfo(asset_server) << "No existing mappings loaded from file since no file was found at" << mapFilePath;
     }
+    std::sort(demandedBakes.begin(), demandedBakes.end(), [](const QPair<int, QString>& a, const QPair<int, QString>& b) {
+        return a.first > b.first;
+    });
 
-    return true;
-}
-
-bool AssetServer::writeMappingsToFile() {
-    auto mapFilePath = _resourcesDirectory.absoluteFilePath(MAP_FILE_NAME);
-
-    QSaveFile mapFile { mapFilePath };
-    if (mapFile.open(QIODevice::WriteOnly)) {
-        QJsonObject root;
+    static const int MAX_REPORTED_DEMANDED_BAKES = 10;
+    QJsonObject demandStats;
+    for (int i = 0; i < demandedBakes.size() && i < MAX_REPORTED_DEMANDED_BAKES; ++i) {
+        demandStats[demandedBakes[i].second] = demandedBakes[i].first;
+    }
 
-        for (auto it : _fileMappings) {
-            root[it.first] = it.second;
-        }
+    QJsonObject bakingStats;
+    bakingStats["1. Workers"] = _bakingTaskPool.maxThreadCount();
+    bakingStats["2. Baking"] = activeBakes;
+    bakingStats["3. Queued"] = _pendingBakes.size() - activeBakes;
+    bakingStats["4. Completed"] = (double)_completedBakes;
+    bakingStats["5. Failed"] = (double)_failedBakes;
+    bakingStats["6. Most Requested Queued"] = demandStats;
+    serverStats["Baking"] = bakingStats;
 
-        QJsonDocument jsonDocument { root };
+    // send off the stats packets
+    ThreadedAssignment::addPacketStatsAndSendStatsPacket(serverStats);
+}
 
-        if (mapFile.write(jsonDocument.toJson()) != -1) {
-            if (mapFile.commit()) {
-                qCDebug(asset_server) << "Wrote JSON mappings to file at" << mapFilePath;
-                return true;
-            } else {
-                qCWarning(asset_server) << "Failed to commit JSON mappings to file at" << mapFilePath;
-            }
-        } else {
-            qCWarning(asset_server) << "Failed to write JSON mappings to file at" << mapFilePath;
-        }
-    } else {
-        qCWarning(asset_server) << "Failed to open map file at" << mapFilePath;
-    }
+static const QString MAP_FILE_NAME = "map.json";
 
-    return false;
+bool AssetServer::loadMappingsFromFile() {
+    auto mapFilePath = _resourcesDirectory.absoluteFilePath(MAP_FILE_NAME);
+    return _fileMappings.load(mapFilePath);
 }
 
 bool AssetServer::setMapping(AssetUtils::AssetPath path, AssetUtils::AssetHash hash) {
@@ -1063,29 +1268,16 @@ bool AssetServer::setMapping(AssetUtils::AssetPath path, AssetUtils::AssetHash h
         return false;
     }
 
-    // remember what the old mapping was in case persistence fails
-    auto it = _fileMappings.find(path);
-    auto oldMapping = it != _fileMappings.end() ? it->second : "";
-
-    // update the in memory QHash
-    _fileMappings[path] = hash;
+    AssetMappingStore::Transaction transaction;
+    transaction.set(path, hash);
 
-    // attempt to write to file
-    if (writeMappingsToFile()) {
+    if (_fileMappings.commit(transaction)) {
         // persistence succeeded, we are good to go
         qCDebug(asset_server) << "Set mapping:" << path << "=>" << hash;
         maybeBake(path, hash);
         return true;
     } else {
-        // failed to persist this mapping to file - put back the old one in our in-memory representation
-        if (oldMapping.isEmpty()) {
-            _fileMappings.erase(_fileMappings.find(path));
-        } else {
-            _fileMappings[path] = oldMapping;
-        }
-
         qCWarning(asset_server) << "Failed to persist mapping:" << path << "=>" << hash;
-
         return false;
     }
 }
@@ -1107,8 +1299,7 @@ void AssetServer::removeBakedPathsForDeletedAsset(AssetUtils::AssetHash hash) {
 }
 
 bool AssetServer::deleteMappings(const AssetUtils::AssetPathList& paths) {
-    // take a copy of the current mappings in case persistence of these deletes fails
-    auto oldMappings = _fileMappings;
+    AssetMappingStore::Transaction transaction;
 
     QSet<QString> hashesToCheckForDeletion;
 
@@ -1118,24 +1309,20 @@ bool AssetServer::deleteMappings(const AssetUtils::AssetPathList& paths) {
 
         // figure out if this path will delete a file or folder
         if (pathIsFolder(path)) {
-            // enumerate the in memory file mappings and remove anything that matches
-            auto it = _fileMappings.begin();
-            auto sizeBefore = _fileMappings.size();
+            // the mappings in the folder are next to each other
+            auto range = _fileMappings.prefixRange(path);
+            int numDeleted = 0;
 
-            while (it != _fileMappings.end()) {
-                if (it->first.startsWith(path)) {
-                    // add this hash to the list we need to check for asset removal from the server
-                    hashesToCheckForDeletion << it->second;
+            for (auto it = range.first; it != range.second; ++it) {
+                // add this hash to the list we need to check for asset removal from the server
+                hashesToCheckForDeletion << it->second;
 
-                    it = _fileMappings.erase(it);
-                } else {
-                    ++it;
-                }
+                transaction.remove(it->first);
+                ++numDeleted;
             }
 
-            auto sizeNow = _fileMappings.size();
-            if (sizeBefore != sizeNow) {
-                qCDebug(asset_server) << "Deleted" << sizeBefore - sizeNow << "mappings in folder: " << path;
+            if (numDeleted > 0) {
+                qCDebug(asset_server) << "Deleted" << numDeleted << "mappings in folder: " << path;
             } else {
                 qCDebug(asset_server) << "Did not find any mappings to delete in folder:" << path;
             }
@@ -1147,16 +1334,16 @@ bool AssetServer::deleteMappings(const AssetUtils::AssetPathList& paths) {
                 hashesToCheckForDeletion << it->second;
 
                 qCDebug(asset_server) << "Deleted a mapping:" << path << "=>" << it->second;
-                
-                _fileMappings.erase(it);
+
+                transaction.remove(path);
             } else {
                 qCDebug(asset_server) << "Unable to delete a mapping that was not found:" << path;
             }
         }
     }
 
-    // deleted the old mappings, attempt to persist to file
-    if (writeMappingsToFile()) {
+    // attempt to persist the deletes
+    if (_fileMappings.commit(transaction)) {
         // persistence succeeded we are good to go
 
         // TODO iterate through hashesToCheckForDeletion instead
@@ -1174,6 +1361,8 @@ bool AssetServer::deleteMappings(const AssetUtils::AssetPathList& paths) {
 
             if (removeableFile.remove()) {
                 qCDebug(asset_server) << "\tDeleted" << hash << "from asset files directory since it is now unmapped.";
+                _contentCache->remove(hash);
+                _chunkListsDirectory.remove(hash);
 
                 removeBakedPathsForDeletedAsset(hash);
             } else {
@@ -1183,10 +1372,7 @@ bool AssetServer::deleteMappings(const AssetUtils::AssetPathList& paths) {
 
         return true;
     } else {
-        qCWarning(asset_server) << "Failed to persist deleted mappings, rolling back";
-
-        // we didn't delete the previous mapping, put it back in our in-memory representation
-        _fileMappings = oldMappings;
+        qCWarning(asset_server) << "Failed to persist deleted mappings";
 
         return false;
     }
@@ -1212,35 +1398,29 @@ bool AssetServer::renameMapping(AssetUtils::AssetPath oldPath, AssetUtils::Asset
             return false;
         }
 
-        // take a copy of the old mappings
-        auto oldMappings = _fileMappings;
-
-        // iterate the current mappings and adjust any that matches the renamed folder
-        auto it = oldMappings.begin();
+        // remove every mapping in the renamed folder before adding them back under the new one,
+        // so a folder renamed into itself keeps all of its mappings
+        AssetMappingStore::Transaction transaction;
+        std::vector<std::pair<AssetUtils::AssetPath, AssetUtils::AssetHash>> renamedMappings;
 
-        while (it != oldMappings.end()) {
-            auto& oldKey = it->first;
-            if (oldKey.startsWith(oldPath)) {
-                auto newKey = oldKey;
-                newKey.replace(0, oldPath.size(), newPath);
-
-                // remove the old version from the in memory file mappings
-                _fileMappings.erase(_fileMappings.find(oldKey));
-                _fileMappings[newKey] = it->second;
-            }
+        auto range = _fileMappings.prefixRange(oldPath);
+        for (auto it = range.first; it != range.second; ++it) {
+            auto newKey = it->first;
+            newKey.replace(0, oldPath.size(), newPath);
 
-            ++it;
+            transaction.remove(it->first);
+            renamedMappings.emplace_back(newKey, it->second);
+        }
+        for (const auto& mapping : renamedMappings) {
+            transaction.set(mapping.first, mapping.second);
         }
 
-        if (writeMappingsToFile()) {
+        if (_fileMappings.commit(transaction)) {
             // persisted the changed mappings, return success
             qCDebug(asset_server) << "Renamed folder mapping:" << oldPath << "=>" << newPath;
 
             return true;
         } else {
-            // couldn't persist the renamed paths, rollback and return failure
-            _fileMappings = oldMappings;
-
             qCWarning(asset_server) << "Failed to persist renamed folder mapping:" << oldPath << "=>" << newPath;
 
             return false;
@@ -1253,40 +1433,25 @@ bool AssetServer::renameMapping(AssetUtils::AssetPath oldPath, AssetUtils::Asset
             return false;
         }
 
-        // take the old hash to remove the old mapping
         auto it = _fileMappings.find(oldPath);
-        auto oldSourceMapping = it->second;
-        _fileMappings.erase(it);
-
-        // in case we're overwriting, keep the current destination mapping for potential rollback
-        auto oldDestinationIt = _fileMappings.find(newPath);
-
-        if (!oldSourceMapping.isEmpty()) {
-            _fileMappings[newPath] = oldSourceMapping;
-
-            if (writeMappingsToFile()) {
-                // persisted the renamed mapping, return success
-                qCDebug(asset_server) << "Renamed mapping:" << oldPath << "=>" << newPath;
-
-                return true;
-            } else {
-                // we couldn't persist the renamed mapping, rollback and return failure
-                _fileMappings[oldPath] = oldSourceMapping;
+        if (it == _fileMappings.end()) {
+            // failed to find a mapping that was to be renamed, return failure
+            return false;
+        }
 
-                if (oldDestinationIt != _fileMappings.end()) {
-                    // put back the overwritten mapping for the destination path
-                    _fileMappings[newPath] = oldDestinationIt->second;
-                } else {
-                    // clear the new mapping
-                    _fileMappings.erase(_fileMappings.find(newPath));
-                }
+        // the new mapping replaces any mapping already at the destination path
+        AssetMappingStore::Transaction transaction;
+        transaction.remove(oldPath);
+        transaction.set(newPath, it->second);
 
-                qCDebug(asset_server) << "Failed to persist renamed mapping:" << oldPath << "=>" << newPath;
+        if (_fileMappings.commit(transaction)) {
+            // persisted the renamed mapping, return success
+            qCDebug(asset_server) << "Renamed mapping:" << oldPath << "=>" << newPath;
 
-                return false;
-            }
+            return true;
         } else {
-            // failed to find a mapping that was to be renamed, return failure
+            qCDebug(asset_server) << "Failed to persist renamed mapping:" << oldPath << "=>" << newPath;
+
             return false;
         }
     }
@@ -1310,6 +1475,8 @@ void AssetServer::handleFailedBake(QString originalAssetHash, QString assetPath,
     writeMetaFile(originalAssetHash, meta);
 
     _pendingBakes.remove(originalAssetHash);
+    _bakeDemand.remove(originalAssetHash);
+    ++_failedBakes;
 }
 
 void AssetServer::handleCompletedBake(QString originalAssetHash, QString originalAssetPath,
@@ -1333,6 +1500,12 @@ void AssetServer::handleCompletedBake(QString originalAssetHash, QString origina
         writeMetaFile(originalAssetHash, meta);
 
         _pendingBakes.remove(originalAssetHash);
+        _bakeDemand.remove(originalAssetHash);
+        if (errorCompletingBake) {
+            ++_failedBakes;
+        } else {
+            ++_completedBakes;
+        }
     };
 
     bool errorCompletingBake { false };
@@ -1466,6 +1639,7 @@ void AssetServer::handleAbortedBake(QString originalAssetHash, QString assetPath
 
     // for an aborted bake we don't do anything but remove the BakeAssetTask from our pending bakes
     _pendingBakes.remove(originalAssetHash);
+    _bakeDemand.remove(originalAssetHash);
 }
 
 static const QString BAKE_VERSION_KEY = "bake_version";
@@ -18,6 +18,10 @@
 
 #include <ThreadedAssignment.h>
 
+#include "AssetContentCache.h"
+#include "AssetFileIO.h"
+#include "AssetMappingStore.h"
+#include "AssetUploadSessions.h"
 #include "AssetUtils.h"
 #include "ReceivedMessage.h"
 
@@ -85,8 +89,10 @@ private slots:
 
     void queueRequests(QSharedPointer<ReceivedMessage> packet, SharedNodePointer senderNode);
     void handleAssetGetInfo(QSharedPointer<ReceivedMessage> packet, SharedNodePointer senderNode);
+    void handleAssetGetChunkList(QSharedPointer<ReceivedMessage> packet, SharedNodePointer senderNode);
     void handleAssetGet(QSharedPointer<ReceivedMessage> packet, SharedNodePointer senderNode);
     void handleAssetUpload(QSharedPointer<ReceivedMessage> packetList, SharedNodePointer senderNode);
+    void handleAssetUploadChunk(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleAssetMappingOperation(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
 
     void sendStatsPacket() override;
@@ -96,6 +102,9 @@ private:
 
     void handleGetMappingOperation(ReceivedMessage& message, NLPacketList& replyPacket);
     void handleGetAllMappingOperation(NLPacketList& replyPacket);
+    void handleGetMappingsPageOperation(ReceivedMessage& message, NLPacketList& replyPacket);
+    void handleGetManifestOperation(NLPacketList& replyPacket);
+    void writeMappingEntry(NLPacketList& replyPacket, const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash);
     void handleSetMappingOperation(ReceivedMessage& message, bool hasWriteAccess, NLPacketList& replyPacket);
     void handleDeleteMappingsOperation(ReceivedMessage& message, bool hasWriteAccess, NLPacketList& replyPacket);
     void handleRenameMappingOperation(ReceivedMessage& message, bool hasWriteAccess, NLPacketList& replyPacket);
@@ -106,7 +115,6 @@ private:
 
     // Mapping file operations must be called from main assignment thread only
     bool loadMappingsFromFile();
-    bool writeMappingsToFile();
 
     /// Set the mapping for path to hash
     bool setMapping(AssetUtils::AssetPath path, AssetUtils::AssetHash hash);
@@ -127,6 +135,9 @@ private:
 
     QString getPathToAssetHash(const AssetUtils::AssetHash& assetHash);
 
+    /// The hash clients are given for the mapping, which is that of its baked version when there is one
+    AssetUtils::AssetHash getServedHash(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash);
+
     std::pair<AssetUtils::BakingStatus, QString> getAssetStatus(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash);
 
     void bakeAssets();
@@ -136,6 +147,9 @@ private:
     bool needsToBeBaked(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& assetHash);
     void bakeAsset(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath, const QString& filePath);
 
+    /// Count a client's request for an asset whose bake is queued and move the bake up the queue
+    void prioritizeBake(const AssetUtils::AssetHash& assetHash);
+
     /// Move baked content for asset to baked directory and update baked status
     void handleCompletedBake(QString originalAssetHash, QString assetPath, QString bakedTempOutputDir);
     void handleFailedBake(QString originalAssetHash, QString assetPath, QString errors);
@@ -148,17 +162,41 @@ private:
     /// Remove baked paths when the original asset is deleteds
     void removeBakedPathsForDeletedAsset(AssetUtils::AssetHash originalAssetHash);
 
-    AssetUtils::Mappings _fileMappings;
+    AssetMappingStore _fileMappings;
 
     QDir _resourcesDirectory;
     QDir _filesDirectory;
 
+    /// The content defined chunks of the large assets clients asked for, by the hash of the asset. They only
+    /// deduplicate transfers: assets are still stored whole, storage dedup would need every reader of
+    /// _filesDirectory (replies, baking, backups, upload hashing) to assemble assets from chunks.
+    QDir _chunkListsDirectory;
+    int _numChunkListRequests { 0 };
+
     /// Task pool for handling uploads and downloads of assets
     QThreadPool _transferTaskPool;
 
+    /// Disk reads and writes for uploads, completed back on the transfer task pool
+    AssetFileIOPointer _fileIO;
+
+    /// Chunked uploads in progress, kept across dropped connections so they can resume
+    AssetUploadSessionsPointer _uploadSessions;
+
+    /// The content and size of the most requested assets, shared with the transfer tasks
+    AssetContentCachePointer _contentCache { std::make_shared<AssetContentCache>(0) };
+
+    /// Folders whose assets lead the manifest clients prefetch on connect, and the size of that manifest
+    AssetUtils::AssetPathList _prefetchPaths;
+    int _prefetchManifestSize { 0 };
+
     QHash<AssetUtils::AssetHash, std::shared_ptr<BakeAssetTask>> _pendingBakes;
     QThreadPool _bakingTaskPool;
 
+    /// Number of requests for each asset while its bake is queued, which is the priority of the bake
+    QHash<AssetUtils::AssetHash, int> _bakeDemand;
+    quint64 _completedBakes { 0 };
+    quint64 _failedBakes { 0 };
+
     QMutex _queuedRequestsMutex;
     bool _isQueueingRequests { true };
     using RequestQueue = QVector<QPair<QSharedPointer<ReceivedMessage>, SharedNodePointer>>;
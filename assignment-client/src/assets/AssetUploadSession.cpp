@@ -0,0 +1,107 @@
+//
+//  AssetUploadSession.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetUploadSession.h"
+
+#include <algorithm>
+
+#include <AssetUtils.h>
+#include <SharedUtil.h>
+
+AssetUploadSession::AssetUploadSession(const QUuid& uploadID, uint64_t totalSize, const QString& temporaryPath,
+                                       const QUuid& nodeID) :
+    _uploadID(uploadID),
+    _nodeID(nodeID),
+    _totalSize(totalSize),
+    _numChunks((uint32_t)((totalSize + AssetUtils::UPLOAD_CHUNK_SIZE - 1) / AssetUtils::UPLOAD_CHUNK_SIZE)),
+    _temporaryPath(temporaryPath),
+    _receivedChunks(_numChunks, false),
+    _writtenChunks(_numChunks, false),
+    _lastActivity(usecTimestampNow())
+{
+
+}
+
+qint64 AssetUploadSession::getChunkOffset(uint32_t index) const {
+    return (qint64)index * AssetUtils::UPLOAD_CHUNK_SIZE;
+}
+
+qint64 AssetUploadSession::getChunkSize(uint32_t index) const {
+    return std::min((qint64)AssetUtils::UPLOAD_CHUNK_SIZE, (qint64)_totalSize - getChunkOffset(index));
+}
+
+AssetUploadSession::ReceiveResult AssetUploadSession::receiveChunk(uint32_t index, const QByteArray& data) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _lastActivity = usecTimestampNow();
+
+    if (_receivedChunks[index]) {
+        return AlreadyReceived;
+    }
+    if (index >= _numHashed + MAX_CHUNKS_AHEAD) {
+        return TooFarAhead;
+    }
+
+    _receivedChunks[index] = true;
+    _bufferedChunks[index] = data;
+    hashBufferedChunks();
+    return Accepted;
+}
+
+void AssetUploadSession::hashBufferedChunks() {
+    auto it = _bufferedChunks.begin();
+    while (it != _bufferedChunks.end() && it->first == _numHashed) {
+        _hasher.addData(it->second);
+        ++_numHashed;
+        it = _bufferedChunks.erase(it);
+    }
+
+    if (_numHashed == _numChunks && _hash.isEmpty()) {
+        _hash = _hasher.result();
+    }
+}
+
+bool AssetUploadSession::chunkWritten(uint32_t index) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _lastActivity = usecTimestampNow();
+
+    if (_writtenChunks[index]) {
+        return false;
+    }
+    _writtenChunks[index] = true;
+    ++_numWritten;
+
+    // every chunk was received by now, so they are all hashed as well
+    return _numWritten == _numChunks;
+}
+
+QByteArray AssetUploadSession::getWrittenChunks() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    QByteArray bits((_numChunks + 7) / 8, 0);
+    for (uint32_t i = 0; i < _numChunks; ++i) {
+        if (_writtenChunks[i]) {
+            bits[i / 8] = bits[i / 8] | (1 << (i % 8));
+        }
+    }
+    return bits;
+}
+
+QByteArray AssetUploadSession::getHash() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _hash;
+}
+
+qint64 AssetUploadSession::getBufferedBytes() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    qint64 bytes = 0;
+    for (const auto& chunk : _bufferedChunks) {
+        bytes += chunk.second.size();
+    }
+    return bytes;
+}
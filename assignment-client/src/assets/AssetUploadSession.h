@@ -0,0 +1,94 @@
+//
+//  AssetUploadSession.h
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetUploadSession_h
+#define hifi_AssetUploadSession_h
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QString>
+#include <QtCore/QUuid>
+
+/// A chunked upload in progress. Chunks are hashed in order as they arrive, so the hash is known as soon
+/// as the last one is written, and are written to a temporary file at their offset as they arrive.
+class AssetUploadSession {
+public:
+    // how far past the first missing chunk a chunk may arrive, clients keep far fewer chunks in flight
+    static const uint32_t MAX_CHUNKS_AHEAD = 32;
+
+    AssetUploadSession(const QUuid& uploadID, uint64_t totalSize, const QString& temporaryPath,
+                       const QUuid& nodeID = QUuid());
+
+    const QUuid& getUploadID() const { return _uploadID; }
+    const QUuid& getNodeID() const { return _nodeID; }
+    uint64_t getTotalSize() const { return _totalSize; }
+    uint32_t getNumChunks() const { return _numChunks; }
+    const QString& getTemporaryPath() const { return _temporaryPath; }
+
+    qint64 getChunkOffset(uint32_t index) const;
+    qint64 getChunkSize(uint32_t index) const;
+
+    enum ReceiveResult {
+        Accepted,
+        AlreadyReceived,
+        TooFarAhead
+    };
+
+    // accepts a chunk for writing. Chunks that arrive ahead of the ones still missing are held until they can be
+    // hashed, up to a limit so a client can't make the server buffer the whole upload.
+    ReceiveResult receiveChunk(uint32_t index, const QByteArray& data);
+
+    // returns true for the write that completes the upload, after which getHash is valid
+    bool chunkWritten(uint32_t index);
+
+    // a bit for each chunk that was written, in the order of the chunks
+    QByteArray getWrittenChunks() const;
+
+    QByteArray getHash() const;
+    void setCommitted() { std::lock_guard<std::mutex> lock(_mutex); _isCommitted = true; }
+    bool isCommitted() const { std::lock_guard<std::mutex> lock(_mutex); return _isCommitted; }
+
+    // set once the session is dropped, after which its temporary file may be gone and must not be written
+    void setRemoved() { std::lock_guard<std::mutex> lock(_mutex); _isRemoved = true; }
+    bool isRemoved() const { std::lock_guard<std::mutex> lock(_mutex); return _isRemoved; }
+
+    quint64 getLastActivity() const { std::lock_guard<std::mutex> lock(_mutex); return _lastActivity; }
+    qint64 getBufferedBytes() const;
+
+private:
+    void hashBufferedChunks();
+
+    const QUuid _uploadID;
+    const QUuid _nodeID;
+    const uint64_t _totalSize;
+    const uint32_t _numChunks;
+    const QString _temporaryPath;
+
+    mutable std::mutex _mutex;
+    QCryptographicHash _hasher { QCryptographicHash::Sha256 };
+    QByteArray _hash;
+    uint32_t _numHashed { 0 };
+    std::map<uint32_t, QByteArray> _bufferedChunks;
+    std::vector<bool> _receivedChunks;
+    std::vector<bool> _writtenChunks;
+    uint32_t _numWritten { 0 };
+    bool _isCommitted { false };
+    bool _isRemoved { false };
+    quint64 _lastActivity { 0 };
+};
+
+using AssetUploadSessionPointer = std::shared_ptr<AssetUploadSession>;
+
+#endif // hifi_AssetUploadSession_h
@@ -0,0 +1,143 @@
+//
+//  AssetUploadSessions.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetUploadSessions.h"
+
+#include <algorithm>
+
+#include <QtCore/QFile>
+
+#include <AssetUtils.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include "AssetFileIO.h"
+#include "AssetServerLogging.h"
+
+// sessions idle for longer than this are given up on
+static const quint64 SESSION_EXPIRY_USECS = 60 * 60 * USECS_PER_SECOND;
+static const quint64 COMMITTED_SESSION_EXPIRY_USECS = 10 * 60 * USECS_PER_SECOND;
+
+// limits on the uploads in progress, each of which reserves its whole size on disk for as long as it lasts
+static const int MAX_SESSIONS = 64;
+static const int MAX_SESSIONS_PER_NODE = 4;
+static const uint64_t MAX_RESERVED_BYTES = 8ULL * 1024 * 1024 * 1024;
+static const uint64_t MAX_RESERVED_BYTES_PER_NODE = 2ULL * 1024 * 1024 * 1024;
+
+AssetUploadSessionPointer AssetUploadSessions::find(const QUuid& uploadID, uint64_t totalSize) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _sessions.find(uploadID);
+    if (it != _sessions.end() && (*it)->getTotalSize() == totalSize) {
+        return *it;
+    }
+    return nullptr;
+}
+
+AssetUploadSessionPointer AssetUploadSessions::findOrCreate(const QUuid& uploadID, uint64_t totalSize, const QUuid& nodeID) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _sessions.find(uploadID);
+    if (it != _sessions.end()) {
+        return (*it)->getTotalSize() == totalSize ? *it : nullptr;
+    }
+
+    // committed uploads no longer hold a temporary file, so they don't count against the limits
+    int numSessions = 0;
+    int numNodeSessions = 0;
+    uint64_t reservedBytes = totalSize;
+    uint64_t nodeReservedBytes = totalSize;
+    for (const auto& session : _sessions) {
+        if (session->isCommitted()) {
+            continue;
+        }
+        ++numSessions;
+        reservedBytes += session->getTotalSize();
+        if (session->getNodeID() == nodeID) {
+            ++numNodeSessions;
+            nodeReservedBytes += session->getTotalSize();
+        }
+    }
+
+    if (numSessions >= MAX_SESSIONS || reservedBytes > MAX_RESERVED_BYTES) {
+        qCWarning(asset_server) << "Refusing chunked upload" << uploadID << "of" << totalSize << "bytes -"
+            << numSessions << "uploads are already in progress";
+        return nullptr;
+    }
+    if (numNodeSessions >= MAX_SESSIONS_PER_NODE || nodeReservedBytes > MAX_RESERVED_BYTES_PER_NODE) {
+        qCWarning(asset_server) << "Refusing chunked upload" << uploadID << "of" << totalSize << "bytes -"
+            << nodeID << "already has" << numNodeSessions << "uploads in progress";
+        return nullptr;
+    }
+
+    // the temporary suffix has leftovers of uploads that never finished removed at startup
+    auto temporaryPath = _directory.filePath(QString(uploadID.toRfc4122().toHex()) + AssetFileIO::TEMPORARY_SUFFIX);
+    QFile file { temporaryPath };
+    if (!file.open(QIODevice::WriteOnly) || !file.resize(totalSize)) {
+        qCWarning(asset_server) << "Failed to create" << temporaryPath << "for a chunked upload -" << file.errorString();
+        file.remove();
+        return nullptr;
+    }
+
+    auto session = std::make_shared<AssetUploadSession>(uploadID, totalSize, temporaryPath, nodeID);
+    _sessions.insert(uploadID, session);
+    qCDebug(asset_server) << "Started chunked upload" << uploadID << "of" << totalSize << "bytes";
+    return session;
+}
+
+void AssetUploadSessions::remove(const QUuid& uploadID) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto session = _sessions.take(uploadID);
+    if (session) {
+        session->setRemoved();
+        if (!session->isCommitted()) {
+            QFile::remove(session->getTemporaryPath());
+        }
+    }
+}
+
+void AssetUploadSessions::removeExpired() {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto now = usecTimestampNow();
+    auto it = _sessions.begin();
+    while (it != _sessions.end()) {
+        auto& session = *it;
+        bool isCommitted = session->isCommitted();
+        auto expiry = isCommitted ? COMMITTED_SESSION_EXPIRY_USECS : SESSION_EXPIRY_USECS;
+
+        // committed sessions only stay around to answer a client that missed the completing reply
+        if (now - session->getLastActivity() > expiry) {
+            session->setRemoved();
+            if (!isCommitted) {
+                qCDebug(asset_server) << "Giving up on chunked upload" << session->getUploadID();
+                QFile::remove(session->getTemporaryPath());
+            }
+            it = _sessions.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+int AssetUploadSessions::getCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _sessions.size();
+}
+
+qint64 AssetUploadSessions::getBufferedBytes() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    qint64 bytes = 0;
+    for (const auto& session : _sessions) {
+        bytes += session->getBufferedBytes();
+    }
+    return bytes;
+}
@@ -0,0 +1,57 @@
+//
+//  AssetUploadSessions.h
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetUploadSessions_h
+#define hifi_AssetUploadSessions_h
+
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QDir>
+#include <QtCore/QHash>
+#include <QtCore/QUuid>
+
+#include "AssetUploadSession.h"
+
+/// The chunked uploads the asset server is receiving. A session outlives a dropped connection so the
+/// upload can resume where it stopped, and is dropped, with its temporary file, once it's idle for long.
+/// The number of uploads in progress and the disk space their temporary files reserve are capped, both per
+/// node and in total.
+class AssetUploadSessions {
+public:
+    AssetUploadSessions(const QDir& directory) : _directory(directory) {}
+
+    // returns nullptr if there is no such upload or it has another size. Callers check the session's node, only the
+    // node that started an upload may add to it.
+    AssetUploadSessionPointer find(const QUuid& uploadID, uint64_t totalSize) const;
+
+    // returns nullptr if the upload exists with another size, would go over the limits on uploads in progress,
+    // or its temporary file can't be created
+    AssetUploadSessionPointer findOrCreate(const QUuid& uploadID, uint64_t totalSize, const QUuid& nodeID);
+
+    // drops the session, removing its temporary file unless the upload was committed. Writes to the file
+    // still queued fail rather than create it again.
+    void remove(const QUuid& uploadID);
+
+    void removeExpired();
+
+    int getCount() const;
+    qint64 getBufferedBytes() const;
+
+private:
+    QDir _directory;
+
+    mutable std::mutex _mutex;
+    QHash<QUuid, AssetUploadSessionPointer> _sessions;
+};
+
+using AssetUploadSessionsPointer = std::shared_ptr<AssetUploadSessions>;
+
+#endif // hifi_AssetUploadSessions_h
@@ -52,10 +52,16 @@ void BakeAssetTask::run() {
         return;
     }
 
-    // Copy file to bake the temporary dir and give a name the oven can work with
+    // Give the file to bake a name the oven can work with in the temporary dir. A symbolic link avoids
+    // copying the whole file where one can be made, the oven only reads its input.
     auto assetName = _assetPath.split("/").last();
     auto tempAssetPath = tempOutputDir + "/" + assetName;
+#ifdef Q_OS_WIN
+    // links on Windows are .lnk shortcuts, which the oven can't read
     auto success = QFile::copy(_filePath, tempAssetPath);
+#else
+    auto success = QFile::link(_filePath, tempAssetPath) || QFile::copy(_filePath, tempAssetPath);
+#endif
     if (!success) {
         QString errors = "Couldn't copy file to bake to temporary directory";
         emit bakeFailed(_assetHash, _assetPath, errors);
@@ -0,0 +1,87 @@
+//
+//  SendAssetChunkListTask.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SendAssetChunkListTask.h"
+
+#include <QtCore/QFile>
+
+#include <AssetChunking.h>
+#include <AssetUtils.h>
+#include <ClientServerUtils.h>
+#include <NLPacketList.h>
+#include <NodeList.h>
+
+#include "AssetServerLogging.h"
+
+SendAssetChunkListTask::SendAssetChunkListTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode,
+                                               const QDir& filesDir, const QDir& chunkListsDir,
+                                               const AssetFileIOPointer& fileIO) :
+    _message(message),
+    _senderNode(sendToNode),
+    _filesDir(filesDir),
+    _chunkListsDir(chunkListsDir),
+    _fileIO(fileIO)
+{
+
+}
+
+void SendAssetChunkListTask::run() {
+    MessageID messageID;
+    _message->readPrimitive(&messageID);
+    QString hexHash = _message->read(AssetUtils::SHA256_HASH_LENGTH).toHex();
+
+    auto replyPacketList = NLPacketList::create(PacketType::AssetGetChunkListReply, QByteArray(), true, true);
+    replyPacketList->writePrimitive(messageID);
+
+    QFile chunkListFile { _chunkListsDir.filePath(hexHash) };
+    QFile file { _filesDir.filePath(hexHash) };
+    bool needsChunkList = false;
+
+    if (chunkListFile.open(QIODevice::ReadOnly)) {
+        replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
+        replyPacketList->write(chunkListFile.readAll());
+    } else if (!file.open(QIODevice::ReadOnly)) {
+        replyPacketList->writePrimitive(AssetUtils::AssetServerError::AssetNotFound);
+    } else {
+        // small assets are downloaded whole, and so is a large one until its chunk list is ready: the client
+        // is answered right away with an empty list rather than waiting while the whole file is hashed
+        replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
+        replyPacketList->write(AssetUtils::serializeChunkList(AssetUtils::AssetChunkList()));
+        needsChunkList = file.size() >= AssetUtils::CHUNKED_DOWNLOAD_THRESHOLD;
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    if (_senderNode) {
+        nodeList->sendPacketList(std::move(replyPacketList), *_senderNode);
+    } else {
+        nodeList->sendPacketList(std::move(replyPacketList), _message->getSenderSockAddr());
+    }
+
+    if (needsChunkList) {
+        auto size = file.size();
+        uchar* mapped = file.map(0, size);
+        QByteArray content;
+        if (!mapped) {
+            content = file.readAll();
+        }
+        const char* data = mapped ? reinterpret_cast<const char*>(mapped) : content.constData();
+
+        if (mapped || content.size() == size) {
+            auto chunkList = AssetUtils::serializeChunkList(AssetUtils::chunkData(data, size));
+            _fileIO->writeFile(chunkListFile.fileName(), chunkList, [hexHash](bool success) {
+                if (!success) {
+                    qCWarning(asset_server) << "Failed to save the chunk list of" << hexHash;
+                }
+            });
+        } else {
+            qCWarning(asset_server) << "Failed to read" << hexHash << "to compute its chunk list";
+        }
+    }
+}
@@ -0,0 +1,40 @@
+//
+//  SendAssetChunkListTask.h
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SendAssetChunkListTask_h
+#define hifi_SendAssetChunkListTask_h
+
+#include <QtCore/QDir>
+#include <QtCore/QRunnable>
+#include <QtCore/QSharedPointer>
+
+#include "AssetFileIO.h"
+#include "Node.h"
+#include "ReceivedMessage.h"
+
+/// Replies with the content defined chunks of an asset, which a client uses to fetch only the chunks it doesn't
+/// already have in other assets. A chunk list is computed after the first request for it has been answered with
+/// an empty one, and then kept in the chunk lists directory, as assets never change.
+class SendAssetChunkListTask : public QRunnable {
+public:
+    SendAssetChunkListTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode,
+                           const QDir& filesDir, const QDir& chunkListsDir, const AssetFileIOPointer& fileIO);
+
+    void run() override;
+
+private:
+    QSharedPointer<ReceivedMessage> _message;
+    SharedNodePointer _senderNode;
+    QDir _filesDir;
+    QDir _chunkListsDir;
+    AssetFileIOPointer _fileIO;
+};
+
+#endif // hifi_SendAssetChunkListTask_h
@@ -12,6 +12,7 @@
 #include "SendAssetTask.h"
 
 #include <cmath>
+#include <memory>
 
 #include <QFile>
 
@@ -26,11 +27,43 @@
 #include "ByteRange.h"
 #include "ClientServerUtils.h"
 
-SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir) :
+udt::PacketList::DataStream SendAssetTask::makeFileStream(std::shared_ptr<QFile> file, qint64 start, qint64 size) {
+    // Asset files are never modified, only removed, which leaves a mapping readable, so the range is copied straight
+    // from the page cache into the packets. Should mapping fail we read the file as we go instead.
+    uchar* mapped = size > 0 ? file->map(start, size) : nullptr;
+    if (mapped) {
+        file->close(); // the mapping outlives the file handle, and is unmapped with the QFile
+        qint64 position = 0;
+        return [file, mapped, position](char* destination, qint64 maxSize) mutable -> qint64 {
+            memcpy(destination, mapped + position, maxSize);
+            position += maxSize;
+            return maxSize;
+        };
+    }
+
+    file->seek(start);
+    return [file](char* destination, qint64 maxSize) -> qint64 {
+        return file->read(destination, maxSize);
+    };
+}
+
+udt::PacketList::DataStream SendAssetTask::makeContentStream(QByteArray content, qint64 start) {
+    // the stream shares the cached content, which stays valid even if the cache evicts it meanwhile
+    qint64 position = start;
+    return [content, position](char* destination, qint64 maxSize) mutable -> qint64 {
+        memcpy(destination, content.constData() + position, maxSize);
+        position += maxSize;
+        return maxSize;
+    };
+}
+
+SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir,
+                             const AssetContentCachePointer& contentCache) :
     QRunnable(),
     _message(message),
     _senderNode(sendToNode),
-    _resourcesDir(resourcesDir)
+    _resourcesDir(resourcesDir),
+    _contentCache(contentCache)
 {
     
 }
@@ -64,17 +97,40 @@ void SendAssetTask::run() {
         replyPacketList->writePrimitive(AssetUtils::AssetServerError::InvalidByteRange);
     } else {
         QString filePath = _resourcesDir.filePath(QString(hexHash));
-        
-        QFile file { filePath };
 
-        if (file.open(QIODevice::ReadOnly)) {
+        // popular assets are served from memory, anything else is read from its file as the reply goes out
+        QByteArray content = _contentCache->findContent(hexHash);
+        std::shared_ptr<QFile> file;
+        bool found = !content.isEmpty();
+
+        if (!found) {
+            file = std::make_shared<QFile>(filePath);
+            found = file->open(QIODevice::ReadOnly);
+
+            if (found && _contentCache->shouldAdmit(hexHash, file->size())) {
+                // the requests for this asset that arrive while it is read share that read
+                content = _contentCache->loadContent(hexHash, [file] {
+                    auto content = file->readAll();
+                    return content.size() == file->size() ? content : QByteArray();
+                });
+
+                if (!content.isEmpty()) {
+                    file.reset();
+                } else {
+                    file->seek(0);
+                }
+            }
+        }
+
+        if (found) {
+            qint64 fileSize = file ? file->size() : content.size();
 
             // first fixup the range based on the now known file size
-            byteRange.fixupRange(file.size());
+            byteRange.fixupRange(fileSize);
 
             // check if we're being asked to read data that we just don't have
             // because of the file size
-            if (file.size() < byteRange.fromInclusive || file.size() < byteRange.toExclusive) {
+            if (fileSize < byteRange.fromInclusive || fileSize < byteRange.toExclusive) {
                 replyPacketList->writePrimitive(AssetUtils::AssetServerError::InvalidByteRange);
                 qCDebug(networking) << "Bad byte range: " << hexHash << " "
                     << byteRange.fromInclusive << ":" << byteRange.toExclusive;
@@ -82,29 +138,15 @@ void SendAssetTask::run() {
                 // we have a valid byte range, handle it and send the asset
                 auto size = byteRange.size();
 
-                if (byteRange.fromInclusive >= 0) {
+                // a negative range is read back from the end of the file
+                qint64 start = byteRange.fromInclusive >= 0 ? byteRange.fromInclusive : fileSize + byteRange.fromInclusive;
 
-                    // this range is positive, meaning we just need to seek into the file and then read from there
-                    file.seek(byteRange.fromInclusive);
-                    replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
-                    replyPacketList->writePrimitive(size);
-                    replyPacketList->write(file.read(size));
-                } else {
-                    // this range is negative, at least the first part of the read will be back into the end of the file
-
-                    // seek to the part of the file where the negative range begins
-                    file.seek(file.size() + byteRange.fromInclusive);
-
-                    replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
-                    replyPacketList->writePrimitive(size);
-
-                    // first write everything from the negative range to the end of the file
-                    replyPacketList->write(file.read(size));
-                }
+                replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
+                replyPacketList->writePrimitive(size);
+                replyPacketList->writeStream(size, file ? makeFileStream(file, start, size) : makeContentStream(content, start));
 
                 qCDebug(networking) << "Sending asset: " << hexHash;
             }
-            file.close();
         } else {
             qCDebug(networking) << "Asset not found: " << filePath << "(" << hexHash << ")";
             replyPacketList->writePrimitive(AssetUtils::AssetServerError::AssetNotFound);
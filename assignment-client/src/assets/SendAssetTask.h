@@ -17,22 +17,31 @@
 #include <QtCore/QString>
 #include <QtCore/QRunnable>
 
+#include <udt/PacketList.h>
+
+#include "AssetContentCache.h"
 #include "AssetUtils.h"
 #include "AssetServer.h"
 #include "Node.h"
 
 class NLPacket;
+class QFile;
 
 class SendAssetTask : public QRunnable {
 public:
-    SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir);
+    SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir,
+                  const AssetContentCachePointer& contentCache);
 
     void run() override;
 
 private:
+    static udt::PacketList::DataStream makeFileStream(std::shared_ptr<QFile> file, qint64 start, qint64 size);
+    static udt::PacketList::DataStream makeContentStream(QByteArray content, qint64 start);
+
     QSharedPointer<ReceivedMessage> _message;
     SharedNodePointer _senderNode;
     QDir _resourcesDir;
+    AssetContentCachePointer _contentCache;
 };
 
 #endif
@@ -0,0 +1,159 @@
+//
+//  UploadAssetChunkTask.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "UploadAssetChunkTask.h"
+
+#include <QtCore/QUuid>
+
+#include <NodeList.h>
+#include <NLPacketList.h>
+#include <UUID.h>
+
+#include "AssetServerLogging.h"
+
+UploadAssetChunkTask::UploadAssetChunkTask(QSharedPointer<ReceivedMessage> message, QSharedPointer<Node> senderNode,
+                                           const QDir& resourcesDir, uint64_t filesizeLimit, const AssetFileIOPointer& fileIO,
+                                           const AssetUploadSessionsPointer& sessions) :
+    _receivedMessage(message),
+    _senderNode(senderNode),
+    _resourcesDir(resourcesDir),
+    _filesizeLimit(filesizeLimit),
+    _fileIO(fileIO),
+    _sessions(sessions)
+{
+
+}
+
+void UploadAssetChunkTask::run() {
+    MessageID messageID;
+    _receivedMessage->readPrimitive(&messageID);
+
+    auto uploadID = QUuid::fromRfc4122(_receivedMessage->read(NUM_BYTES_RFC4122_UUID));
+
+    uint64_t totalSize;
+    _receivedMessage->readPrimitive(&totalSize);
+
+    uint32_t chunkIndex;
+    _receivedMessage->readPrimitive(&chunkIndex);
+
+    if (totalSize == 0 || totalSize > _filesizeLimit) {
+        sendReply(_receivedMessage, _senderNode, messageID, AssetUtils::AssetServerError::AssetTooLarge);
+        return;
+    }
+
+    auto nodeID = _senderNode ? _senderNode->getUUID() : QUuid();
+
+    if (chunkIndex == AssetUtils::UPLOAD_CHUNK_STATUS_QUERY) {
+        // a status query never starts an upload, one we don't know of simply has no chunks written yet
+        auto session = _sessions->find(uploadID, totalSize);
+        if (session && session->getNodeID() != nodeID) {
+            sendReply(_receivedMessage, _senderNode, messageID, AssetUtils::AssetServerError::PermissionDenied);
+            return;
+        }
+        sendReply(_receivedMessage, _senderNode, messageID, AssetUtils::AssetServerError::NoError, session);
+        return;
+    }
+
+    auto session = _sessions->findOrCreate(uploadID, totalSize, nodeID);
+    if (!session) {
+        sendReply(_receivedMessage, _senderNode, messageID, AssetUtils::AssetServerError::FileOperationFailed);
+        return;
+    }
+    if (session->getNodeID() != nodeID) {
+        qCWarning(asset_server) << "Refusing a chunk of upload" << uploadID << "from" << nodeID << "which didn't start it";
+        sendReply(_receivedMessage, _senderNode, messageID, AssetUtils::AssetServerError::PermissionDenied);
+        return;
+    }
+
+    auto chunk = _receivedMessage->readAll();
+    if (chunkIndex >= session->getNumChunks() || chunk.size() != session->getChunkSize(chunkIndex)) {
+        sendReply(_receivedMessage, _senderNode, messageID, AssetUtils::AssetServerError::InvalidByteRange);
+        return;
+    }
+
+    auto result = session->receiveChunk(chunkIndex, chunk);
+    if (result == AssetUploadSession::TooFarAhead) {
+        sendReply(_receivedMessage, _senderNode, messageID, AssetUtils::AssetServerError::ChunkTooFarAhead);
+        return;
+    } else if (result == AssetUploadSession::AlreadyReceived) {
+        // the reply to the first copy may have been lost, the client learns where the upload stands from this one
+        sendReply(_receivedMessage, _senderNode, messageID, AssetUtils::AssetServerError::NoError, session);
+        return;
+    }
+
+    // the chunk goes to the temporary file at its offset, and the write of the last one commits the upload.
+    // A session that failed or expired in the meantime has had its file removed, so its writes are dropped.
+    auto isLive = [session] { return !session->isRemoved(); };
+    auto message = _receivedMessage;
+    auto senderNode = _senderNode;
+    auto sessions = _sessions;
+    auto fileIO = _fileIO;
+    auto resourcesDir = _resourcesDir;
+    _fileIO->writeFileAt(session->getTemporaryPath(), session->getChunkOffset(chunkIndex), chunk,
+                         [=](bool success) {
+        if (!success) {
+            // the upload may have been given up on already, and then restarted under the same ID
+            if (!session->isRemoved()) {
+                qCWarning(asset_server) << "Failed to write chunk" << chunkIndex << "of upload" << uploadID << "- upload failed.";
+                sessions->remove(uploadID);
+            }
+            sendReply(message, senderNode, messageID, AssetUtils::AssetServerError::FileOperationFailed);
+            return;
+        }
+
+        if (!session->chunkWritten(chunkIndex)) {
+            sendReply(message, senderNode, messageID, AssetUtils::AssetServerError::NoError, session);
+            return;
+        }
+
+        auto hash = session->getHash();
+        auto filePath = resourcesDir.filePath(QString(hash.toHex()));
+        fileIO->commitFile(session->getTemporaryPath(), filePath, [=](bool success) {
+            if (success) {
+                qCDebug(asset_server) << "Wrote file" << hash.toHex() << "from chunked upload" << uploadID << "to disk. Upload complete";
+                session->setCommitted();
+                sendReply(message, senderNode, messageID, AssetUtils::AssetServerError::NoError, session);
+            } else {
+                if (!session->isRemoved()) {
+                    qCWarning(asset_server) << "Failed to commit chunked upload" << uploadID << "- upload failed.";
+                    sessions->remove(uploadID);
+                }
+                sendReply(message, senderNode, messageID, AssetUtils::AssetServerError::FileOperationFailed);
+            }
+        }, isLive);
+    }, isLive);
+}
+
+void UploadAssetChunkTask::sendReply(QSharedPointer<ReceivedMessage> message, QSharedPointer<Node> senderNode,
+                                     MessageID messageID, AssetUtils::AssetServerError error,
+                                     const AssetUploadSessionPointer& session) {
+    auto replyPacketList = NLPacketList::create(PacketType::AssetUploadChunkReply, QByteArray(), true, true);
+    replyPacketList->writePrimitive(messageID);
+    replyPacketList->writePrimitive(error);
+
+    if (error == AssetUtils::AssetServerError::NoError) {
+        quint8 isComplete = session && session->isCommitted();
+        replyPacketList->writePrimitive(isComplete);
+        if (isComplete) {
+            replyPacketList->write(session->getHash());
+        } else {
+            auto writtenChunks = session ? session->getWrittenChunks() : QByteArray();
+            replyPacketList->writePrimitive((uint32_t)writtenChunks.size());
+            replyPacketList->write(writtenChunks);
+        }
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    if (senderNode) {
+        nodeList->sendPacketList(std::move(replyPacketList), *senderNode);
+    } else {
+        nodeList->sendPacketList(std::move(replyPacketList), message->getSenderSockAddr());
+    }
+}
@@ -0,0 +1,46 @@
+//
+//  UploadAssetChunkTask.h
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_UploadAssetChunkTask_h
+#define hifi_UploadAssetChunkTask_h
+
+#include <QtCore/QDir>
+#include <QtCore/QRunnable>
+#include <QtCore/QSharedPointer>
+
+#include <AssetUtils.h>
+#include <ClientServerUtils.h>
+
+#include "AssetFileIO.h"
+#include "AssetUploadSessions.h"
+#include "ReceivedMessage.h"
+
+class Node;
+
+class UploadAssetChunkTask : public QRunnable {
+public:
+    UploadAssetChunkTask(QSharedPointer<ReceivedMessage> message, QSharedPointer<Node> senderNode, const QDir& resourcesDir,
+                         uint64_t filesizeLimit, const AssetFileIOPointer& fileIO, const AssetUploadSessionsPointer& sessions);
+
+    void run() override;
+
+    static void sendReply(QSharedPointer<ReceivedMessage> message, QSharedPointer<Node> senderNode, MessageID messageID,
+                          AssetUtils::AssetServerError error, const AssetUploadSessionPointer& session = nullptr);
+
+private:
+    QSharedPointer<ReceivedMessage> _receivedMessage;
+    QSharedPointer<Node> _senderNode;
+    QDir _resourcesDir;
+    uint64_t _filesizeLimit;
+    AssetFileIOPointer _fileIO;
+    AssetUploadSessionsPointer _sessions;
+};
+
+#endif // hifi_UploadAssetChunkTask_h
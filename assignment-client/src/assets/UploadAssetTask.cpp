@@ -13,6 +13,7 @@
 
 #include <QtCore/QBuffer>
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
 
 #include <AssetUtils.h>
 #include <NodeList.h>
@@ -21,11 +22,12 @@
 #include "ClientServerUtils.h"
 
 UploadAssetTask::UploadAssetTask(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode,
-                                 const QDir& resourcesDir, uint64_t filesizeLimit) :
+                                 const QDir& resourcesDir, uint64_t filesizeLimit, const AssetFileIOPointer& fileIO) :
     _receivedMessage(receivedMessage),
     _senderNode(senderNode),
     _resourcesDir(resourcesDir),
-    _filesizeLimit(filesizeLimit)
+    _filesizeLimit(filesizeLimit),
+    _fileIO(fileIO)
 {
     
 }
@@ -47,71 +49,75 @@ void UploadAssetTask::run() {
     } else {
         qDebug() << "UploadAssetTask reading a file of " << fileSize << "bytes from" << _receivedMessage->getSenderSockAddr();
     }
-    
-    auto replyPacket = NLPacket::create(PacketType::AssetUploadReply, -1, true);
-    replyPacket->writePrimitive(messageID);
+
+    Upload upload;
+    upload.receivedMessage = _receivedMessage;
+    upload.senderNode = _senderNode;
+    upload.messageID = messageID;
     
     if (fileSize > _filesizeLimit) {
-        replyPacket->writePrimitive(AssetUtils::AssetServerError::AssetTooLarge);
-    } else {
-        QByteArray fileData = buffer.read(fileSize);
-        
-        auto hash = AssetUtils::hashData(fileData);
-        auto hexHash = hash.toHex();
+        sendReply(upload, AssetUtils::AssetServerError::AssetTooLarge);
+        return;
+    }
 
-        if (_senderNode) {
-            qDebug() << "Hash for uploaded file from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID()) << "is: (" << hexHash << ")";
-        } else {
-            qDebug() << "Hash for uploaded file from" << _receivedMessage->getSenderSockAddr() << "is: (" << hexHash << ")";
-        }
-        
-        QFile file { _resourcesDir.filePath(QString(hexHash)) };
+    QByteArray fileData = buffer.read(fileSize);
 
-        bool existingCorrectFile = false;
-        
-        if (file.exists()) {
-            // check if the local file has the correct contents, otherwise we overwrite
-            if (file.open(QIODevice::ReadOnly) && AssetUtils::hashData(file.readAll()) == hash) {
-                qDebug() << "Not overwriting existing verified file: " << hexHash;
+    upload.hash = AssetUtils::hashData(fileData);
+    auto hexHash = upload.hash.toHex();
+    upload.filePath = _resourcesDir.filePath(QString(hexHash));
 
-                existingCorrectFile = true;
+    if (_senderNode) {
+        qDebug() << "Hash for uploaded file from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID()) << "is: (" << hexHash << ")";
+    } else {
+        qDebug() << "Hash for uploaded file from" << _receivedMessage->getSenderSockAddr() << "is: (" << hexHash << ")";
+    }
 
-                replyPacket->writePrimitive(AssetUtils::AssetServerError::NoError);
-                replyPacket->write(hash);
+    // the disk work is handed to the file I/O threads, this thread is free again once the upload is hashed
+    QFileInfo fileInfo { upload.filePath };
+    if (fileInfo.exists() && fileInfo.size() == fileData.size()) {
+        // check if the local file has the correct contents, otherwise we overwrite
+        auto fileIO = _fileIO;
+        _fileIO->readFile(upload.filePath, [fileIO, upload, fileData](bool success, QByteArray existingData) {
+            if (success && AssetUtils::hashData(existingData) == upload.hash) {
+                qDebug() << "Not overwriting existing verified file: " << upload.hash.toHex();
+                sendReply(upload, AssetUtils::AssetServerError::NoError);
             } else {
-                qDebug() << "Overwriting an existing file whose contents did not match the expected hash: " << hexHash;
-                file.close();
+                qDebug() << "Overwriting an existing file whose contents did not match the expected hash: " << upload.hash.toHex();
+                writeUpload(fileIO, upload, fileData);
             }
+        });
+    } else {
+        if (fileInfo.exists()) {
+            qDebug() << "Overwriting an existing file whose size did not match the upload: " << hexHash;
         }
+        writeUpload(_fileIO, upload, fileData);
+    }
+}
 
-        if (!existingCorrectFile) {
-            if (file.open(QIODevice::WriteOnly) && file.write(fileData) == qint64(fileSize)) {
-                qDebug() << "Wrote file" << hexHash << "to disk. Upload complete";
-                file.close();
-
-                replyPacket->writePrimitive(AssetUtils::AssetServerError::NoError);
-                replyPacket->write(hash);
-            } else {
-                qWarning() << "Failed to upload or write to file" << hexHash << " - upload failed.";
-
-                // upload has failed - remove the file and return an error
-                auto removed = file.remove();
-
-                if (!removed) {
-                    qWarning() << "Removal of failed upload file" << hexHash << "failed.";
-                }
-                
-                replyPacket->writePrimitive(AssetUtils::AssetServerError::FileOperationFailed);
-            }
+void UploadAssetTask::writeUpload(const AssetFileIOPointer& fileIO, const Upload& upload, QByteArray fileData) {
+    fileIO->writeFile(upload.filePath, fileData, [upload](bool success) {
+        if (success) {
+            qDebug() << "Wrote file" << upload.hash.toHex() << "to disk. Upload complete";
+            sendReply(upload, AssetUtils::AssetServerError::NoError);
+        } else {
+            qWarning() << "Failed to upload or write to file" << upload.hash.toHex() << " - upload failed.";
+            sendReply(upload, AssetUtils::AssetServerError::FileOperationFailed);
         }
+    });
+}
 
-
+void UploadAssetTask::sendReply(const Upload& upload, AssetUtils::AssetServerError error) {
+    auto replyPacket = NLPacket::create(PacketType::AssetUploadReply, -1, true);
+    replyPacket->writePrimitive(upload.messageID);
+    replyPacket->writePrimitive(error);
+    if (error == AssetUtils::AssetServerError::NoError) {
+        replyPacket->write(upload.hash);
     }
-    
+
     auto nodeList = DependencyManager::get<NodeList>();
-    if (_senderNode) {
-        nodeList->sendPacket(std::move(replyPacket), *_senderNode);
+    if (upload.senderNode) {
+        nodeList->sendPacket(std::move(replyPacket), *upload.senderNode);
     } else {
-        nodeList->sendPacket(std::move(replyPacket), _receivedMessage->getSenderSockAddr());
+        nodeList->sendPacket(std::move(replyPacket), upload.receivedMessage->getSenderSockAddr());
     }
 }
@@ -19,6 +19,10 @@
 #include <QtCore/QRunnable>
 #include <QtCore/QSharedPointer>
 
+#include <AssetUtils.h>
+#include <ClientServerUtils.h>
+
+#include "AssetFileIO.h"
 #include "ReceivedMessage.h"
 
 class NLPacketList;
@@ -27,15 +31,27 @@ class Node;
 class UploadAssetTask : public QRunnable {
 public:
     UploadAssetTask(QSharedPointer<ReceivedMessage> message, QSharedPointer<Node> senderNode, 
-                    const QDir& resourcesDir, uint64_t filesizeLimit);
+                    const QDir& resourcesDir, uint64_t filesizeLimit, const AssetFileIOPointer& fileIO);
 
     void run() override;
 
 private:
+    struct Upload {
+        QSharedPointer<ReceivedMessage> receivedMessage;
+        QSharedPointer<Node> senderNode;
+        MessageID messageID;
+        QByteArray hash;
+        QString filePath;
+    };
+
+    static void writeUpload(const AssetFileIOPointer& fileIO, const Upload& upload, QByteArray fileData);
+    static void sendReply(const Upload& upload, AssetUtils::AssetServerError error);
+
     QSharedPointer<ReceivedMessage> _receivedMessage;
     QSharedPointer<Node> _senderNode;
     QDir _resourcesDir;
     uint64_t _filesizeLimit;
+    AssetFileIOPointer _fileIO;
 };
 
 #endif // hifi_UploadAssetTask_h
@@ -162,7 +162,7 @@ void AvatarMixer::handleReplicatedBulkAvatarPacket(QSharedPointer<ReceivedMessag
 
         // queue up the replicated avatar data with the client data for the replicated node
         auto start = usecTimestampNow();
-        getOrCreateClientData(replicatedNode)->queuePacket(replicatedMessage, replicatedNode);
+        getOrCreateClientData(replicatedNode)->queuePacket(std::move(replicatedMessage));
         auto end = usecTimestampNow();
         _queueIncomingPacketElapsedTime += (end - start);
     }
@@ -205,7 +205,7 @@ void AvatarMixer::optionallyReplicatePacket(ReceivedMessage& message, const Node
 
 void AvatarMixer::queueIncomingPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node) {
     auto start = usecTimestampNow();
-    getOrCreateClientData(node)->queuePacket(message, node);
+    getOrCreateClientData(node)->queuePacket(std::move(message));
     auto end = usecTimestampNow();
     _queueIncomingPacketElapsedTime += (end - start);
 }
@@ -1027,6 +1027,18 @@ void AvatarMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
         }
     }
 
+    {   // Rate of the avatar updates replicated to downstream avatar mixers:
+        static const QString REPLICATED_AVATAR_RATE_KEY = "replicated_avatar_rate";
+        float replicatedAvatarRate = avatarMixerGroupObject[REPLICATED_AVATAR_RATE_KEY].toVariant().toFloat();
+        if (replicatedAvatarRate > 0.0f) {
+            _slaveSharedData.replicatedAvatarIntervalUsecs = (quint64)(USECS_PER_SECOND / replicatedAvatarRate);
+            qCDebug(avatars) << "Avatar mixer replicating each avatar at most" << replicatedAvatarRate
+                << "times per second to downstream mixers";
+        } else {
+            _slaveSharedData.replicatedAvatarIntervalUsecs = 0;
+        }
+    }
+
     const QString AVATARS_SETTINGS_KEY = "avatars";
 
     static const QString MIN_HEIGHT_OPTION = "min_avatar_height";
@@ -1057,6 +1069,7 @@ void AvatarMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
         // KeepEmptyParts above will parse "," as ["", ""] (which is ok), but "" as [""] (which is not ok).
         _slaveSharedData.skeletonURLWhitelist.clear();
     }
+    _slaveSharedData.clearSkeletonURLWhitelistCache();
 
     if (_slaveSharedData.skeletonURLWhitelist.isEmpty()) {
         qCDebug(avatars) << "All avatars are allowed.";
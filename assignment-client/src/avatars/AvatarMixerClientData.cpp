@@ -46,22 +46,15 @@ void AvatarMixerClientData::setLastOtherAvatarEncodeTime(NLPacket::LocalID other
     }
 }
 
-void AvatarMixerClientData::queuePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node) {
-    if (!_packetQueue.node) {
-        _packetQueue.node = node;
-    }
-    _packetQueue.push(message);
+void AvatarMixerClientData::queuePacket(QSharedPointer<ReceivedMessage> message) {
+    _packetQueue.push(std::move(message));
 }
 
-int AvatarMixerClientData::processPackets(const SlaveSharedData& slaveSharedData) {
+int AvatarMixerClientData::processPackets(const SlaveSharedData& slaveSharedData, Node& node) {
     int packetsProcessed = 0;
-    SharedNodePointer node = _packetQueue.node;
-    assert(_packetQueue.empty() || node);
-    _packetQueue.node.clear();
-
-    while (!_packetQueue.empty()) {
-        auto& packet = _packetQueue.front();
 
+    QSharedPointer<ReceivedMessage> packet;
+    while (_packetQueue.try_pop(packet)) {
         packetsProcessed++;
 
         switch (packet->getType()) {
@@ -69,7 +62,7 @@ int AvatarMixerClientData::processPackets(const SlaveSharedData& slaveSharedData
                 parseData(*packet, slaveSharedData);
                 break;
             case PacketType::SetAvatarTraits:
-                processSetTraitsMessage(*packet, slaveSharedData, *node);
+                processSetTraitsMessage(*packet, slaveSharedData, node);
                 break;
             case PacketType::BulkAvatarTraitsAck:
                 processBulkAvatarTraitsAckMessage(*packet);
@@ -77,9 +70,7 @@ int AvatarMixerClientData::processPackets(const SlaveSharedData& slaveSharedData
             default:
                 Q_UNREACHABLE();
         }
-        _packetQueue.pop();
     }
-    assert(_packetQueue.empty());
 
     if (_avatar) {
         _avatar->processCertifyEvents();
@@ -132,7 +123,14 @@ int AvatarMixerClientData::parseData(ReceivedMessage& message, const SlaveShared
     if (sequenceNumber < _lastReceivedSequenceNumber && _lastReceivedSequenceNumber != UINT16_MAX) {
         incrementNumOutOfOrderSends();
     }
-    _lastReceivedSequenceNumber = sequenceNumber;
+
+    // only move forward, so a late packet doesn't make the ones after it look out of order,
+    // the sequence numbers wrap around
+    uint16_t sequenceStep = sequenceNumber - _lastReceivedSequenceNumber;
+    if (!_hasReceivedSequenceNumber || (sequenceStep != 0 && sequenceStep < UINT16_MAX / 2)) {
+        _hasReceivedSequenceNumber = true;
+        _lastReceivedSequenceNumber = sequenceNumber;
+    }
     glm::vec3 oldPosition = _avatar->getClientGlobalPosition();
     bool oldHasPriority = _avatar->getHasPriority();
 
@@ -329,22 +327,7 @@ void AvatarMixerClientData::checkSkeletonURLAgainstWhitelist(const SlaveSharedDa
     const auto& whitelist = slaveSharedData.skeletonURLWhitelist;
 
     if (!whitelist.isEmpty()) {
-        bool inWhitelist = false;
-        auto avatarURL = _avatar->getSkeletonModelURL();
-
-        // The avatar is in the whitelist if:
-        // 1. The avatar's URL's host matches one of the hosts of the URLs in the whitelist AND
-        // 2. The avatar's URL's path starts with the path of that same URL in the whitelist
-        for (const auto& whiteListedPrefix : whitelist) {
-            auto whiteListURL = QUrl::fromUserInput(whiteListedPrefix);
-            // check if this script URL matches the whitelist domain and, optionally, is beneath the path
-            if (avatarURL.host().compare(whiteListURL.host(), Qt::CaseInsensitive) == 0 &&
-                avatarURL.path().startsWith(whiteListURL.path(), Qt::CaseInsensitive)) {
-                inWhitelist = true;
-
-                break;
-            }
-        }
+        bool inWhitelist = slaveSharedData.isSkeletonURLWhitelisted(_avatar->getSkeletonModelURL());
 
         if (!inWhitelist) {
             // make sure we're not unecessarily overriding the default avatar with the default avatar
@@ -376,6 +359,14 @@ uint64_t AvatarMixerClientData::getLastBroadcastTime(NLPacket::LocalID nodeUUID)
     return 0;
 }
 
+uint64_t AvatarMixerClientData::getLastReplicatedTime(NLPacket::LocalID nodeID) const {
+    auto nodeMatch = _lastReplicatedTimes.find(nodeID);
+    if (nodeMatch != _lastReplicatedTimes.end()) {
+        return nodeMatch->second;
+    }
+    return 0;
+}
+
 uint16_t AvatarMixerClientData::getLastBroadcastSequenceNumber(NLPacket::LocalID nodeID) const {
     // return the matching PacketSequenceNumber, or the default if we don't have it
     auto nodeMatch = _lastBroadcastSequenceNumbers.find(nodeID);
@@ -457,6 +448,58 @@ bool AvatarMixerClientData::otherAvatarInView(const AABox& otherAvatarBox) {
     });
 }
 
+void AvatarMixerClientData::updateBandwidthBudget(const Node::Stats& connectionStats, float maxKbps) {
+    // fraction of the reliable packets sent to this node that had to be resent before we consider the link congested
+    const float LOSS_THRESHOLD = 0.02f;
+    // reliable traits and identity packets are rare, so samples are pooled until there are enough to judge the loss
+    const uint32_t MIN_PACKETS_FOR_LOSS = 20;
+    // without enough reliable packets to judge, the link is assumed fine after this many samples
+    const int MAX_SAMPLES_FOR_LOSS = 10;
+    // the budget only grows while this node is actually sent most of it, otherwise it isn't what limits the node
+    const float MIN_USED_BUDGET_FRACTION = 0.75f;
+    const float BUDGET_DECREASE_FACTOR = 0.75f;
+    const float BUDGET_INCREASE_FRACTION = 0.05f;
+    const float MIN_BUDGET_FRACTION = 0.1f;
+
+    if (_bandwidthBudgetKbps <= 0.0f) {
+        // start new listeners at the full budget
+        _bandwidthBudgetKbps = maxKbps;
+    }
+
+    // the stats are sampled about once a second, only adjust once per sample
+    if (connectionStats.endTime != _lastConnectionStatsSample && connectionStats.endTime > connectionStats.startTime) {
+        _lastConnectionStatsSample = connectionStats.endTime;
+
+        _numReliablePacketsSent += connectionStats.sentPackets;
+        _numReliablePacketsResent += connectionStats.retransmittedPackets;
+        ++_numConnectionStatsSamples;
+
+        float sampleSeconds = (float)(connectionStats.endTime - connectionStats.startTime).count() / (float)USECS_PER_SECOND;
+        float sentKbps = (float)connectionStats.sentUnreliableBytes / (float)BYTES_PER_KILOBIT / sampleSeconds;
+        bool isUsingBudget = sentKbps >= MIN_USED_BUDGET_FRACTION * _bandwidthBudgetKbps;
+
+        if (_numReliablePacketsSent >= MIN_PACKETS_FOR_LOSS) {
+            if ((float)_numReliablePacketsResent / (float)_numReliablePacketsSent > LOSS_THRESHOLD) {
+                _bandwidthBudgetKbps *= BUDGET_DECREASE_FACTOR;
+            } else if (isUsingBudget) {
+                _bandwidthBudgetKbps += BUDGET_INCREASE_FRACTION * maxKbps;
+            }
+            _numReliablePacketsSent = 0;
+            _numReliablePacketsResent = 0;
+            _numConnectionStatsSamples = 0;
+        } else if (_numConnectionStatsSamples >= MAX_SAMPLES_FOR_LOSS) {
+            if (_numReliablePacketsResent == 0 && isUsingBudget) {
+                _bandwidthBudgetKbps += BUDGET_INCREASE_FRACTION * maxKbps;
+            }
+            _numReliablePacketsSent = 0;
+            _numReliablePacketsResent = 0;
+            _numConnectionStatsSamples = 0;
+        }
+    }
+
+    _bandwidthBudgetKbps = glm::clamp(_bandwidthBudgetKbps, MIN_BUDGET_FRACTION * maxKbps, maxKbps);
+}
+
 void AvatarMixerClientData::loadJSONStats(QJsonObject& jsonObject) const {
     jsonObject["display_name"] = _avatar->getDisplayName();
     jsonObject["num_avs_sent_last_frame"] = _numAvatarsSentLastFrame;
@@ -467,6 +510,7 @@ void AvatarMixerClientData::loadJSONStats(QJsonObject& jsonObject) const {
     jsonObject[OUTBOUND_AVATAR_DATA_STATS_KEY] = getOutboundAvatarDataKbps();
     jsonObject[OUTBOUND_AVATAR_TRAITS_STATS_KEY] = getOutboundAvatarTraitsKbps();
     jsonObject[INBOUND_AVATAR_DATA_STATS_KEY] = _avatar->getAverageBytesReceivedPerSecond() / (float)BYTES_PER_KILOBIT;
+    jsonObject["av_data_budget_kbps"] = _bandwidthBudgetKbps;
 
     jsonObject["av_data_receive_rate"] = _avatar->getReceiveRate();
     jsonObject["recent_other_av_in_view"] = _recentOtherAvatarsInView;
@@ -486,6 +530,7 @@ AvatarMixerClientData::TraitsCheckTimestamp AvatarMixerClientData::getLastOtherA
 void AvatarMixerClientData::cleanupKilledNode(const QUuid&, Node::LocalID nodeLocalID) {
     removeLastBroadcastSequenceNumber(nodeLocalID);
     removeLastBroadcastTime(nodeLocalID);
+    _lastReplicatedTimes.erase(nodeLocalID);
     _lastSentTraitsTimestamps.erase(nodeLocalID);
     _perNodeSentTraitVersions.erase(nodeLocalID);
     _perNodeAckedTraitVersions.erase(nodeLocalID);
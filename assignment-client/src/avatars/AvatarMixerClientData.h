@@ -16,7 +16,8 @@
 #include <cfloat>
 #include <unordered_map>
 #include <vector>
-#include <queue>
+
+#include <tbb/concurrent_queue.h>
 
 #include <QtCore/QJsonObject>
 #include <QtCore/QUrl>
@@ -63,6 +64,10 @@ public:
     void setLastBroadcastTime(NLPacket::LocalID nodeUUID, uint64_t broadcastTime) { _lastBroadcastTimes[nodeUUID] = broadcastTime; }
     Q_INVOKABLE void removeLastBroadcastTime(NLPacket::LocalID nodeUUID) { _lastBroadcastTimes.erase(nodeUUID); }
 
+    // when a downstream mixer was last sent data for a replicated avatar
+    uint64_t getLastReplicatedTime(NLPacket::LocalID nodeID) const;
+    void setLastReplicatedTime(NLPacket::LocalID nodeID, uint64_t replicatedTime) { _lastReplicatedTimes[nodeID] = replicatedTime; }
+
     Q_INVOKABLE void cleanupKilledNode(const QUuid& nodeUUID, Node::LocalID nodeLocalID);
 
     uint16_t getLastReceivedSequenceNumber() const { return _lastReceivedSequenceNumber; }
@@ -93,6 +98,16 @@ public:
         _avgOtherAvatarTraitsRate.updateAverage(numTraitsBytes);
     }
 
+    // adapts this listener's avatar data budget to the loss and send rate of the link to it
+    void updateBandwidthBudget(const Node::Stats& connectionStats, float maxKbps);
+    float getBandwidthBudgetKbps() const { return _bandwidthBudgetKbps; }
+
+    // what the non-priority avatars used of last frame's budget, and whether any avatar didn't fit in it
+    void setLastFrameBudgetUsage(int nonHeroBytes, bool wasOverBudget)
+        { _lastNonHeroBytes = nonHeroBytes; _lastFrameWasOverBudget = wasOverBudget; }
+    int getLastNonHeroBytes() const { return _lastNonHeroBytes; }
+    bool getLastFrameWasOverBudget() const { return _lastFrameWasOverBudget; }
+
     float getOutboundAvatarDataKbps() const
         { return _avgOtherAvatarDataRate.getAverageSampleValuePerSecond() / (float) BYTES_PER_KILOBIT; }
     float getOutboundAvatarTraitsKbps() const
@@ -128,8 +143,9 @@ public:
 
     QVector<JointData>& getLastOtherAvatarSentJoints(NLPacket::LocalID otherAvatar) { return _lastOtherAvatarSentJoints[otherAvatar]; }
 
-    void queuePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node);
-    int processPackets(const SlaveSharedData& slaveSharedData); // returns number of packets processed
+    // safe to call from any thread, including while a slave is draining this node's queue
+    void queuePacket(QSharedPointer<ReceivedMessage> message);
+    int processPackets(const SlaveSharedData& slaveSharedData, Node& node); // returns number of packets processed
 
     void processSetTraitsMessage(ReceivedMessage& message, const SlaveSharedData& slaveSharedData, Node& sendingNode);
     void processBulkAvatarTraitsAckMessage(ReceivedMessage& message);
@@ -159,9 +175,8 @@ public:
     void resetSentTraitData(Node::LocalID nodeID);
 
 private:
-    struct PacketQueue : public std::queue<QSharedPointer<ReceivedMessage>> {
-        QWeakPointer<Node> node;
-    };
+    // lock-free multi-producer queue, drained by whichever slave owns this node for the frame
+    using PacketQueue = tbb::concurrent_queue<QSharedPointer<ReceivedMessage>>;
     PacketQueue _packetQueue;
 
     MixerAvatarSharedPointer _avatar { new MixerAvatar() };
@@ -169,6 +184,7 @@ private:
     uint16_t _lastReceivedSequenceNumber { 0 };
     std::unordered_map<NLPacket::LocalID, uint16_t> _lastBroadcastSequenceNumbers;
     std::unordered_map<NLPacket::LocalID, uint64_t> _lastBroadcastTimes;
+    std::unordered_map<NLPacket::LocalID, uint64_t> _lastReplicatedTimes;
 
     // this is a map of the last time we encoded an "other" avatar for
     // sending to "this" node
@@ -186,6 +202,15 @@ private:
     SimpleMovingAverage _otherAvatarSkips;
     int _numOutOfOrderSends = 0;
 
+    float _bandwidthBudgetKbps { 0.0f };
+    Node::Stats::microseconds _lastConnectionStatsSample { 0 };
+    uint32_t _numReliablePacketsSent { 0 };
+    uint32_t _numReliablePacketsResent { 0 };
+    int _numConnectionStatsSamples { 0 };
+    bool _hasReceivedSequenceNumber { false };
+    int _lastNonHeroBytes { 0 };
+    bool _lastFrameWasOverBudget { true };
+
     SimpleMovingAverage _avgOtherAvatarDataRate;
     SimpleMovingAverage _avgOtherAvatarTraitsRate;
     std::vector<QUuid> _radiusIgnoredOthers;
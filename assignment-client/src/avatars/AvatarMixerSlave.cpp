@@ -36,6 +36,43 @@
 
 namespace chrono = std::chrono;
 
+bool SlaveSharedData::isSkeletonURLWhitelisted(const QUrl& skeletonURL) const {
+    // bounds the cache if clients keep sending new URLs
+    const int MAX_WHITELISTED_SKELETON_URLS = 1024;
+
+    std::lock_guard<std::mutex> lock(_whitelistedSkeletonURLsMutex);
+    auto itr = _whitelistedSkeletonURLs.find(skeletonURL);
+    if (itr != _whitelistedSkeletonURLs.end()) {
+        return itr.value();
+    }
+
+    // The avatar is in the whitelist if:
+    // 1. The avatar's URL's host matches one of the hosts of the URLs in the whitelist AND
+    // 2. The avatar's URL's path starts with the path of that same URL in the whitelist
+    bool inWhitelist = false;
+    for (const auto& whiteListedPrefix : skeletonURLWhitelist) {
+        auto whiteListURL = QUrl::fromUserInput(whiteListedPrefix);
+        // check if this script URL matches the whitelist domain and, optionally, is beneath the path
+        if (skeletonURL.host().compare(whiteListURL.host(), Qt::CaseInsensitive) == 0 &&
+            skeletonURL.path().startsWith(whiteListURL.path(), Qt::CaseInsensitive)) {
+            inWhitelist = true;
+
+            break;
+        }
+    }
+
+    if (_whitelistedSkeletonURLs.size() >= MAX_WHITELISTED_SKELETON_URLS) {
+        _whitelistedSkeletonURLs.clear();
+    }
+    _whitelistedSkeletonURLs.insert(skeletonURL, inWhitelist);
+    return inWhitelist;
+}
+
+void SlaveSharedData::clearSkeletonURLWhitelistCache() {
+    std::lock_guard<std::mutex> lock(_whitelistedSkeletonURLsMutex);
+    _whitelistedSkeletonURLs.clear();
+}
+
 void AvatarMixerSlave::configure(ConstIter begin, ConstIter end) {
     _begin = begin;
     _end = end;
@@ -64,7 +101,7 @@ void AvatarMixerSlave::processIncomingPackets(const SharedNodePointer& node) {
     auto nodeData = dynamic_cast<AvatarMixerClientData*>(node->getLinkedData());
     if (nodeData) {
         _stats.nodesProcessed++;
-        _stats.packetsProcessed += nodeData->processPackets(*_sharedData);
+        _stats.packetsProcessed += nodeData->processPackets(*_sharedData, *node);
     }
     auto end = usecTimestampNow();
     _stats.processIncomingPacketsElapsedTime += (end - start);
@@ -349,9 +386,19 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
     int identityBytesSent = 0;
     int traitBytesSent = 0;
 
-    // max number of avatarBytes per frame (13 900, typical)
-    const int maxAvatarBytesPerFrame = int(_maxKbpsPerNode * BYTES_PER_KILOBIT / AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND);
-    const int maxHeroBytesPerFrame = int(maxAvatarBytesPerFrame * _avatarHeroFraction);  // 5555, typical
+    // max number of avatarBytes per frame (13 900, typical), backed off for listeners on lossy links
+    destinationNodeData->updateBandwidthBudget(destinationNode->getConnectionStats(), _maxKbpsPerNode);
+    const int maxAvatarBytesPerFrame = int(destinationNodeData->getBandwidthBudgetKbps() * BYTES_PER_KILOBIT
+        / AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND);
+
+    // heroes get their reserved fraction (5555, typical), plus whatever the other avatars left unused last frame
+    // as long as they all fit; once some don't, heroes are back to their fraction so the others can't be squeezed out
+    int maxHeroBytesPerFrame = int(maxAvatarBytesPerFrame * _avatarHeroFraction);
+    if (!destinationNodeData->getLastFrameWasOverBudget()) {
+        maxHeroBytesPerFrame = std::max(maxHeroBytesPerFrame, maxAvatarBytesPerFrame - destinationNodeData->getLastNonHeroBytes());
+    }
+    int nonHeroBytes = 0;
+    bool wasOverBudget = false;
 
     // keep track of the number of other avatars held back in this frame
     int numAvatarsHeldBack = 0;
@@ -527,6 +574,7 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
             auto frameByteEstimate = identityBytesSent + traitBytesSent + numAvatarDataBytes + minimRemainingAvatarBytes;
             bool overBudget = frameByteEstimate > maxAvatarBytesPerFrame;
             if (overBudget) {
+                wasOverBudget = true;
                 if (PALIsOpen) {
                     _stats.overBudgetAvatars++;
                     detail = AvatarData::PALMinimum;
@@ -586,6 +634,9 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
                 avatarPacket->write(bytes);
                 avatarSpaceAvailable -= bytes.size();
                 numAvatarDataBytes += bytes.size();
+                if (!sourceAvatar->getHasPriority()) {
+                    nonHeroBytes += bytes.size();
+                }
                 if (!sendStatus || avatarSpaceAvailable < (int)AvatarDataPacket::MIN_BULK_PACKET_SIZE) {
                     // Weren't able to fit everything.
                     nodeList->sendPacket(std::move(avatarPacket), *destinationNode);
@@ -662,6 +713,7 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
 
     // record the bytes sent for other avatar data in the AvatarMixerClientData
     destinationNodeData->recordSentAvatarData(numAvatarDataBytes, traitBytesSent);
+    destinationNodeData->setLastFrameBudgetUsage(nonHeroBytes, wasOverBudget);
 
 
     // record the number of avatars held back this frame
@@ -711,13 +763,7 @@ void AvatarMixerSlave::broadcastAvatarDataToDownstreamMixer(const SharedNodePoin
             quint64 start = usecTimestampNow();
             AvatarDataPacket::SendStatus sendStatus;
 
-            QVector<JointData> emptyLastJointSendData { otherAvatar->getJointCount() };
-
-            QByteArray avatarByteArray = otherAvatar->toByteArray(AvatarData::SendAllData, 0, emptyLastJointSendData,
-                sendStatus, false, false, glm::vec3(0), nullptr, 0);
-            quint64 end = usecTimestampNow();
-            _stats.toByteArrayElapsedTime += (end - start);
-
+            // identity changes go out regardless of the rate limit below
             auto lastBroadcastTime = nodeData->getLastBroadcastTime(agentNode->getLocalID());
             if (lastBroadcastTime <= agentNodeData->getIdentityChangeTimestamp()
                 || (start - lastBroadcastTime) >= REBROADCAST_IDENTITY_TO_DOWNSTREAM_EVERY_US) {
@@ -725,6 +771,19 @@ void AvatarMixerSlave::broadcastAvatarDataToDownstreamMixer(const SharedNodePoin
                 nodeData->setLastBroadcastTime(agentNode->getLocalID(), start);
             }
 
+            // optionally limit how often each avatar is sent downstream, the updates stay full ones
+            if (_sharedData->replicatedAvatarIntervalUsecs > 0 &&
+                start - nodeData->getLastReplicatedTime(agentNode->getLocalID()) < _sharedData->replicatedAvatarIntervalUsecs) {
+                return;
+            }
+
+            QVector<JointData> emptyLastJointSendData { otherAvatar->getJointCount() };
+
+            QByteArray avatarByteArray = otherAvatar->toByteArray(AvatarData::SendAllData, 0, emptyLastJointSendData,
+                sendStatus, false, false, glm::vec3(0), nullptr, 0);
+            quint64 end = usecTimestampNow();
+            _stats.toByteArrayElapsedTime += (end - start);
+
             // figure out how large our avatar byte array can be to fit in the packet list
             // given that we need it and the avatar UUID and the size of the byte array (16 bit)
             // to fit in a segment of the packet list
@@ -752,6 +811,9 @@ void AvatarMixerSlave::broadcastAvatarDataToDownstreamMixer(const SharedNodePoin
             }
 
             if (avatarByteArray.size() <= maxAvatarByteArraySize) {
+                // only an avatar that made it into the packet list waits for the next replication interval
+                nodeData->setLastReplicatedTime(agentNode->getLocalID(), start);
+
                 // increment the number of avatars sent to this reciever
                 nodeData->incrementNumAvatarsSentLastFrame();
 
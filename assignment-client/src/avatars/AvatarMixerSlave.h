@@ -12,6 +12,8 @@
 #ifndef hifi_AvatarMixerSlave_h
 #define hifi_AvatarMixerSlave_h
 
+#include <mutex>
+
 #include <NodeList.h>
 
 class AvatarMixerClientData;
@@ -100,6 +102,17 @@ struct SlaveSharedData {
     QStringList skeletonURLWhitelist;
     QUrl skeletonReplacementURL;
     EntityTreePointer entityTree;
+
+    // matches each distinct skeleton URL against the whitelist once, safe to call from any slave
+    bool isSkeletonURLWhitelisted(const QUrl& skeletonURL) const;
+    void clearSkeletonURLWhitelistCache();
+
+    // minimum time between two updates of the same avatar to a downstream mixer, 0 sends every frame
+    quint64 replicatedAvatarIntervalUsecs { 0 };
+
+private:
+    mutable std::mutex _whitelistedSkeletonURLsMutex;
+    mutable QHash<QUrl, bool> _whitelistedSkeletonURLs;
 };
 
 class AvatarMixerSlave {
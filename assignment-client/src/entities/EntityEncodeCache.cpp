@@ -0,0 +1,86 @@
+//
+//  EntityEncodeCache.cpp
+//  assignment-client/src/entities
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityEncodeCache.h"
+
+#include <SharedUtil.h>
+
+EntityEncodeCache::Version EntityEncodeCache::versionOf(const EntityItem& entity) {
+    Version version;
+    version.changedOnServer = entity.getLastChangedOnServer();
+    version.lastEdited = entity.getLastEdited();
+    version.lastUpdated = entity.getLastUpdated();
+    version.lastSimulated = entity.getLastSimulated();
+    return version;
+}
+
+QByteArray EntityEncodeCache::find(const EntityItemID& entityID, const Version& version, bool withPrivateUserData) {
+    Shard& shard = shardFor(entityID);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto& entries = shard.entries[withPrivateUserData ? 1 : 0];
+        auto itr = entries.find(entityID);
+        if (itr != entries.end() && itr->version == version) {
+            itr->lastUsed = usecTimestampNow();
+            ++_hits;
+            return itr->encoded;
+        }
+    }
+    ++_misses;
+    return QByteArray();
+}
+
+void EntityEncodeCache::insert(const EntityItemID& entityID, const Version& version, bool withPrivateUserData,
+                               QByteArray encoded) {
+    Shard& shard = shardFor(entityID);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Entry& entry = shard.entries[withPrivateUserData ? 1 : 0][entityID];
+    _bytes += encoded.size() - entry.encoded.size();
+    entry.version = version;
+    entry.encoded = encoded;
+    entry.lastUsed = usecTimestampNow();
+}
+
+void EntityEncodeCache::removeUnused(quint64 olderThan) {
+    for (auto& shard : _shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto& entries : shard.entries) {
+            auto itr = entries.begin();
+            while (itr != entries.end()) {
+                if (itr->lastUsed < olderThan) {
+                    _bytes -= itr->encoded.size();
+                    itr = entries.erase(itr);
+                } else {
+                    ++itr;
+                }
+            }
+        }
+    }
+}
+
+float EntityEncodeCache::getHitRate() const {
+    quint64 hits = _hits;
+    quint64 lookups = hits + _misses;
+    return lookups > 0 ? (float)hits / (float)lookups : 0.0f;
+}
+
+float EntityEncodeCache::getAverageEncodeTime() const {
+    quint64 encodes = _encodes;
+    return encodes > 0 ? (float)_encodeTime / (float)encodes : 0.0f;
+}
+
+int EntityEncodeCache::getCount() const {
+    int count = 0;
+    for (const auto& shard : _shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        count += shard.entries[0].size() + shard.entries[1].size();
+    }
+    return count;
+}
@@ -0,0 +1,82 @@
+//
+//  EntityEncodeCache.h
+//  assignment-client/src/entities
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityEncodeCache_h
+#define hifi_EntityEncodeCache_h
+
+#include <array>
+#include <atomic>
+#include <mutex>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+
+#include <EntityItem.h>
+
+/// Shared by all the EntityTreeSendThreads so that an entity that changed is encoded once for every viewer
+/// rather than once per viewer. Only complete encodings are cached; partial ones depend on the packet being filled.
+class EntityEncodeCache {
+public:
+    struct Version {
+        quint64 changedOnServer { 0 };
+        quint64 lastEdited { 0 };
+        quint64 lastUpdated { 0 };
+        quint64 lastSimulated { 0 };
+
+        bool operator==(const Version& other) const {
+            return changedOnServer == other.changedOnServer && lastEdited == other.lastEdited &&
+                lastUpdated == other.lastUpdated && lastSimulated == other.lastSimulated;
+        }
+        bool operator!=(const Version& other) const { return !(*this == other); }
+    };
+
+    static Version versionOf(const EntityItem& entity);
+
+    // returns an empty array when there's no encoding of this version of the entity
+    QByteArray find(const EntityItemID& entityID, const Version& version, bool withPrivateUserData);
+    void insert(const EntityItemID& entityID, const Version& version, bool withPrivateUserData, QByteArray encoded);
+
+    void trackEncodeTime(quint64 usecs) { _encodeTime += usecs; ++_encodes; }
+
+    // drops the encodings that haven't been used since olderThan, which also takes care of deleted entities
+    void removeUnused(quint64 olderThan);
+
+    quint64 getHits() const { return _hits; }
+    quint64 getMisses() const { return _misses; }
+    float getHitRate() const;
+    float getAverageEncodeTime() const; // usecs to encode an entity that wasn't in the cache
+    int getCount() const;
+    qint64 getBytes() const { return _bytes; }
+
+private:
+    struct Entry {
+        Version version;
+        QByteArray encoded;
+        quint64 lastUsed { 0 };
+    };
+
+    // sharded to keep the send threads from all contending for one lock
+    static const int NUM_SHARDS = 16;
+    struct Shard {
+        mutable std::mutex mutex;
+        QHash<EntityItemID, Entry> entries[2]; // without and with private user data
+    };
+    Shard& shardFor(const EntityItemID& entityID) { return _shards[qHash(entityID) % NUM_SHARDS]; }
+
+    std::array<Shard, NUM_SHARDS> _shards;
+
+    std::atomic<quint64> _hits { 0 };
+    std::atomic<quint64> _misses { 0 };
+    std::atomic<quint64> _encodes { 0 };
+    std::atomic<quint64> _encodeTime { 0 };
+    std::atomic<qint64> _bytes { 0 };
+};
+
+#endif // hifi_EntityEncodeCache_h
@@ -0,0 +1,54 @@
+//
+//  EntityKnownState.cpp
+//  assignment-client/src/entities
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityKnownState.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <SharedUtil.h>
+
+const EntityKnownState::Version EntityKnownState::UNKNOWN;
+
+EntityKnownState::EntityKnownState() :
+    _epoch(usecTimestampNow())
+{
+}
+
+EntityKnownState::Version EntityKnownState::versionAt(quint64 usecTimestamp) const {
+    static const quint64 MAX_TICKS = std::numeric_limits<Version>::max() - 1;
+
+    // anything from before this state was created, like the lastEdited of a persisted entity, shares the first tick
+    quint64 ticks = usecTimestamp > _epoch ? (usecTimestamp - _epoch) / VERSION_USECS : 0;
+    return (Version)std::min(ticks, MAX_TICKS) + 1;
+}
+
+void EntityKnownState::setSent(const EntityItem& entity, Version version) {
+    uint32_t slot = entity.getServerSlot();
+    if (slot == EntityItem::NO_SERVER_SLOT) {
+        return;
+    }
+    if (slot >= _versions.size()) {
+        _versions.resize(slot + 1, UNKNOWN);
+    }
+    _versions[slot] = version;
+}
+
+void EntityKnownState::forget(const EntityItem& entity) {
+    uint32_t slot = entity.getServerSlot();
+    if (slot < _versions.size()) {
+        _versions[slot] = UNKNOWN;
+    }
+}
+
+void EntityKnownState::clear() {
+    // keep the capacity, the viewer is about to learn about the same entities again
+    std::fill(_versions.begin(), _versions.end(), UNKNOWN);
+}
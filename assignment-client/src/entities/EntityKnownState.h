@@ -0,0 +1,57 @@
+//
+//  EntityKnownState.h
+//  assignment-client/src/entities
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityKnownState_h
+#define hifi_EntityKnownState_h
+
+#include <stdint.h>
+#include <vector>
+
+#include <EntityItem.h>
+#include <NumericalConstants.h>
+
+/// What one viewer knows about the entities: a flat array of versions indexed by the entities' server slots.
+/// A version is the time the entity was last sent to the viewer, counted in VERSION_USECS ticks since this state was
+/// created, plus one so that UNKNOWN can be zero. Comparisons made within a tick assume the entity changed, which at worst
+/// sends it again.
+class EntityKnownState {
+public:
+    using Version = uint32_t;
+    static const Version UNKNOWN = 0;
+    static const quint64 VERSION_USECS = 10 * USECS_PER_MSEC; // wraps after ~497 days, versions saturate after that
+
+    EntityKnownState();
+
+    Version versionAt(quint64 usecTimestamp) const;
+
+    // false for an entity that was sent before its slot was recycled
+    bool isKnown(const EntityItem& entity) const {
+        Version sent = get(entity.getServerSlot());
+        return sent != UNKNOWN && sent > versionAt(entity.getServerSlotAssignedAt());
+    }
+
+    // only meaningful for known entities
+    bool changedSinceSent(const EntityItem& entity) const {
+        Version sent = get(entity.getServerSlot());
+        return versionAt(entity.getLastEdited()) >= sent || versionAt(entity.getLastChangedOnServer()) >= sent;
+    }
+
+    void setSent(const EntityItem& entity, Version version);
+    void forget(const EntityItem& entity);
+    void clear();
+
+private:
+    Version get(uint32_t slot) const { return slot < _versions.size() ? _versions[slot] : UNKNOWN; }
+
+    const quint64 _epoch;
+    std::vector<Version> _versions;
+};
+
+#endif // hifi_EntityKnownState_h
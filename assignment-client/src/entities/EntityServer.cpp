@@ -287,7 +287,33 @@ int EntityServer::sendSpecialPackets(const SharedNodePointer& node, OctreeQueryN
     return totalBytes;
 }
 
+void EntityServer::updateDataDictionary() {
+    const quint64 DATA_DICTIONARY_UPDATE_INTERVAL = 10 * SECS_PER_MINUTE * USECS_PER_SECOND; // each update costs every viewer a download
+    const quint64 DATA_DICTIONARY_RETRY_INTERVAL = 10 * USECS_PER_SECOND; // until the content has loaded
+
+    quint64 now = usecTimestampNow();
+    if (now < _nextDataDictionaryUpdate) {
+        return;
+    }
+
+    EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+    auto dictionary = EntityDataDictionary::build(tree->sampleEntities(EntityDataDictionary::MAX_SAMPLED_ENTITIES));
+
+    std::lock_guard<std::mutex> lock(_dataDictionaryMutex);
+    if (dictionary && (!_dataDictionary || dictionary->getID() != _dataDictionary->getID())) {
+        qDebug() << "Built an entity data dictionary of" << dictionary->getData().size() << "bytes from"
+            << dictionary->getNumStrings() << "repeated strings";
+        _dataDictionary = dictionary;
+    }
+    _nextDataDictionaryUpdate = now + (_dataDictionary ? DATA_DICTIONARY_UPDATE_INTERVAL : DATA_DICTIONARY_RETRY_INTERVAL);
+}
+
 void EntityServer::pruneDeletedEntities() {
+    const quint64 UNUSED_ENCODE_EXPIRY = 5 * USECS_PER_SECOND;
+    _encodeCache.removeUnused(usecTimestampNow() - UNUSED_ENCODE_EXPIRY);
+
+    updateDataDictionary();
+
     EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
     if (tree->hasAnyDeletedEntities()) {
 
@@ -413,6 +439,32 @@ QString EntityServer::serverSubclassStats() {
     statsString += QString().sprintf("       EntityItem size... %ld bytes\r\n", sizeof(EntityItem));
     statsString += "\r\n\r\n";
 
+    statsString += "<b>Entity Server Encode Cache Statistics</b>\r\n";
+    statsString += QString("    Hit rate:               %1%\r\n").arg(locale.toString(_encodeCache.getHitRate() * 100.0f, 'f', 1));
+    statsString += QString("    Hits / misses:          %1 / %2\r\n")
+        .arg(locale.toString(_encodeCache.getHits())).arg(locale.toString(_encodeCache.getMisses()));
+    statsString += QString("    Average encode time:    %1 usecs per entity\r\n")
+        .arg(locale.toString(_encodeCache.getAverageEncodeTime(), 'f', 2));
+    statsString += QString("    Cached encodings:       %1 (%2 bytes)\r\n")
+        .arg(locale.toString(_encodeCache.getCount())).arg(locale.toString(_encodeCache.getBytes()));
+    auto dataDictionary = getDataDictionary();
+    if (dataDictionary) {
+        statsString += QString("    Data dictionary:        %1 bytes, %2 strings, sent %3 times\r\n")
+            .arg(locale.toString(dataDictionary->getData().size()))
+            .arg(locale.toString(dataDictionary->getNumStrings()))
+            .arg(locale.toString(_dataDictionariesSent));
+    }
+    statsString += "\r\n\r\n";
+
+    auto entityEditFilters = DependencyManager::get<EntityEditFilters>();
+    if (entityEditFilters) {
+        statsString += "<b>Entity Server Edit Filter Statistics</b>\r\n";
+        statsString += QString("    Filter calls:           %1\r\n").arg(locale.toString(entityEditFilters->getEvaluatedCount()));
+        statsString += QString("    Cached results used:    %1\r\n").arg(locale.toString(entityEditFilters->getCachedCount()));
+        statsString += QString("    Skipped (unfiltered):   %1\r\n").arg(locale.toString(entityEditFilters->getSkippedCount()));
+        statsString += "\r\n\r\n";
+    }
+
     statsString += "<b>Entity Server Sending to Viewer Statistics</b>\r\n";
     statsString += "----- Viewer Node ID -----------------    ----- Entity ID ----------------------    "
                    "---------- Last Sent To ----------    ---------- Last Edited -----------\r\n";
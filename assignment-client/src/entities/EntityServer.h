@@ -14,8 +14,12 @@
 
 #include "../octree/OctreeServer.h"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 
+#include "EntityEncodeCache.h"
+#include "EntityDataDictionary.h"
 #include "EntityItem.h"
 #include "EntityServerConsts.h"
 #include "EntityTree.h"
@@ -60,6 +64,12 @@ public:
 
     virtual void aboutToFinish() override;
 
+    EntityEncodeCache& getEncodeCache() { return _encodeCache; }
+
+    // nullptr until the domain has enough repeated strings for one
+    EntityDataDictionaryPointer getDataDictionary() const { std::lock_guard<std::mutex> lock(_dataDictionaryMutex); return _dataDictionary; }
+    void trackDataDictionarySent() { ++_dataDictionariesSent; }
+
 public slots:
     virtual void nodeAdded(SharedNodePointer node) override;
     virtual void nodeKilled(SharedNodePointer node) override;
@@ -81,6 +91,14 @@ private:
     QReadWriteLock _viewerSendingStatsLock;
     QMap<QUuid, QMap<QUuid, ViewerSendingStats>> _viewerSendingStats;
 
+    EntityEncodeCache _encodeCache;
+
+    void updateDataDictionary();
+    mutable std::mutex _dataDictionaryMutex;
+    EntityDataDictionaryPointer _dataDictionary;
+    quint64 _nextDataDictionaryUpdate { 0 };
+    std::atomic<int> _dataDictionariesSent { 0 };
+
     static const int DEFAULT_MINIMUM_DYNAMIC_DOMAIN_VERIFICATION_TIMER_MS = 45 * 60 * 1000;                    // 45m
     static const int DEFAULT_MAXIMUM_DYNAMIC_DOMAIN_VERIFICATION_TIMER_MS = 60 * 60 * 1000;                    // 1h
     int _MINIMUM_DYNAMIC_DOMAIN_VERIFICATION_TIMER_MS = DEFAULT_MINIMUM_DYNAMIC_DOMAIN_VERIFICATION_TIMER_MS;  // 45m
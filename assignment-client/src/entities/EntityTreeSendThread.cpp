@@ -12,6 +12,7 @@
 #include "EntityTreeSendThread.h"
 
 #include <EntityNodeData.h>
+#include <NodeList.h>
 #include <EntityTypes.h>
 #include <OctreeUtils.h>
 
@@ -21,7 +22,6 @@ EntityTreeSendThread::EntityTreeSendThread(OctreeServer* myServer, const SharedN
     OctreeSendThread(myServer, node)
 {
     connect(std::static_pointer_cast<EntityTree>(myServer->getOctree()).get(), &EntityTree::editingEntityPointer, this, &EntityTreeSendThread::editingEntityPointer, Qt::QueuedConnection);
-    connect(std::static_pointer_cast<EntityTree>(myServer->getOctree()).get(), &EntityTree::deletingEntityPointer, this, &EntityTreeSendThread::deletingEntityPointer, Qt::QueuedConnection);
 
     // connect to connection ID change on EntityNodeData so we can clear state for this receiver
     auto nodeData = static_cast<EntityNodeData*>(node->getLinkedData());
@@ -33,6 +33,7 @@ void EntityTreeSendThread::resetState() {
 
     _knownState.clear();
     _traversal.reset();
+    _sentDataDictionaryID = NO_DATA_DICTIONARY;
 }
 
 void EntityTreeSendThread::preDistributionProcessing() {
@@ -101,65 +102,83 @@ void EntityTreeSendThread::preDistributionProcessing() {
 
 bool EntityTreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, OctreeQueryNode* nodeData,
             bool viewFrustumChanged, bool isFullScene) {
-    if (viewFrustumChanged || _traversal.finished()) {
+    // The tree lock is only held for the traversal, which walks the tree structure that edits change. Packets are then
+    // built from the queued entities under their own locks, so edits are applied while we encode and send.
+    withTreeReadLock([&] {
         EntityTreeElementPointer root = std::dynamic_pointer_cast<EntityTreeElement>(_myServer->getOctree()->getRoot());
+        _rootChildrenExistBits = 0;
+        for (int32_t i = 0; i < NUMBER_OF_CHILDREN; ++i) {
+            if (root->getChildAtIndex(i)) {
+                _rootChildrenExistBits += (1 << i);
+            }
+        }
 
+        if (viewFrustumChanged || _traversal.finished()) {
+            DiffTraversal::View newView;
+            newView.viewFrustums = nodeData->getCurrentViews();
 
-        DiffTraversal::View newView;
-        newView.viewFrustums = nodeData->getCurrentViews();
-
-        int32_t lodLevelOffset = nodeData->getBoundaryLevelAdjust() + (viewFrustumChanged ? LOW_RES_MOVING_ADJUST : NO_BOUNDARY_ADJUST);
-        newView.lodScaleFactor = powf(2.0f, lodLevelOffset);
-        
-        startNewTraversal(newView, root, isFullScene);
+            int32_t lodLevelOffset = nodeData->getBoundaryLevelAdjust() + (viewFrustumChanged ? LOW_RES_MOVING_ADJUST : NO_BOUNDARY_ADJUST);
+            newView.lodScaleFactor = powf(2.0f, lodLevelOffset);
 
-        // When the viewFrustum changed the sort order may be incorrect, so we re-sort
-        // and also use the opportunity to cull anything no longer in view
-        if (viewFrustumChanged && !_sendQueue.empty()) {
-            EntityPriorityQueue prevSendQueue;
-            std::swap(_sendQueue, prevSendQueue);
-            assert(_sendQueue.empty());
+            // while the node loads its initial scene, what it is interested in goes out first
+            if (isInitialLoad() && newView.usesViewFrustums()) {
+                newView.interestRegions = nodeData->getInterestRegions();
+                newView.interestClasses = nodeData->getInterestClasses();
+            }
 
-            // Re-add elements from previous traversal if they still need to be sent
-            while (!prevSendQueue.empty()) {
-                EntityItemPointer entity = prevSendQueue.top().getEntity();
-                bool forceRemove = prevSendQueue.top().shouldForceRemove();
-                prevSendQueue.pop();
-                if (entity) {
-                    float priority = PrioritizedEntity::DO_NOT_SEND;
+            startNewTraversal(newView, root, isFullScene);
+
+            // When the viewFrustum changed the sort order may be incorrect, so we re-sort
+            // and also use the opportunity to cull anything no longer in view
+            if (viewFrustumChanged && !_sendQueue.empty()) {
+                EntityPriorityQueue prevSendQueue;
+                std::swap(_sendQueue, prevSendQueue);
+                assert(_sendQueue.empty());
+
+                // Re-add elements from previous traversal if they still need to be sent
+                while (!prevSendQueue.empty()) {
+                    EntityItemPointer entity = prevSendQueue.top().getEntity();
+                    bool forceRemove = prevSendQueue.top().shouldForceRemove();
+                    prevSendQueue.pop();
+                    if (entity) {
+                        float priority = PrioritizedEntity::DO_NOT_SEND;
 
-                    if (forceRemove) {
-                        priority = PrioritizedEntity::FORCE_REMOVE;
-                    } else {
-                        const auto& view = _traversal.getCurrentView();
-                        priority = view.computePriority(entity);
-                    }
+                        if (forceRemove) {
+                            priority = PrioritizedEntity::FORCE_REMOVE;
+                        } else {
+                            const auto& view = _traversal.getCurrentView();
+                            priority = view.computePriority(entity);
+                        }
 
-                    if (priority != PrioritizedEntity::DO_NOT_SEND) {
-                        _sendQueue.emplace(entity, priority, forceRemove);
+                        if (priority != PrioritizedEntity::DO_NOT_SEND) {
+                            _sendQueue.emplace(entity, priority, forceRemove);
+                        }
                     }
                 }
             }
         }
-    }
 
-    if (!_traversal.finished()) {
-        quint64 startTime = usecTimestampNow();
-
-        #ifdef DEBUG
-        const uint64_t TIME_BUDGET = 400; // usec
-        #else
-        const uint64_t TIME_BUDGET = 200; // usec
-        #endif
-        _traversal.traverse(TIME_BUDGET);
-        OctreeServer::trackTreeTraverseTime((float)(usecTimestampNow() - startTime));
-    }
+        if (!_traversal.finished()) {
+            quint64 startTime = usecTimestampNow();
+
+            #ifdef DEBUG
+            const uint64_t TIME_BUDGET = 400; // usec
+            #else
+            const uint64_t TIME_BUDGET = 200; // usec
+            #endif
+            // a loading node can be given many more packets per interval, so the traversal needs to keep up
+            const uint64_t INITIAL_LOAD_TIME_BUDGET_SCALE = 4;
+            _traversal.traverse(isInitialLoad() ? INITIAL_LOAD_TIME_BUDGET_SCALE * TIME_BUDGET : TIME_BUDGET);
+            OctreeServer::trackTreeTraverseTime((float)(usecTimestampNow() - startTime));
+        }
+    });
 
     bool sendComplete = OctreeSendThread::traverseTreeAndSendContents(node, nodeData, viewFrustumChanged, isFullScene);
 
     if (sendComplete && nodeData->wantReportInitialCompletion() && _traversal.finished()) {
         // Dealt with all nearby entities.
         nodeData->setReportInitialCompletion(false);
+        finishInitialLoad();
 
         // Send EntityQueryInitialResultsComplete reliable packet ...
         auto initialCompletion = NLPacket::create(PacketType::EntityQueryInitialResultsComplete,
@@ -262,13 +281,11 @@ void EntityTreeSendThread::startNewTraversal(const DiffTraversal::View& view, En
                         }
                         float priority = PrioritizedEntity::DO_NOT_SEND;
 
-                        auto knownTimestamp = _knownState.find(entity.get());
-                        if (knownTimestamp == _knownState.end()) {
+                        if (!_knownState.isKnown(*entity)) {
                             const auto& view = _traversal.getCurrentView();
                             priority = view.computePriority(entity);
 
-                        } else if (entity->getLastEdited() > knownTimestamp->second ||
-                                   entity->getLastChangedOnServer() > knownTimestamp->second) {
+                        } else if (_knownState.changedSinceSent(*entity)) {
                             // it is known and it changed --> put it on the queue with any priority
                             // TODO: sort these correctly
                             priority = PrioritizedEntity::WHEN_IN_DOUBT_PRIORITY;
@@ -291,13 +308,11 @@ void EntityTreeSendThread::startNewTraversal(const DiffTraversal::View& view, En
                     }
                     float priority = PrioritizedEntity::DO_NOT_SEND;
 
-                    auto knownTimestamp = _knownState.find(entity.get());
-                    if (knownTimestamp == _knownState.end()) {
+                    if (!_knownState.isKnown(*entity)) {
                         const auto& view = _traversal.getCurrentView();
                         priority = view.computePriority(entity);
 
-                    } else if (entity->getLastEdited() > knownTimestamp->second ||
-                               entity->getLastChangedOnServer() > knownTimestamp->second) {
+                    } else if (_knownState.changedSinceSent(*entity)) {
                         // it is known and it changed --> put it on the queue with any priority
                         // TODO: sort these correctly
                         priority = PrioritizedEntity::WHEN_IN_DOUBT_PRIORITY;
@@ -332,14 +347,7 @@ bool EntityTreeSendThread::traverseTreeAndBuildNextPacketPayload(EncodeBitstream
         _packetData.appendValue(zeroByte); // octalcode
         _packetData.appendValue(zeroByte); // colors
         if (params.includeExistsBits) {
-            uint8_t childrenExistBits = 0;
-            EntityTreeElementPointer root = std::dynamic_pointer_cast<EntityTreeElement>(_myServer->getOctree()->getRoot());
-            for (int32_t i = 0; i < NUMBER_OF_CHILDREN; ++i) {
-                if (root->getChildAtIndex(i)) {
-                    childrenExistBits += (1 << i);
-                }
-            }
-            _packetData.appendValue(childrenExistBits); // childrenInTreeMask
+            _packetData.appendValue(_rootChildrenExistBits); // childrenInTreeMask
         }
         _packetData.appendValue(zeroByte); // childrenInBufferMask
 
@@ -352,7 +360,7 @@ bool EntityTreeSendThread::traverseTreeAndBuildNextPacketPayload(EncodeBitstream
     }
 
     LevelDetails entitiesLevel = _packetData.startLevel();
-    uint64_t sendTime = usecTimestampNow();
+    EntityKnownState::Version sendVersion = _knownState.versionAt(usecTimestampNow());
     auto nodeData = static_cast<OctreeQueryNode*>(params.nodeData);
     nodeData->stats.encodeStarted();
     auto entityNode = _node.toStrongRef();
@@ -372,7 +380,7 @@ bool EntityTreeSendThread::traverseTreeAndBuildNextPacketPayload(EncodeBitstream
                     // Record explicitly filtered-in entity so that extra entities can be flagged.
                     entityNodeData->insertSentFilteredEntity(entityID);
                 }
-                OctreeElement::AppendState appendEntityState = entity->appendEntityData(&_packetData, params, _extraEncodeData, entityNode->getCanGetAndSetPrivateUserData());
+                OctreeElement::AppendState appendEntityState = appendEntityData(*entity, params, entityNode->getCanGetAndSetPrivateUserData());
 
                 if (appendEntityState != OctreeElement::COMPLETED) {
                     if (appendEntityState == OctreeElement::PARTIAL) {
@@ -388,9 +396,9 @@ bool EntityTreeSendThread::traverseTreeAndBuildNextPacketPayload(EncodeBitstream
                 ++_numEntities;
             }
             if (queuedItem.shouldForceRemove()) {
-                _knownState.erase(entity.get());
+                _knownState.forget(*entity);
             } else {
-                _knownState[entity.get()] = sendTime;
+                _knownState.setSent(*entity, sendVersion);
             }
         }
         _sendQueue.pop();
@@ -413,9 +421,71 @@ bool EntityTreeSendThread::traverseTreeAndBuildNextPacketPayload(EncodeBitstream
     return true;
 }
 
+OctreeElement::AppendState EntityTreeSendThread::appendEntityData(const EntityItem& entity, EncodeBitstreamParams& params,
+                                                                  bool withPrivateUserData) {
+    // the remainder of a partially sent entity can't come from the cache
+    const EntityItemID& entityID = entity.getEntityItemID();
+    if (_extraEncodeData->entities.contains(entityID)) {
+        return entity.appendEntityData(&_packetData, params, _extraEncodeData, withPrivateUserData);
+    }
+
+    EntityEncodeCache& encodeCache = static_cast<EntityServer*>(_myServer)->getEncodeCache();
+    EntityEncodeCache::Version version = EntityEncodeCache::versionOf(entity);
+    QByteArray encoded = encodeCache.find(entityID, version, withPrivateUserData);
+    if (!encoded.isEmpty() && _packetData.appendRawData(encoded)) {
+        params.trackSend(entity.getID(), entity.getLastEdited());
+        return OctreeElement::COMPLETED;
+    }
+
+    quint64 encodeStart = usecTimestampNow();
+    int entityOffset = _packetData.getUncompressedByteOffset();
+    OctreeElement::AppendState appendState = entity.appendEntityData(&_packetData, params, _extraEncodeData,
+                                                                     withPrivateUserData);
+    encodeCache.trackEncodeTime(usecTimestampNow() - encodeStart);
+
+    // don't cache an encoding of an entity that was changed while we encoded it
+    if (appendState == OctreeElement::COMPLETED && encoded.isEmpty() && EntityEncodeCache::versionOf(entity) == version) {
+        int entitySize = _packetData.getUncompressedByteOffset() - entityOffset;
+        encodeCache.insert(entityID, version, withPrivateUserData,
+            QByteArray(reinterpret_cast<const char*>(_packetData.getUncompressedData(entityOffset)), entitySize));
+    }
+    return appendState;
+}
+
+void EntityTreeSendThread::updatePacketDataDictionary(const SharedNodePointer& node, OctreeQueryNode* nodeData) {
+    EntityDataDictionaryPointer dictionary;
+    if (nodeData->wantDataDictionary()) {
+        dictionary = static_cast<EntityServer*>(_myServer)->getDataDictionary();
+    }
+
+    uint32_t viewerDictionaryID = nodeData->getDataDictionaryID();
+    if (dictionary && dictionary->getID() == viewerDictionaryID) {
+        if (nodeData->getPacketDataDictionaryID() != viewerDictionaryID) {
+            nodeData->setPacketDataDictionary(viewerDictionaryID, dictionary->getData());
+        }
+        return;
+    }
+
+    // until the viewer has our current dictionary, keep using the one it has, if we were using it
+    if (nodeData->getPacketDataDictionaryID() != NO_DATA_DICTIONARY &&
+        nodeData->getPacketDataDictionaryID() != viewerDictionaryID) {
+        nodeData->setPacketDataDictionary(NO_DATA_DICTIONARY, QByteArray());
+    }
+
+    if (dictionary && dictionary->getID() != _sentDataDictionaryID) {
+        auto packetList = NLPacketList::create(PacketType::EntityDataDictionary, QByteArray(), true, true);
+        packetList->writePrimitive(dictionary->getID());
+        packetList->write(dictionary->getData());
+        DependencyManager::get<NodeList>()->sendPacketList(std::move(packetList), *node);
+
+        _sentDataDictionaryID = dictionary->getID();
+        static_cast<EntityServer*>(_myServer)->trackDataDictionarySent();
+    }
+}
+
 void EntityTreeSendThread::editingEntityPointer(const EntityItemPointer& entity) {
     if (entity) {
-        if (!_sendQueue.contains(entity.get()) && _knownState.find(entity.get()) != _knownState.end()) {
+        if (!_sendQueue.contains(entity.get()) && _knownState.isKnown(*entity)) {
             const auto& view = _traversal.getCurrentView();
             float priority = view.computePriority(entity);
 
@@ -428,7 +498,3 @@ void EntityTreeSendThread::editingEntityPointer(const EntityItemPointer& entity)
         }
     }
 }
-
-void EntityTreeSendThread::deletingEntityPointer(EntityItem* entity) {
-    _knownState.erase(entity);
-}
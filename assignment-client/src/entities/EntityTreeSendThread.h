@@ -20,6 +20,8 @@
 #include <EntityPriorityQueue.h>
 #include <shared/ConicalViewFrustum.h>
 
+#include "EntityKnownState.h"
+
 
 class EntityNodeData;
 class EntityItem;
@@ -44,23 +46,26 @@ private:
 
     void startNewTraversal(const DiffTraversal::View& viewFrustum, EntityTreeElementPointer root, bool forceFirstPass = false);
     bool traverseTreeAndBuildNextPacketPayload(EncodeBitstreamParams& params, const QJsonObject& jsonFilters) override;
+    OctreeElement::AppendState appendEntityData(const EntityItem& entity, EncodeBitstreamParams& params, bool withPrivateUserData);
 
     void preDistributionProcessing() override;
+    void updatePacketDataDictionary(const SharedNodePointer& node, OctreeQueryNode* nodeData) override;
     bool hasSomethingToSend(OctreeQueryNode* nodeData) override { return !_sendQueue.empty(); }
     bool shouldStartNewTraversal(OctreeQueryNode* nodeData, bool viewFrustumChanged) override { return viewFrustumChanged || _traversal.finished(); }
 
     DiffTraversal _traversal;
     EntityPriorityQueue _sendQueue;
-    std::unordered_map<EntityItem*, uint64_t> _knownState;
+    EntityKnownState _knownState; // a deleted entity's slot is recycled, so it needs no cleanup
+    uint32_t _sentDataDictionaryID { NO_DATA_DICTIONARY };
 
     // packet construction stuff
     EntityTreeElementExtraEncodeDataPointer _extraEncodeData { new EntityTreeElementExtraEncodeData() };
     int32_t _numEntitiesOffset { 0 };
     uint16_t _numEntities { 0 };
+    uint8_t _rootChildrenExistBits { 0 }; // as of the last traversal step, packets are built without the tree lock
 
 private slots:
     void editingEntityPointer(const EntityItemPointer& entity);
-    void deletingEntityPointer(EntityItem* entity);
 };
 
 #endif // hifi_EntityTreeSendThread_h
@@ -29,7 +29,8 @@ quint64 endSceneSleepTime = 0;
 OctreeSendThread::OctreeSendThread(OctreeServer* myServer, const SharedNodePointer& node) :
     _node(node),
     _myServer(myServer),
-    _nodeUuid(node->getUUID())
+    _nodeUuid(node->getUUID()),
+    _initialLoadStart(usecTimestampNow())
 {
     QString safeServerName("Octree");
 
@@ -57,6 +58,7 @@ OctreeSendThread::~OctreeSendThread() {
     qDebug() << qPrintable(safeServerName)  << "server [" << _myServer << "]: client disconnected "
                                             "- ending sending thread [" << this << "]";
 
+    setIsInitialLoad(false);
     OctreeServer::clientDisconnected();
     OctreeServer::stopTrackingThread(this);
 }
@@ -65,6 +67,30 @@ void OctreeSendThread::setIsShuttingDown() {
     _isShuttingDown = true;
 }
 
+void OctreeSendThread::setIsInitialLoad(bool isInitialLoad) {
+    if (isInitialLoad != _isInitialLoad) {
+        _isInitialLoad = isInitialLoad;
+        if (isInitialLoad) {
+            OctreeServer::clientStartedInitialLoad();
+        } else {
+            OctreeServer::clientFinishedInitialLoad();
+        }
+    }
+}
+
+void OctreeSendThread::finishInitialLoad() {
+    _hasFinishedInitialLoad = true;
+    setIsInitialLoad(false);
+}
+
+int OctreeSendThread::getMaxPacketsPerInterval(OctreeQueryNode* nodeData) const {
+    // the client caps what it wants to receive, the server what each client gets
+    int clientMaxPacketsPerInterval = std::max(1, (nodeData->getMaxQueryPacketsPerSecond() / INTERVALS_PER_SECOND));
+    int serverMaxPacketsPerInterval = _isInitialLoad ? _myServer->getInitialLoadPacketsPerClientPerInterval() :
+        _myServer->getPacketsPerClientPerInterval();
+    return std::min(clientMaxPacketsPerInterval, serverMaxPacketsPerInterval);
+}
+
 
 bool OctreeSendThread::process() {
     if (_isShuttingDown) {
@@ -320,6 +346,14 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
     _trueBytesSent = 0;
     _packetsSentThisInterval = 0;
 
+    // the server decides how long a node gets to load its initial scene: from connecting until its initial results are
+    // complete, once per connection and no longer than a fixed cap, however often the client asks for completion
+    const quint64 MAX_INITIAL_LOAD_USECS = 30 * USECS_PER_SECOND;
+    if (!_hasFinishedInitialLoad && usecTimestampNow() - _initialLoadStart > MAX_INITIAL_LOAD_USECS) {
+        _hasFinishedInitialLoad = true;
+    }
+    setIsInitialLoad(!_hasFinishedInitialLoad && nodeData->wantReportInitialCompletion());
+
     bool isFullScene = nodeData->shouldForceFullScene();
     if (isFullScene) {
         // we're forcing a full scene, clear the force in OctreeQueryNode so we don't force it next time again
@@ -332,6 +366,13 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
     } else {
         nodeData->resetOctreePacket();
     }
+
+    // every section of a packet has to be compressed with the same dictionary, so only switch between packets
+    if (!nodeData->isPacketWaiting()) {
+        updatePacketDataDictionary(node, nodeData);
+    }
+    _packetData.setCompressionDictionary(nodeData->getPacketDataDictionary());
+
     int targetSize = MAX_OCTREE_PACKET_DATA_SIZE;
     targetSize = nodeData->getAvailable() - sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
 
@@ -362,9 +403,8 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
 
     quint64 start = usecTimestampNow();
 
-    _myServer->getOctree()->withReadLock([&]{
-        traverseTreeAndSendContents(node, nodeData, viewFrustumChanged, isFullScene);
-    });
+    // the tree is only locked while we read from it, and not while we compress or send what we read
+    traverseTreeAndSendContents(node, nodeData, viewFrustumChanged, isFullScene);
 
     // Here's where we can/should allow the server to send other data...
     // send the environment packet
@@ -385,8 +425,7 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
     }
 
     // calculate max number of packets that can be sent during this interval
-    int clientMaxPacketsPerInterval = std::max(1, (nodeData->getMaxQueryPacketsPerSecond() / INTERVALS_PER_SECOND));
-    int maxPacketsPerInterval = std::min(clientMaxPacketsPerInterval, _myServer->getPacketsPerClientPerInterval());
+    int maxPacketsPerInterval = getMaxPacketsPerInterval(nodeData);
 
     // Re-send packets that were nacked by the client
     while (nodeData->hasNextNackedPacket() && _packetsSentThisInterval < maxPacketsPerInterval) {
@@ -404,6 +443,8 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
         }
     }
 
+    OctreeServer::trackPacketsSent(_packetsSentThisInterval, _isInitialLoad);
+
     quint64 end = usecTimestampNow();
     int elapsedmsec = (end - start) / USECS_PER_MSEC;
     OctreeServer::trackLoopTime(elapsedmsec);
@@ -424,10 +465,19 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
     return _truePacketsSent;
 }
 
+void OctreeSendThread::withTreeReadLock(const std::function<void()>& f) {
+    quint64 lockWaitStart = usecTimestampNow();
+    _myServer->getOctree()->withReadLock([&] {
+        quint64 lockStart = usecTimestampNow();
+        OctreeServer::trackTreeWaitTime((float)(lockStart - lockWaitStart));
+        f();
+        OctreeServer::trackTreeHoldTime((float)(usecTimestampNow() - lockStart));
+    });
+}
+
 bool OctreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, OctreeQueryNode* nodeData, bool viewFrustumChanged, bool isFullScene) {
     // calculate max number of packets that can be sent during this interval
-    int clientMaxPacketsPerInterval = std::max(1, (nodeData->getMaxQueryPacketsPerSecond() / INTERVALS_PER_SECOND));
-    int maxPacketsPerInterval = std::min(clientMaxPacketsPerInterval, _myServer->getPacketsPerClientPerInterval());
+    int maxPacketsPerInterval = getMaxPacketsPerInterval(nodeData);
 
     int extraPackingAttempts = 0;
 
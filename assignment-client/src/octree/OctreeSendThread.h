@@ -15,6 +15,7 @@
 #define hifi_OctreeSendThread_h
 
 #include <atomic>
+#include <functional>
 
 #include <GenericThread.h>
 #include <Node.h>
@@ -54,8 +55,18 @@ protected:
 
     virtual bool traverseTreeAndSendContents(SharedNodePointer node, OctreeQueryNode* nodeData,
             bool viewFrustumChanged, bool isFullScene);
+    // called without the tree lock, implementations take it for whatever part of the tree structure they read
     virtual bool traverseTreeAndBuildNextPacketPayload(EncodeBitstreamParams& params, const QJsonObject& jsonFilters) = 0;
 
+    // reads the tree under its read lock, tracking how long we waited for and then held the lock
+    void withTreeReadLock(const std::function<void()>& f);
+
+    // true while the node is loading its initial scene, which gets it a fair share of the server's spare bandwidth
+    bool isInitialLoad() const { return _isInitialLoad; }
+    // ends the node's initial load for good, once its initial results are complete
+    void finishInitialLoad();
+    int getMaxPacketsPerInterval(OctreeQueryNode* nodeData) const;
+
     OctreePacketData _packetData;
     QWeakPointer<Node> _node;
     OctreeServer* _myServer { nullptr };
@@ -64,8 +75,11 @@ protected:
 private:
     /// Called before a packetDistributor pass to allow for pre-distribution processing
     virtual void preDistributionProcessing() = 0;
+    /// Called between packets to pick the data dictionary the node's packets are compressed with
+    virtual void updatePacketDataDictionary(const SharedNodePointer& node, OctreeQueryNode* nodeData) {}
     int handlePacketSend(SharedNodePointer node, OctreeQueryNode* nodeData, bool dontSuppressDuplicate = false);
     int packetDistributor(SharedNodePointer node, OctreeQueryNode* nodeData, bool viewFrustumChanged);
+    void setIsInitialLoad(bool isInitialLoad);
 
     virtual bool hasSomethingToSend(OctreeQueryNode* nodeData) = 0;
     virtual bool shouldStartNewTraversal(OctreeQueryNode* nodeData, bool viewFrustumChanged) = 0;
@@ -74,6 +88,9 @@ private:
     int _trueBytesSent { 0 }; // available for debug stats
     int _packetsSentThisInterval { 0 }; // used for bandwidth throttle condition
     bool _isShuttingDown { false };
+    bool _isInitialLoad { false };
+    bool _hasFinishedInitialLoad { false };
+    quint64 _initialLoadStart { 0 };
 };
 
 #endif // hifi_OctreeSendThread_h
@@ -38,6 +38,10 @@
 Q_LOGGING_CATEGORY(octree_server, "hifi.octree-server")
 
 int OctreeServer::_clientCount = 0;
+std::atomic<int> OctreeServer::_initialLoadClientCount { 0 };
+std::atomic<int> OctreeServer::_settledPacketsThisWindow { 0 };
+std::atomic<quint64> OctreeServer::_settledPacketsWindowStart { 0 };
+std::atomic<int> OctreeServer::_settledPacketsPerInterval { 0 };
 const int MOVING_AVERAGE_SAMPLE_COUNTS = 1000;
 
 float OctreeServer::SKIP_TIME = -1.0f; // use this for trackXXXTime() calls for non-times
@@ -58,6 +62,7 @@ SimpleMovingAverage OctreeServer::_averageTreeWaitTime(MOVING_AVERAGE_SAMPLE_COU
 SimpleMovingAverage OctreeServer::_averageTreeShortWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
 SimpleMovingAverage OctreeServer::_averageTreeLongWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
 SimpleMovingAverage OctreeServer::_averageTreeExtraLongWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
+SimpleMovingAverage OctreeServer::_averageTreeHoldTime(MOVING_AVERAGE_SAMPLE_COUNTS);
 int OctreeServer::_extraLongTreeWait = 0;
 int OctreeServer::_longTreeWait = 0;
 int OctreeServer::_shortTreeWait = 0;
@@ -108,6 +113,7 @@ void OctreeServer::resetSendingStats() {
     _averageTreeShortWaitTime.reset();
     _averageTreeLongWaitTime.reset();
     _averageTreeExtraLongWaitTime.reset();
+    _averageTreeHoldTime.reset();
     _extraLongTreeWait = 0;
     _longTreeWait = 0;
     _shortTreeWait = 0;
@@ -160,6 +166,34 @@ void OctreeServer::trackEncodeTime(float time) {
     }
 }
 
+void OctreeServer::trackPacketsSent(int numPackets, bool isInitialLoad) {
+    if (!isInitialLoad) {
+        _settledPacketsThisWindow += numPackets;
+    }
+
+    // once a second, the send thread that notices turns the window into a per-interval rate
+    quint64 now = usecTimestampNow();
+    quint64 windowStart = _settledPacketsWindowStart;
+    quint64 windowUsecs = now - windowStart;
+    if (windowUsecs >= USECS_PER_SECOND && _settledPacketsWindowStart.compare_exchange_strong(windowStart, now)) {
+        float intervals = (float)windowUsecs / (float)OCTREE_SEND_INTERVAL_USECS;
+        _settledPacketsPerInterval = (int)ceilf((float)_settledPacketsThisWindow.exchange(0) / intervals);
+    }
+}
+
+int OctreeServer::getInitialLoadPacketsPerClientPerInterval() const {
+    int packetsPerClient = getPacketsPerClientPerInterval();
+    int loadingClients = getInitialLoadClientCount();
+    if (loadingClients <= 0) {
+        return packetsPerClient;
+    }
+
+    // a loading client never gets less than it would have had anyway, and may get much more when
+    // the settled clients are only sending the odd update
+    int available = getPacketsTotalPerInterval() - getSettledPacketsPerInterval();
+    return std::max(packetsPerClient, available / loadingClients);
+}
+
 void OctreeServer::trackTreeWaitTime(float time) {
     const float MAX_SHORT_TIME = 10.0f;
     const float MAX_LONG_TIME = 100.0f;
@@ -389,8 +423,16 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
 
         statsString += QString("        Configured Max PPS/Client: %1 pps/client\r\n")
             .arg(locale.toString((uint)getPacketsPerClientPerSecond()).rightJustified(COLUMN_WIDTH, ' '));
-        statsString += QString("        Configured Max PPS/Server: %1 pps/server\r\n\r\n")
+        statsString += QString("        Configured Max PPS/Server: %1 pps/server\r\n")
             .arg(locale.toString((uint)getPacketsTotalPerSecond()).rightJustified(COLUMN_WIDTH, ' '));
+        statsString += QString("           Settled Clients Using: %1 pps/server\r\n")
+            .arg(locale.toString((uint)(getSettledPacketsPerInterval() * INTERVALS_PER_SECOND))
+                .rightJustified(COLUMN_WIDTH, ' '));
+        statsString += QString("     Clients Loading Initial Scene: %1 clients\r\n")
+            .arg(locale.toString((uint)getInitialLoadClientCount()).rightJustified(COLUMN_WIDTH, ' '));
+        statsString += QString("          Initial Load PPS/Client: %1 pps/client\r\n\r\n")
+            .arg(locale.toString((uint)(getInitialLoadPacketsPerClientPerInterval() * INTERVALS_PER_SECOND))
+                .rightJustified(COLUMN_WIDTH, ' '));
 
 
         // display scene stats
@@ -514,6 +556,10 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
                                          (double)_averageTreeExtraLongWaitTime.getAverage(),
                                          (double)(extraLongVsTotal * AS_PERCENT), _extraLongTreeWait);
 
+        float averageTreeHoldTime = getAverageTreeHoldTime();
+        statsString += QString().sprintf("         Average tree lock hold time:    %9.2f usecs\r\n\r\n",
+                                         (double)averageTreeHoldTime);
+
         // traverse
         float averageTreeTraverseTime = getAverageTreeTraverseTime();
         statsString += QString().sprintf("          Average tree traverse time:    %9.2f usecs\r\n\r\n", (double)averageTreeTraverseTime);
@@ -655,6 +701,7 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         quint64 averageLockWaitTimePerElement = _octreeInboundPacketProcessor->getAverageLockWaitTimePerElement();
         quint64 totalElementsProcessed = _octreeInboundPacketProcessor->getTotalElementsProcessed();
         quint64 totalPacketsProcessed = _octreeInboundPacketProcessor->getTotalPacketsProcessed();
+        float averageElementsPerBatch = _octreeInboundPacketProcessor->getAverageElementsPerBatch();
 
         quint64 averageDecodeTime = _tree->getAverageDecodeTime();
         quint64 averageLookupTime = _tree->getAverageLookupTime();
@@ -680,6 +727,8 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             .arg(locale.toString((uint)totalElementsProcessed).rightJustified(COLUMN_WIDTH, ' '));
         statsString += QString().sprintf(" Average Inbound Elements/Packet: %f elements/packet\r\n",
                                          (double)averageElementsPerPacket);
+        statsString += QString().sprintf("  Average Inbound Elements/Batch: %f elements/batch\r\n",
+                                         (double)averageElementsPerBatch);
         statsString += QString("     Average Transit Time/Packet: %1 usecs\r\n")
             .arg(locale.toString((uint)averageTransitTimePerPacket).rightJustified(COLUMN_WIDTH, ' '));
         statsString += QString("     Average Process Time/Packet: %1 usecs\r\n")
@@ -1058,6 +1107,22 @@ void OctreeServer::readConfiguration() {
 
         qDebug() << "persistInterval=" << _persistInterval.count();
 
+        _persistLogInterval = OctreePersistThread::DEFAULT_CHANGE_LOG_INTERVAL;
+        result = -1;
+        readOptionInt(QString("persistLogInterval"), settingsSectionObject, result);
+        if (result != -1) {
+            _persistLogInterval = std::chrono::milliseconds(result);
+        }
+        qDebug() << "persistLogInterval=" << _persistLogInterval.count();
+
+        _persistLogMaxSize = OctreePersistThread::DEFAULT_CHANGE_LOG_MAX_SIZE;
+        result = -1;
+        readOptionInt(QString("persistLogMaxSize"), settingsSectionObject, result);
+        if (result > 0) {
+            _persistLogMaxSize = (qint64)result * BYTES_PER_KILOBYTE * BYTES_PER_KILOBYTE;
+        }
+        qDebug() << "persistLogMaxSize=" << _persistLogMaxSize;
+
         readOptionBool(QString("persistFileDownload"), settingsSectionObject, _persistFileDownload);
         qDebug() << "persistFileDownload=" << _persistFileDownload;
 
@@ -1186,7 +1251,7 @@ void OctreeServer::domainSettingsRequestComplete() {
 
         // now set up PersistThread
         _persistManager = new OctreePersistThread(_tree, _persistAbsoluteFilePath, _persistInterval, _debugTimestampNow,
-                                                 _persistAsFileType);
+                                                 _persistAsFileType, _persistLogInterval, _persistLogMaxSize);
         _persistManager->moveToThread(&_persistThread);
         connect(&_persistThread, &QThread::finished, _persistManager, &QObject::deleteLater);
         connect(&_persistThread, &QThread::started, _persistManager, &OctreePersistThread::start);
@@ -1220,7 +1285,8 @@ void OctreeServer::beginRunning() {
     srand((unsigned)time(0));
 
     // set up our OctreeServerPacketProcessor
-    _octreeInboundPacketProcessor = new OctreeInboundPacketProcessor(this);
+    _octreeInboundPacketProcessor = new OctreeInboundPacketProcessor(_tree, getMyEditNackType(),
+                                                                     _debugReceiving, _verboseDebug);
     _octreeInboundPacketProcessor->initialize(true);
 
     // Convert now to tm struct for local timezone
@@ -1444,6 +1510,8 @@ void OctreeServer::sendStatsPacket() {
     timingArray1["5. avgCompressAndWriteTime"] = getAverageCompressAndWriteTime();
     timingArray1["6. avgSendTime"] = getAveragePacketSendingTime();
     timingArray1["7. nodeWaitTime"] = getAverageNodeWaitTime();
+    timingArray1["8. treeLockWaitTime"] = getAverageTreeWaitTime();
+    timingArray1["9. treeLockHoldTime"] = getAverageTreeHoldTime();
 
     QJsonObject statsObject2;
     statsObject2["data"] = dataObject1;
@@ -1457,6 +1525,7 @@ void OctreeServer::sendStatsPacket() {
         dataArray2["1. packetQueue"] = (double)_octreeInboundPacketProcessor->packetsToProcessCount();
         dataArray2["2. totalPackets"] = (double)_octreeInboundPacketProcessor->getTotalPacketsProcessed();
         dataArray2["3. totalElements"] = (double)_octreeInboundPacketProcessor->getTotalElementsProcessed();
+        dataArray2["4. totalBatches"] = (double)_octreeInboundPacketProcessor->getTotalBatchesProcessed();
 
         timingArray2["1. avgTransitTimePerPacket"] = (double)_octreeInboundPacketProcessor->getAverageTransitTimePerPacket();
         timingArray2["2. avgProcessTimePerPacket"] = (double)_octreeInboundPacketProcessor->getAverageProcessTimePerPacket();
@@ -12,6 +12,7 @@
 #ifndef hifi_OctreeServer_h
 #define hifi_OctreeServer_h
 
+#include <atomic>
 #include <memory>
 
 #include <QStringList>
@@ -52,6 +53,9 @@ public:
     int getPacketsPerClientPerInterval() const { return std::min(_packetsPerClientPerInterval,
                                 std::max(1, getPacketsTotalPerInterval() / std::max(1, getCurrentClientCount()))); }
 
+    // clients still loading their initial scene share equally what the settled clients leave of the total
+    int getInitialLoadPacketsPerClientPerInterval() const;
+
     int getPacketsPerClientPerSecond() const { return getPacketsPerClientPerInterval() * INTERVALS_PER_SECOND; }
     int getPacketsTotalPerInterval() const { return _packetsTotalPerInterval; }
     int getPacketsTotalPerSecond() const { return getPacketsTotalPerInterval() * INTERVALS_PER_SECOND; }
@@ -60,6 +64,14 @@ public:
     static void clientConnected() { _clientCount++; }
     static void clientDisconnected() { _clientCount--; }
 
+    static int getInitialLoadClientCount() { return _initialLoadClientCount; }
+    static void clientStartedInitialLoad() { _initialLoadClientCount++; }
+    static void clientFinishedInitialLoad() { _initialLoadClientCount--; }
+
+    // every send thread reports what it sent each interval, so we know what the settled clients are using
+    static void trackPacketsSent(int numPackets, bool isInitialLoad);
+    static int getSettledPacketsPerInterval() { return _settledPacketsPerInterval; }
+
     bool isInitialLoadComplete() const { return (_persistManager) ? _persistManager->isInitialLoadComplete() : true; }
     bool isPersistEnabled() const { return (_persistManager) ? true : false; }
     quint64 getLoadElapsedTime() const { return (_persistManager) ? _persistManager->getLoadElapsedTime() : 0; }
@@ -99,6 +111,9 @@ public:
     static void trackTreeWaitTime(float time);
     static float getAverageTreeWaitTime() { return _averageTreeWaitTime.getAverage(); }
 
+    static void trackTreeHoldTime(float time) { _averageTreeHoldTime.updateAverage(time); }
+    static float getAverageTreeHoldTime() { return _averageTreeHoldTime.getAverage(); }
+
     static void trackTreeTraverseTime(float time) { _averageTreeTraverseTime.updateAverage(time); }
     static float getAverageTreeTraverseTime() { return _averageTreeTraverseTime.getAverage(); }
 
@@ -194,6 +209,8 @@ protected:
     QThread _persistThread;
 
     std::chrono::milliseconds _persistInterval;
+    std::chrono::milliseconds _persistLogInterval;
+    qint64 _persistLogMaxSize;
     bool _persistFileDownload;
     int _maxBackupVersions;
 
@@ -204,6 +221,10 @@ protected:
     SendThreads _sendThreads;
 
     static int _clientCount;
+    static std::atomic<int> _initialLoadClientCount;
+    static std::atomic<int> _settledPacketsThisWindow;
+    static std::atomic<quint64> _settledPacketsWindowStart;
+    static std::atomic<int> _settledPacketsPerInterval;
     static SimpleMovingAverage _averageLoopTime;
 
     static SimpleMovingAverage _averageEncodeTime;
@@ -221,6 +242,7 @@ protected:
     static SimpleMovingAverage _averageTreeShortWaitTime;
     static SimpleMovingAverage _averageTreeLongWaitTime;
     static SimpleMovingAverage _averageTreeExtraLongWaitTime;
+    static SimpleMovingAverage _averageTreeHoldTime;
     static int _extraLongTreeWait;
     static int _longTreeWait;
     static int _shortTreeWait;
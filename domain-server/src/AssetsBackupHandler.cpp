@@ -13,6 +13,7 @@
 
 #include <QJsonDocument>
 #include <QDate>
+#include <QFileInfo>
 #include <QtCore/QLoggingCategory>
 
 #if !defined(__clang__) && defined(__GNUC__)
@@ -40,6 +41,14 @@ static const QString MAPPINGS_FILE { "mappings.json" };
 static const QString ZIP_ASSETS_FOLDER { "files" };
 static const chrono::minutes MAX_REFRESH_TIME { 5 };
 
+static const int MAX_CONCURRENT_TRANSFERS { 8 };
+// an upload reads the whole asset in memory, past this many bytes uploads wait for the others to finish
+static const qint64 MAX_UPLOAD_BYTES_IN_FLIGHT { 256 * 1024 * 1024 };
+static const qint64 MAX_TRANSFER_BYTES_PER_SECOND { 32 * 1024 * 1024 };
+static const chrono::seconds TRANSFER_WINDOW { 1 };
+static const chrono::seconds PROGRESS_REPORT_INTERVAL { 10 };
+static const qint64 COPY_BLOCK_SIZE { 1024 * 1024 };
+
 Q_DECLARE_LOGGING_CATEGORY(asset_backup)
 Q_LOGGING_CATEGORY(asset_backup, "hifi.asset-backup");
 
@@ -60,6 +69,14 @@ void AssetsBackupHandler::setupRefreshTimer() {
     _mappingsRefreshTimer.setSingleShot(true);
     QObject::connect(&_mappingsRefreshTimer, &QTimer::timeout, this, &AssetsBackupHandler::refreshMappings);
 
+    _transferThrottleTimer.setSingleShot(true);
+    QObject::connect(&_transferThrottleTimer, &QTimer::timeout, this, [this] {
+        downloadNextMissingFiles();
+        if (_isRestoringAssets) {
+            restoreNextAssets();
+        }
+    });
+
     auto nodeList = DependencyManager::get<LimitedNodeList>();
     QObject::connect(nodeList.data(), &LimitedNodeList::nodeActivated, this, [this](SharedNodePointer node) {
         if (node->getType() == NodeType::AssetServer) {
@@ -171,6 +188,7 @@ std::pair<bool, float> AssetsBackupHandler::isAvailable(const QString& backupNam
 
 std::pair<bool, float> AssetsBackupHandler::getRecoveryStatus() {
     if (_assetsLeftToUpload.empty() &&
+        _assetUploadsInFlight == 0 &&
         _mappingsLeftToSet.empty() &&
         _mappingsLeftToDelete.empty() &&
         _mappingRequestsInFlight == 0) {
@@ -179,6 +197,7 @@ std::pair<bool, float> AssetsBackupHandler::getRecoveryStatus() {
 
     float progress = (float)_numRestoreOperations;
     progress -= (float)_assetsLeftToUpload.size();
+    progress -= (float)_assetUploadsInFlight;
     progress -= (float)_mappingRequestsInFlight;
     progress /= (float)_numRestoreOperations;
 
@@ -319,7 +338,7 @@ void AssetsBackupHandler::recoverBackup(const QString& backupName, QuaZip& zip)
                     continue;
                 }
 
-                writeAssetFile(asset, zipFile.readAll());
+                writeAssetFile(asset, zipFile);
             }
         }
 
@@ -395,7 +414,9 @@ void AssetsBackupHandler::consolidateBackup(const QString& backupName, QuaZip& z
             qCDebug(asset_backup) << "Could not open zip file:" << zipFile.getZipError();
             continue;
         }
-        zipFile.write(file.readAll());
+        while (!file.atEnd()) {
+            zipFile.write(file.read(COPY_BLOCK_SIZE));
+        }
         zipFile.close();
         if (zipFile.getZipError() != UNZ_OK) {
             qCDebug(asset_backup) << "Could not close zip file: " << zipFile.getZipError();
@@ -441,8 +462,6 @@ void AssetsBackupHandler::refreshMappings() {
 }
 
 void AssetsBackupHandler::downloadMissingFiles(const AssetUtils::Mappings& mappings) {
-    auto wasEmpty = _assetsLeftToRequest.empty();
-
     for (const auto& mapping : mappings) {
         const auto& hash = mapping.second;
         if (_assetsOnDisk.find(hash) == end(_assetsOnDisk)) {
@@ -450,40 +469,49 @@ void AssetsBackupHandler::downloadMissingFiles(const AssetUtils::Mappings& mappi
         }
     }
 
-    // If we were empty, that means no download chain was already going, start one.
-    if (wasEmpty) {
-        downloadNextMissingFile();
-    }
+    downloadNextMissingFiles();
 }
 
-void AssetsBackupHandler::downloadNextMissingFile() {
-    if (_assetsLeftToRequest.empty()) {
-        return;
-    }
-    auto hash = *begin(_assetsLeftToRequest);
-
+void AssetsBackupHandler::downloadNextMissingFiles() {
     auto assetClient = DependencyManager::get<AssetClient>();
-    auto assetRequest = assetClient->createRequest(hash);
 
-    QObject::connect(assetRequest, &AssetRequest::finished, this, [this](AssetRequest* request) {
-        if (request->getError() == AssetRequest::NoError) {
-            qCDebug(asset_backup) << "Backing up asset" << request->getHash();
+    // the assets being requested are a handful at most, so they're quickly skipped over
+    auto it = begin(_assetsLeftToRequest);
+    while (it != end(_assetsLeftToRequest) && (int)_assetsBeingRequested.size() < MAX_CONCURRENT_TRANSFERS) {
+        const auto hash = *it++;
+        if (_assetsBeingRequested.find(hash) != end(_assetsBeingRequested)) {
+            continue;
+        }
+        if (isTransferThrottled()) {
+            return;
+        }
+
+        auto assetRequest = assetClient->createRequest(hash);
 
-            bool success = writeAssetFile(request->getHash(), request->getData());
-            if (!success) {
-                qCCritical(asset_backup) << "Failed to write asset file" << request->getHash();
+        QObject::connect(assetRequest, &AssetRequest::finished, this, [this](AssetRequest* request) {
+            if (request->getError() == AssetRequest::NoError) {
+                qCDebug(asset_backup) << "Backing up asset" << request->getHash();
+
+                bool success = writeAssetFile(request->getHash(), request->getData());
+                if (!success) {
+                    qCCritical(asset_backup) << "Failed to write asset file" << request->getHash();
+                }
+                addTransferredBytes(request->getData().size());
+            } else {
+                qCCritical(asset_backup) << "Failed to backup asset" << request->getHash();
             }
-        } else {
-            qCCritical(asset_backup) << "Failed to backup asset" << request->getHash();
-        }
 
-        _assetsLeftToRequest.erase(request->getHash());
-        downloadNextMissingFile();
+            _assetsBeingRequested.erase(request->getHash());
+            _assetsLeftToRequest.erase(request->getHash());
+            reportTransferProgress();
+            downloadNextMissingFiles();
 
-        request->deleteLater();
-    });
+            request->deleteLater();
+        });
 
-    assetRequest->start();
+        _assetsBeingRequested.insert(hash);
+        assetRequest->start();
+    }
 }
 
 bool AssetsBackupHandler::writeAssetFile(const AssetUtils::AssetHash& hash, const QByteArray& data) {
@@ -506,6 +534,71 @@ bool AssetsBackupHandler::writeAssetFile(const AssetUtils::AssetHash& hash, cons
     return true;
 }
 
+bool AssetsBackupHandler::writeAssetFile(const AssetUtils::AssetHash& hash, QIODevice& source) {
+    QDir assetsDir { _assetsDirectory };
+    QFile file { assetsDir.filePath(hash) };
+    if (!file.open(QFile::WriteOnly)) {
+        qCCritical(asset_backup) << "Could not open asset file for write:" << file.fileName();
+        return false;
+    }
+
+    // copied a block at a time, so that large assets are never held in memory whole
+    while (!source.atEnd()) {
+        auto block = source.read(COPY_BLOCK_SIZE);
+        if (block.isEmpty() || file.write(block) != block.size()) {
+            qCCritical(asset_backup) << "Could not write data to file" << file.fileName();
+            file.remove();
+            return false;
+        }
+    }
+
+    _assetsOnDisk.insert(hash);
+
+    return true;
+}
+
+bool AssetsBackupHandler::isTransferThrottled() {
+    auto now = p_high_resolution_clock::now();
+    if (now - _transferWindowStart >= TRANSFER_WINDOW) {
+        _transferWindowStart = now;
+        _numBytesTransferredInWindow = 0;
+    }
+
+    if (_numBytesTransferredInWindow < MAX_TRANSFER_BYTES_PER_SECOND) {
+        return false;
+    }
+
+    // carry on with the transfers when the next window starts
+    if (!_transferThrottleTimer.isActive()) {
+        auto timeLeft = chrono::duration_cast<chrono::milliseconds>(_transferWindowStart + TRANSFER_WINDOW - now);
+        _transferThrottleTimer.start((int)timeLeft.count() + 1);
+    }
+    return true;
+}
+
+void AssetsBackupHandler::addTransferredBytes(qint64 numBytes) {
+    _numBytesTransferredInWindow += numBytes;
+    _numBytesTransferred += numBytes;
+}
+
+void AssetsBackupHandler::reportTransferProgress() {
+    auto now = p_high_resolution_clock::now();
+    if (now - _lastProgressReport < PROGRESS_REPORT_INTERVAL) {
+        return;
+    }
+    _lastProgressReport = now;
+
+    static const qint64 BYTES_PER_MEGABYTE { 1024 * 1024 };
+    if (!_assetsLeftToRequest.empty()) {
+        qCInfo(asset_backup) << "Backing up assets:" << _assetsLeftToRequest.size() << "left,"
+            << _numBytesTransferred / BYTES_PER_MEGABYTE << "MB transferred so far";
+    }
+    if (_isRestoringAssets) {
+        qCInfo(asset_backup) << "Restoring assets:" << _assetsLeftToUpload.size() + _assetUploadsInFlight << "left,"
+            << _numBytesTransferred / BYTES_PER_MEGABYTE << "MB transferred so far";
+    }
+}
+
 void AssetsBackupHandler::computeServerStateDifference(const AssetUtils::Mappings& currentMappings,
                                                        const AssetUtils::Mappings& newMappings) {
     _mappingsLeftToSet.reserve((int)newMappings.size());
@@ -547,35 +640,56 @@ void AssetsBackupHandler::computeServerStateDifference(const AssetUtils::Mapping
 }
 
 void AssetsBackupHandler::restoreAllAssets() {
-    restoreNextAsset();
+    _isRestoringAssets = true;
+    restoreNextAssets();
 }
 
-void AssetsBackupHandler::restoreNextAsset() {
+void AssetsBackupHandler::restoreNextAssets() {
     if (_assetsLeftToUpload.empty()) {
-        updateMappings();
+        if (_assetUploadsInFlight == 0) {
+            _isRestoringAssets = false;
+            updateMappings();
+        }
         return;
     }
 
-    auto hash = _assetsLeftToUpload.back();
-    _assetsLeftToUpload.pop_back();
-
-    auto assetFilename = _assetsDirectory + hash;
-
     auto assetClient = DependencyManager::get<AssetClient>();
-    auto request = assetClient->createUpload(assetFilename);
 
-    QObject::connect(request, &AssetUpload::finished, this, [this](AssetUpload* request) {
-        if (request->getError() != AssetUpload::NoError) {
-            qCCritical(asset_backup) << "Failed to restore asset:" << request->getFilename();
-            qCCritical(asset_backup) << "    Error:" << request->getErrorString();
+    while (!_assetsLeftToUpload.empty() && _assetUploadsInFlight < MAX_CONCURRENT_TRANSFERS) {
+        auto assetFilename = _assetsDirectory + _assetsLeftToUpload.back();
+        auto assetSize = QFileInfo(assetFilename).size();
+
+        // a single asset larger than the limit is still uploaded, on its own
+        if (_assetUploadsInFlight > 0 && _numUploadBytesInFlight + assetSize > MAX_UPLOAD_BYTES_IN_FLIGHT) {
+            return;
+        }
+        if (isTransferThrottled()) {
+            return;
         }
+        _assetsLeftToUpload.pop_back();
 
-        restoreNextAsset();
+        auto request = assetClient->createUpload(assetFilename);
 
-        request->deleteLater();
-    });
+        QObject::connect(request, &AssetUpload::finished, this, [this, assetSize](AssetUpload* request) {
+            if (request->getError() != AssetUpload::NoError) {
+                qCCritical(asset_backup) << "Failed to restore asset:" << request->getFilename();
+                qCCritical(asset_backup) << "    Error:" << request->getErrorString();
+            } else {
+                addTransferredBytes(assetSize);
+            }
 
-    request->start();
+            --_assetUploadsInFlight;
+            _numUploadBytesInFlight -= assetSize;
+            reportTransferProgress();
+            restoreNextAssets();
+
+            request->deleteLater();
+        });
+
+        ++_assetUploadsInFlight;
+        _numUploadBytesInFlight += assetSize;
+        request->start();
+    }
 }
 
 void AssetsBackupHandler::updateMappings() {
@@ -55,19 +55,31 @@ private:
     void checkForAssetsToDelete();
 
     void downloadMissingFiles(const AssetUtils::Mappings& mappings);
-    void downloadNextMissingFile();
+    void downloadNextMissingFiles();
     bool writeAssetFile(const AssetUtils::AssetHash& hash, const QByteArray& data);
+    bool writeAssetFile(const AssetUtils::AssetHash& hash, QIODevice& source);
 
     void computeServerStateDifference(const AssetUtils::Mappings& currentMappings,
                                       const AssetUtils::Mappings& newMappings);
     void restoreAllAssets();
-    void restoreNextAsset();
+    void restoreNextAssets();
     void updateMappings();
 
+    // Assets are transferred a few at a time, and at a bounded rate so that backups
+    // don't starve the asset server of the disk and bandwidth it needs to serve clients
+    bool isTransferThrottled();
+    void addTransferredBytes(qint64 numBytes);
+    void reportTransferProgress();
+
     QString _assetsDirectory;
     bool _assetServerEnabled { false };
 
     QTimer _mappingsRefreshTimer;
+    QTimer _transferThrottleTimer;
+    p_high_resolution_clock::time_point _transferWindowStart;
+    qint64 _numBytesTransferredInWindow { 0 };
+    qint64 _numBytesTransferred { 0 };
+    p_high_resolution_clock::time_point _lastProgressReport;
     p_high_resolution_clock::time_point _lastMappingsRefresh;
     AssetUtils::Mappings _currentMappings;
 
@@ -87,9 +99,13 @@ private:
 
     // Internal storage for backup in progress
     std::set<AssetUtils::AssetHash> _assetsLeftToRequest;
+    std::set<AssetUtils::AssetHash> _assetsBeingRequested;
 
     // Internal storage for restore in progress
+    bool _isRestoringAssets { false };
     std::vector<AssetUtils::AssetHash> _assetsLeftToUpload;
+    int _assetUploadsInFlight { 0 };
+    qint64 _numUploadBytesInFlight { 0 };
     std::vector<std::pair<AssetUtils::AssetPath, AssetUtils::AssetHash>> _mappingsLeftToSet;
     AssetUtils::AssetPathList _mappingsLeftToDelete;
     int _mappingRequestsInFlight { 0 };
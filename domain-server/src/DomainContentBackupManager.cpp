@@ -19,7 +19,6 @@
 #include <fstream>
 #include <time.h>
 
-#include <QBuffer>
 #include <QDateTime>
 #include <QDebug>
 #include <QDir>
@@ -330,28 +329,6 @@ void DomainContentBackupManager::recoverFromBackup(MiniPromise::Promise promise,
     });
 }
 
-void DomainContentBackupManager::recoverFromUploadedBackup(MiniPromise::Promise promise, QByteArray uploadedBackup) {
-
-    if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "recoverFromUploadedBackup", Q_ARG(MiniPromise::Promise, promise),
-                                  Q_ARG(QByteArray, uploadedBackup));
-        return;
-    }
-
-    qDebug() << "Recovering from uploaded content archive";
-
-    // create a buffer and then a QuaZip from that buffer
-    QBuffer uploadedBackupBuffer { &uploadedBackup };
-    QuaZip uploadedZip { &uploadedBackupBuffer };
-
-    QString backupName = MANUAL_BACKUP_PREFIX + "uploaded.zip";
-    bool success = recoverFromBackupZip(backupName, uploadedZip);
-
-    promise->resolve({
-        { "success", success }
-    });
-}
-
 void DomainContentBackupManager::recoverFromUploadedFile(MiniPromise::Promise promise, QString uploadedFilename) {
     if (QThread::currentThread() != thread()) {
         QMetaObject::invokeMethod(this, "recoverFromUploadedFile", Q_ARG(MiniPromise::Promise, promise),
@@ -23,6 +23,7 @@
 #include <QProcess>
 #include <QSharedMemory>
 #include <QRegularExpression>
+#include <QSaveFile>
 #include <QStandardPaths>
 #include <QTimer>
 #include <QUrlQuery>
@@ -65,6 +66,7 @@ Q_LOGGING_CATEGORY(domain_server_ice, "hifi.domain_server.ice")
 
 const QString ACCESS_TOKEN_KEY_PATH = "metaverse.access_token";
 const QString DomainServer::REPLACEMENT_FILE_EXTENSION = ".replace";
+static const QString TEMPORARY_CONTENT_FILEPATH { QDir::tempPath() + "/hifiUploadContent_XXXXXX.zip" };
 
 int const DomainServer::EXIT_CODE_REBOOT = 234923;
 
@@ -314,7 +316,8 @@ DomainServer::DomainServer(int argc, char* argv[]) :
     _contentManager.reset(new DomainContentBackupManager(getContentBackupDir(), backupRulesVariant.toList()));
 
     connect(_contentManager.get(), &DomainContentBackupManager::started, _contentManager.get(), [this](){
-        _contentManager->addBackupHandler(BackupHandlerPointer(new EntitiesBackupHandler(getEntitiesFilePath(), getEntitiesReplacementFilePath())));
+        _contentManager->addBackupHandler(BackupHandlerPointer(new EntitiesBackupHandler(getEntitiesFilePath(), getEntitiesReplacementFilePath(),
+                                                                                         getEntitiesChangeLogFilePath())));
         _contentManager->addBackupHandler(BackupHandlerPointer(new AssetsBackupHandler(getContentBackupDir(), isAssetServerEnabled())));
         _contentManager->addBackupHandler(BackupHandlerPointer(new ContentSettingsBackupHandler(_settingsManager)));
     });
@@ -768,6 +771,7 @@ void DomainServer::setupNodeListAndAssignments() {
 
     packetReceiver.registerListener(PacketType::OctreeDataFileRequest, this, "processOctreeDataRequestMessage");
     packetReceiver.registerListener(PacketType::OctreeDataPersist, this, "processOctreeDataPersistMessage");
+    packetReceiver.registerListener(PacketType::OctreeDataPersistChanges, this, "processOctreeDataPersistChangesMessage");
 
     packetReceiver.registerListener(PacketType::OctreeFileReplacement, this, "handleOctreeFileReplacementRequest");
     packetReceiver.registerListener(PacketType::DomainContentReplacementFromUrl, this, "handleDomainContentReplacementFromURLRequest");
@@ -1763,9 +1767,13 @@ void DomainServer::processOctreeDataPersistMessage(QSharedPointer<ReceivedMessag
     QFile f(filePath);
     if (f.open(QIODevice::WriteOnly)) {
         f.write(data);
+        // the new file includes all the changes sent before it
+        discardEntitiesChangeLog();
         OctreeUtils::RawEntityData entityData;
         if (entityData.readOctreeDataInfoFromData(data)) {
             qCDebug(domain_server) << "Wrote new entities file" << entityData.id << entityData.dataVersion;
+            _entitiesFileID = entityData.id;
+            _entitiesFileDataVersion = entityData.dataVersion;
         } else {
             qCDebug(domain_server) << "Failed to read new octree data info";
         }
@@ -1774,6 +1782,69 @@ void DomainServer::processOctreeDataPersistMessage(QSharedPointer<ReceivedMessag
     }
 }
 
+// In between full saves the entity server sends the records of its change log. They are appended to a log next to
+// the entities file, and only folded into it when the file is needed, so that they cost no more than the write.
+void DomainServer::processOctreeDataPersistChangesMessage(QSharedPointer<ReceivedMessage> message) {
+    constexpr size_t UUID_SIZE_BYTES = 16;
+    QUuid id = QUuid::fromRfc4122(message->read(UUID_SIZE_BYTES));
+    int64_t dataVersion;
+    message->readPrimitive(&dataVersion);
+    auto changes = message->readAll();
+
+    if (_entitiesFileID.isNull()) {
+        OctreeUtils::RawEntityData entityData;
+        if (entityData.readOctreeDataInfoFromFile(getEntitiesFilePath())) {
+            _entitiesFileID = entityData.id;
+            _entitiesFileDataVersion = entityData.dataVersion;
+        }
+    }
+
+    if (id != _entitiesFileID || dataVersion != _entitiesFileDataVersion) {
+        // the entity server sends its whole data once it is saved, which will replace ours
+        qCDebug(domain_server) << "Ignoring entity changes for ID(" << id << ") DataVersion(" << dataVersion
+                               << "), the entities file is ID(" << _entitiesFileID << ") DataVersion("
+                               << _entitiesFileDataVersion << ")";
+        return;
+    }
+
+    QFile changeLogFile(getEntitiesChangeLogFilePath());
+    if (!changeLogFile.open(QIODevice::WriteOnly | QIODevice::Append) || changeLogFile.write(changes) != changes.size()) {
+        qCWarning(domain_server) << "Failed to write entity changes to" << changeLogFile.fileName()
+                                 << changeLogFile.errorString();
+    }
+}
+
+void DomainServer::foldEntitiesChangeLog() {
+    QFile changeLogFile(getEntitiesChangeLogFilePath());
+    if (!changeLogFile.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    auto changeLog = changeLogFile.readAll();
+    changeLogFile.close();
+
+    OctreeUtils::RawEntityData data;
+    if (!data.readOctreeDataInfoFromFile(getEntitiesFilePath())) {
+        qCWarning(domain_server) << "Unable to read the entities file to apply entity changes to";
+        return;
+    }
+
+    int numRecords = data.applyChangeLog(changeLog);
+    QSaveFile entitiesFile(getEntitiesFilePath());
+    if (entitiesFile.open(QIODevice::WriteOnly) && entitiesFile.write(data.toGzippedByteArray()) != -1 && entitiesFile.commit()) {
+        qCDebug(domain_server) << "Applied" << numRecords << "entity changes to the entities file";
+        discardEntitiesChangeLog();
+    } else {
+        qCWarning(domain_server) << "Failed to apply entity changes to the entities file:" << entitiesFile.errorString();
+    }
+}
+
+void DomainServer::discardEntitiesChangeLog() {
+    QFile changeLogFile(getEntitiesChangeLogFilePath());
+    if (changeLogFile.exists() && !changeLogFile.remove()) {
+        qCWarning(domain_server) << "Failed to remove" << changeLogFile.fileName() << changeLogFile.errorString();
+    }
+}
+
 QString DomainServer::getContentBackupDir() {
     return PathUtils::getAppDataFilePath("backups");
 }
@@ -1790,10 +1861,15 @@ QString DomainServer::getEntitiesReplacementFilePath() {
     return getEntitiesFilePath().append(REPLACEMENT_FILE_EXTENSION);
 }
 
+QString DomainServer::getEntitiesChangeLogFilePath() {
+    return getEntitiesFilePath().append(".log");
+}
+
 void DomainServer::processOctreeDataRequestMessage(QSharedPointer<ReceivedMessage> message) {
     qDebug() << "Got request for octree data from " << message->getSenderSockAddr();
 
     maybeHandleReplacementEntityFile();
+    foldEntitiesChangeLog();
 
     bool remoteHasExistingData { false };
     QUuid id;
@@ -2566,8 +2642,6 @@ bool DomainServer::processPendingContent(HTTPConnection* connection, QString ite
     bool newUpload = itemName == "restore-file" || itemName == "restore-file-chunk-initial" || itemName == "restore-file-chunk-only";
 
     if (filename.endsWith(".zip", Qt::CaseInsensitive)) {
-        static const QString TEMPORARY_CONTENT_FILEPATH { QDir::tempPath() + "/hifiUploadContent_XXXXXX.zip" };
-
         if (_pendingContentFiles.find(sessionId) == _pendingContentFiles.end()) {
             if (!newUpload) {
                 return false;
@@ -3487,6 +3561,10 @@ void DomainServer::maybeHandleReplacementEntityFile() {
             data.resetIdAndVersion();
             auto gzippedData = data.toGzippedByteArray();
 
+            // changes made to the entities being replaced don't apply to the replacement
+            discardEntitiesChangeLog();
+            _entitiesFileID = QUuid();
+
             QFile currentFile(getEntitiesFilePath());
             if (!currentFile.open(QIODevice::WriteOnly)) {
                 qCWarning(domain_server)
@@ -3536,18 +3614,39 @@ void DomainServer::handleDomainContentReplacementFromURLRequest(QSharedPointer<R
 
         qDebug() << "Downloading JSON from: " << modelsURL;
 
-        connect(reply, &QNetworkReply::finished, [this, reply, modelsURL]() {
+        // content archives can be tens of GB, so they are written to disk as they arrive
+        std::shared_ptr<QTemporaryFile> archive;
+        if (modelsURL.fileName().endsWith(".zip")) {
+            archive = std::make_shared<QTemporaryFile>(TEMPORARY_CONTENT_FILEPATH);
+            if (!archive->open()) {
+                qWarning() << "Could not create a temporary file for the content archive at" << modelsURL;
+                reply->abort();
+                reply->deleteLater();
+                return;
+            }
+            connect(reply, &QNetworkReply::readyRead, [reply, archive]() {
+                archive->write(reply->readAll());
+            });
+        }
+
+        connect(reply, &QNetworkReply::finished, [this, reply, modelsURL, archive]() {
             QNetworkReply::NetworkError networkError = reply->error();
             if (networkError == QNetworkReply::NoError) {
                 if (modelsURL.fileName().endsWith(".json.gz")) {
                     handleOctreeFileReplacement(reply->readAll());
-                } else if (modelsURL.fileName().endsWith(".zip")) {
-                    auto deferred = makePromise("recoverFromUploadedBackup");
-                    _contentManager->recoverFromUploadedBackup(deferred, reply->readAll());
+                } else if (archive) {
+                    archive->write(reply->readAll());
+                    archive->close();
+
+                    auto deferred = makePromise("recoverFromUploadedFile");
+                    // the archive is removed once it has been recovered from
+                    deferred->then([archive](QString error, QVariantMap result) {});
+                    _contentManager->recoverFromUploadedFile(deferred, archive->fileName());
                 }
             } else {
                 qDebug() << "Error downloading JSON from specified file: " << modelsURL;
             }
+            reply->deleteLater();
         });
     }
 }
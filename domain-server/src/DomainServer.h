@@ -103,6 +103,7 @@ private slots:
 
     void processOctreeDataRequestMessage(QSharedPointer<ReceivedMessage> message);
     void processOctreeDataPersistMessage(QSharedPointer<ReceivedMessage> message);
+    void processOctreeDataPersistChangesMessage(QSharedPointer<ReceivedMessage> message);
 
     void setupPendingAssignmentCredits();
     void sendPendingTransactionsToServer();
@@ -148,8 +149,11 @@ private:
     QString getEntitiesDirPath();
     QString getEntitiesFilePath();
     QString getEntitiesReplacementFilePath();
+    QString getEntitiesChangeLogFilePath();
 
     void maybeHandleReplacementEntityFile();
+    void foldEntitiesChangeLog();
+    void discardEntitiesChangeLog();
 
     void setupNodeListAndAssignments();
     bool optionallySetupOAuth();
@@ -285,6 +289,10 @@ private:
 
     std::unique_ptr<DomainContentBackupManager> _contentManager { nullptr };
 
+    // the ID and version of the entities file, which the entity server's changes are only applied to if they match
+    QUuid _entitiesFileID;
+    int64_t _entitiesFileDataVersion { -1 };
+
     QHash<QUuid, QPointer<HTTPSConnection>> _pendingOAuthConnections;
 
     std::unordered_map<int, QByteArray> _pendingUploadedContents;
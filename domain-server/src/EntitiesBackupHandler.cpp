@@ -27,15 +27,24 @@
 
 #include <OctreeDataUtils.h>
 
-EntitiesBackupHandler::EntitiesBackupHandler(QString entitiesFilePath, QString entitiesReplacementFilePath) :
+EntitiesBackupHandler::EntitiesBackupHandler(QString entitiesFilePath, QString entitiesReplacementFilePath,
+                                             QString entitiesChangeLogFilePath) :
     _entitiesFilePath(entitiesFilePath),
-    _entitiesReplacementFilePath(entitiesReplacementFilePath)
+    _entitiesReplacementFilePath(entitiesReplacementFilePath),
+    _entitiesChangeLogFilePath(entitiesChangeLogFilePath)
 {
 }
 
 static const QString ENTITIES_BACKUP_FILENAME = "models.json.gz";
 
 void EntitiesBackupHandler::createBackup(const QString& backupName, QuaZip& zip) {
+    // the log is read first: if the entities file has its changes folded in meanwhile, applying them again is harmless
+    QByteArray changeLog;
+    QFile changeLogFile { _entitiesChangeLogFilePath };
+    if (changeLogFile.open(QIODevice::ReadOnly)) {
+        changeLog = changeLogFile.readAll();
+    }
+
     QFile entitiesFile { _entitiesFilePath };
 
     if (entitiesFile.open(QIODevice::ReadOnly)) {
@@ -45,6 +54,13 @@ void EntitiesBackupHandler::createBackup(const QString& backupName, QuaZip& zip)
             return;
         }
         auto entityData = entitiesFile.readAll();
+
+        // the entity server sends the changes it makes in between full saves, which the backup includes
+        OctreeUtils::RawEntityData data;
+        if (!changeLog.isEmpty() && data.readOctreeDataInfoFromData(entityData)) {
+            data.applyChangeLog(changeLog);
+            entityData = data.toGzippedByteArray();
+        }
         if (zipFile.write(entityData) != entityData.size()) {
             qCritical() << "Failed to write entities file to backup";
             zipFile.close();
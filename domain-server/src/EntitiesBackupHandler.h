@@ -16,7 +16,7 @@
 
 class EntitiesBackupHandler : public BackupHandlerInterface {
 public:
-    EntitiesBackupHandler(QString entitiesFilePath, QString entitiesReplacementFilePath);
+    EntitiesBackupHandler(QString entitiesFilePath, QString entitiesReplacementFilePath, QString entitiesChangeLogFilePath);
 
     std::pair<bool, float> isAvailable(const QString& backupName) override { return { true, 1.0f }; }
     std::pair<bool, float> getRecoveryStatus() override { return { false, 1.0f }; }
@@ -42,6 +42,7 @@ public:
 private:
     QString _entitiesFilePath;
     QString _entitiesReplacementFilePath;
+    QString _entitiesChangeLogFilePath;
 };
 
 #endif /* hifi_EntitiesBackupHandler_h */
@@ -936,6 +936,7 @@ bool setupEssentials(int& argc, char** argv, bool runningMarkerExisted) {
     DependencyManager::set<Snapshot>();
     DependencyManager::set<CloseEventSender>();
     DependencyManager::set<ResourceManager>();
+    DependencyManager::get<AssetClient>()->setPrefetchingEnabled(true);
     DependencyManager::set<SelectionScriptingInterface>();
     DependencyManager::set<Ledger>();
     DependencyManager::set<Wallet>();
@@ -6623,8 +6624,12 @@ void Application::update(float deltaTime) {
         // if it's been a while since our last query or the view has significantly changed then send a query, otherwise suppress it
         static const std::chrono::seconds MIN_PERIOD_BETWEEN_QUERIES { 3 };
         auto now = SteadyClock::now();
-        if (now > _queryExpiry || viewIsDifferentEnough) {
-            if (DependencyManager::get<SceneScriptingInterface>()->shouldRenderEntities()) {
+        // tell the entity server right away when we've got a new data dictionary so it can start compressing with it
+        bool shouldRenderEntities = DependencyManager::get<SceneScriptingInterface>()->shouldRenderEntities();
+        bool dataDictionaryChanged = shouldRenderEntities &&
+            _octreeQuery.getDataDictionaryID() != getEntities()->getDataDictionaryID();
+        if (now > _queryExpiry || viewIsDifferentEnough || dataDictionaryChanged) {
+            if (shouldRenderEntities) {
                 queryOctree(NodeType::EntityServer, PacketType::EntityQuery);
             }
             queryAvatars();
@@ -6917,13 +6922,27 @@ void Application::queryOctree(NodeType_t serverType, PacketType packetType) {
         _octreeQuery.setOctreeSizeScale(DEFAULT_OCTREE_SIZE_SCALE);
         static constexpr float MIN_LOD_ADJUST = -20.0f;
         _octreeQuery.setBoundaryLevelAdjust(MIN_LOD_ADJUST);
+
+        // ask for what we need before we can enable physics ahead of the rest: the zones and the things we
+        // could collide with, around where we spawned and where we are looking from
+        OctreeQuery::InterestRegions interestRegions;
+        interestRegions.push_back({ getMyAvatar()->getWorldPosition(), INITIAL_QUERY_RADIUS });
+        if (glm::distance(_viewFrustum.getPosition(), getMyAvatar()->getWorldPosition()) > INITIAL_QUERY_RADIUS) {
+            interestRegions.push_back({ _viewFrustum.getPosition(), INITIAL_QUERY_RADIUS });
+        }
+        _octreeQuery.setInterestRegions(interestRegions);
+        _octreeQuery.setInterestClasses(OctreeQuery::InterestInZones | OctreeQuery::InterestInCollidables);
     } else {
         _octreeQuery.setConicalViews(_conicalViews);
         auto lodManager = DependencyManager::get<LODManager>();
         _octreeQuery.setOctreeSizeScale(lodManager->getOctreeSizeScale());
         _octreeQuery.setBoundaryLevelAdjust(lodManager->getBoundaryLevelAdjust());
+        _octreeQuery.setInterestRegions({});
+        _octreeQuery.setInterestClasses(OctreeQuery::NoInterest);
     }
     _octreeQuery.setReportInitialCompletion(isModifiedQuery);
+    _octreeQuery.setWantDataDictionary(true);
+    _octreeQuery.setDataDictionaryID(getEntities()->getDataDictionaryID());
 
 
     auto nodeList = DependencyManager::get<NodeList>();
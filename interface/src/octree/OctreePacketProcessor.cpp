@@ -24,7 +24,8 @@ OctreePacketProcessor::OctreePacketProcessor():
 
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
     const PacketReceiver::PacketTypeList octreePackets =
-        { PacketType::OctreeStats, PacketType::EntityData, PacketType::EntityErase, PacketType::EntityQueryInitialResultsComplete };
+        { PacketType::OctreeStats, PacketType::EntityData, PacketType::EntityErase, PacketType::EntityQueryInitialResultsComplete,
+          PacketType::EntityDataDictionary };
     packetReceiver.registerDirectListenerForTypes(octreePackets, this, "handleOctreePacket");
 }
 
@@ -93,7 +94,7 @@ void OctreePacketProcessor::processPacket(QSharedPointer<ReceivedMessage> messag
         return; // bail since piggyback version doesn't match
     }
 
-    if (packetType != PacketType::EntityQueryInitialResultsComplete) {
+    if (packetType != PacketType::EntityQueryInitialResultsComplete && packetType != PacketType::EntityDataDictionary) {
         qApp->trackIncomingOctreePacket(*message, sendingNode, wasStatsPacket);
     }
     
@@ -120,6 +121,14 @@ void OctreePacketProcessor::processPacket(QSharedPointer<ReceivedMessage> messag
             }
         } break;
 
+        case PacketType::EntityDataDictionary: {
+            // processed here so it's in place before the data packets that follow it are
+            auto renderer = qApp->getEntities();
+            if (renderer) {
+                renderer->processDataDictionaryMessage(*message);
+            }
+        } break;
+
         case PacketType::EntityQueryInitialResultsComplete: {
             // Read sequence #
             OCTREE_PACKET_SEQUENCE completionNumber;
@@ -14,6 +14,7 @@
 
 #include <cstdio>
 #include <cstring>
+#include <mutex>
 #include <stdint.h>
 
 #include <QtCore/QDataStream>
@@ -40,6 +41,7 @@
 #include <Profile.h>
 #include <VariantMapToScriptValue.h>
 #include <BitVectorHelpers.h>
+#include <JointPacking.h>
 
 #include "AvatarLogging.h"
 #include "AvatarTraits.h"
@@ -685,22 +687,35 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
 
         float minRotationDOT = (distanceAdjust && cullSmallChanges) ? getDistanceBasedMinRotationDOT(viewerPosition) : AVATAR_MIN_ROTATION_DOT;
 
+        // numJoints fits in a byte, so the per-frame scratch space for the batch packing lives on the stack
+        const int MAX_JOINTS = 256;
+        uint8_t changedBits[MAX_JOINTS / BITS_IN_BYTE];
+        glm::quat rotationsToPack[MAX_JOINTS];
+        int numRotationsToPack = 0;
+
         int i = sendStatus.rotationsSent;
+        const bool checkRotationChanges = !sendAll && cullSmallChanges;
+        if (checkRotationChanges) {
+            computeJointRotationChangeBits(joints + i, lastSentJointData.data() + i, numJoints - i, minRotationDOT, changedBits);
+        }
+        const int firstRotation = i;
+
         for (; i < numJoints; ++i) {
             const JointData& data = joints[i];
             const JointData& last = lastSentJointData[i];
 
-            if (packetEnd - destinationBuffer >= minSizeForJoint) {
+            if (packetEnd - destinationBuffer - numRotationsToPack * (ptrdiff_t)sizeof(AvatarDataPacket::SixByteQuat) >= minSizeForJoint) {
                 if (!data.rotationIsDefaultPose) {
                     // The dot product for larger rotations is a lower number,
                     // so if the dot() is less than the value, then the rotation is a larger angle of rotation
+                    int bit = i - firstRotation;
                     if (sendAll || last.rotationIsDefaultPose || (!cullSmallChanges && last.rotation != data.rotation)
-                        || (cullSmallChanges && fabsf(glm::dot(last.rotation, data.rotation)) < minRotationDOT)) {
+                        || (checkRotationChanges && (changedBits[bit / BITS_IN_BYTE] & (1 << (bit % BITS_IN_BYTE))))) {
                         validityPosition[i / BITS_IN_BYTE] |= 1 << (i % BITS_IN_BYTE);
 #ifdef WANT_DEBUG
                         rotationSentCount++;
 #endif
-                        destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, data.rotation);
+                        rotationsToPack[numRotationsToPack++] = data.rotation;
 
                         if (sentJoints) {
                             sentJoints[i].rotation = data.rotation;
@@ -716,6 +731,7 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
             }
 
         }
+        destinationBuffer += packOrientationQuatsToSixBytes(destinationBuffer, rotationsToPack, numRotationsToPack);
         sendStatus.rotationsSent = i;
 
         // joint translation data
@@ -734,22 +750,31 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
 
         float minTranslation = (distanceAdjust && cullSmallChanges) ? getDistanceBasedMinTranslationDistance(viewerPosition) : AVATAR_MIN_TRANSLATION;
 
+        glm::vec3 translationsToPack[MAX_JOINTS];
+        int numTranslationsToPack = 0;
+
         i = sendStatus.translationsSent;
+        const bool checkTranslationChanges = !sendAll && cullSmallChanges;
+        if (checkTranslationChanges) {
+            computeJointTranslationChangeBits(joints + i, lastSentJointData.data() + i, numJoints - i, minTranslation, changedBits);
+        }
+        const int firstTranslation = i;
+
         for (; i < numJoints; ++i) {
             const JointData& data = joints[i];
             const JointData& last = lastSentJointData[i];
 
             // Note minSizeForJoint is conservative since there isn't a following bit-vector + scale.
-            if (packetEnd - destinationBuffer >= minSizeForJoint) {
+            if (packetEnd - destinationBuffer - numTranslationsToPack * (ptrdiff_t)sizeof(AvatarDataPacket::SixByteTrans) >= minSizeForJoint) {
                 if (!data.translationIsDefaultPose) {
+                    int bit = i - firstTranslation;
                     if (sendAll || last.translationIsDefaultPose || (!cullSmallChanges && last.translation != data.translation)
-                        || (cullSmallChanges && glm::distance(data.translation, lastSentJointData[i].translation) > minTranslation)) {
+                        || (checkTranslationChanges && (changedBits[bit / BITS_IN_BYTE] & (1 << (bit % BITS_IN_BYTE))))) {
                         validityPosition[i / BITS_IN_BYTE] |= 1 << (i % BITS_IN_BYTE);
 #ifdef WANT_DEBUG
                         translationSentCount++;
 #endif
-                        destinationBuffer += packFloatVec3ToSignedTwoByteFixed(destinationBuffer, data.translation / maxTranslationDimension,
-                                                                               TRANSLATION_COMPRESSION_RADIX);
+                        translationsToPack[numTranslationsToPack++] = data.translation;
 
                         if (sentJoints) {
                             sentJoints[i].translation = data.translation;
@@ -765,6 +790,8 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
             }
 
         }
+        destinationBuffer += packFloatVec3sToSignedTwoByteFixed(destinationBuffer, translationsToPack, numTranslationsToPack,
+                                                                maxTranslationDimension, TRANSLATION_COMPRESSION_RADIX);
         sendStatus.translationsSent = i;
 
         IF_AVATAR_SPACE(PACKET_HAS_GRAB_JOINTS, sizeof (AvatarDataPacket::FarGrabJoints)) {
@@ -1305,10 +1332,15 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
 
         const int COMPRESSED_QUATERNION_SIZE = 6;
         PACKET_READ_CHECK(JointRotations, numValidJointRotations * COMPRESSED_QUATERNION_SIZE);
-        for (int i = 0; i < numJoints; i++) {
+
+        // numJoints fits in a byte, so the unpacked joints can be staged on the stack
+        const int MAX_JOINTS = 256;
+        glm::quat unpackedRotations[MAX_JOINTS];
+        sourceBuffer += unpackOrientationQuatsFromSixBytes(sourceBuffer, unpackedRotations, numValidJointRotations);
+        for (int i = 0, j = 0; i < numJoints; i++) {
             JointData& data = _jointData[i];
             if (validRotations[i]) {
-                sourceBuffer += unpackOrientationQuatFromSixBytes(sourceBuffer, data.rotation);
+                data.rotation = unpackedRotations[j++];
                 _hasNewJointData = true;
                 data.rotationIsDefaultPose = false;
             }
@@ -1346,11 +1378,13 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
         const int COMPRESSED_TRANSLATION_SIZE = 6;
         PACKET_READ_CHECK(JointTranslation, numValidJointTranslations * COMPRESSED_TRANSLATION_SIZE);
 
-        for (int i = 0; i < numJoints; i++) {
+        glm::vec3 unpackedTranslations[MAX_JOINTS];
+        sourceBuffer += unpackFloatVec3sFromSignedTwoByteFixed(sourceBuffer, unpackedTranslations, numValidJointTranslations,
+                                                               TRANSLATION_COMPRESSION_RADIX);
+        for (int i = 0, j = 0; i < numJoints; i++) {
             JointData& data = _jointData[i];
             if (validTranslations[i]) {
-                sourceBuffer += unpackFloatVec3FromSignedTwoByteFixed(sourceBuffer, data.translation, TRANSLATION_COMPRESSION_RADIX);
-                data.translation *= maxTranslationDimension;
+                data.translation = unpackedTranslations[j++] * maxTranslationDimension;
                 _hasNewJointData = true;
                 data.translationIsDefaultPose = false;
             }
@@ -2016,66 +2050,56 @@ QUrl AvatarData::getWireSafeSkeletonModelURL() const {
         return QUrl();
     }
 }
-QByteArray AvatarData::packSkeletonData() const {
-    // Send an avatar trait packet with the skeleton data before the mesh is loaded
-    int avatarDataSize = 0;
-    QByteArray avatarDataByteArray;
-    _avatarSkeletonDataLock.withReadLock([&] {
-        // Add header
-        AvatarSkeletonTrait::Header header;
-        header.maxScaleDimension = 0.0f;
-        header.maxTranslationDimension = 0.0f;
-        header.numJoints = (uint8_t)_avatarSkeletonData.size();
-        header.stringTableLength = 0;
-
-        for (size_t i = 0; i < _avatarSkeletonData.size(); i++) {
-            header.stringTableLength += (uint16_t)_avatarSkeletonData[i].jointName.size();
-            auto& translation = _avatarSkeletonData[i].defaultTranslation;
-            header.maxTranslationDimension = std::max(header.maxTranslationDimension, std::max(std::max(translation.x, translation.y), translation.z));
-            header.maxScaleDimension = std::max(header.maxScaleDimension, _avatarSkeletonData[i].defaultScale);
-        }
-
-        const int byteArraySize = (int)sizeof(AvatarSkeletonTrait::Header) + (int)(header.numJoints * sizeof(AvatarSkeletonTrait::JointData)) + header.stringTableLength;
-        avatarDataByteArray = QByteArray(byteArraySize, 0);
-        unsigned char* destinationBuffer = reinterpret_cast<unsigned char*>(avatarDataByteArray.data());
-        const unsigned char* const startPosition = destinationBuffer;
-
-        memcpy(destinationBuffer, &header, sizeof(header));
-        destinationBuffer += sizeof(AvatarSkeletonTrait::Header);
-
-        QString stringTable = "";
-        for (size_t i = 0; i < _avatarSkeletonData.size(); i++) {
-            AvatarSkeletonTrait::JointData jdata;
-            jdata.boneType = _avatarSkeletonData[i].boneType;
-            jdata.parentIndex = _avatarSkeletonData[i].parentIndex;
-            packFloatRatioToTwoByte((uint8_t*)(&jdata.defaultScale), _avatarSkeletonData[i].defaultScale / header.maxScaleDimension);
-            packOrientationQuatToSixBytes(jdata.defaultRotation, _avatarSkeletonData[i].defaultRotation);
-            packFloatVec3ToSignedTwoByteFixed(jdata.defaultTranslation, _avatarSkeletonData[i].defaultTranslation / header.maxTranslationDimension, TRANSLATION_COMPRESSION_RADIX);
-            jdata.jointIndex = (uint16_t)i;
-            jdata.stringStart = (uint16_t)_avatarSkeletonData[i].stringStart;
-            jdata.stringLength = (uint8_t)_avatarSkeletonData[i].stringLength;
-            stringTable += _avatarSkeletonData[i].jointName;
-            memcpy(destinationBuffer, &jdata, sizeof(AvatarSkeletonTrait::JointData));
-            destinationBuffer += sizeof(AvatarSkeletonTrait::JointData);
-        }
-
-        memcpy(destinationBuffer, stringTable.toUtf8(), header.stringTableLength);
-        destinationBuffer += header.stringTableLength;
-
-        avatarDataSize = destinationBuffer - startPosition;
-    });
-    return avatarDataByteArray.left(avatarDataSize);
-}
+static QByteArray packSkeletonJoints(const std::vector<AvatarSkeletonTrait::UnpackedJointData>& joints) {
+    // Add header
+    AvatarSkeletonTrait::Header header;
+    header.maxScaleDimension = 0.0f;
+    header.maxTranslationDimension = 0.0f;
+    header.numJoints = (uint8_t)joints.size();
+    header.stringTableLength = 0;
 
-QByteArray AvatarData::packSkeletonModelURL() const {
-    return getWireSafeSkeletonModelURL().toEncoded();
-}
+    for (size_t i = 0; i < joints.size(); i++) {
+        header.stringTableLength += (uint16_t)joints[i].jointName.size();
+        auto& translation = joints[i].defaultTranslation;
+        header.maxTranslationDimension = std::max(header.maxTranslationDimension, std::max(std::max(translation.x, translation.y), translation.z));
+        header.maxScaleDimension = std::max(header.maxScaleDimension, joints[i].defaultScale);
+    }
 
-void AvatarData::unpackSkeletonData(const QByteArray& data) {
+    const int byteArraySize = (int)sizeof(AvatarSkeletonTrait::Header) + (int)(header.numJoints * sizeof(AvatarSkeletonTrait::JointData)) + header.stringTableLength;
+    QByteArray avatarDataByteArray = QByteArray(byteArraySize, 0);
+    unsigned char* destinationBuffer = reinterpret_cast<unsigned char*>(avatarDataByteArray.data());
+    const unsigned char* const startPosition = destinationBuffer;
 
+    memcpy(destinationBuffer, &header, sizeof(header));
+    destinationBuffer += sizeof(AvatarSkeletonTrait::Header);
+
+    QString stringTable = "";
+    for (size_t i = 0; i < joints.size(); i++) {
+        AvatarSkeletonTrait::JointData jdata;
+        jdata.boneType = joints[i].boneType;
+        jdata.parentIndex = joints[i].parentIndex;
+        packFloatRatioToTwoByte((uint8_t*)(&jdata.defaultScale), joints[i].defaultScale / header.maxScaleDimension);
+        packOrientationQuatToSixBytes(jdata.defaultRotation, joints[i].defaultRotation);
+        packFloatVec3ToSignedTwoByteFixed(jdata.defaultTranslation, joints[i].defaultTranslation / header.maxTranslationDimension, TRANSLATION_COMPRESSION_RADIX);
+        jdata.jointIndex = (uint16_t)i;
+        jdata.stringStart = (uint16_t)joints[i].stringStart;
+        jdata.stringLength = (uint8_t)joints[i].stringLength;
+        stringTable += joints[i].jointName;
+        memcpy(destinationBuffer, &jdata, sizeof(AvatarSkeletonTrait::JointData));
+        destinationBuffer += sizeof(AvatarSkeletonTrait::JointData);
+    }
+
+    memcpy(destinationBuffer, stringTable.toUtf8(), header.stringTableLength);
+    destinationBuffer += header.stringTableLength;
+
+    int avatarDataSize = destinationBuffer - startPosition;
+    return avatarDataByteArray.left(avatarDataSize);
+}
+
+static std::vector<AvatarSkeletonTrait::UnpackedJointData> unpackSkeletonJoints(const QByteArray& data) {
     const unsigned char* startPosition = reinterpret_cast<const unsigned char*>(data.data());
     const unsigned char* sourceBuffer = startPosition;
-    
+
     auto header = reinterpret_cast<const AvatarSkeletonTrait::Header*>(sourceBuffer);
     sourceBuffer += sizeof(const AvatarSkeletonTrait::Header);
 
@@ -2102,14 +2126,80 @@ void AvatarData::unpackSkeletonData(const QByteArray& data) {
         QStringRef subString(&table, joints[i].stringStart, joints[i].stringLength);
         joints[i].jointName = subString.toString();
     }
+    return joints;
+}
+
+// Crowds mostly wear a handful of avatars, so received skeletons are unpacked once and shared
+// by every avatar using them for as long as any of them does.
+static AvatarSkeletonTrait::SkeletonDataPointer internSkeletonData(const QByteArray& packedData) {
+    static std::mutex internedSkeletonsMutex;
+    static QHash<QByteArray, std::weak_ptr<const AvatarSkeletonTrait::SkeletonData>> internedSkeletons;
+
+    std::lock_guard<std::mutex> lock(internedSkeletonsMutex);
+    auto& internedSkeleton = internedSkeletons[packedData];
+    auto skeletonData = internedSkeleton.lock();
+    if (!skeletonData) {
+        auto newSkeletonData = std::make_shared<AvatarSkeletonTrait::SkeletonData>();
+        newSkeletonData->joints = unpackSkeletonJoints(packedData);
+        newSkeletonData->packedData = packedData;
+        skeletonData = newSkeletonData;
+        internedSkeleton = skeletonData;
+
+        // new skeletons are rare, take the opportunity to forget the ones nobody uses anymore
+        for (auto itr = internedSkeletons.begin(); itr != internedSkeletons.end();) {
+            if (itr.value().expired()) {
+                itr = internedSkeletons.erase(itr);
+            } else {
+                ++itr;
+            }
+        }
+    }
+    return skeletonData;
+}
+
+QByteArray AvatarData::packSkeletonData() const {
+    // Send an avatar trait packet with the skeleton data before the mesh is loaded
+    AvatarSkeletonTrait::SkeletonDataPointer skeletonData;
+    _avatarSkeletonDataLock.withReadLock([&] {
+        skeletonData = _avatarSkeletonData;
+    });
+    return skeletonData ? skeletonData->packedData : packSkeletonJoints({});
+}
+
+QByteArray AvatarData::packSkeletonModelURL() const {
+    return getWireSafeSkeletonModelURL().toEncoded();
+}
+
+void AvatarData::unpackSkeletonData(const QByteArray& data) {
+    auto skeletonData = internSkeletonData(data);
     if (_clientTraitsHandler) {
         _clientTraitsHandler->markTraitUpdated(AvatarTraits::SkeletonData);
     }
-    setSkeletonData(joints);
+    _avatarSkeletonDataLock.withWriteLock([&] {
+        _avatarSkeletonData = skeletonData;
+    });
+}
+
+// Parsed skeleton URLs are shared the same way, so that avatars wearing the same model share one QUrl.
+static QUrl internSkeletonModelURL(const QByteArray& encodedURL) {
+    // bounds the table if clients keep sending new URLs, it is simply refilled with the ones still in use
+    const int MAX_INTERNED_SKELETON_MODEL_URLS = 1024;
+    static std::mutex internedURLsMutex;
+    static QHash<QByteArray, QUrl> internedURLs;
+
+    std::lock_guard<std::mutex> lock(internedURLsMutex);
+    auto itr = internedURLs.find(encodedURL);
+    if (itr == internedURLs.end()) {
+        if (internedURLs.size() >= MAX_INTERNED_SKELETON_MODEL_URLS) {
+            internedURLs.clear();
+        }
+        itr = internedURLs.insert(encodedURL, QUrl::fromEncoded(encodedURL));
+    }
+    return itr.value();
 }
 
 void AvatarData::unpackSkeletonModelURL(const QByteArray& data) {
-    auto skeletonModelURL = QUrl::fromEncoded(data);
+    auto skeletonModelURL = internSkeletonModelURL(data);
     setSkeletonModelURL(skeletonModelURL);
 }
 
@@ -3138,17 +3228,20 @@ AABox AvatarData::computeBubbleBox(float bubbleScale) const {
 }
 
 void AvatarData::setSkeletonData(const std::vector<AvatarSkeletonTrait::UnpackedJointData>& skeletonData) {
+    auto newSkeletonData = std::make_shared<AvatarSkeletonTrait::SkeletonData>();
+    newSkeletonData->joints = skeletonData;
+    newSkeletonData->packedData = packSkeletonJoints(skeletonData);
     _avatarSkeletonDataLock.withWriteLock([&] {
-        _avatarSkeletonData = skeletonData;
+        _avatarSkeletonData = newSkeletonData;
     });
 }
 
 std::vector<AvatarSkeletonTrait::UnpackedJointData> AvatarData::getSkeletonData() const {
-    std::vector<AvatarSkeletonTrait::UnpackedJointData> skeletonData;
+    AvatarSkeletonTrait::SkeletonDataPointer skeletonData;
     _avatarSkeletonDataLock.withReadLock([&] {
         skeletonData = _avatarSkeletonData;
     });
-    return skeletonData;
+    return skeletonData ? skeletonData->joints : std::vector<AvatarSkeletonTrait::UnpackedJointData>();
 }
 
 void AvatarData::sendSkeletonData() const{
@@ -182,6 +182,13 @@ namespace AvatarSkeletonTrait {
         int parentIndex;
         QString jointName;
     };
+
+    // Avatars using the same skeleton share one immutable copy of it, interned by its packed trait data.
+    struct SkeletonData {
+        std::vector<UnpackedJointData> joints;
+        QByteArray packedData;
+    };
+    using SkeletonDataPointer = std::shared_ptr<const SkeletonData>;
 }
 
 namespace AvatarDataPacket {
@@ -1791,7 +1798,7 @@ protected:
     bool _avatarGrabDataChanged { false }; // by network
 
     mutable ReadWriteLockable _avatarSkeletonDataLock;
-    std::vector<AvatarSkeletonTrait::UnpackedJointData> _avatarSkeletonData;
+    AvatarSkeletonTrait::SkeletonDataPointer _avatarSkeletonData;
 
     // used to transform any sensor into world space, including the _hmdSensorMat, or hand controllers.
     ThreadSafeValueCache<glm::mat4> _sensorToWorldMatrixCache { glm::mat4() };
@@ -15,6 +15,11 @@
 
 #include "EntityPriorityQueue.h"
 
+// added to the priority of the classes of entities the viewer is interested in, which puts them ahead of any
+// entity that is merely in view since an angular size is never more than 2 pi
+static const float INTEREST_IN_ZONES_BOOST = 20.0f;
+static const float INTEREST_IN_COLLIDABLES_BOOST = 10.0f;
+
 DiffTraversal::Waypoint::Waypoint(EntityTreeElementPointer& element) : _nextIndex(0) {
     assert(element);
     _weakElement = element;
@@ -113,6 +118,16 @@ bool DiffTraversal::View::isVerySimilar(const View& view) const {
         return false;
     }
 
+    if (view.interestClasses != interestClasses || view.interestRegions.size() != interestRegions.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < interestRegions.size(); ++i) {
+        if (view.interestRegions[i].position != interestRegions[i].position ||
+            view.interestRegions[i].radius != interestRegions[i].radius) {
+            return false;
+        }
+    }
+
     for (size_t i = 0; i < size; ++i) {
         if (!viewFrustums[i].isVerySimilar(view.viewFrustums[i])) {
             return false;
@@ -159,6 +174,33 @@ float DiffTraversal::View::computePriority(const EntityItemPointer& entity) cons
         }
     }
 
+    if (hasInterest()) {
+        priority = computeInterestPriority(*entity, center, radius, priority);
+    }
+
+    return priority;
+}
+
+float DiffTraversal::View::computeInterestPriority(const EntityItem& entity, const glm::vec3& center, float radius,
+                                                   float priority) const {
+    // everything touching a region of interest is sent, whether it's in view or not, the nearer the sooner
+    for (const auto& region : interestRegions) {
+        float distance = glm::distance(center, region.position);
+        if (distance < region.radius + radius) {
+            priority = std::max(priority, radius / std::max(distance, radius));
+        }
+    }
+
+    // the classes only reorder what we were going to send anyway
+    if (priority == PrioritizedEntity::DO_NOT_SEND) {
+        return priority;
+    }
+    if ((interestClasses & OctreeQuery::InterestInZones) && entity.getType() == EntityTypes::Zone) {
+        priority += INTEREST_IN_ZONES_BOOST;
+    } else if ((interestClasses & OctreeQuery::InterestInCollidables) && entity.shouldBePhysical() &&
+               !entity.getCollisionless()) {
+        priority += INTEREST_IN_COLLIDABLES_BOOST;
+    }
     return priority;
 }
 
@@ -172,6 +214,11 @@ bool DiffTraversal::View::shouldTraverseElement(const EntityTreeElement& element
     auto center = cube.calcCenter(); // center of bounding sphere
     auto radius = 0.5f * SQRT_THREE * cube.getScale(); // radius of bounding sphere
 
+    if (any_of(begin(interestRegions), end(interestRegions), [&](const OctreeQuery::InterestRegion& region) {
+        return cube.touchesSphere(region.position, region.radius);
+    })) {
+        return true;
+    }
 
     return any_of(begin(viewFrustums), end(viewFrustums), [&](const ConicalViewFrustum& frustum) {
         auto position = center - frustum.getPosition(); // position of bounding sphere in view-frame
@@ -13,6 +13,7 @@
 #define hifi_DiffTraversal_h
 
 #include <shared/ConicalViewFrustum.h>
+#include <OctreeQuery.h>
 
 #include "EntityTreeElement.h"
 
@@ -35,9 +36,19 @@ public:
         bool shouldTraverseElement(const EntityTreeElement& element) const;
         float computePriority(const EntityItemPointer& entity) const;
 
+        bool hasInterest() const { return interestClasses != OctreeQuery::NoInterest || !interestRegions.empty(); }
+
         ConicalViewFrustums viewFrustums;
         uint64_t startTime { 0 };
         float lodScaleFactor { 1.0f };
+
+        // what the viewer wants ahead of everything else while it loads its initial scene
+        OctreeQuery::InterestRegions interestRegions;
+        uint8_t interestClasses { OctreeQuery::NoInterest };
+
+    private:
+        float computeInterestPriority(const EntityItem& entity, const glm::vec3& center, float radius,
+                                      float priority) const;
     };
 
     // Waypoint is an bookmark in a "path" of waypoints during a traversal.
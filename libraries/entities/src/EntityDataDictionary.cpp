@@ -0,0 +1,138 @@
+//
+//  EntityDataDictionary.cpp
+//  libraries/entities/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityDataDictionary.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <QtCore/QHash>
+
+#include "EntityItemProperties.h"
+
+static const int MIN_STRING_SIZE = 8; // shorter strings don't save anything over a zlib literal run
+static const int MAX_STRING_SIZE = EntityDataDictionary::MAX_SIZE / 8; // keep one big userData from crowding out the rest
+static const int MIN_DICTIONARY_SIZE = 256;
+
+static EntityPropertyFlags getDictionaryProperties() {
+    EntityPropertyFlags properties;
+    properties += PROP_NAME;
+    properties += PROP_USER_DATA;
+    properties += PROP_SCRIPT;
+    properties += PROP_SERVER_SCRIPTS;
+    properties += PROP_COLLISION_SOUND_URL;
+    properties += PROP_MODEL_URL;
+    properties += PROP_COMPOUND_SHAPE_URL;
+    properties += PROP_TEXTURES;
+    properties += PROP_ANIMATION_URL;
+    properties += PROP_SKYBOX_URL;
+    properties += PROP_AMBIENT_LIGHT_URL;
+    properties += PROP_SOURCE_URL;
+    properties += PROP_SCRIPT_URL;
+    properties += PROP_MATERIAL_URL;
+    properties += PROP_MATERIAL_DATA;
+    properties += PROP_IMAGE_URL;
+    return properties;
+}
+
+EntityDataDictionaryPointer EntityDataDictionary::build(const QVector<EntityItemPointer>& entities) {
+    static const EntityPropertyFlags DICTIONARY_PROPERTIES = getDictionaryProperties();
+
+    // the derived property flags alias each other, so only read the ones that belong to the entity's type
+    QHash<QByteArray, int> counts;
+    auto count = [&](const QString& string) {
+        if (string.size() >= MIN_STRING_SIZE) {
+            QByteArray utf8 = string.toUtf8();
+            if (utf8.size() <= MAX_STRING_SIZE) {
+                counts[utf8]++;
+            }
+        }
+    };
+    for (const auto& entity : entities) {
+        EntityItemProperties properties = entity->getProperties(DICTIONARY_PROPERTIES);
+        count(properties.getName());
+        count(properties.getUserData());
+        count(properties.getScript());
+        count(properties.getServerScripts());
+        count(properties.getCollisionSoundURL());
+        switch (entity->getType()) {
+            case EntityTypes::Model:
+                count(properties.getModelURL());
+                count(properties.getCompoundShapeURL());
+                count(properties.getTextures());
+                count(properties.getAnimation().getURL());
+                break;
+            case EntityTypes::Zone:
+                count(properties.getCompoundShapeURL());
+                count(properties.getSkybox().getURL());
+                count(properties.getAmbientLight().getAmbientURL());
+                break;
+            case EntityTypes::ParticleEffect:
+                count(properties.getTextures());
+                break;
+            case EntityTypes::Web:
+                count(properties.getSourceUrl());
+                count(properties.getScriptURL());
+                break;
+            case EntityTypes::Material:
+                count(properties.getMaterialURL());
+                count(properties.getMaterialData());
+                break;
+            case EntityTypes::Image:
+                count(properties.getImageURL());
+                break;
+            default:
+                break;
+        }
+    }
+
+    // a string saves its size in every section after the first one that carries it
+    struct Candidate {
+        QByteArray string;
+        int savings;
+    };
+    std::vector<Candidate> candidates;
+    for (auto itr = counts.constBegin(); itr != counts.constEnd(); ++itr) {
+        if (itr.value() > 1) {
+            candidates.push_back({ itr.key(), (itr.value() - 1) * itr.key().size() });
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.savings > b.savings || (a.savings == b.savings && a.string < b.string);
+    });
+
+    int size = 0;
+    int numStrings = 0;
+    while (numStrings < (int)candidates.size() && size + candidates[numStrings].string.size() <= MAX_SIZE) {
+        size += candidates[numStrings].string.size();
+        ++numStrings;
+    }
+    if (size < MIN_DICTIONARY_SIZE) {
+        return nullptr;
+    }
+
+    // zlib encodes nearer matches in fewer bits, so the most valuable strings go at the end
+    QByteArray data;
+    data.reserve(size);
+    for (int i = numStrings - 1; i >= 0; --i) {
+        data.append(candidates[i].string);
+    }
+    return std::make_shared<EntityDataDictionary>(data, numStrings);
+}
+
+EntityDataDictionary::EntityDataDictionary(const QByteArray& data, int numStrings) :
+    _data(data),
+    _numStrings(numStrings)
+{
+    _id = qHash(_data);
+    if (_id == 0) {
+        _id = 1; // 0 means no dictionary
+    }
+}
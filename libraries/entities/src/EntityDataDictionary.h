@@ -0,0 +1,47 @@
+//
+//  EntityDataDictionary.h
+//  libraries/entities/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityDataDictionary_h
+#define hifi_EntityDataDictionary_h
+
+#include <memory>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QVector>
+
+#include "EntityItem.h"
+
+class EntityDataDictionary;
+using EntityDataDictionaryPointer = std::shared_ptr<const EntityDataDictionary>;
+
+/// A zlib preset dictionary of the strings that repeat across a domain's entities: model, texture and script URLs,
+/// userData and the like. EntityData sections compressed with it don't each carry their own copy of those strings.
+/// The ID is a hash of the content, so a viewer holding a dictionary with the same ID can decode with it.
+class EntityDataDictionary {
+public:
+    static const int MAX_SIZE = 32 * 1024; // zlib doesn't look back any further
+    static const int MAX_SAMPLED_ENTITIES = 20000;
+
+    // returns nullptr when the entities don't repeat enough strings to make a dictionary worthwhile
+    static EntityDataDictionaryPointer build(const QVector<EntityItemPointer>& entities);
+
+    EntityDataDictionary(const QByteArray& data, int numStrings = 0);
+
+    uint32_t getID() const { return _id; }
+    const QByteArray& getData() const { return _data; }
+    int getNumStrings() const { return _numStrings; }
+
+private:
+    uint32_t _id;
+    QByteArray _data;
+    int _numStrings;
+};
+
+#endif // hifi_EntityDataDictionary_h
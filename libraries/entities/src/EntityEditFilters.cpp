@@ -11,10 +11,137 @@
 
 #include "EntityEditFilters.h"
 
+#include <list>
+#include <mutex>
+
 #include <QUrl>
 
+#include <NLPacket.h>
 #include <ResourceManager.h>
 
+static bool hadUncaughtExceptions(QScriptEngine& engine, const QString& fileName);
+
+// the result of running a filter on an edit, kept so that identical edits don't run the filter again
+struct EntityEditFilterResult {
+    enum Verdict { Reject, Accept, Modify };
+    Verdict verdict { Reject };
+    EntityItemProperties properties; // the properties the filter returned, when it modified the edit
+    bool wasChanged { false };
+};
+
+// A filter script loaded into its engine, and the results of the filter for the edits it has seen. Shared by the
+// copies of the filter's FilterData, so that removing a filter doesn't delete the engine under a running edit.
+class EntityEditFilterScript {
+public:
+    // returns null if the script threw while loading
+    static std::shared_ptr<EntityEditFilterScript> create(const QString& scriptContents, const QString& urlString);
+
+    const QString& getURL() const { return _urlString; }
+    QScriptEngine* engine() const { return _engine.get(); }
+    QScriptValue& filterFn() { return _filterFn; }
+
+    // the engine isn't reentrant, hold this while calling the filter
+    std::mutex& getMutex() { return _mutex; }
+
+    // returns an empty key if edits with these properties can't share a result
+    static QByteArray resultKey(const EntityItemID& entityID, EntityItemProperties& properties,
+                                const EntityPropertyFlags& specifiedProperties, EntityTree::FilterType filterType);
+    bool findResult(const QByteArray& key, EntityEditFilterResult& result);
+    void insertResult(const QByteArray& key, const EntityEditFilterResult& result);
+
+private:
+    static const int MAX_CACHED_RESULTS = 4096;
+
+    struct CachedResult {
+        EntityEditFilterResult result;
+        std::list<QByteArray>::iterator recentItr;
+    };
+
+    QString _urlString;
+    std::unique_ptr<QScriptEngine> _engine;
+    QScriptValue _filterFn; // must be destroyed before the engine
+    std::mutex _mutex;
+
+    std::mutex _resultsMutex;
+    std::list<QByteArray> _recentKeys; // most recently used first, the last one is evicted when the cache is full
+    QHash<QByteArray, CachedResult> _results;
+};
+
+std::shared_ptr<EntityEditFilterScript> EntityEditFilterScript::create(const QString& scriptContents,
+                                                                      const QString& urlString) {
+    auto filterScript = std::make_shared<EntityEditFilterScript>();
+    filterScript->_urlString = urlString;
+    filterScript->_engine.reset(new QScriptEngine());
+    QScriptEngine* engine = filterScript->_engine.get();
+    engine->evaluate(scriptContents);
+    if (hadUncaughtExceptions(*engine, urlString)) {
+        return nullptr;
+    }
+
+    auto global = engine->globalObject();
+    auto entitiesObject = engine->newObject();
+    entitiesObject.setProperty("ADD_FILTER_TYPE", EntityTree::FilterType::Add);
+    entitiesObject.setProperty("EDIT_FILTER_TYPE", EntityTree::FilterType::Edit);
+    entitiesObject.setProperty("PHYSICS_FILTER_TYPE", EntityTree::FilterType::Physics);
+    entitiesObject.setProperty("DELETE_FILTER_TYPE", EntityTree::FilterType::Delete);
+    global.setProperty("Entities", entitiesObject);
+    filterScript->_filterFn = global.property("filter");
+    return filterScript;
+}
+
+QByteArray EntityEditFilterScript::resultKey(const EntityItemID& entityID, EntityItemProperties& properties,
+                                             const EntityPropertyFlags& specifiedProperties,
+                                             EntityTree::FilterType filterType) {
+    // these aren't part of the edit encoding, so they can't be told apart by the key
+    if (specifiedProperties.getHasProperty(PROP_ENTITY_HOST_TYPE) || specifiedProperties.getHasProperty(PROP_OWNING_AVATAR_ID) ||
+        specifiedProperties.getHasProperty(PROP_VISIBLE_IN_SECONDARY_CAMERA)) {
+        return QByteArray();
+    }
+
+    // the edit's timestamp differs for every edit, so it is left out of the key, and out of what caching filters see
+    quint64 lastEdited = properties.getLastEdited();
+    properties.setLastEdited(0);
+    QByteArray key(NLPacket::maxPayloadSize(PacketType::EntityEdit), 0);
+    EntityPropertyFlags didntFit;
+    auto encodeResult = EntityItemProperties::encodeEntityEditPacket(PacketType::EntityEdit, entityID, properties, key,
+                                                                     specifiedProperties, didntFit);
+    properties.setLastEdited(lastEdited);
+
+    if (encodeResult != OctreeElement::COMPLETED) {
+        return QByteArray();
+    }
+    key.append((char)filterType);
+    return key;
+}
+
+bool EntityEditFilterScript::findResult(const QByteArray& key, EntityEditFilterResult& result) {
+    std::lock_guard<std::mutex> lock(_resultsMutex);
+    auto itr = _results.find(key);
+    if (itr == _results.end()) {
+        return false;
+    }
+    _recentKeys.splice(_recentKeys.begin(), _recentKeys, itr->recentItr);
+    result = itr->result;
+    return true;
+}
+
+void EntityEditFilterScript::insertResult(const QByteArray& key, const EntityEditFilterResult& result) {
+    std::lock_guard<std::mutex> lock(_resultsMutex);
+    auto itr = _results.find(key);
+    if (itr != _results.end()) {
+        _recentKeys.splice(_recentKeys.begin(), _recentKeys, itr->recentItr);
+        itr->result = result;
+        return;
+    }
+
+    if (_results.size() >= MAX_CACHED_RESULTS) {
+        _results.remove(_recentKeys.back());
+        _recentKeys.pop_back();
+    }
+    _recentKeys.push_front(key);
+    _results.insert(key, { result, _recentKeys.begin() });
+}
+
 QList<EntityItemID> EntityEditFilters::getZonesByPosition(glm::vec3& position) {
     QList<EntityItemID> zones;
     QList<EntityItemID> missingZones;
@@ -72,12 +199,55 @@ bool EntityEditFilters::filter(glm::vec3& position, EntityItemProperties& proper
                 return true; // accept the message
             }
 
-            auto oldProperties = propertiesIn.getDesiredProperties();
             auto specifiedProperties = propertiesIn.getChangedProperties();
+
+            // skip filters that told us which properties they look at, when the edit doesn't touch any of them.
+            // The intersection's last flag is negative when no flag is shared; isEmpty() wouldn't see that,
+            // since intersecting never resets the lowest flag.
+            if (!filterData.filteredProperties.isEmpty() && filterType != EntityTree::FilterType::Delete &&
+                (specifiedProperties & filterData.filteredProperties).lastFlag() < 0) {
+                _skipped++;
+                continue;
+            }
+
+            auto& filterScript = *filterData.script;
+
+            // filters that opted in get the result of an identical edit to the same entity, unless they also
+            // look at the entity or the zone, which aren't part of the key
+            QByteArray resultKey;
+            if (filterData.wantsResultCaching && !filterData.wantsOriginalProperties && !filterData.wantsZoneProperties) {
+                resultKey = EntityEditFilterScript::resultKey(itemID, propertiesIn, specifiedProperties, filterType);
+            }
+
+            EntityEditFilterResult cachedResult;
+            if (!resultKey.isEmpty() && filterScript.findResult(resultKey, cachedResult)) {
+                _cached++;
+                if (cachedResult.verdict == EntityEditFilterResult::Reject) {
+                    return false;
+                } else if (cachedResult.verdict == EntityEditFilterResult::Accept) {
+                    propertiesOut = propertiesIn;
+                    wasChanged = false;
+                } else {
+                    propertiesIn.merge(cachedResult.properties);
+                    propertiesOut.merge(cachedResult.properties);
+                    wasChanged |= cachedResult.wasChanged;
+                }
+                continue;
+            }
+
+            std::lock_guard<std::mutex> scriptLock(filterScript.getMutex());
+            QScriptEngine* engine = filterScript.engine();
+            _evaluated++;
+
+            auto oldProperties = propertiesIn.getDesiredProperties();
             propertiesIn.setDesiredProperties(specifiedProperties);
-            QScriptValue inputValues = propertiesIn.copyToScriptValue(filterData.engine, false, true, true);
+            QScriptValue inputValues = propertiesIn.copyToScriptValue(engine, false, true, true);
             propertiesIn.setDesiredProperties(oldProperties);
 
+            if (filterData.wantsResultCaching) {
+                inputValues.setProperty("lastEdited", QScriptValue());
+            }
+
             auto in = QJsonValue::fromVariant(inputValues.toVariant()); // grab json copy now, because the inputValues might be side effected by the filter.
 
             QScriptValueList args;
@@ -87,7 +257,7 @@ bool EntityEditFilters::filter(glm::vec3& position, EntityItemProperties& proper
             // get the current properties for then entity and include them for the filter call
             if (existingEntity && filterData.wantsOriginalProperties) {
                 auto currentProperties = existingEntity->getProperties(filterData.includedOriginalProperties);
-                QScriptValue currentValues = currentProperties.copyToScriptValue(filterData.engine, false, true, true);
+                QScriptValue currentValues = currentProperties.copyToScriptValue(engine, false, true, true);
                 args << currentValues;
             }
 
@@ -97,17 +267,17 @@ bool EntityEditFilters::filter(glm::vec3& position, EntityItemProperties& proper
                 auto zoneEntity = _tree->findEntityByEntityItemID(id);
                 if (zoneEntity) {
                     auto zoneProperties = zoneEntity->getProperties(filterData.includedZoneProperties);
-                    QScriptValue zoneValues = zoneProperties.copyToScriptValue(filterData.engine, false, true, true);
+                    QScriptValue zoneValues = zoneProperties.copyToScriptValue(engine, false, true, true);
 
                     if (filterData.wantsZoneBoundingBox) {
                         bool success = true;
                         AABox aaBox = zoneEntity->getAABox(success);
                         if (success) {
-                            QScriptValue boundingBox = filterData.engine->newObject();
-                            QScriptValue bottomRightNear = vec3ToScriptValue(filterData.engine, aaBox.getCorner());
-                            QScriptValue topFarLeft = vec3ToScriptValue(filterData.engine, aaBox.calcTopFarLeft());
-                            QScriptValue center = vec3ToScriptValue(filterData.engine, aaBox.calcCenter());
-                            QScriptValue boundingBoxDimensions = vec3ToScriptValue(filterData.engine, aaBox.getDimensions());
+                            QScriptValue boundingBox = engine->newObject();
+                            QScriptValue bottomRightNear = vec3ToScriptValue(engine, aaBox.getCorner());
+                            QScriptValue topFarLeft = vec3ToScriptValue(engine, aaBox.calcTopFarLeft());
+                            QScriptValue center = vec3ToScriptValue(engine, aaBox.calcCenter());
+                            QScriptValue boundingBoxDimensions = vec3ToScriptValue(engine, aaBox.getDimensions());
                             boundingBox.setProperty("brn", bottomRightNear);
                             boundingBox.setProperty("tfl", topFarLeft);
                             boundingBox.setProperty("center", center);
@@ -128,12 +298,13 @@ bool EntityEditFilters::filter(glm::vec3& position, EntityItemProperties& proper
                 }
             }
 
-            QScriptValue result = filterData.filterFn.call(_nullObjectForFilter, args);
+            QScriptValue result = filterScript.filterFn().call(_nullObjectForFilter, args);
 
-            if (filterData.uncaughtExceptions()) {
+            if (hadUncaughtExceptions(*engine, filterScript.getURL())) {
                 return false;
             }
 
+            EntityEditFilterResult filterResult;
             if (result.isObject()) {
                 // make propertiesIn reflect the changes, for next filter...
                 propertiesIn.copyFromScriptValue(result, false);
@@ -141,20 +312,29 @@ bool EntityEditFilters::filter(glm::vec3& position, EntityItemProperties& proper
                 // and update propertiesOut too.  TODO: this could be more efficient...
                 propertiesOut.copyFromScriptValue(result, false);
                 // Javascript objects are == only if they are the same object. To compare arbitrary values, we need to use JSON.
-                auto out = QJsonValue::fromVariant(result.toVariant());
+                auto resultValues = result.toVariant();
+                auto out = QJsonValue::fromVariant(resultValues);
                 wasChanged |= (in != out);
-            } else if (result.isBool()) {
 
-                // if the filter returned false, then it's authoritative
-                if (!result.toBool()) {
-                    return false;
+                if (!resultKey.isEmpty()) {
+                    filterResult.properties.copyFromScriptValue(result, false);
                 }
-
-                // otherwise, assume it wants to pass all properties
+                filterResult.verdict = EntityEditFilterResult::Modify;
+                filterResult.wasChanged = (in != out);
+            } else if (result.isBool() && result.toBool()) {
+                // if the filter returned true, assume it wants to pass all properties
                 propertiesOut = propertiesIn;
                 wasChanged = false;
-                
-            } else {
+
+                filterResult.verdict = EntityEditFilterResult::Accept;
+            }
+
+            if (!resultKey.isEmpty()) {
+                filterScript.insertResult(resultKey, filterResult);
+            }
+
+            // if the filter returned false (or anything else), then it's authoritative
+            if (filterResult.verdict == EntityEditFilterResult::Reject) {
                 return false;
             }
         }
@@ -164,11 +344,8 @@ bool EntityEditFilters::filter(glm::vec3& position, EntityItemProperties& proper
 }
 
 void EntityEditFilters::removeFilter(EntityItemID entityID) {
+    // the filter's engine goes away once an edit still running it is done with it
     QWriteLocker writeLock(&_lock);
-    FilterData filterData = _filterDataMap.value(entityID);
-    if (filterData.valid()) {
-        delete filterData.engine;
-    }
     _filterDataMap.remove(entityID);
 }
 
@@ -247,132 +424,140 @@ static bool hadUncaughtExceptions(QScriptEngine& engine, const QString& fileName
     return false;
 }
 
-void EntityEditFilters::scriptRequestFinished(EntityItemID entityID) {
-    qDebug() << "script request completed for entity " << entityID;
-    auto scriptRequest = qobject_cast<ResourceRequest*>(sender());
-    if (scriptRequest && scriptRequest->getResult() == ResourceRequest::Success) {
-        const QString urlString = scriptRequest->getUrl().toString();
-        auto scriptContents = scriptRequest->getData();
-        qInfo() << "Downloaded script:" << scriptContents;
-        QScriptProgram program(scriptContents, urlString);
-        if (hasCorrectSyntax(program)) {
-            // create a QScriptEngine for this script
-            QScriptEngine* engine = new QScriptEngine();
-            engine->evaluate(scriptContents);
-            if (!hadUncaughtExceptions(*engine, urlString)) {
-                // put the engine in the engine map (so we don't leak them, etc...)
-                FilterData filterData;
-                filterData.engine = engine;
-                filterData.rejectAll = false;
-                
-                // define the uncaughtException function
-                QScriptEngine& engineRef = *engine;
-                filterData.uncaughtExceptions = [&engineRef, urlString]() { return hadUncaughtExceptions(engineRef, urlString); };
-
-                // now get the filter function
-                auto global = engine->globalObject();
-                auto entitiesObject = engine->newObject();
-                entitiesObject.setProperty("ADD_FILTER_TYPE", EntityTree::FilterType::Add);
-                entitiesObject.setProperty("EDIT_FILTER_TYPE", EntityTree::FilterType::Edit);
-                entitiesObject.setProperty("PHYSICS_FILTER_TYPE", EntityTree::FilterType::Physics);
-                entitiesObject.setProperty("DELETE_FILTER_TYPE", EntityTree::FilterType::Delete);
-                global.setProperty("Entities", entitiesObject);
-                filterData.filterFn = global.property("filter");
-                if (!filterData.filterFn.isFunction()) {
-                    qDebug() << "Filter function specified but not found. Will reject all edits for those without lock rights.";
-                    delete engine;
-                    filterData.rejectAll=true;
-                }
+bool EntityEditFilters::setFilterScript(EntityItemID entityID, const QString& scriptContents, const QString& urlString) {
+    QScriptProgram program(scriptContents, urlString);
+    if (hasCorrectSyntax(program)) {
+        // create a QScriptEngine for this script
+        auto filterScript = EntityEditFilterScript::create(scriptContents, urlString);
+        if (filterScript) {
+            // keep the engine in the filter's script (so we don't leak it, etc...)
+            FilterData filterData;
+            filterData.script = filterScript;
+            filterData.rejectAll = false;
+
+            // now get the filter function
+            QScriptValue& filterFn = filterScript->filterFn();
+            if (!filterFn.isFunction()) {
+                qDebug() << "Filter function specified but not found. Will reject all edits for those without lock rights.";
+                filterData.script.reset();
+                filterData.rejectAll=true;
+            }
 
-                // if the wantsToFilterEdit is a boolean evaluate as a boolean, otherwise assume true
-                QScriptValue wantsToFilterAddValue = filterData.filterFn.property("wantsToFilterAdd");
-                filterData.wantsToFilterAdd = wantsToFilterAddValue.isBool() ? wantsToFilterAddValue.toBool() : true;
-
-                // if the wantsToFilterEdit is a boolean evaluate as a boolean, otherwise assume true
-                QScriptValue wantsToFilterEditValue = filterData.filterFn.property("wantsToFilterEdit");
-                filterData.wantsToFilterEdit = wantsToFilterEditValue.isBool() ? wantsToFilterEditValue.toBool() : true;
-
-                // if the wantsToFilterPhysics is a boolean evaluate as a boolean, otherwise assume true
-                QScriptValue wantsToFilterPhysicsValue = filterData.filterFn.property("wantsToFilterPhysics");
-                filterData.wantsToFilterPhysics = wantsToFilterPhysicsValue.isBool() ? wantsToFilterPhysicsValue.toBool() : true;
-
-                // if the wantsToFilterDelete is a boolean evaluate as a boolean, otherwise assume false
-                QScriptValue wantsToFilterDeleteValue = filterData.filterFn.property("wantsToFilterDelete");
-                filterData.wantsToFilterDelete = wantsToFilterDeleteValue.isBool() ? wantsToFilterDeleteValue.toBool() : false;
-
-                // check to see if the filterFn has properties asking for Original props
-                QScriptValue wantsOriginalPropertiesValue = filterData.filterFn.property("wantsOriginalProperties");
-                // if the wantsOriginalProperties is a boolean, or a string, or list of strings, then evaluate as follows:
-                //   - boolean - true  - include all original properties
-                //               false - no properties at all
-                //   - string  - empty - no properties at all
-                //               any valid property - include just that property in the Original properties
-                //   - list of strings - include only those properties in the Original properties
-                if (wantsOriginalPropertiesValue.isBool()) {
-                    filterData.wantsOriginalProperties = wantsOriginalPropertiesValue.toBool();
-                } else if (wantsOriginalPropertiesValue.isString()) {
-                    auto stringValue = wantsOriginalPropertiesValue.toString();
-                    filterData.wantsOriginalProperties = !stringValue.isEmpty();
-                    if (filterData.wantsOriginalProperties) {
-                        EntityPropertyFlagsFromScriptValue(wantsOriginalPropertiesValue, filterData.includedOriginalProperties);
-                    }
-                } else if (wantsOriginalPropertiesValue.isArray()) {
+            // if the wantsToFilterEdit is a boolean evaluate as a boolean, otherwise assume true
+            QScriptValue wantsToFilterAddValue = filterFn.property("wantsToFilterAdd");
+            filterData.wantsToFilterAdd = wantsToFilterAddValue.isBool() ? wantsToFilterAddValue.toBool() : true;
+
+            // if the wantsToFilterEdit is a boolean evaluate as a boolean, otherwise assume true
+            QScriptValue wantsToFilterEditValue = filterFn.property("wantsToFilterEdit");
+            filterData.wantsToFilterEdit = wantsToFilterEditValue.isBool() ? wantsToFilterEditValue.toBool() : true;
+
+            // if the wantsToFilterPhysics is a boolean evaluate as a boolean, otherwise assume true
+            QScriptValue wantsToFilterPhysicsValue = filterFn.property("wantsToFilterPhysics");
+            filterData.wantsToFilterPhysics = wantsToFilterPhysicsValue.isBool() ? wantsToFilterPhysicsValue.toBool() : true;
+
+            // if the wantsToFilterDelete is a boolean evaluate as a boolean, otherwise assume false
+            QScriptValue wantsToFilterDeleteValue = filterFn.property("wantsToFilterDelete");
+            filterData.wantsToFilterDelete = wantsToFilterDeleteValue.isBool() ? wantsToFilterDeleteValue.toBool() : false;
+
+            // check to see if the filterFn has properties asking for Original props
+            QScriptValue wantsOriginalPropertiesValue = filterFn.property("wantsOriginalProperties");
+            // if the wantsOriginalProperties is a boolean, or a string, or list of strings, then evaluate as follows:
+            //   - boolean - true  - include all original properties
+            //               false - no properties at all
+            //   - string  - empty - no properties at all
+            //               any valid property - include just that property in the Original properties
+            //   - list of strings - include only those properties in the Original properties
+            if (wantsOriginalPropertiesValue.isBool()) {
+                filterData.wantsOriginalProperties = wantsOriginalPropertiesValue.toBool();
+            } else if (wantsOriginalPropertiesValue.isString()) {
+                auto stringValue = wantsOriginalPropertiesValue.toString();
+                filterData.wantsOriginalProperties = !stringValue.isEmpty();
+                if (filterData.wantsOriginalProperties) {
                     EntityPropertyFlagsFromScriptValue(wantsOriginalPropertiesValue, filterData.includedOriginalProperties);
-                    filterData.wantsOriginalProperties = !filterData.includedOriginalProperties.isEmpty();
                 }
+            } else if (wantsOriginalPropertiesValue.isArray()) {
+                EntityPropertyFlagsFromScriptValue(wantsOriginalPropertiesValue, filterData.includedOriginalProperties);
+                filterData.wantsOriginalProperties = !filterData.includedOriginalProperties.isEmpty();
+            }
 
-                // check to see if the filterFn has properties asking for Zone props
-                QScriptValue wantsZonePropertiesValue = filterData.filterFn.property("wantsZoneProperties");
-                // if the wantsZoneProperties is a boolean, or a string, or list of strings, then evaluate as follows:
-                //   - boolean - true  - include all Zone properties
-                //               false - no properties at all
-                //   - string  - empty - no properties at all
-                //               any valid property - include just that property in the Zone properties
-                //   - list of strings - include only those properties in the Zone properties
-                if (wantsZonePropertiesValue.isBool()) {
-                    filterData.wantsZoneProperties = wantsZonePropertiesValue.toBool();
-                    filterData.wantsZoneBoundingBox = filterData.wantsZoneProperties; // include this too
-                } else if (wantsZonePropertiesValue.isString()) {
-                    auto stringValue = wantsZonePropertiesValue.toString();
-                    filterData.wantsZoneProperties = !stringValue.isEmpty();
-                    if (filterData.wantsZoneProperties) {
+            // check to see if the filterFn has properties asking for Zone props
+            QScriptValue wantsZonePropertiesValue = filterFn.property("wantsZoneProperties");
+            // if the wantsZoneProperties is a boolean, or a string, or list of strings, then evaluate as follows:
+            //   - boolean - true  - include all Zone properties
+            //               false - no properties at all
+            //   - string  - empty - no properties at all
+            //               any valid property - include just that property in the Zone properties
+            //   - list of strings - include only those properties in the Zone properties
+            if (wantsZonePropertiesValue.isBool()) {
+                filterData.wantsZoneProperties = wantsZonePropertiesValue.toBool();
+                filterData.wantsZoneBoundingBox = filterData.wantsZoneProperties; // include this too
+            } else if (wantsZonePropertiesValue.isString()) {
+                auto stringValue = wantsZonePropertiesValue.toString();
+                filterData.wantsZoneProperties = !stringValue.isEmpty();
+                if (filterData.wantsZoneProperties) {
+                    if (stringValue == "boundingBox") {
+                        filterData.wantsZoneBoundingBox = true;
+                    } else {
+                        EntityPropertyFlagsFromScriptValue(wantsZonePropertiesValue, filterData.includedZoneProperties);
+                    }
+                }
+            } else if (wantsZonePropertiesValue.isArray()) {
+                auto length = wantsZonePropertiesValue.property("length").toInteger();
+                for (int i = 0; i < length; i++) {
+                    auto stringValue = wantsZonePropertiesValue.property(i).toString();
+                    if (!stringValue.isEmpty()) {
+                        filterData.wantsZoneProperties = true;
+
+                        // boundingBox is a special case since it's not a true EntityPropertyFlag, so we
+                        // need to detect it here.
                         if (stringValue == "boundingBox") {
                             filterData.wantsZoneBoundingBox = true;
-                        } else {
-                            EntityPropertyFlagsFromScriptValue(wantsZonePropertiesValue, filterData.includedZoneProperties);
+                            break; // we can break here, since there are no other special cases
                         }
-                    }
-                } else if (wantsZonePropertiesValue.isArray()) {
-                    auto length = wantsZonePropertiesValue.property("length").toInteger();
-                    for (int i = 0; i < length; i++) {
-                        auto stringValue = wantsZonePropertiesValue.property(i).toString();
-                        if (!stringValue.isEmpty()) {
-                            filterData.wantsZoneProperties = true;
-
-                            // boundingBox is a special case since it's not a true EntityPropertyFlag, so we
-                            // need to detect it here.
-                            if (stringValue == "boundingBox") {
-                                filterData.wantsZoneBoundingBox = true;
-                                break; // we can break here, since there are no other special cases
-                            }
 
-                        }
-                    }
-                    if (filterData.wantsZoneProperties) {
-                        EntityPropertyFlagsFromScriptValue(wantsZonePropertiesValue, filterData.includedZoneProperties);
                     }
                 }
+                if (filterData.wantsZoneProperties) {
+                    EntityPropertyFlagsFromScriptValue(wantsZonePropertiesValue, filterData.includedZoneProperties);
+                }
+            }
 
-                _lock.lockForWrite();
-                _filterDataMap.insert(entityID, filterData);
-                _lock.unlock();
-
-                qDebug() << "script request filter processed for entity id " << entityID;
-                
-                emit filterAdded(entityID, true);
-                return;
+            // check to see if the filterFn tells us which of the edit's properties it looks at
+            QScriptValue wantsToFilterPropertiesValue = filterFn.property("wantsToFilterProperties");
+            // if the wantsToFilterProperties is a string or list of strings, then edits that don't change any
+            // of those properties are accepted without calling the filter
+            if (wantsToFilterPropertiesValue.isString() || wantsToFilterPropertiesValue.isArray()) {
+                EntityPropertyFlagsFromScriptValue(wantsToFilterPropertiesValue, filterData.filteredProperties);
             }
-        } 
+
+            // if the wantsResultCaching is a boolean evaluate as a boolean, otherwise assume false. Only filters whose
+            // result depends on nothing but the edit (not time, randomness, state or its lastEdited) should set it.
+            QScriptValue wantsResultCachingValue = filterFn.property("wantsResultCaching");
+            filterData.wantsResultCaching = wantsResultCachingValue.isBool() ? wantsResultCachingValue.toBool() : false;
+
+            _lock.lockForWrite();
+            _filterDataMap.insert(entityID, filterData);
+            _lock.unlock();
+
+            qDebug() << "script request filter processed for entity id " << entityID;
+        
+            emit filterAdded(entityID, true);
+            return true;
+        }
+    }
+    return false;
+}
+
+void EntityEditFilters::scriptRequestFinished(EntityItemID entityID) {
+    qDebug() << "script request completed for entity " << entityID;
+    auto scriptRequest = qobject_cast<ResourceRequest*>(sender());
+    if (scriptRequest && scriptRequest->getResult() == ResourceRequest::Success) {
+        const QString urlString = scriptRequest->getUrl().toString();
+        auto scriptContents = scriptRequest->getData();
+        qInfo() << "Downloaded script:" << scriptContents;
+        if (setFilterScript(entityID, scriptContents, urlString)) {
+            return;
+        }
     } else if (scriptRequest) {
         const QString urlString = scriptRequest->getUrl().toString();
         qCritical() << "Failed to download script";
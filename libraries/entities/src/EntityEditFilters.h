@@ -17,17 +17,20 @@
 #include <QScriptEngine>
 #include <glm/glm.hpp>
 
+#include <atomic>
 #include <functional>
+#include <memory>
 
 #include "EntityItemID.h"
 #include "EntityItemProperties.h"
 #include "EntityTree.h"
 
+class EntityEditFilterScript;
+
 class EntityEditFilters : public QObject, public Dependency {
     Q_OBJECT
 public:
     struct FilterData {
-        QScriptValue filterFn;
         bool wantsOriginalProperties { false };
         bool wantsZoneProperties { false };
 
@@ -40,23 +43,35 @@ public:
         EntityPropertyFlags includedZoneProperties;
         bool wantsZoneBoundingBox { false };
 
-        std::function<bool()> uncaughtExceptions;
-        QScriptEngine* engine;
+        // the properties the filter looks at, if it told us; edits that change none of them skip the filter
+        EntityPropertyFlags filteredProperties;
+
+        // whether the filter's result depends only on the edit, so it can be reused for identical edits to the same entity
+        bool wantsResultCaching { false };
+
+        // the filter script and its engine, shared by the copies of this FilterData
+        std::shared_ptr<EntityEditFilterScript> script;
         bool rejectAll;
         
-        FilterData(): engine(nullptr), rejectAll(false) {};
-        bool valid() { return (rejectAll || (engine != nullptr && filterFn.isFunction() && uncaughtExceptions)); }
+        FilterData(): rejectAll(false) {};
+        bool valid() { return (rejectAll || script); }
     };
 
     EntityEditFilters() {};
     EntityEditFilters(EntityTreePointer tree ): _tree(tree) {};
 
     void addFilter(EntityItemID entityID, QString filterURL);
+    // loads the filter from the contents of its script, which addFilter does once the script is downloaded
+    bool setFilterScript(EntityItemID entityID, const QString& scriptContents, const QString& urlString);
     void removeFilter(EntityItemID entityID);
 
     bool filter(glm::vec3& position, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged, 
                 EntityTree::FilterType filterType, EntityItemID& entityID, EntityItemPointer& existingEntity);
 
+    quint64 getEvaluatedCount() const { return _evaluated; }
+    quint64 getSkippedCount() const { return _skipped; }
+    quint64 getCachedCount() const { return _cached; }
+
 signals:
     void filterAdded(EntityItemID id, bool success);
 
@@ -72,6 +87,10 @@ private:
     
     QReadWriteLock _lock;
     QMap<EntityItemID, FilterData> _filterDataMap;
+
+    std::atomic<quint64> _evaluated { 0 };
+    std::atomic<quint64> _skipped { 0 };
+    std::atomic<quint64> _cached { 0 };
 };
 
 #endif //hifi_EntityEditFilters_h
@@ -544,6 +544,12 @@ public:
     void setSpaceIndex(int32_t index);
     int32_t getSpaceIndex() const { return _spaceIndex; }
 
+    // dense index assigned by the EntityTree while the entity is in its map, recycled once the entity is removed
+    static const uint32_t NO_SERVER_SLOT = UINT32_MAX;
+    void setServerSlot(uint32_t slot, quint64 assignedAt) { _serverSlot = slot; _serverSlotAssignedAt = assignedAt; }
+    uint32_t getServerSlot() const { return _serverSlot; }
+    quint64 getServerSlotAssignedAt() const { return _serverSlotAssignedAt; }
+
     virtual void preDelete();
     virtual void postParentFixup() {}
 
@@ -737,6 +743,8 @@ protected:
 
     float _boundingRadius { 0.0f };
     int32_t _spaceIndex { -1 }; // index to proxy in workload::Space
+    uint32_t _serverSlot { NO_SERVER_SLOT };
+    quint64 _serverSlotAssignedAt { 0 };
 
     // TODO: move this "scriptSimulationPriority" and "pendingOwnership" stuff into EntityMotionState
     // but first would need to do some other cleanup. In the meantime these live here as "scratch space"
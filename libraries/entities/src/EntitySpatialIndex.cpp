@@ -0,0 +1,119 @@
+//
+//  EntitySpatialIndex.cpp
+//  libraries/entities/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySpatialIndex.h"
+
+#include <cmath>
+
+const float EntitySpatialIndex::CELL_SIZE = 16.0f;
+
+int EntitySpatialIndex::cellCoordinate(float value) {
+    return (int)floorf(value / CELL_SIZE);
+}
+
+void EntitySpatialIndex::insert(const EntityItemPointer& entity, const AACube& elementCube) {
+    QWriteLocker locker(&_lock);
+    Location location;
+    if (elementCube.getScale() <= CELL_SIZE) {
+        const glm::vec3& corner = elementCube.getCorner();
+        location.cell = { cellCoordinate(corner.x), cellCoordinate(corner.y), cellCoordinate(corner.z) };
+        location.large = false;
+        auto& entities = _cells[location.cell];
+        location.index = entities.size();
+        entities.push_back(entity);
+    } else {
+        location.cell = { 0, 0, 0 };
+        location.large = true;
+        location.index = _large.size();
+        _large.push_back(entity);
+    }
+    _locations[entity.get()] = location;
+}
+
+void EntitySpatialIndex::removeAt(std::vector<EntityItemPointer>& entities, size_t index) {
+    if (index + 1 < entities.size()) {
+        entities[index] = std::move(entities.back());
+        _locations[entities[index].get()].index = index;
+    }
+    entities.pop_back();
+}
+
+void EntitySpatialIndex::remove(const EntityItemPointer& entity) {
+    QWriteLocker locker(&_lock);
+    auto itr = _locations.find(entity.get());
+    if (itr == _locations.end()) {
+        return;
+    }
+    Location location = itr->second;
+    _locations.erase(itr);
+
+    if (location.large) {
+        removeAt(_large, location.index);
+    } else {
+        auto cell = _cells.find(location.cell);
+        if (cell != _cells.end()) {
+            removeAt(cell->second, location.index);
+            if (cell->second.empty()) {
+                _cells.erase(cell);
+            }
+        }
+    }
+}
+
+void EntitySpatialIndex::clear() {
+    QWriteLocker locker(&_lock);
+    _cells.clear();
+    _large.clear();
+    _locations.clear();
+}
+
+int EntitySpatialIndex::size() const {
+    QReadLocker locker(&_lock);
+    return (int)_locations.size();
+}
+
+void EntitySpatialIndex::findCandidates(const AABox& box, std::vector<EntityItemPointer>& candidates) const {
+    QReadLocker locker(&_lock);
+    candidates.insert(candidates.end(), _large.begin(), _large.end());
+
+    // widen the box a hair so that entities in the cells it only touches on a face are still found
+    const float CELL_EPSILON = 0.001f;
+    glm::vec3 minimum = box.getMinimumPoint() - glm::vec3(CELL_EPSILON);
+    glm::vec3 maximum = box.getMaximumPoint() + glm::vec3(CELL_EPSILON);
+    int minX = cellCoordinate(minimum.x);
+    int minY = cellCoordinate(minimum.y);
+    int minZ = cellCoordinate(minimum.z);
+    int maxX = cellCoordinate(maximum.x);
+    int maxY = cellCoordinate(maximum.y);
+    int maxZ = cellCoordinate(maximum.z);
+
+    double cellsInBox = (double)(maxX - minX + 1) * (double)(maxY - minY + 1) * (double)(maxZ - minZ + 1);
+    if (cellsInBox > (double)_cells.size()) {
+        // the box covers more cells than are occupied, so check the occupied ones instead
+        for (auto& cell : _cells) {
+            const Cell& key = cell.first;
+            if (key.x >= minX && key.x <= maxX && key.y >= minY && key.y <= maxY && key.z >= minZ && key.z <= maxZ) {
+                candidates.insert(candidates.end(), cell.second.begin(), cell.second.end());
+            }
+        }
+        return;
+    }
+
+    for (int x = minX; x <= maxX; x++) {
+        for (int y = minY; y <= maxY; y++) {
+            for (int z = minZ; z <= maxZ; z++) {
+                auto cell = _cells.find({ x, y, z });
+                if (cell != _cells.end()) {
+                    candidates.insert(candidates.end(), cell->second.begin(), cell->second.end());
+                }
+            }
+        }
+    }
+}
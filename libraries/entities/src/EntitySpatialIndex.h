@@ -0,0 +1,69 @@
+//
+//  EntitySpatialIndex.h
+//  libraries/entities/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitySpatialIndex_h
+#define hifi_EntitySpatialIndex_h
+
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QReadWriteLock>
+
+#include <AABox.h>
+#include <AACube.h>
+
+#include "EntityItem.h"
+
+/// A flat grid over the entities in an EntityTree, so that region queries can visit the handful of cells they
+/// touch instead of recursing the octree. Each entity is filed under the cube of the octree element that holds it;
+/// since element cubes are power of two aligned, any element no larger than a cell falls in exactly one cell. The
+/// entities in larger elements are kept on a list that every query visits, as the octree visits its upper levels.
+/// The tree keeps the index up to date as entities are added to and removed from its elements.
+class EntitySpatialIndex {
+public:
+    static const float CELL_SIZE; // meters, a power of two
+
+    void insert(const EntityItemPointer& entity, const AACube& elementCube);
+    void remove(const EntityItemPointer& entity);
+    void clear();
+
+    int size() const;
+
+    /// Appends the entities filed in the cells the box touches. These are candidates: the caller tests each one.
+    void findCandidates(const AABox& box, std::vector<EntityItemPointer>& candidates) const;
+
+private:
+    struct Cell {
+        int x;
+        int y;
+        int z;
+        bool operator==(const Cell& other) const { return x == other.x && y == other.y && z == other.z; }
+    };
+    struct CellHash {
+        size_t operator()(const Cell& cell) const {
+            return (size_t)cell.x * 73856093 ^ (size_t)cell.y * 19349663 ^ (size_t)cell.z * 83492791;
+        }
+    };
+    struct Location {
+        Cell cell;
+        bool large;
+        size_t index;
+    };
+
+    static int cellCoordinate(float value);
+    void removeAt(std::vector<EntityItemPointer>& entities, size_t index);
+
+    mutable QReadWriteLock _lock;
+    std::unordered_map<Cell, std::vector<EntityItemPointer>, CellHash> _cells;
+    std::vector<EntityItemPointer> _large;
+    std::unordered_map<const EntityItem*, Location> _locations;
+};
+
+#endif // hifi_EntitySpatialIndex_h
@@ -11,6 +11,8 @@
 
 #include "EntityTree.h"
 #include <QtCore/QDateTime>
+#include <QtCore/QIODevice>
+#include <QtCore/QtEndian>
 #include <QtCore/QQueue>
 #include <openssl/err.h>
 #include <openssl/pem.h>
@@ -27,6 +29,7 @@
 #include <PerfStat.h>
 #include <Profile.h>
 #include <AddressManager.h>
+#include <OctreeDataUtils.h>
 
 #include "EntitySimulation.h"
 #include "VariantMapToScriptValue.h"
@@ -92,7 +95,8 @@ void EntityTree::eraseDomainAndNonOwnedEntities() {
         QHash<EntityItemID, EntityItemPointer> savedEntities;
         // NOTE: lock the Tree first, then lock the _entityMap.
         // It should never be done the other way around.
-        QReadLocker locker(&_entityMapLock);
+        // The map and its server slots are changed below, so this takes the write lock.
+        QWriteLocker locker(&_entityMapLock);
         foreach(EntityItemPointer entity, _entityMap) {
             EntityTreeElementPointer element = entity->getElement();
             if (element) {
@@ -102,6 +106,7 @@ void EntityTree::eraseDomainAndNonOwnedEntities() {
             if (entity->isLocalEntity() || (entity->isAvatarEntity() && entity->getOwningAvatarID() == getMyAvatarSessionUUID())) {
                 savedEntities[entity->getEntityItemID()] = entity;
             } else {
+                releaseServerSlot(entity);
                 int32_t spaceIndex = entity->getSpaceIndex();
                 if (spaceIndex != -1) {
                     // stale spaceIndices will be freed later
@@ -137,7 +142,15 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
         _simulation->clearEntities();
     }
     QHash<EntityItemID, EntityItemPointer> localMap;
-    localMap.swap(_entityMap);
+    {
+        QWriteLocker locker(&_entityMapLock);
+        localMap.swap(_entityMap);
+        for (auto& entity : localMap) {
+            entity->setServerSlot(EntityItem::NO_SERVER_SLOT, 0);
+        }
+        _nextServerSlot = 0;
+        _freeServerSlots.clear();
+    }
     this->withWriteLock([&] {
         foreach(EntityItemPointer entity, localMap) {
             EntityTreeElementPointer element = entity->getElement();
@@ -300,6 +313,7 @@ void EntityTree::postAddEntity(EntityItemPointer entity) {
     }
 
     _isDirty = true;
+    logEntityChanged(entity->getEntityItemID());
 
     // find and hook up any entities with this entity as a (previously) missing parent
     fixupNeedsParentFixups();
@@ -366,6 +380,7 @@ bool EntityTree::updateEntity(EntityItemPointer entity, const EntityItemProperti
                     emit editingEntityPointer(entity);
                 }
                 _isDirty = true;
+                logEntityChanged(entity->getEntityItemID());
             }
         }
     } else {
@@ -501,6 +516,7 @@ bool EntityTree::updateEntity(EntityItemPointer entity, const EntityItemProperti
         }
 
         _isDirty = true;
+        logEntityChanged(entity->getEntityItemID());
 
         uint32_t newFlags = entity->getDirtyFlags() & ~preFlags;
         if (newFlags) {
@@ -743,6 +759,7 @@ void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator)
         }
 
         theEntity->die();
+        logEntityDeleted(theEntity->getEntityItemID());
 
         if (getIsServer()) {
             removeCertifiedEntityOnServer(theEntity);
@@ -931,219 +948,103 @@ EntityItemID EntityTree::evalParabolaIntersection(const PickParabola& parabola,
     return args.entityID;
 }
 
-class FindClosestEntityArgs {
-public:
-    // Inputs
-    glm::vec3 position;
-    float targetRadius;
-    PickFilter searchFilter;
-
-    // Outputs
-    QUuid closestEntity;
-    float closestEntityDistance;
-};
-
-
-bool evalClosestEntityOperation(const OctreeElementPointer& element, void* extraData) {
-    FindClosestEntityArgs* args = static_cast<FindClosestEntityArgs*>(extraData);
-    EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
-
-    glm::vec3 penetration;
-    bool sphereIntersection = entityTreeElement->getAACube().findSpherePenetration(args->position, args->targetRadius, penetration);
-
-    // If this entityTreeElement contains the point, then search it...
-    if (sphereIntersection) {
-        float closestDistanceSquared = FLT_MAX;
-        QUuid thisClosestEntity = entityTreeElement->evalClosetEntity(args->position, args->searchFilter, closestDistanceSquared);
-
-        // we may have gotten NULL back, meaning no entity was available
-        if (!thisClosestEntity.isNull()) {
-            float distanceFromPointToEntity = glm::sqrt(closestDistanceSquared);
-
-            // If we're within our target radius
-            if (distanceFromPointToEntity <= args->targetRadius) {
-                // we are closer than anything else we've found
-                if (distanceFromPointToEntity < args->closestEntityDistance) {
-                    args->closestEntity = thisClosestEntity;
-                    args->closestEntityDistance = distanceFromPointToEntity;
-                }
-            }
-        }
-
-        // we should be able to optimize this...
-        return true; // keep searching in case children have closer entities
-    }
-
-    // if this element doesn't contain the point, then none of its children can contain the point, so stop searching
-    return false;
-}
-
 // NOTE: assumes caller has handled locking
 QUuid EntityTree::evalClosestEntity(const glm::vec3& position, float targetRadius, PickFilter searchFilter) {
-    FindClosestEntityArgs args = { position, targetRadius, searchFilter, QUuid(), FLT_MAX };
-    recurseTreeWithOperation(evalClosestEntityOperation, &args);
-    return args.closestEntity;
-}
+    std::vector<EntityItemPointer> candidates;
+    _spatialIndex.findCandidates(AABox(position - glm::vec3(targetRadius), 2.0f * targetRadius), candidates);
 
-class FindEntitiesInSphereArgs {
-public:
-    // Inputs
-    glm::vec3 position;
-    float targetRadius;
-    PickFilter searchFilter;
-
-    // Outputs
-    QVector<QUuid> entities;
-};
-
-bool evalInSphereOperation(const OctreeElementPointer& element, void* extraData) {
-    FindEntitiesInSphereArgs* args = static_cast<FindEntitiesInSphereArgs*>(extraData);
-    glm::vec3 penetration;
-    bool sphereIntersection = element->getAACube().findSpherePenetration(args->position, args->targetRadius, penetration);
-
-    // If this element contains the point, then search it...
-    if (sphereIntersection) {
-        EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
-        entityTreeElement->evalEntitiesInSphere(args->position, args->targetRadius, args->searchFilter, args->entities);
-        return true; // keep searching in case children have closer entities
+    QUuid closestEntity;
+    float closestDistanceSquared = targetRadius * targetRadius;
+    for (auto& entity : candidates) {
+        if (!EntityTreeElement::checkFilterSettings(entity, searchFilter)) {
+            continue;
+        }
+        float distanceSquared = glm::distance2(position, entity->getWorldPosition());
+        if (distanceSquared <= closestDistanceSquared && (closestEntity.isNull() || distanceSquared < closestDistanceSquared)) {
+            closestEntity = entity->getID();
+            closestDistanceSquared = distanceSquared;
+        }
     }
-
-    // if this element doesn't contain the point, then none of it's children can contain the point, so stop searching
-    return false;
+    return closestEntity;
 }
 
 // NOTE: assumes caller has handled locking
 void EntityTree::evalEntitiesInSphere(const glm::vec3& center, float radius, PickFilter searchFilter, QVector<QUuid>& foundEntities) {
-    FindEntitiesInSphereArgs args = { center, radius, searchFilter, QVector<QUuid>() };
-    recurseTreeWithOperation(evalInSphereOperation, &args);
-    foundEntities.swap(args.entities);
-}
+    std::vector<EntityItemPointer> candidates;
+    _spatialIndex.findCandidates(AABox(center - glm::vec3(radius), 2.0f * radius), candidates);
 
-class FindEntitiesInSphereWithTypeArgs {
-public:
-    // Inputs
-    glm::vec3 position;
-    float targetRadius;
-    EntityTypes::EntityType type;
-    PickFilter searchFilter;
-
-    // Outputs
     QVector<QUuid> entities;
-};
-
-bool evalInSphereWithTypeOperation(const OctreeElementPointer& element, void* extraData) {
-    FindEntitiesInSphereWithTypeArgs* args = static_cast<FindEntitiesInSphereWithTypeArgs*>(extraData);
-    glm::vec3 penetration;
-    bool sphereIntersection = element->getAACube().findSpherePenetration(args->position, args->targetRadius, penetration);
-
-    // If this element contains the point, then search it...
-    if (sphereIntersection) {
-        EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
-        entityTreeElement->evalEntitiesInSphereWithType(args->position, args->targetRadius, args->type, args->searchFilter, args->entities);
-        return true; // keep searching in case children have closer entities
+    for (auto& entity : candidates) {
+        if (EntityTreeElement::checkFilterSettings(entity, searchFilter) &&
+            EntityTreeElement::isEntityInSphere(entity, center, radius)) {
+            entities.push_back(entity->getID());
+        }
     }
-
-    // if this element doesn't contain the point, then none of it's children can contain the point, so stop searching
-    return false;
+    foundEntities.swap(entities);
 }
 
 // NOTE: assumes caller has handled locking
 void EntityTree::evalEntitiesInSphereWithType(const glm::vec3& center, float radius, EntityTypes::EntityType type, PickFilter searchFilter, QVector<QUuid>& foundEntities) {
-    FindEntitiesInSphereWithTypeArgs args = { center, radius, type, searchFilter, QVector<QUuid>() };
-    recurseTreeWithOperation(evalInSphereWithTypeOperation, &args);
-    foundEntities.swap(args.entities);
-}
-
-class FindEntitiesInSphereWithNameArgs {
-public:
-    // Inputs
-    glm::vec3 position;
-    float targetRadius;
-    QString name;
-    bool caseSensitive;
-    PickFilter searchFilter;
+    std::vector<EntityItemPointer> candidates;
+    _spatialIndex.findCandidates(AABox(center - glm::vec3(radius), 2.0f * radius), candidates);
 
-    // Outputs
     QVector<QUuid> entities;
-};
-
-bool evalInSphereWithNameOperation(const OctreeElementPointer& element, void* extraData) {
-    FindEntitiesInSphereWithNameArgs* args = static_cast<FindEntitiesInSphereWithNameArgs*>(extraData);
-    glm::vec3 penetration;
-    bool sphereIntersection = element->getAACube().findSpherePenetration(args->position, args->targetRadius, penetration);
-
-    // If this element contains the point, then search it...
-    if (sphereIntersection) {
-        EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
-        entityTreeElement->evalEntitiesInSphereWithName(args->position, args->targetRadius, args->name, args->caseSensitive, args->searchFilter, args->entities);
-        return true; // keep searching in case children have closer entities
+    for (auto& entity : candidates) {
+        if (type == entity->getType() && EntityTreeElement::checkFilterSettings(entity, searchFilter) &&
+            EntityTreeElement::isEntityInSphere(entity, center, radius)) {
+            entities.push_back(entity->getID());
+        }
     }
-
-    // if this element doesn't contain the point, then none of it's children can contain the point, so stop searching
-    return false;
+    foundEntities.swap(entities);
 }
 
 // NOTE: assumes caller has handled locking
 void EntityTree::evalEntitiesInSphereWithName(const glm::vec3& center, float radius, const QString& name, bool caseSensitive, PickFilter searchFilter, QVector<QUuid>& foundEntities) {
-    FindEntitiesInSphereWithNameArgs args = { center, radius, name, caseSensitive, searchFilter, QVector<QUuid>() };
-    recurseTreeWithOperation(evalInSphereWithNameOperation, &args);
-    foundEntities.swap(args.entities);
-}
+    std::vector<EntityItemPointer> candidates;
+    _spatialIndex.findCandidates(AABox(center - glm::vec3(radius), 2.0f * radius), candidates);
 
-class FindEntitiesInCubeArgs {
-public:
-    // Inputs
-    AACube cube;
-    PickFilter searchFilter;
-
-    // Outputs
     QVector<QUuid> entities;
-};
-
-bool findInCubeOperation(const OctreeElementPointer& element, void* extraData) {
-    FindEntitiesInCubeArgs* args = static_cast<FindEntitiesInCubeArgs*>(extraData);
-    if (element->getAACube().touches(args->cube)) {
-        EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
-        entityTreeElement->evalEntitiesInCube(args->cube, args->searchFilter, args->entities);
-        return true;
+    for (auto& entity : candidates) {
+        if (!EntityTreeElement::checkFilterSettings(entity, searchFilter)) {
+            continue;
+        }
+        QString entityName = entity->getName();
+        if ((caseSensitive && name != entityName) || (!caseSensitive && name.toLower() != entityName.toLower())) {
+            continue;
+        }
+        if (EntityTreeElement::isEntityInSphere(entity, center, radius)) {
+            entities.push_back(entity->getID());
+        }
     }
-    return false;
+    foundEntities.swap(entities);
 }
 
 // NOTE: assumes caller has handled locking
 void EntityTree::evalEntitiesInCube(const AACube& cube, PickFilter searchFilter, QVector<QUuid>& foundEntities) {
-    FindEntitiesInCubeArgs args { cube, searchFilter, QVector<QUuid>() };
-    recurseTreeWithOperation(findInCubeOperation, &args);
-    foundEntities.swap(args.entities);
-}
+    std::vector<EntityItemPointer> candidates;
+    _spatialIndex.findCandidates(AABox(cube), candidates);
 
-class FindEntitiesInBoxArgs {
-public:
-    // Inputs
-    AABox box;
-    PickFilter searchFilter;
-
-    // Outputs
     QVector<QUuid> entities;
-};
-
-bool findInBoxOperation(const OctreeElementPointer& element, void* extraData) {
-    FindEntitiesInBoxArgs* args = static_cast<FindEntitiesInBoxArgs*>(extraData);
-    if (element->getAACube().touches(args->box)) {
-        EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
-        entityTreeElement->evalEntitiesInBox(args->box, args->searchFilter, args->entities);
-        return true;
+    for (auto& entity : candidates) {
+        if (EntityTreeElement::checkFilterSettings(entity, searchFilter) && EntityTreeElement::isEntityInCube(entity, cube)) {
+            entities.push_back(entity->getID());
+        }
     }
-    return false;
+    foundEntities.swap(entities);
 }
 
 // NOTE: assumes caller has handled locking
 void EntityTree::evalEntitiesInBox(const AABox& box, PickFilter searchFilter, QVector<QUuid>& foundEntities) {
-    FindEntitiesInBoxArgs args { box, searchFilter, QVector<QUuid>() };
-    // NOTE: This should use recursion, since this is a spatial operation
-    recurseTreeWithOperation(findInBoxOperation, &args);
-    // swap the two lists of entity pointers instead of copy
-    foundEntities.swap(args.entities);
+    std::vector<EntityItemPointer> candidates;
+    _spatialIndex.findCandidates(box, candidates);
+
+    QVector<QUuid> entities;
+    for (auto& entity : candidates) {
+        if (EntityTreeElement::checkFilterSettings(entity, searchFilter) && EntityTreeElement::isEntityInBox(entity, box)) {
+            entities.push_back(entity->getID());
+        }
+    }
+    foundEntities.swap(entities);
 }
 
 class FindEntitiesInFrustumArgs {
@@ -2465,11 +2366,43 @@ void EntityTree::addEntityMapEntry(EntityItemPointer entity) {
         return;
     }
     _entityMap.insert(id, entity);
+
+    uint32_t slot;
+    if (_freeServerSlots.empty()) {
+        slot = _nextServerSlot++;
+    } else {
+        slot = _freeServerSlots.back();
+        _freeServerSlots.pop_back();
+    }
+    entity->setServerSlot(slot, usecTimestampNow());
 }
 
 void EntityTree::clearEntityMapEntry(const EntityItemID& id) {
     QWriteLocker locker(&_entityMapLock);
-    _entityMap.remove(id);
+    releaseServerSlot(_entityMap.take(id));
+}
+
+void EntityTree::releaseServerSlot(const EntityItemPointer& entity) {
+    // the caller holds the _entityMapLock
+    if (entity && entity->getServerSlot() != EntityItem::NO_SERVER_SLOT) {
+        _freeServerSlots.push_back(entity->getServerSlot());
+        entity->setServerSlot(EntityItem::NO_SERVER_SLOT, 0);
+    }
+}
+
+QVector<EntityItemPointer> EntityTree::sampleEntities(int maxCount) const {
+    QVector<EntityItemPointer> entities;
+    QReadLocker locker(&_entityMapLock);
+    int numEntities = _entityMap.size();
+    int stride = numEntities > maxCount ? (numEntities + maxCount - 1) / std::max(1, maxCount) : 1;
+    entities.reserve(std::min(maxCount, numEntities));
+    int i = 0;
+    for (const auto& entity : _entityMap) {
+        if (i++ % stride == 0) {
+            entities.push_back(entity);
+        }
+    }
+    return entities;
 }
 
 void EntityTree::debugDumpMap() {
@@ -2746,6 +2679,225 @@ bool EntityTree::writeToMap(QVariantMap& entityDescription, OctreeElementPointer
     return true;
 }
 
+using OctreeUtils::CHANGE_LOG_EDIT_KEY;
+using OctreeUtils::CHANGE_LOG_DELETE_KEY;
+
+void EntityTree::setChangeLogEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(_changeLogMutex);
+    _changeLogEnabled = enabled;
+    _loggedChangedEntities.clear();
+    _loggedDeletedEntities.clear();
+}
+
+void EntityTree::logEntityChanged(const EntityItemID& entityID) {
+    if (_changeLogEnabled) {
+        std::lock_guard<std::mutex> lock(_changeLogMutex);
+        _loggedDeletedEntities.remove(entityID);
+        _loggedChangedEntities.insert(entityID);
+    }
+}
+
+void EntityTree::logEntityDeleted(const EntityItemID& entityID) {
+    if (_changeLogEnabled) {
+        std::lock_guard<std::mutex> lock(_changeLogMutex);
+        _loggedChangedEntities.remove(entityID);
+        _loggedDeletedEntities.insert(entityID);
+    }
+}
+
+bool EntityTree::appendChangesToLog(QIODevice& log) {
+    QSet<EntityItemID> changedEntities;
+    QSet<EntityItemID> deletedEntities;
+    {
+        std::lock_guard<std::mutex> lock(_changeLogMutex);
+        changedEntities.swap(_loggedChangedEntities);
+        deletedEntities.swap(_loggedDeletedEntities);
+    }
+
+    if (changedEntities.isEmpty() && deletedEntities.isEmpty()) {
+        return true;
+    }
+
+    // One compact JSON record per line, holding the full current properties of each changed entity:
+    // replaying a record doesn't depend on any earlier one, and a record torn by a crash is simply skipped.
+    QByteArray records;
+    QScriptEngine scriptEngine;
+    withReadLock([&] {
+        foreach (const EntityItemID& entityID, changedEntities) {
+            EntityItemPointer entity = findEntityByEntityItemID(entityID);
+            if (!entity) {
+                continue;
+            }
+            QScriptValue properties = EntityItemPropertiesToScriptValue(&scriptEngine, entity->getProperties());
+            QJsonObject record;
+            record[CHANGE_LOG_EDIT_KEY] = QJsonObject::fromVariantMap(properties.toVariant().toMap());
+            records += QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n';
+        }
+    });
+    foreach (const EntityItemID& entityID, deletedEntities) {
+        QJsonObject record;
+        record[CHANGE_LOG_DELETE_KEY] = entityID.toString();
+        records += QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n';
+    }
+
+    return log.write(records) == records.size();
+}
+
+int EntityTree::replayChangeLog(QIODevice& log) {
+    // NOTE: callers must lock the tree before using this method
+    QScriptEngine scriptEngine;
+    int numRecords = 0;
+    while (!log.atEnd()) {
+        QJsonParseError parseError;
+        QJsonDocument record = QJsonDocument::fromJson(log.readLine(), &parseError);
+        if (parseError.error != QJsonParseError::NoError || !record.isObject()) {
+            qCWarning(entities) << "Skipping malformed entity change log record:" << parseError.errorString();
+            continue;
+        }
+
+        QJsonObject recordObject = record.object();
+        if (recordObject.contains(CHANGE_LOG_DELETE_KEY)) {
+            deleteEntity(EntityItemID(QUuid(recordObject[CHANGE_LOG_DELETE_KEY].toString())), true);
+        } else if (recordObject.contains(CHANGE_LOG_EDIT_KEY)) {
+            QVariantMap entityMap = recordObject[CHANGE_LOG_EDIT_KEY].toObject().toVariantMap();
+            EntityItemID entityID(QUuid(entityMap["id"].toString()));
+            if (entityID.isNull()) {
+                continue;
+            }
+
+            QScriptValue entityScriptValue = variantMapToScriptValue(entityMap, scriptEngine);
+            EntityItemProperties properties;
+            EntityItemPropertiesFromScriptValueIgnoreReadOnly(entityScriptValue, properties);
+
+            EntityItemPointer entity = findEntityByEntityItemID(entityID);
+            if (!entity) {
+                addEntity(entityID, properties);
+            } else if (entity->getElement()) {
+                // the record is the entity's complete state, so it is applied as is rather than as an edit
+                AACube newQueryAACube = properties.queryAACubeChanged() ? properties.getQueryAACube() : entity->getQueryAACube();
+                UpdateEntityOperator theOperator(getThisPointer(), entity->getElement(), entity, newQueryAACube);
+                recurseTreeWithOperator(&theOperator);
+                entity->setProperties(properties);
+                _isDirty = true;
+            }
+        }
+        ++numRecords;
+    }
+    return numRecords;
+}
+
+// Each entity is stored as a size prefixed EntityAdd edit encoding, which carries its full set of properties
+// as EntityPropertyFlags plus values and can be decoded straight out of a memory mapped file.
+static const int INITIAL_SNAPSHOT_RECORD_SIZE = 64 * 1024;
+static const int MAX_SNAPSHOT_RECORD_SIZE = 64 * 1024 * 1024;
+
+bool EntityTree::writeToSnapshot(QIODevice& snapshot) {
+    bool success = true;
+    withReadLock([&] {
+        QVector<EntityItemPointer> entities;
+        {
+            QReadLocker locker(&_entityMapLock);
+            entities.reserve(_entityMap.size());
+            for (const auto& entity : _entityMap) {
+                // same as the JSON file, don't save entities whose parent we couldn't resolve
+                if (entity->isParentIDValid()) {
+                    entities.push_back(entity);
+                }
+            }
+        }
+
+        quint32 numRecords = qToBigEndian<quint32>(entities.size());
+        success = snapshot.write(reinterpret_cast<const char*>(&numRecords), sizeof(numRecords)) == sizeof(numRecords);
+
+        QByteArray buffer;
+        for (int i = 0; success && i < entities.size(); ++i) {
+            const EntityItemPointer& entity = entities[i];
+            EntityItemProperties properties = entity->getProperties();
+            properties.markAllChanged(); // getProperties clears the changed flags, and only changed properties are encoded
+            EntityPropertyFlags didntFit;
+            OctreeElement::AppendState encodeResult = OctreeElement::NONE;
+            for (int bufferSize = INITIAL_SNAPSHOT_RECORD_SIZE; bufferSize <= MAX_SNAPSHOT_RECORD_SIZE; bufferSize *= 4) {
+                buffer.resize(bufferSize);
+                encodeResult = EntityItemProperties::encodeEntityEditPacket(PacketType::EntityAdd, entity->getEntityItemID(),
+                    properties, buffer, properties.getChangedProperties(), didntFit);
+                if (encodeResult == OctreeElement::COMPLETED) {
+                    break;
+                }
+            }
+            if (encodeResult != OctreeElement::COMPLETED) {
+                qCWarning(entities) << "Entity too large to write to snapshot:" << entity->getEntityItemID();
+                success = false;
+                break;
+            }
+
+            quint32 recordSize = qToBigEndian<quint32>(buffer.size());
+            success = snapshot.write(reinterpret_cast<const char*>(&recordSize), sizeof(recordSize)) == sizeof(recordSize) &&
+                snapshot.write(buffer) == buffer.size();
+        }
+    });
+    return success;
+}
+
+bool EntityTree::readFromSnapshot(const QByteArray& snapshot) {
+    // NOTE: callers must lock the tree before using this method
+    const unsigned char* dataAt = reinterpret_cast<const unsigned char*>(snapshot.constData());
+    const unsigned char* dataEnd = dataAt + snapshot.size();
+
+    if (dataEnd - dataAt < (int)sizeof(quint32)) {
+        return false;
+    }
+    quint32 numRecords = qFromBigEndian<quint32>(dataAt);
+    dataAt += sizeof(quint32);
+
+    QMap<QUuid, QVector<QUuid>> cloneIDs;
+
+    bool success = true;
+    for (quint32 i = 0; i < numRecords; ++i) {
+        if (dataEnd - dataAt < (int)sizeof(quint32)) {
+            qCWarning(entities) << "Entity snapshot is truncated after" << i << "of" << numRecords << "entities";
+            return false;
+        }
+        quint32 recordSize = qFromBigEndian<quint32>(dataAt);
+        dataAt += sizeof(quint32);
+        if (recordSize > (quint32)(dataEnd - dataAt)) {
+            qCWarning(entities) << "Entity snapshot is truncated after" << i << "of" << numRecords << "entities";
+            return false;
+        }
+
+        EntityItemID entityItemID;
+        EntityItemProperties properties;
+        int processedBytes = 0;
+        bool validRecord = EntityItemProperties::decodeEntityEditPacket(dataAt, recordSize, processedBytes,
+                                                                       entityItemID, properties);
+        dataAt += recordSize;
+        if (!validRecord || processedBytes > (int)recordSize) {
+            qCWarning(entities) << "Entity snapshot has a bad record after" << i << "of" << numRecords << "entities";
+            return false;
+        }
+
+        EntityItemPointer entity = addEntity(entityItemID, properties);
+        if (!entity) {
+            qCDebug(entities) << "adding Entity failed:" << entityItemID << properties.getType();
+            success = false;
+            continue;
+        }
+
+        const QUuid& cloneOriginID = entity->getCloneOriginID();
+        if (!cloneOriginID.isNull()) {
+            cloneIDs[cloneOriginID].push_back(entity->getEntityItemID());
+        }
+    }
+
+    for (const auto& entityID : cloneIDs.keys()) {
+        auto entity = findEntityByID(entityID);
+        if (entity) {
+            entity->setCloneIDs(cloneIDs.value(entityID));
+        }
+    }
+
+    return success;
+}
+
 void convertGrabUserDataToProperties(EntityItemProperties& properties) {
     GrabPropertyGroup& grabProperties = properties.getGrab();
     QJsonObject userData = QJsonDocument::fromJson(properties.getUserData().toUtf8()).object();
@@ -12,6 +12,10 @@
 #ifndef hifi_EntityTree_h
 #define hifi_EntityTree_h
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+
 #include <QSet>
 #include <QVector>
 
@@ -20,6 +24,7 @@
 
 #include "AddEntityOperator.h"
 #include "EntityTreeElement.h"
+#include "EntitySpatialIndex.h"
 #include "DeleteEntityOperator.h"
 #include "MovingEntitiesOperator.h"
 
@@ -142,6 +147,12 @@ public:
     void evalEntitiesInBox(const AABox& box, PickFilter searchFilter, QVector<QUuid>& foundEntities);
     void evalEntitiesInFrustum(const ViewFrustum& frustum, PickFilter searchFilter, QVector<QUuid>& foundEntities);
 
+    /// The grid the region queries above use; kept up to date by the EntityTreeElements as entities come and go.
+    EntitySpatialIndex& getSpatialIndex() { return _spatialIndex; }
+
+    /// Up to maxCount of the entities, spread evenly over all of them.
+    QVector<EntityItemPointer> sampleEntities(int maxCount) const;
+
     void addNewlyCreatedHook(NewlyCreatedEntityHook* hook);
     void removeNewlyCreatedHook(NewlyCreatedEntityHook* hook);
 
@@ -196,6 +207,12 @@ public:
     virtual bool readFromMap(QVariantMap& entityDescription) override;
     virtual bool writeToJSON(QString& jsonString, const OctreeElementPointer& element) override;
 
+    virtual void setChangeLogEnabled(bool enabled) override;
+    virtual bool appendChangesToLog(QIODevice& log) override;
+    virtual int replayChangeLog(QIODevice& log) override;
+    virtual bool writeToSnapshot(QIODevice& snapshot) override;
+    virtual bool readFromSnapshot(const QByteArray& snapshot) override;
+
 
     glm::vec3 getContentsDimensions();
     float getContentsLargestDimension();
@@ -322,6 +339,10 @@ protected:
 
     mutable QReadWriteLock _entityMapLock;
     QHash<EntityItemID, EntityItemPointer> _entityMap;
+    EntitySpatialIndex _spatialIndex;
+    uint32_t _nextServerSlot { 0 }; // guarded by _entityMapLock, like the free list
+    std::vector<uint32_t> _freeServerSlots;
+    void releaseServerSlot(const EntityItemPointer& entity);
 
     mutable QReadWriteLock _entityCertificateIDMapLock;
     QHash<QString, QList<EntityItemID>> _entityCertificateIDMap;
@@ -393,6 +414,14 @@ private:
 
     std::map<QString, QString> _namedPaths;
 
+    // entities added, edited or deleted since the change log was last appended to
+    void logEntityChanged(const EntityItemID& entityID);
+    void logEntityDeleted(const EntityItemID& entityID);
+    std::atomic<bool> _changeLogEnabled { false };
+    std::mutex _changeLogMutex;
+    QSet<EntityItemID> _loggedChangedEntities;
+    QSet<EntityItemID> _loggedDeletedEntities;
+
     void updateEntityQueryAACubeWorker(SpatiallyNestablePointer object, EntityEditPacketSender* packetSender,
                                        MovingEntitiesOperator& moveOperator, bool force, bool tellServer);
 };
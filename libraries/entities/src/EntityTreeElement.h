@@ -135,6 +135,9 @@ public:
     virtual bool deleteApproved() const override { return !hasEntities(); }
 
     static bool checkFilterSettings(const EntityItemPointer& entity, PickFilter searchFilter);
+    static bool isEntityInSphere(const EntityItemPointer& entity, const glm::vec3& position, float radius);
+    static bool isEntityInCube(const EntityItemPointer& entity, const AACube& cube);
+    static bool isEntityInBox(const EntityItemPointer& entity, const AABox& box);
     virtual bool canPickIntersect() const override { return hasEntities(); }
     virtual EntityItemID evalRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
         OctreeElementPointer& element, float& distance, BoxFace& face, glm::vec3& surfaceNormal,
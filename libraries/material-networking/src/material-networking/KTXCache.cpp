@@ -11,6 +11,10 @@
 
 #include "KTXCache.h"
 
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+
 #include <SettingHandle.h>
 #include <ktx/KTX.h>
 
@@ -23,9 +27,18 @@ const int KTXCache::CURRENT_VERSION = 0x01;
 const int KTXCache::INVALID_VERSION = 0x00;
 const char* KTXCache::SETTING_VERSION_NAME = "hifi.ktx.cache_version";
 
+static const char* SOURCES_FILENAME = "cache_sources";
+static const quint32 SOURCES_VERSION = 1;
+// far more than the textures of a domain, each costs a url and a hash
+static const size_t MAX_SOURCES = 16 * 1024;
+
 KTXCache::KTXCache(const std::string& dir, const std::string& ext) :
     FileCache(dir, ext) { }
 
+KTXCache::~KTXCache() {
+    saveSources();
+}
+
 void KTXCache::initialize() {
     FileCache::initialize();
     Setting::Handle<int> cacheVersionHandle(SETTING_VERSION_NAME, INVALID_VERSION);
@@ -33,6 +46,91 @@ void KTXCache::initialize() {
     if (cacheVersion != CURRENT_VERSION) {
         wipe();
         cacheVersionHandle.set(CURRENT_VERSION);
+    } else {
+        loadSources();
+    }
+}
+
+void KTXCache::setSourceKey(const std::string& source, const Key& key) {
+    std::unique_lock<std::mutex> lock(_sourcesMutex);
+    auto it = _sourcesMap.find(source);
+    if (it != _sourcesMap.end()) {
+        _sources.erase(it->second);
+    }
+    _sourcesMap[source] = _sources.emplace(_sources.end(), source, key);
+
+    while (_sources.size() > MAX_SOURCES) {
+        _sourcesMap.erase(_sources.front().first);
+        _sources.pop_front();
+    }
+}
+
+bool KTXCache::hintSource(const std::string& source) {
+    Key key;
+    {
+        std::unique_lock<std::mutex> lock(_sourcesMutex);
+        auto it = _sourcesMap.find(source);
+        if (it == _sourcesMap.end()) {
+            return false;
+        }
+        key = it->second->second;
+    }
+
+    if (hint(key)) {
+        return true;
+    }
+
+    // the file was ejected, so the source will be converted again
+    std::unique_lock<std::mutex> lock(_sourcesMutex);
+    auto it = _sourcesMap.find(source);
+    if (it != _sourcesMap.end() && it->second->second == key) {
+        _sources.erase(it->second);
+        _sourcesMap.erase(it);
+    }
+    return false;
+}
+
+void KTXCache::loadSources() {
+    QFile sourcesFile((getDirpath() + "/" + SOURCES_FILENAME).c_str());
+    if (!sourcesFile.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream(&sourcesFile);
+    quint32 version;
+    stream >> version;
+    if (stream.status() != QDataStream::Ok || version != SOURCES_VERSION) {
+        return;
+    }
+
+    while (!stream.atEnd()) {
+        QByteArray source;
+        QByteArray key;
+        stream >> source >> key;
+        if (stream.status() != QDataStream::Ok) {
+            break;
+        }
+        setSourceKey(source.toStdString(), key.toStdString());
+    }
+}
+
+void KTXCache::saveSources() {
+    std::unique_lock<std::mutex> lock(_sourcesMutex);
+
+    QSaveFile sourcesFile((getDirpath() + "/" + SOURCES_FILENAME).c_str());
+    if (!sourcesFile.open(QIODevice::WriteOnly)) {
+        qCWarning(file_cache) << "Failed to save the KTX cache sources to" << sourcesFile.fileName();
+        return;
+    }
+
+    QDataStream stream(&sourcesFile);
+    stream << SOURCES_VERSION;
+    for (const auto& source : _sources) {
+        stream << QByteArray::fromStdString(source.first) << QByteArray::fromStdString(source.second);
+    }
+
+    if (!sourcesFile.commit()) {
+        qCWarning(file_cache) << "Failed to save the KTX cache sources to" << sourcesFile.fileName();
     }
 }
 
@@ -12,6 +12,11 @@
 #ifndef hifi_KTXCache_h
 #define hifi_KTXCache_h
 
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 #include <QUrl>
 
 #include <shared/FileCache.h>
@@ -34,11 +39,28 @@ public:
     static const char* SETTING_VERSION_NAME;
 
     KTXCache(const std::string& dir, const std::string& ext);
+    ~KTXCache() override;
 
     void initialize() override;
 
+    // Remember which file a source (a texture url, say) was last converted to, so a prefetch of the source can be
+    // hinted to the cache before the source itself is fetched again
+    void setSourceKey(const std::string& source, const Key& key);
+    // Returns false if the source's file is unknown or no longer in the cache
+    bool hintSource(const std::string& source);
+
 protected:
     std::unique_ptr<cache::File> createFile(Metadata&& metadata, const std::string& filepath) override final;
+
+private:
+    // The sources are kept next to the cache index, most recently set last, up to a fixed number of them
+    using SourceList = std::list<std::pair<std::string, Key>>;
+    void loadSources();
+    void saveSources();
+
+    std::mutex _sourcesMutex;
+    SourceList _sources;
+    std::unordered_map<std::string, SourceList::iterator> _sourcesMap;
 };
 
 #endif // hifi_KTXCache_h
@@ -285,6 +285,18 @@ gpu::TexturePointer TextureCache::cacheTextureByHash(const std::string& hash, co
     return result;
 }
 
+static std::string getKtxSource(const QUrl& url, size_t extraHash) {
+    return url.toString().toStdString() + '#' + std::to_string(extraHash);
+}
+
+void TextureCache::setKtxKey(const QUrl& url, size_t extraHash, const std::string& hash) {
+    _ktxCache->setSourceKey(getKtxSource(url, extraHash), hash);
+}
+
+void TextureCache::prefetchHint(const QUrl& url, size_t extraHash) {
+    _ktxCache->hintSource(getKtxSource(url, extraHash));
+}
+
 gpu::TexturePointer getFallbackTextureForType(image::TextureUsage::Type type) {
     gpu::TexturePointer result;
     auto textureCache = DependencyManager::get<TextureCache>();
@@ -964,6 +976,7 @@ void NetworkTexture::handleFinishedInitialLoad() {
         }
 
         auto textureCache = DependencyManager::get<TextureCache>();
+        textureCache->setKtxKey(url, resource->getExtraHash(), hash);
 
         gpu::TexturePointer texture = textureCache->getTextureByHash(hash);
 
@@ -1225,6 +1238,8 @@ void ImageReader::read() {
     // Maybe load from cache
     auto textureCache = DependencyManager::get<TextureCache>();
     if (textureCache) {
+        textureCache->setKtxKey(_url, _extraHash, hash);
+
         // If we already have a live texture with the same hash, use it
         auto texture = textureCache->getTextureByHash(hash);
 
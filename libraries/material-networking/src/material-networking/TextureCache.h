@@ -186,6 +186,9 @@ public:
     gpu::TexturePointer getTextureByHash(const std::string& hash);
     gpu::TexturePointer cacheTextureByHash(const std::string& hash, const gpu::TexturePointer& texture);
 
+    // Remember which KTX cache file a texture was last loaded from, so a prefetch of it can be hinted to the cache
+    void setKtxKey(const QUrl& url, size_t extraHash, const std::string& hash);
+
     NetworkTexturePointer getResourceTexture(const QUrl& resourceTextureUrl);
     const gpu::FramebufferPointer& getHmdPreviewFramebuffer(int width, int height);
     const gpu::FramebufferPointer& getSpectatorCameraFramebuffer();
@@ -208,6 +211,7 @@ protected:
 
     virtual QSharedPointer<Resource> createResource(const QUrl& url) override;
     QSharedPointer<Resource> createResourceCopy(const QSharedPointer<Resource>& resource) override;
+    void prefetchHint(const QUrl& url, size_t extraHash) override;
 
 private:
     friend class ImageReader;
@@ -223,7 +227,7 @@ private:
 
     gpu::ContextPointer _gpuContext { nullptr };
 
-    std::shared_ptr<cache::FileCache> _ktxCache { std::make_shared<KTXCache>(KTX_DIRNAME, KTX_EXT) };
+    std::shared_ptr<KTXCache> _ktxCache { std::make_shared<KTXCache>(KTX_DIRNAME, KTX_EXT) };
 
     // Map from image hashes to texture weak pointers
     std::unordered_map<std::string, std::weak_ptr<gpu::Texture>> _texturesByHashes;
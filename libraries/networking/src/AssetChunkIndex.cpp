@@ -0,0 +1,161 @@
+//
+//  AssetChunkIndex.cpp
+//  libraries/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetChunkIndex.h"
+
+#include <algorithm>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+
+#include "NetworkLogging.h"
+
+// about as many chunks as a full disk cache holds, older assets are forgotten past that
+static const int MAX_INDEXED_CHUNKS = 160 * 1024;
+
+// the index is saved after this many assets were added or removed, and when it is destroyed
+static const int CHANGES_BETWEEN_SAVES = 32;
+
+static const quint32 INDEX_FILE_VERSION = 1;
+
+AssetChunkIndex::~AssetChunkIndex() {
+    save();
+}
+
+void AssetChunkIndex::load(const QString& indexFilePath) {
+    clear();
+    _indexFilePath = indexFilePath;
+
+    QFile indexFile { indexFilePath };
+    if (!indexFile.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream { &indexFile };
+    quint32 version;
+    stream >> version;
+    if (version != INDEX_FILE_VERSION) {
+        return;
+    }
+
+    while (!stream.atEnd() && stream.status() == QDataStream::Ok) {
+        QString assetHash;
+        QByteArray serializedChunks;
+        stream >> assetHash >> serializedChunks;
+
+        AssetUtils::AssetChunkList chunks;
+        if (stream.status() == QDataStream::Ok && AssetUtils::deserializeChunkList(serializedChunks, chunks)) {
+            addChunks(assetHash, chunks);
+        }
+    }
+
+    qCDebug(asset_client) << "Loaded the chunks of" << _assets.size() << "cached assets from" << indexFilePath;
+}
+
+void AssetChunkIndex::save() {
+    if (_indexFilePath.isEmpty() || _numChanges == 0) {
+        return;
+    }
+    _numChanges = 0;
+
+    QSaveFile indexFile { _indexFilePath };
+    if (!indexFile.open(QIODevice::WriteOnly)) {
+        qCWarning(asset_client) << "Failed to save the asset chunk index to" << _indexFilePath;
+        return;
+    }
+
+    QDataStream stream { &indexFile };
+    stream << INDEX_FILE_VERSION;
+    for (const auto& assetHash : _assetOrder) {
+        stream << assetHash << AssetUtils::serializeChunkList(_assets[assetHash]);
+    }
+
+    if (!indexFile.commit()) {
+        qCWarning(asset_client) << "Failed to save the asset chunk index to" << _indexFilePath;
+    }
+}
+
+void AssetChunkIndex::clear() {
+    _numChanges += _assets.size();
+    _chunks.clear();
+    _numLocations = 0;
+    _assets.clear();
+    _assetOrder.clear();
+}
+
+void AssetChunkIndex::addAsset(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetChunkList& chunks) {
+    if (_assets.contains(assetHash)) {
+        return;
+    }
+
+    addChunks(assetHash, chunks);
+
+    if (++_numChanges >= CHANGES_BETWEEN_SAVES) {
+        save();
+    }
+}
+
+void AssetChunkIndex::addChunks(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetChunkList& chunks) {
+    if (chunks.empty() || _assets.contains(assetHash)) {
+        return;
+    }
+
+    while (!_assetOrder.isEmpty() && _numLocations + (int)chunks.size() > MAX_INDEXED_CHUNKS) {
+        removeAsset(_assetOrder.first());
+    }
+
+    int64_t offset = 0;
+    for (const auto& chunk : chunks) {
+        _chunks[chunk.hash].push_back({ assetHash, offset, chunk.length });
+        offset += chunk.length;
+    }
+    _numLocations += (int)chunks.size();
+    _assets.insert(assetHash, chunks);
+    _assetOrder << assetHash;
+}
+
+void AssetChunkIndex::removeAsset(const AssetUtils::AssetHash& assetHash) {
+    auto assetIt = _assets.find(assetHash);
+    if (assetIt == _assets.end()) {
+        return;
+    }
+
+    // a chunk other assets share stays findable in them
+    for (const auto& chunk : assetIt.value()) {
+        auto chunkIt = _chunks.find(chunk.hash);
+        if (chunkIt == _chunks.end()) {
+            continue;
+        }
+
+        auto& locations = chunkIt.value();
+        auto numLocations = locations.size();
+        locations.erase(std::remove_if(locations.begin(), locations.end(), [&](const Location& location) {
+            return location.assetHash == assetHash;
+        }), locations.end());
+        _numLocations -= numLocations - locations.size();
+
+        if (locations.isEmpty()) {
+            _chunks.erase(chunkIt);
+        }
+    }
+    _assets.erase(assetIt);
+    _assetOrder.removeOne(assetHash);
+    ++_numChanges;
+}
+
+bool AssetChunkIndex::findChunk(const QByteArray& chunkHash, Location& location) const {
+    auto chunkIt = _chunks.find(chunkHash);
+    if (chunkIt == _chunks.end()) {
+        return false;
+    }
+    location = chunkIt->last();
+    return true;
+}
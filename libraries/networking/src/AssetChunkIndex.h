@@ -0,0 +1,62 @@
+//
+//  AssetChunkIndex.h
+//  libraries/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_AssetChunkIndex_h
+#define hifi_AssetChunkIndex_h
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "AssetChunking.h"
+#include "AssetUtils.h"
+
+// Where the content defined chunks of the assets in the disk cache are, so that a download of an asset that shares
+// chunks with one we already have only fetches the chunks we don't. The index is saved next to the disk cache.
+// An asset the disk cache has since evicted leaves stale entries, which are caught because the chunk read
+// from the cache no longer matches its hash. Lives on AssetClient's thread.
+class AssetChunkIndex {
+public:
+    struct Location {
+        AssetUtils::AssetHash assetHash;
+        int64_t offset;
+        uint32_t length;
+    };
+
+    ~AssetChunkIndex();
+
+    void load(const QString& indexFilePath);
+    void save();
+    void clear();
+
+    bool isEmpty() const { return _chunks.isEmpty(); }
+
+    void addAsset(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetChunkList& chunks);
+    void removeAsset(const AssetUtils::AssetHash& assetHash);
+
+    // finds the chunk in the latest cached asset that has it, which is the least likely to have been evicted
+    bool findChunk(const QByteArray& chunkHash, Location& location) const;
+
+private:
+    void addChunks(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetChunkList& chunks);
+
+    QString _indexFilePath;
+
+    QHash<QByteArray, QVector<Location>> _chunks; // every cached asset a chunk is in, latest last
+    int _numLocations { 0 };
+    QHash<AssetUtils::AssetHash, AssetUtils::AssetChunkList> _assets;
+    QList<AssetUtils::AssetHash> _assetOrder; // oldest first
+    int _numChanges { 0 };
+};
+
+#endif // hifi_AssetChunkIndex_h
@@ -0,0 +1,137 @@
+//
+//  AssetChunking.cpp
+//  libraries/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetChunking.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include <QtCore/QCryptographicHash>
+
+#include "AssetUtils.h"
+
+namespace AssetUtils {
+
+// Chunks are cut on the high bits of a rolling gear hash, which depend on the last 64 bytes. Before the average
+// size a cut needs more zero bits than after it, which keeps chunk sizes close to the average.
+static const uint64_t SMALL_CHUNK_MASK = ~0ULL << (64 - 18);
+static const uint64_t LARGE_CHUNK_MASK = ~0ULL << (64 - 14);
+
+// the table must be the same everywhere, so it comes from a fixed seed rather than a random device
+static const std::array<uint64_t, 256>& gearTable() {
+    static const std::array<uint64_t, 256> table = [] {
+        std::array<uint64_t, 256> table;
+        uint64_t state = 0x6869666920636463ULL;
+        for (auto& value : table) {
+            // splitmix64
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            value = z ^ (z >> 31);
+        }
+        return table;
+    }();
+    return table;
+}
+
+static uint32_t findCut(const uint8_t* data, uint32_t size) {
+    if (size <= MIN_CONTENT_CHUNK_SIZE) {
+        return size;
+    }
+    size = std::min(size, MAX_CONTENT_CHUNK_SIZE);
+    uint32_t normalSize = std::min(size, AVERAGE_CONTENT_CHUNK_SIZE);
+
+    const auto& gear = gearTable();
+    uint64_t fingerprint = 0;
+
+    // no chunk is smaller than the minimum, so the bytes before it are not looked at
+    uint32_t i = MIN_CONTENT_CHUNK_SIZE;
+    for (; i < normalSize; ++i) {
+        fingerprint = (fingerprint << 1) + gear[data[i]];
+        if (!(fingerprint & SMALL_CHUNK_MASK)) {
+            return i + 1;
+        }
+    }
+    for (; i < size; ++i) {
+        fingerprint = (fingerprint << 1) + gear[data[i]];
+        if (!(fingerprint & LARGE_CHUNK_MASK)) {
+            return i + 1;
+        }
+    }
+    return size;
+}
+
+std::vector<uint32_t> findChunkLengths(const char* data, int64_t size) {
+    std::vector<uint32_t> lengths;
+    lengths.reserve(size / AVERAGE_CONTENT_CHUNK_SIZE + 1);
+
+    int64_t offset = 0;
+    while (offset < size) {
+        auto remaining = (uint32_t)std::min(size - offset, (int64_t)MAX_CONTENT_CHUNK_SIZE);
+        auto length = findCut(reinterpret_cast<const uint8_t*>(data) + offset, remaining);
+        lengths.push_back(length);
+        offset += length;
+    }
+    return lengths;
+}
+
+AssetChunkList chunkData(const char* data, int64_t size) {
+    AssetChunkList chunks;
+    int64_t offset = 0;
+    for (auto length : findChunkLengths(data, size)) {
+        chunks.push_back({ length, QCryptographicHash::hash(QByteArray::fromRawData(data + offset, length),
+                                                            QCryptographicHash::Sha256) });
+        offset += length;
+    }
+    return chunks;
+}
+
+QByteArray serializeChunkList(const AssetChunkList& chunks) {
+    QByteArray serialized;
+    serialized.reserve(sizeof(uint32_t) + (int)chunks.size() * (int)(sizeof(uint32_t) + SHA256_HASH_LENGTH));
+
+    auto count = (uint32_t)chunks.size();
+    serialized.append(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const auto& chunk : chunks) {
+        serialized.append(reinterpret_cast<const char*>(&chunk.length), sizeof(chunk.length));
+        serialized.append(chunk.hash);
+    }
+    return serialized;
+}
+
+bool deserializeChunkList(const QByteArray& serialized, AssetChunkList& chunks) {
+    static const int ENTRY_SIZE = sizeof(uint32_t) + SHA256_HASH_LENGTH;
+
+    uint32_t count;
+    if (serialized.size() < (int)sizeof(count)) {
+        return false;
+    }
+    memcpy(&count, serialized.constData(), sizeof(count));
+    if ((int64_t)serialized.size() != (int64_t)sizeof(count) + (int64_t)count * ENTRY_SIZE) {
+        return false;
+    }
+
+    chunks.clear();
+    chunks.reserve(count);
+    const char* entry = serialized.constData() + sizeof(count);
+    for (uint32_t i = 0; i < count; ++i, entry += ENTRY_SIZE) {
+        AssetChunk chunk;
+        memcpy(&chunk.length, entry, sizeof(chunk.length));
+        chunk.hash = QByteArray(entry + sizeof(chunk.length), SHA256_HASH_LENGTH);
+        if (chunk.length == 0 || chunk.length > MAX_CONTENT_CHUNK_SIZE) {
+            return false;
+        }
+        chunks.push_back(chunk);
+    }
+    return true;
+}
+
+} // namespace AssetUtils
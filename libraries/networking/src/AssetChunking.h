@@ -0,0 +1,49 @@
+//
+//  AssetChunking.h
+//  libraries/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetChunking_h
+#define hifi_AssetChunking_h
+
+#include <cstdint>
+#include <vector>
+
+#include <QtCore/QByteArray>
+
+namespace AssetUtils {
+
+// Assets are cut into chunks where their content says so (FastCDC), not at fixed offsets, so an edit only
+// changes the chunks around it: the rest of a re-exported model or a texture variant keeps the chunks, and
+// the chunk hashes, of the version a client already has.
+const uint32_t MIN_CONTENT_CHUNK_SIZE = 16 * 1024;
+const uint32_t AVERAGE_CONTENT_CHUNK_SIZE = 64 * 1024;
+const uint32_t MAX_CONTENT_CHUNK_SIZE = 256 * 1024;
+
+// smaller assets are always downloaded whole
+const int64_t CHUNKED_DOWNLOAD_THRESHOLD = 1024 * 1024;
+
+struct AssetChunk {
+    uint32_t length;
+    QByteArray hash; // SHA-256 of the chunk's content
+};
+using AssetChunkList = std::vector<AssetChunk>;
+
+// the lengths of the chunks of the data, in order
+std::vector<uint32_t> findChunkLengths(const char* data, int64_t size);
+
+// the chunks of the data with their hashes
+AssetChunkList chunkData(const char* data, int64_t size);
+
+// the chunk list as it's sent by the asset-server, returns false if the serialized list is malformed
+QByteArray serializeChunkList(const AssetChunkList& chunks);
+bool deserializeChunkList(const QByteArray& serialized, AssetChunkList& chunks);
+
+} // namespace AssetUtils
+
+#endif // hifi_AssetChunking_h
@@ -14,14 +14,18 @@
 #include <cstdint>
 
 #include <QtCore/QBuffer>
+#include <QtCore/QDir>
+#include <QtCore/QPointer>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QThread>
 #include <QtScript/QScriptEngine>
 #include <QtNetwork/QNetworkDiskCache>
+#include <QtConcurrent/QtConcurrentRun>
 
 #include <shared/GlobalAppProperties.h>
 #include <shared/MiniPromises.h>
 
+#include "AssetPrefetcher.h"
 #include "AssetRequest.h"
 #include "AssetUpload.h"
 #include "AssetUtils.h"
@@ -34,7 +38,11 @@
 
 MessageID AssetClient::_currentID = 0;
 
-AssetClient::AssetClient() {
+static const QString ASSET_CHUNK_INDEX_FILENAME = "assetChunks.idx";
+
+AssetClient::AssetClient() :
+    _prefetcher(new AssetPrefetcher(this))
+{
     _cacheDir = qApp->property(hifi::properties::APP_LOCAL_DATA_PATH).toString();
     setCustomDeleter([](Dependency* dependency){
         static_cast<AssetClient*>(dependency)->deleteLater();
@@ -47,10 +55,13 @@ AssetClient::AssetClient() {
     packetReceiver.registerListener(PacketType::AssetGetInfoReply, this, "handleAssetGetInfoReply");
     packetReceiver.registerListener(PacketType::AssetGetReply, this, "handleAssetGetReply", true);
     packetReceiver.registerListener(PacketType::AssetUploadReply, this, "handleAssetUploadReply");
+    packetReceiver.registerListener(PacketType::AssetUploadChunkReply, this, "handleAssetUploadChunkReply");
+    packetReceiver.registerListener(PacketType::AssetGetChunkListReply, this, "handleAssetGetChunkListReply");
 
     connect(nodeList.data(), &LimitedNodeList::nodeKilled, this, &AssetClient::handleNodeKilled);
     connect(nodeList.data(), &LimitedNodeList::clientConnectionToNodeReset,
             this, &AssetClient::handleNodeClientConnectionReset);
+    connect(nodeList.data(), &LimitedNodeList::nodeActivated, this, &AssetClient::handleNodeActivated);
 }
 
 void AssetClient::initCaching() {
@@ -73,6 +84,8 @@ void AssetClient::initCaching() {
         networkAccessManager.setCache(cache);
         qInfo() << "ResourceManager disk cache setup at" << _cacheDir
                  << "(size:" << MAXIMUM_CACHE_SIZE / BYTES_PER_GIGABYTES << "GB)";
+
+        _chunkIndex.load(QDir(_cacheDir).absoluteFilePath(ASSET_CHUNK_INDEX_FILENAME));
     } else {
         auto cache = qobject_cast<QNetworkDiskCache*>(networkAccessManager.cache());
         qInfo() << "ResourceManager disk cache already setup at" << cache->cacheDirectory()
@@ -272,11 +285,26 @@ void AssetClient::clearCache() {
     if (auto cache = NetworkAccessManager::getInstance().cache()) {
         qInfo() << "AssetClient::clearCache(): Clearing disk cache.";
         cache->clear();
+        _chunkIndex.clear();
     } else {
         qCWarning(asset_client) << "No disk cache to clear.";
     }
 }
 
+void AssetClient::indexCachedAsset(const AssetUtils::AssetHash& hash, const QByteArray& data) {
+    QPointer<AssetClient> assetClient = this;
+    QtConcurrent::run([assetClient, hash, data] {
+        auto chunks = AssetUtils::chunkData(data.constData(), data.size());
+        if (assetClient) {
+            QMetaObject::invokeMethod(assetClient, [assetClient, hash, chunks] {
+                if (assetClient) {
+                    assetClient->_chunkIndex.addAsset(hash, chunks);
+                }
+            });
+        }
+    });
+}
+
 void AssetClient::handleAssetMappingOperationReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     Q_ASSERT(QThread::currentThread() == thread());
 
@@ -335,6 +363,15 @@ GetAllMappingsRequest* AssetClient::createGetAllMappingsRequest() {
     return request;
 }
 
+GetMappingsPageRequest* AssetClient::createGetMappingsPageRequest(const AssetUtils::AssetPath& prefix,
+                                                                  const AssetUtils::AssetPath& after, uint32_t limit) {
+    auto request = new GetMappingsPageRequest(prefix, after, limit);
+
+    request->moveToThread(thread());
+
+    return request;
+}
+
 DeleteMappingsRequest* AssetClient::createDeleteMappingsRequest(const AssetUtils::AssetPathList& paths) {
     auto request = new DeleteMappingsRequest(paths);
 
@@ -457,6 +494,64 @@ MessageID AssetClient::getAssetInfo(const QString& hash, GetInfoCallback callbac
     return INVALID_MESSAGE_ID;
 }
 
+MessageID AssetClient::getAssetChunkList(const QString& hash, GetChunkListCallback callback) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    auto nodeList = DependencyManager::get<LimitedNodeList>();
+    SharedNodePointer assetServer = nodeList->soloNodeOfType(NodeType::AssetServer);
+
+    if (assetServer) {
+        auto messageID = ++_currentID;
+
+        auto payloadSize = sizeof(messageID) + AssetUtils::SHA256_HASH_LENGTH;
+        auto packet = NLPacket::create(PacketType::AssetGetChunkList, payloadSize, true);
+
+        packet->writePrimitive(messageID);
+        packet->write(QByteArray::fromHex(hash.toLatin1()));
+
+        if (nodeList->sendPacket(std::move(packet), *assetServer) != -1) {
+            _pendingChunkListRequests[assetServer][messageID] = callback;
+
+            return messageID;
+        }
+    }
+
+    callback(false, AssetUtils::AssetServerError::NoError, AssetUtils::AssetChunkList());
+    return INVALID_MESSAGE_ID;
+}
+
+void AssetClient::handleAssetGetChunkListReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    MessageID messageID;
+    message->readPrimitive(&messageID);
+
+    AssetUtils::AssetServerError error;
+    message->readPrimitive(&error);
+
+    AssetUtils::AssetChunkList chunks;
+    if (error == AssetUtils::AssetServerError::NoError && !AssetUtils::deserializeChunkList(message->readAll(), chunks)) {
+        qCWarning(asset_client) << "Received a malformed chunk list from the asset-server";
+        error = AssetUtils::AssetServerError::FileOperationFailed;
+    }
+
+    // Check if we have any pending requests for this node
+    auto messageMapIt = _pendingChunkListRequests.find(senderNode);
+    if (messageMapIt != _pendingChunkListRequests.end()) {
+
+        // Found the node, get the MessageID -> Callback map
+        auto& messageCallbackMap = messageMapIt->second;
+
+        // Check if we have this pending request
+        auto requestIt = messageCallbackMap.find(messageID);
+        if (requestIt != messageCallbackMap.end()) {
+            auto callback = requestIt->second;
+            messageCallbackMap.erase(requestIt);
+            callback(true, error, chunks);
+        }
+    }
+}
+
 void AssetClient::handleAssetGetInfoReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     Q_ASSERT(QThread::currentThread() == thread());
 
@@ -683,6 +778,61 @@ MessageID AssetClient::getAllAssetMappings(MappingOperationCallback callback) {
     return INVALID_MESSAGE_ID;
 }
 
+MessageID AssetClient::getAssetManifest(MappingOperationCallback callback) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    auto nodeList = DependencyManager::get<LimitedNodeList>();
+    SharedNodePointer assetServer = nodeList->soloNodeOfType(NodeType::AssetServer);
+
+    if (assetServer) {
+        auto packetList = NLPacketList::create(PacketType::AssetMappingOperation, QByteArray(), true, true);
+
+        auto messageID = ++_currentID;
+        packetList->writePrimitive(messageID);
+
+        packetList->writePrimitive(AssetUtils::AssetMappingOperationType::GetManifest);
+
+        if (nodeList->sendPacketList(std::move(packetList), *assetServer) != -1) {
+            _pendingMappingRequests[assetServer][messageID] = callback;
+
+            return messageID;
+        }
+    }
+
+    callback(false, AssetUtils::AssetServerError::NoError, QSharedPointer<ReceivedMessage>());
+    return INVALID_MESSAGE_ID;
+}
+
+MessageID AssetClient::getAssetMappingsPage(const AssetUtils::AssetPath& prefix, const AssetUtils::AssetPath& after,
+                                            uint32_t limit, MappingOperationCallback callback) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    auto nodeList = DependencyManager::get<LimitedNodeList>();
+    SharedNodePointer assetServer = nodeList->soloNodeOfType(NodeType::AssetServer);
+
+    if (assetServer) {
+        auto packetList = NLPacketList::create(PacketType::AssetMappingOperation, QByteArray(), true, true);
+
+        auto messageID = ++_currentID;
+        packetList->writePrimitive(messageID);
+
+        packetList->writePrimitive(AssetUtils::AssetMappingOperationType::GetPage);
+
+        packetList->writeString(prefix);
+        packetList->writeString(after);
+        packetList->writePrimitive(limit);
+
+        if (nodeList->sendPacketList(std::move(packetList), *assetServer) != -1) {
+            _pendingMappingRequests[assetServer][messageID] = callback;
+
+            return messageID;
+        }
+    }
+
+    callback(false, AssetUtils::AssetServerError::NoError, QSharedPointer<ReceivedMessage>());
+    return INVALID_MESSAGE_ID;
+}
+
 MessageID AssetClient::deleteAssetMappings(const AssetUtils::AssetPathList& paths, MappingOperationCallback callback) {
     auto nodeList = DependencyManager::get<LimitedNodeList>();
     SharedNodePointer assetServer = nodeList->soloNodeOfType(NodeType::AssetServer);
@@ -820,6 +970,17 @@ bool AssetClient::cancelGetAssetInfoRequest(MessageID id) {
     return false;
 }
 
+bool AssetClient::cancelGetAssetChunkListRequest(MessageID id) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    for (auto& kv : _pendingChunkListRequests) {
+        if (kv.second.erase(id)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool AssetClient::cancelGetAssetRequest(MessageID id) {
     Q_ASSERT(QThread::currentThread() == thread());
 
@@ -852,6 +1013,11 @@ bool AssetClient::cancelUploadAssetRequest(MessageID id) {
             return true;
         }
     }
+    for (auto& kv : _pendingUploadChunks) {
+        if (kv.second.erase(id)) {
+            return true;
+        }
+    }
     return false;
 }
 
@@ -922,6 +1088,72 @@ void AssetClient::handleAssetUploadReply(QSharedPointer<ReceivedMessage> message
     }
 }
 
+MessageID AssetClient::uploadAssetChunk(const QUuid& uploadID, uint64_t totalSize, uint32_t chunkIndex,
+                                        const QByteArray& chunk, UploadChunkCallback callback) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    auto nodeList = DependencyManager::get<LimitedNodeList>();
+    SharedNodePointer assetServer = nodeList->soloNodeOfType(NodeType::AssetServer);
+
+    if (assetServer) {
+        auto packetList = NLPacketList::create(PacketType::AssetUploadChunk, QByteArray(), true, true);
+
+        auto messageID = ++_currentID;
+        packetList->writePrimitive(messageID);
+        packetList->write(uploadID.toRfc4122());
+        packetList->writePrimitive(totalSize);
+        packetList->writePrimitive(chunkIndex);
+        packetList->write(chunk);
+
+        if (nodeList->sendPacketList(std::move(packetList), *assetServer) != -1) {
+            _pendingUploadChunks[assetServer][messageID] = callback;
+
+            return messageID;
+        }
+    }
+
+    callback(false, AssetUtils::AssetServerError::NoError, QByteArray(), QString());
+    return INVALID_MESSAGE_ID;
+}
+
+void AssetClient::handleAssetUploadChunkReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    MessageID messageID;
+    message->readPrimitive(&messageID);
+
+    AssetUtils::AssetServerError error;
+    message->readPrimitive(&error);
+
+    QByteArray receivedChunks;
+    QString hashString;
+
+    if (!error) {
+        quint8 isComplete;
+        message->readPrimitive(&isComplete);
+
+        if (isComplete) {
+            hashString = message->read(AssetUtils::SHA256_HASH_LENGTH).toHex();
+            qCDebug(asset_client) << "Successfully uploaded asset to asset-server - SHA256 hash is " << hashString;
+        } else {
+            uint32_t numBytes;
+            message->readPrimitive(&numBytes);
+            receivedChunks = message->read(numBytes);
+        }
+    }
+
+    auto messageMapIt = _pendingUploadChunks.find(senderNode);
+    if (messageMapIt != _pendingUploadChunks.end()) {
+        auto& messageCallbackMap = messageMapIt->second;
+        auto requestIt = messageCallbackMap.find(messageID);
+        if (requestIt != messageCallbackMap.end()) {
+            auto callback = requestIt->second;
+            messageCallbackMap.erase(requestIt);
+            callback(true, error, receivedChunks, hashString);
+        }
+    }
+}
+
 void AssetClient::handleNodeKilled(SharedNodePointer node) {
     Q_ASSERT(QThread::currentThread() == thread());
 
@@ -929,6 +1161,9 @@ void AssetClient::handleNodeKilled(SharedNodePointer node) {
         return;
     }
 
+    // stop prefetching before the requests in flight fail, so they aren't retried
+    _prefetcher->clear();
+
     forceFailureOfPendingRequests(node);
 
     {
@@ -955,6 +1190,39 @@ void AssetClient::handleNodeClientConnectionReset(SharedNodePointer node) {
     forceFailureOfPendingRequests(node);
 }
 
+void AssetClient::handleNodeActivated(SharedNodePointer node) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    if (node->getType() != NodeType::AssetServer || !_isPrefetchingEnabled) {
+        return;
+    }
+
+    // the asset-server tells us which assets the domain is going to need, we fetch them while nothing else is asked for
+    getAssetManifest([this](bool responseReceived, AssetUtils::AssetServerError error, QSharedPointer<ReceivedMessage> message) {
+        if (!responseReceived || error != AssetUtils::AssetServerError::NoError) {
+            return;
+        }
+
+        uint32_t numberOfHashes;
+        message->readPrimitive(&numberOfHashes);
+
+        QList<AssetUtils::AssetHash> hashes;
+        for (uint32_t i = 0; i < numberOfHashes && message->getBytesLeftToRead() >= AssetUtils::SHA256_HASH_LENGTH; ++i) {
+            hashes << message->read(AssetUtils::SHA256_HASH_LENGTH).toHex();
+        }
+
+        _prefetcher->setManifest(hashes);
+    });
+}
+
+int AssetClient::getNumPendingGetRequests() const {
+    int numPending = 0;
+    for (const auto& kv : _pendingRequests) {
+        numPending += (int)kv.second.size();
+    }
+    return numPending;
+}
+
 void AssetClient::forceFailureOfPendingRequests(SharedNodePointer node) {
 
     {
@@ -984,6 +1252,17 @@ void AssetClient::forceFailureOfPendingRequests(SharedNodePointer node) {
         }
     }
 
+    {
+        auto messageMapIt = _pendingChunkListRequests.find(node);
+        if (messageMapIt != _pendingChunkListRequests.end()) {
+            auto callbacks = std::move(messageMapIt->second);
+            messageMapIt->second.clear();
+            for (const auto& value : callbacks) {
+                value.second(false, AssetUtils::AssetServerError::NoError, AssetUtils::AssetChunkList());
+            }
+        }
+    }
+
     {
         auto messageMapIt = _pendingMappingRequests.find(node);
         if (messageMapIt != _pendingMappingRequests.end()) {
@@ -993,4 +1272,16 @@ void AssetClient::forceFailureOfPendingRequests(SharedNodePointer node) {
             messageMapIt->second.clear();
         }
     }
+
+    {
+        // chunked uploads resume from the chunks the asset-server has once they reconnect
+        auto messageMapIt = _pendingUploadChunks.find(node);
+        if (messageMapIt != _pendingUploadChunks.end()) {
+            auto callbacks = std::move(messageMapIt->second);
+            messageMapIt->second.clear();
+            for (const auto& value : callbacks) {
+                value.second(false, AssetUtils::AssetServerError::NoError, QByteArray(), QString());
+            }
+        }
+    }
 }
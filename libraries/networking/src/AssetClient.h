@@ -16,11 +16,14 @@
 #include <QtQml/QJSEngine>
 #include <QString>
 
+#include <atomic>
 #include <map>
 
 #include <DependencyManager.h>
 #include <shared/MiniPromises.h>
 
+#include "AssetChunkIndex.h"
+#include "AssetChunking.h"
 #include "AssetUtils.h"
 #include "ByteRange.h"
 #include "ClientServerUtils.h"
@@ -31,6 +34,8 @@
 class GetMappingRequest;
 class SetMappingRequest;
 class GetAllMappingsRequest;
+class GetMappingsPageRequest;
+class AssetPrefetcher;
 class DeleteMappingsRequest;
 class RenameMappingRequest;
 class SetBakingEnabledRequest;
@@ -46,6 +51,11 @@ using MappingOperationCallback = std::function<void(bool responseReceived, Asset
 using ReceivedAssetCallback = std::function<void(bool responseReceived, AssetUtils::AssetServerError serverError, const QByteArray& data)>;
 using GetInfoCallback = std::function<void(bool responseReceived, AssetUtils::AssetServerError serverError, AssetInfo info)>;
 using UploadResultCallback = std::function<void(bool responseReceived, AssetUtils::AssetServerError serverError, const QString& hash)>;
+// receivedChunks has a bit set for each chunk the asset-server has written, hash is only set once the upload is complete
+using UploadChunkCallback = std::function<void(bool responseReceived, AssetUtils::AssetServerError serverError,
+                                               const QByteArray& receivedChunks, const QString& hash)>;
+using GetChunkListCallback = std::function<void(bool responseReceived, AssetUtils::AssetServerError serverError,
+                                                const AssetUtils::AssetChunkList& chunks)>;
 using ProgressCallback = std::function<void(qint64 totalReceived, qint64 total)>;
 
 class AssetClient : public QObject, public Dependency {
@@ -55,6 +65,9 @@ public:
 
     Q_INVOKABLE GetMappingRequest* createGetMappingRequest(const AssetUtils::AssetPath& path);
     Q_INVOKABLE GetAllMappingsRequest* createGetAllMappingsRequest();
+    Q_INVOKABLE GetMappingsPageRequest* createGetMappingsPageRequest(const AssetUtils::AssetPath& prefix,
+                                                                     const AssetUtils::AssetPath& after = QString(),
+                                                                     uint32_t limit = AssetUtils::MAX_MAPPINGS_PAGE_SIZE);
     Q_INVOKABLE DeleteMappingsRequest* createDeleteMappingsRequest(const AssetUtils::AssetPathList& paths);
     Q_INVOKABLE SetMappingRequest* createSetMappingRequest(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash);
     Q_INVOKABLE RenameMappingRequest* createRenameMappingRequest(const AssetUtils::AssetPath& oldPath, const AssetUtils::AssetPath& newPath);
@@ -63,6 +76,9 @@ public:
     Q_INVOKABLE AssetUpload* createUpload(const QString& filename);
     Q_INVOKABLE AssetUpload* createUpload(const QByteArray& data);
 
+    // whether the assets of the asset-server's prefetch manifest are downloaded in the background on connect
+    void setPrefetchingEnabled(bool enabled) { _isPrefetchingEnabled = enabled; }
+
 public slots:
     void initCaching();
 
@@ -78,25 +94,40 @@ private slots:
     void handleAssetGetInfoReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleAssetGetReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleAssetUploadReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void handleAssetUploadChunkReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void handleAssetGetChunkListReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
 
     void handleNodeKilled(SharedNodePointer node);
     void handleNodeClientConnectionReset(SharedNodePointer node);
+    void handleNodeActivated(SharedNodePointer node);
 
 private:
     MessageID getAssetMapping(const AssetUtils::AssetHash& hash, MappingOperationCallback callback);
     MessageID getAllAssetMappings(MappingOperationCallback callback);
+    MessageID getAssetManifest(MappingOperationCallback callback);
+    MessageID getAssetMappingsPage(const AssetUtils::AssetPath& prefix, const AssetUtils::AssetPath& after, uint32_t limit,
+                                   MappingOperationCallback callback);
     MessageID setAssetMapping(const QString& path, const AssetUtils::AssetHash& hash, MappingOperationCallback callback);
     MessageID deleteAssetMappings(const AssetUtils::AssetPathList& paths, MappingOperationCallback callback);
     MessageID renameAssetMapping(const AssetUtils::AssetPath& oldPath, const AssetUtils::AssetPath& newPath, MappingOperationCallback callback);
     MessageID setBakingEnabled(const AssetUtils::AssetPathList& paths, bool enabled, MappingOperationCallback callback);
 
     MessageID getAssetInfo(const QString& hash, GetInfoCallback callback);
+    MessageID getAssetChunkList(const QString& hash, GetChunkListCallback callback);
     MessageID getAsset(const QString& hash, AssetUtils::DataOffset start, AssetUtils::DataOffset end,
                   ReceivedAssetCallback callback, ProgressCallback progressCallback);
     MessageID uploadAsset(const QByteArray& data, UploadResultCallback callback);
+    MessageID uploadAssetChunk(const QUuid& uploadID, uint64_t totalSize, uint32_t chunkIndex, const QByteArray& chunk,
+                               UploadChunkCallback callback);
+
+    // chunks a large asset just saved to the disk cache off this thread, as that hashes all of it, then indexes its chunks
+    void indexCachedAsset(const AssetUtils::AssetHash& hash, const QByteArray& data);
+
+    int getNumPendingGetRequests() const;
 
     bool cancelMappingRequest(MessageID id);
     bool cancelGetAssetInfoRequest(MessageID id);
+    bool cancelGetAssetChunkListRequest(MessageID id);
     bool cancelGetAssetRequest(MessageID id);
     bool cancelUploadAssetRequest(MessageID id);
 
@@ -115,15 +146,25 @@ private:
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, MappingOperationCallback>> _pendingMappingRequests;
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, GetAssetRequestData>> _pendingRequests;
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, GetInfoCallback>> _pendingInfoRequests;
+    std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, GetChunkListCallback>> _pendingChunkListRequests;
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, UploadResultCallback>> _pendingUploads;
+    std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, UploadChunkCallback>> _pendingUploadChunks;
 
     QString _cacheDir;
 
+    // the chunks of the assets in the disk cache, which downloads of similar assets don't fetch again
+    AssetChunkIndex _chunkIndex;
+
+    std::atomic<bool> _isPrefetchingEnabled { false };
+    AssetPrefetcher* _prefetcher;
+
+    friend class AssetPrefetcher;
     friend class AssetRequest;
     friend class AssetUpload;
     friend class MappingRequest;
     friend class GetMappingRequest;
     friend class GetAllMappingsRequest;
+    friend class GetMappingsPageRequest;
     friend class SetMappingRequest;
     friend class DeleteMappingsRequest;
     friend class RenameMappingRequest;
@@ -0,0 +1,100 @@
+//
+//  AssetPrefetcher.cpp
+//  libraries/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetPrefetcher.h"
+
+#include <QtNetwork/QAbstractNetworkCache>
+
+#include <DependencyManager.h>
+
+#include "AssetClient.h"
+#include "AssetRequest.h"
+#include "NetworkAccessManager.h"
+#include "NetworkLogging.h"
+
+static const int MAX_CONCURRENT_PREFETCHES = 2;
+static const qint64 MAX_PREFETCH_BYTES = 256 * 1024 * 1024;
+
+// how long prefetching waits before it looks again whether the connection is free
+static const int IDLE_CHECK_INTERVAL_MS = 500;
+
+AssetPrefetcher::AssetPrefetcher(QObject* parent) :
+    QObject(parent),
+    _idleTimer(this) // so it moves to the thread of the AssetClient with us
+{
+    _idleTimer.setSingleShot(true);
+    _idleTimer.setInterval(IDLE_CHECK_INTERVAL_MS);
+    connect(&_idleTimer, &QTimer::timeout, this, &AssetPrefetcher::prefetchNext);
+}
+
+void AssetPrefetcher::setManifest(const QList<AssetUtils::AssetHash>& hashes) {
+    clear();
+
+    auto cache = NetworkAccessManager::getInstance().cache();
+    if (!cache) {
+        return;
+    }
+
+    for (const auto& hash : hashes) {
+        // only the assets that aren't in the disk cache yet are fetched
+        if (AssetUtils::isValidHash(hash) && !cache->metaData(AssetUtils::getATPUrl(hash)).isValid()) {
+            _queue << hash;
+        }
+    }
+
+    if (!_queue.isEmpty()) {
+        qCDebug(asset_client) << "Prefetching" << _queue.size() << "of the" << hashes.size() << "assets in the manifest";
+        prefetchNext();
+    }
+}
+
+void AssetPrefetcher::clear() {
+    _idleTimer.stop();
+    _queue.clear();
+    _prefetchedBytes = 0;
+
+    // deleting a request cancels it
+    for (auto request : _inFlight) {
+        request->disconnect(this);
+        request->deleteLater();
+    }
+    _inFlight.clear();
+}
+
+void AssetPrefetcher::prefetchNext() {
+    auto assetClient = DependencyManager::get<AssetClient>();
+
+    while (!_queue.isEmpty() && _inFlight.size() < MAX_CONCURRENT_PREFETCHES && _prefetchedBytes < MAX_PREFETCH_BYTES) {
+        // requests for assets the domain needs right now go first, try again once they are done
+        if (assetClient->getNumPendingGetRequests() > _inFlight.size()) {
+            _idleTimer.start();
+            return;
+        }
+
+        auto request = new AssetRequest(_queue.takeFirst());
+        connect(request, &AssetRequest::finished, this, &AssetPrefetcher::requestFinished);
+        _inFlight.insert(request);
+        request->start();
+    }
+}
+
+void AssetPrefetcher::requestFinished(AssetRequest* request) {
+    _inFlight.remove(request);
+
+    if (request->getError() == AssetRequest::NoError) {
+        _prefetchedBytes += request->getData().size();
+        ++_prefetched;
+    } else {
+        qCDebug(asset_client) << "Failed to prefetch" << request->getHash() << "-" << request->getErrorString();
+    }
+    request->deleteLater();
+
+    prefetchNext();
+}
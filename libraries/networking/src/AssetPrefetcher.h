@@ -0,0 +1,54 @@
+//
+//  AssetPrefetcher.h
+//  libraries/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_AssetPrefetcher_h
+#define hifi_AssetPrefetcher_h
+
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QStringList>
+#include <QtCore/QTimer>
+
+#include "AssetUtils.h"
+
+class AssetRequest;
+
+// Downloads the assets of the asset-server's prefetch manifest into the disk cache, in the order of the manifest,
+// so they are already there when the domain needs them. Prefetching only uses the connection while nothing else
+// is downloaded from the asset-server, and stops once it has fetched a budget's worth of assets.
+// Lives on AssetClient's thread.
+class AssetPrefetcher : public QObject {
+    Q_OBJECT
+public:
+    AssetPrefetcher(QObject* parent = nullptr);
+
+    // replaces the assets to prefetch with those of the manifest
+    void setManifest(const QList<AssetUtils::AssetHash>& hashes);
+    void clear();
+
+    int getQueued() const { return _queue.size(); }
+    quint64 getPrefetched() const { return _prefetched; }
+
+private slots:
+    void prefetchNext();
+
+private:
+    void requestFinished(AssetRequest* request);
+
+    QStringList _queue;
+    QSet<AssetRequest*> _inFlight;
+    qint64 _prefetchedBytes { 0 };
+    quint64 _prefetched { 0 };
+    QTimer _idleTimer;
+};
+
+#endif // hifi_AssetPrefetcher_h
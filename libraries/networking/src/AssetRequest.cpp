@@ -13,6 +13,7 @@
 
 #include <algorithm>
 
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QThread>
 
 #include <StatTracker.h>
@@ -22,6 +23,7 @@
 #include "NetworkLogging.h"
 #include "NodeList.h"
 #include "ResourceCache.h"
+#include "ResourceRequest.h"
 
 static int requestID = 0;
 
@@ -38,6 +40,10 @@ AssetRequest::~AssetRequest() {
     if (_assetRequestID) {
         assetClient->cancelGetAssetRequest(_assetRequestID);
     }
+    if (_chunkListRequestID) {
+        assetClient->cancelGetAssetChunkListRequest(_chunkListRequestID);
+    }
+    cancelRangeRequests();
 }
 
 void AssetRequest::start() {
@@ -75,12 +81,33 @@ void AssetRequest::start() {
 
     _state = WaitingForData;
 
+    auto assetClient = DependencyManager::get<AssetClient>();
+    if (!_byteRange.isSet() && _assetSize >= AssetUtils::CHUNKED_DOWNLOAD_THRESHOLD && !assetClient->_chunkIndex.isEmpty()) {
+        // we may already have most of this large asset as part of other assets, everything else is a single request
+        requestChunkList();
+    } else {
+        requestAsset();
+    }
+}
+
+AssetRequest::Error AssetRequest::errorForServerError(AssetUtils::AssetServerError serverError) {
+    switch (serverError) {
+        case AssetUtils::AssetServerError::AssetNotFound:
+            return NotFound;
+        case AssetUtils::AssetServerError::InvalidByteRange:
+            return InvalidByteRange;
+        default:
+            return UnknownError;
+    }
+}
+
+void AssetRequest::requestAsset() {
     auto assetClient = DependencyManager::get<AssetClient>();
     auto that = QPointer<AssetRequest>(this); // Used to track the request's lifetime
     auto hash = _hash;
 
     _assetRequestID = assetClient->getAsset(_hash, _byteRange.fromInclusive, _byteRange.toExclusive,
-        [this, that, hash](bool responseReceived, AssetUtils::AssetServerError serverError, const QByteArray& data) {
+        [this, that, hash, assetClient](bool responseReceived, AssetUtils::AssetServerError serverError, const QByteArray& data) {
 
         if (!that) {
             qCWarning(asset_client) << "Got reply for dead asset request " << hash << "- error code" << _error;
@@ -92,17 +119,7 @@ void AssetRequest::start() {
         if (!responseReceived) {
             _error = NetworkError;
         } else if (serverError != AssetUtils::AssetServerError::NoError) {
-            switch (serverError) {
-                case AssetUtils::AssetServerError::AssetNotFound:
-                    _error = NotFound;
-                    break;
-                case AssetUtils::AssetServerError::InvalidByteRange:
-                    _error = InvalidByteRange;
-                    break;
-                default:
-                    _error = UnknownError;
-                    break;
-            }
+            _error = errorForServerError(serverError);
         } else {
             if (!_byteRange.isSet() && AssetUtils::hashData(data).toHex() != _hash) {
                 // the hash of the received data does not match what we expect, so we return an error
@@ -116,6 +133,11 @@ void AssetRequest::start() {
 
                 if (!_byteRange.isSet()) {
                     AssetUtils::saveToCache(getUrl(), data);
+
+                    // the next version of a large asset can be assembled from the chunks of this one
+                    if (data.size() >= AssetUtils::CHUNKED_DOWNLOAD_THRESHOLD) {
+                        assetClient->indexCachedAsset(_hash, data);
+                    }
                 }
             }
         }
@@ -135,6 +157,181 @@ void AssetRequest::start() {
     });
 }
 
+void AssetRequest::requestChunkList() {
+    auto assetClient = DependencyManager::get<AssetClient>();
+    auto that = QPointer<AssetRequest>(this);
+
+    _chunkListRequestID = assetClient->getAssetChunkList(_hash,
+        [this, that](bool responseReceived, AssetUtils::AssetServerError serverError, const AssetUtils::AssetChunkList& chunks) {
+
+        if (!that) {
+            return;
+        }
+        _chunkListRequestID = INVALID_MESSAGE_ID;
+
+        // small assets have no chunk list, and an asset we have no chunks of is fetched whole
+        bool hasChunkList = responseReceived && serverError == AssetUtils::AssetServerError::NoError && !chunks.empty();
+        if (!hasChunkList || !requestMissingChunks(chunks)) {
+            requestAsset();
+        }
+    });
+}
+
+bool AssetRequest::requestMissingChunks(const AssetUtils::AssetChunkList& chunks) {
+    // past this many separate ranges to fetch, fetching the asset whole is cheaper
+    static const size_t MAX_CHUNK_RANGE_REQUESTS = 32;
+
+    auto assetClient = DependencyManager::get<AssetClient>();
+    auto& chunkIndex = assetClient->_chunkIndex;
+
+    int64_t size = 0;
+    for (const auto& chunk : chunks) {
+        size += chunk.length;
+    }
+    if (size > AssetUtils::MAX_UPLOAD_SIZE) {
+        return false;
+    }
+
+    QByteArray data((int)size, Qt::Uninitialized);
+    QHash<AssetUtils::AssetHash, QByteArray> sources;
+    std::vector<std::pair<int64_t, int64_t>> missingRanges;
+    int64_t reused = 0;
+    int64_t offset = 0;
+
+    for (const auto& chunk : chunks) {
+        bool found = false;
+
+        AssetChunkIndex::Location location;
+        while (!found && chunkIndex.findChunk(chunk.hash, location)) {
+            auto sourceIt = sources.find(location.assetHash);
+            if (sourceIt == sources.end()) {
+                sourceIt = sources.insert(location.assetHash, AssetUtils::loadFromCache(AssetUtils::getATPUrl(location.assetHash)));
+            }
+
+            const auto& source = sourceIt.value();
+            if (location.length == chunk.length && location.offset + location.length <= source.size()) {
+                auto piece = QByteArray::fromRawData(source.constData() + location.offset, location.length);
+                if (QCryptographicHash::hash(piece, QCryptographicHash::Sha256) == chunk.hash) {
+                    memcpy(data.data() + offset, piece.constData(), chunk.length);
+                    reused += chunk.length;
+                    found = true;
+                }
+            }
+
+            if (!found) {
+                // the disk cache has evicted the asset since it was indexed, the chunk may still be in an older one
+                chunkIndex.removeAsset(location.assetHash);
+            }
+        }
+
+        if (!found) {
+            if (!missingRanges.empty() && missingRanges.back().second == offset) {
+                missingRanges.back().second += chunk.length;
+            } else {
+                missingRanges.emplace_back(offset, offset + chunk.length);
+            }
+        }
+        offset += chunk.length;
+    }
+
+    if (reused == 0 || missingRanges.size() > MAX_CHUNK_RANGE_REQUESTS) {
+        return false;
+    }
+
+    qCDebug(asset_client) << "Transfer dedup reuses" << reused << "of the" << size << "bytes of" << _hash
+        << "from cached assets, fetching" << missingRanges.size() << "ranges";
+
+    auto statTracker = DependencyManager::get<StatTracker>();
+    statTracker->incrementStat(STAT_ATP_TRANSFER_DEDUP_REQUEST);
+    statTracker->updateStat(STAT_ATP_TRANSFER_DEDUP_BYTES, reused);
+
+    _data = data;
+    _chunks = chunks;
+    _totalReceived = reused;
+    emit progress(_totalReceived, _data.size());
+
+    if (missingRanges.empty()) {
+        finishChunkedRequest();
+        return true;
+    }
+
+    auto that = QPointer<AssetRequest>(this);
+    _numPendingRequests = (int)missingRanges.size();
+    for (const auto& range : missingRanges) {
+        if (_state == Finished) {
+            // a range failed right away, there is no point in asking for the others
+            break;
+        }
+
+        auto start = range.first;
+        auto end = range.second;
+        auto id = assetClient->getAsset(_hash, start, end,
+            [this, that, start, end](bool responseReceived, AssetUtils::AssetServerError serverError, const QByteArray& data) {
+
+            if (!that) {
+                return;
+            }
+            --_numPendingRequests;
+
+            if (_state == Finished) {
+                // another range failed already
+                return;
+            }
+
+            if (!responseReceived) {
+                _error = NetworkError;
+            } else if (serverError != AssetUtils::AssetServerError::NoError) {
+                _error = errorForServerError(serverError);
+            } else if (data.size() != end - start) {
+                _error = SizeVerificationFailed;
+            } else {
+                memcpy(_data.data() + start, data.constData(), data.size());
+                _totalReceived += data.size();
+                emit progress(_totalReceived, _data.size());
+            }
+
+            if (_error != NoError) {
+                qCWarning(asset_client) << "Got error retrieving chunks of asset" << _hash << "- error code" << _error;
+                cancelRangeRequests();
+                _data.clear();
+                _state = Finished;
+                emit finished(this);
+            } else if (_numPendingRequests == 0) {
+                finishChunkedRequest();
+            }
+        }, [](qint64 totalReceived, qint64 total) {});
+
+        if (id != INVALID_MESSAGE_ID) {
+            _rangeRequestIDs << id;
+        }
+    }
+    return true;
+}
+
+void AssetRequest::finishChunkedRequest() {
+    _rangeRequestIDs.clear();
+
+    if (AssetUtils::hashData(_data).toHex() != _hash) {
+        qCWarning(asset_client) << "Asset" << _hash << "assembled from chunks does not match its hash";
+        _error = HashVerificationFailed;
+        _data.clear();
+    } else {
+        AssetUtils::saveToCache(getUrl(), _data);
+        DependencyManager::get<AssetClient>()->_chunkIndex.addAsset(_hash, _chunks);
+    }
+
+    _state = Finished;
+    emit finished(this);
+}
+
+void AssetRequest::cancelRangeRequests() {
+    auto assetClient = DependencyManager::get<AssetClient>();
+    for (auto id : _rangeRequestIDs) {
+        assetClient->cancelGetAssetRequest(id);
+    }
+    _rangeRequestIDs.clear();
+}
+
 
 const QString AssetRequest::getErrorString() const {
     QString result;
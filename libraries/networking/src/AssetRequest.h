@@ -15,6 +15,7 @@
 #include <QByteArray>
 #include <QObject>
 #include <QString>
+#include <QVector>
 
 #include "AssetClient.h"
 #include "AssetUtils.h"
@@ -57,11 +58,24 @@ public:
 
     bool loadedFromCache() const { return _loadedFromCache; }
 
+    // the size of the asset if the caller knows it, only assets known to be large are fetched by chunks
+    void setAssetSize(qint64 assetSize) { _assetSize = assetSize; }
+
 signals:
     void finished(AssetRequest* thisRequest);
     void progress(qint64 totalReceived, qint64 total);
 
 private:
+    static Error errorForServerError(AssetUtils::AssetServerError serverError);
+
+    void requestAsset();
+
+    // large assets are assembled from the chunks we already have in other cached assets and the ranges we don't
+    void requestChunkList();
+    bool requestMissingChunks(const AssetUtils::AssetChunkList& chunks);
+    void finishChunkedRequest();
+    void cancelRangeRequests();
+
     int _requestID;
     State _state = NotStarted;
     Error _error = NoError;
@@ -70,7 +84,11 @@ private:
     QByteArray _data;
     int _numPendingRequests { 0 };
     MessageID _assetRequestID { INVALID_MESSAGE_ID };
+    MessageID _chunkListRequestID { INVALID_MESSAGE_ID };
+    QVector<MessageID> _rangeRequestIDs;
+    AssetUtils::AssetChunkList _chunks;
     const ByteRange _byteRange;
+    qint64 _assetSize { 0 };
     bool _loadedFromCache { false };
 };
 
@@ -104,7 +104,7 @@ void AssetResourceRequest::requestMappingForPath(const AssetUtils::AssetPath& pa
                     _result = RedirectFail;
                     failed = true;
                 } else {
-                    requestHash(request->getHash());
+                    requestHash(request->getHash(), request->getAssetSize());
                 }
 
                 break;
@@ -144,10 +144,11 @@ void AssetResourceRequest::requestMappingForPath(const AssetUtils::AssetPath& pa
     _assetMappingRequest->start();
 }
 
-void AssetResourceRequest::requestHash(const AssetUtils::AssetHash& hash) {
+void AssetResourceRequest::requestHash(const AssetUtils::AssetHash& hash, qint64 assetSize) {
     // Make request to atp
     auto assetClient = DependencyManager::get<AssetClient>();
     _assetRequest = assetClient->createRequest(hash, _byteRange);
+    _assetRequest->setAssetSize(assetSize);
 
     connect(_assetRequest, &AssetRequest::progress, this, &AssetResourceRequest::onDownloadProgress);
     connect(_assetRequest, &AssetRequest::finished, this, [this](AssetRequest* req) {
@@ -39,7 +39,7 @@ private:
     static bool urlIsAssetHash(const QUrl& url);
 
     void requestMappingForPath(const AssetUtils::AssetPath& path);
-    void requestHash(const AssetUtils::AssetHash& hash);
+    void requestHash(const AssetUtils::AssetHash& hash, qint64 assetSize = 0);
 
     GetMappingRequest* _assetMappingRequest { nullptr };
     AssetRequest* _assetRequest { nullptr };
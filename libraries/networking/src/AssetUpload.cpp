@@ -13,6 +13,7 @@
 
 #include <QtCore/QFileInfo>
 #include <QtCore/QThread>
+#include <QtCore/QTimer>
 
 #include "AssetClient.h"
 #include "NetworkLogging.h"
@@ -46,6 +47,8 @@ QString AssetUpload::getErrorString() const {
             return "There was a problem reaching your Asset Server. Please check your network connectivity.";
         case AssetUpload::ServerFileError:
             return "The Asset Server failed to store the asset. Please try again.";
+        case AssetUpload::InvalidChunkError:
+            return "The Asset Server refused part of the upload as invalid. Please try again.";
         default:
             return QString("Unknown error with code %1").arg(_error);
     }
@@ -80,6 +83,11 @@ void AssetUpload::start() {
     if (!_filename.isEmpty()) {
         qCDebug(asset_client) << "Attempting to upload" << _filename << "to asset-server.";
     }
+
+    if ((uint64_t)_data.size() > AssetUtils::CHUNKED_UPLOAD_THRESHOLD) {
+        startChunkedUpload();
+        return;
+    }
     
     assetClient->uploadAsset(_data, [this](bool responseReceived, AssetUtils::AssetServerError error, const QString& hash){
         if (!responseReceived) {
@@ -111,3 +119,181 @@ void AssetUpload::start() {
         emit finished(this, hash);
     });
 }
+
+// the chunks in flight at once, each is sent as its own reliable message so they share the connection
+static const int MAX_CHUNKS_IN_FLIGHT = 4;
+static const int MAX_CHUNK_RETRIES = 5;
+static const int CHUNK_RETRY_DELAY_MS = 2000;
+
+void AssetUpload::startChunkedUpload() {
+    _uploadID = QUuid::createUuid();
+    auto numChunks = (_data.size() + AssetUtils::UPLOAD_CHUNK_SIZE - 1) / AssetUtils::UPLOAD_CHUNK_SIZE;
+    _receivedChunks = QVector<bool>(numChunks, false);
+
+    qCDebug(asset_client) << "Uploading" << _data.size() << "bytes in" << numChunks << "chunks as" << _uploadID;
+    sendChunks();
+}
+
+void AssetUpload::sendChunks() {
+    for (uint32_t i = 0; i < (uint32_t)_receivedChunks.size() && _sentChunks.size() < MAX_CHUNKS_IN_FLIGHT; ++i) {
+        if (_isFinished || _isRetryScheduled) {
+            return;
+        }
+        if (!_receivedChunks[i] && !_sentChunks.contains(i)) {
+            sendChunk(i);
+        }
+    }
+
+    if (_sentChunks.isEmpty() && _chunkRequests.isEmpty() && !_isFinished && !_isRetryScheduled) {
+        // every chunk was received but the reply that completed the upload was lost, ask for the result
+        queryReceivedChunks();
+    }
+}
+
+void AssetUpload::sendChunk(uint32_t index) {
+    _sentChunks.insert(index);
+
+    auto chunk = _data.mid(index * AssetUtils::UPLOAD_CHUNK_SIZE, AssetUtils::UPLOAD_CHUNK_SIZE);
+    auto assetClient = DependencyManager::get<AssetClient>();
+    auto messageID = std::make_shared<MessageID>(INVALID_MESSAGE_ID);
+    *messageID = assetClient->uploadAssetChunk(_uploadID, _data.size(), index, chunk,
+                                               [this, index, messageID](bool responseReceived, AssetUtils::AssetServerError error,
+                                                                        const QByteArray& receivedChunks, const QString& hash) {
+        _chunkRequests.remove(*messageID);
+        _sentChunks.remove(index);
+
+        if (!responseReceived) {
+            retryChunks();
+        } else if (error != AssetUtils::AssetServerError::NoError) {
+            handleChunkError(error);
+        } else if (!hash.isEmpty()) {
+            finish(hash);
+        } else {
+            _numRetries = 0;
+            _receivedChunks[index] = true;
+            updateReceivedChunks(receivedChunks);
+            sendChunks();
+        }
+    });
+    if (*messageID != INVALID_MESSAGE_ID) {
+        _chunkRequests.insert(*messageID);
+    }
+}
+
+void AssetUpload::queryReceivedChunks() {
+    auto assetClient = DependencyManager::get<AssetClient>();
+    auto messageID = std::make_shared<MessageID>(INVALID_MESSAGE_ID);
+    *messageID = assetClient->uploadAssetChunk(_uploadID, _data.size(), AssetUtils::UPLOAD_CHUNK_STATUS_QUERY, QByteArray(),
+                                               [this, messageID](bool responseReceived, AssetUtils::AssetServerError error,
+                                                                 const QByteArray& receivedChunks, const QString& hash) {
+        _chunkRequests.remove(*messageID);
+
+        if (!responseReceived) {
+            retryChunks();
+        } else if (error != AssetUtils::AssetServerError::NoError) {
+            handleChunkError(error);
+        } else if (!hash.isEmpty()) {
+            finish(hash);
+        } else {
+            // only what the asset-server has written counts, anything else is sent again
+            _receivedChunks.fill(false);
+            updateReceivedChunks(receivedChunks);
+
+            if (!_receivedChunks.contains(false)) {
+                // the last chunk is still being written, ask again once it is
+                retryChunks();
+            } else {
+                sendChunks();
+            }
+        }
+    });
+    if (*messageID != INVALID_MESSAGE_ID) {
+        _chunkRequests.insert(*messageID);
+    }
+}
+
+void AssetUpload::retryChunks() {
+    if (_isFinished || _isRetryScheduled || !_chunkRequests.isEmpty()) {
+        // wait for the other requests to fail too, the retry happens once
+        return;
+    }
+
+    if (++_numRetries > MAX_CHUNK_RETRIES) {
+        _error = NetworkError;
+        finish(QString());
+        return;
+    }
+
+    qCDebug(asset_client) << "Resuming upload" << _uploadID << "- attempt" << _numRetries;
+    _isRetryScheduled = true;
+    QTimer::singleShot(CHUNK_RETRY_DELAY_MS, this, [this] {
+        _isRetryScheduled = false;
+        if (!_isFinished) {
+            queryReceivedChunks();
+        }
+    });
+}
+
+void AssetUpload::updateReceivedChunks(const QByteArray& receivedChunks) {
+    uint64_t received = 0;
+    for (int i = 0; i < _receivedChunks.size(); ++i) {
+        if (i / 8 < receivedChunks.size() && (receivedChunks[i / 8] & (1 << (i % 8)))) {
+            _receivedChunks[i] = true;
+        }
+        if (_receivedChunks[i]) {
+            received += std::min(AssetUtils::UPLOAD_CHUNK_SIZE, (uint64_t)_data.size() - i * AssetUtils::UPLOAD_CHUNK_SIZE);
+        }
+    }
+    emit progress(received, _data.size());
+}
+
+void AssetUpload::handleChunkError(AssetUtils::AssetServerError error) {
+    if (error == AssetUtils::AssetServerError::ChunkTooFarAhead) {
+        // an earlier chunk never made it, find out which ones the asset-server has and send the rest again
+        retryChunks();
+        return;
+    }
+
+    switch (error) {
+        case AssetUtils::AssetServerError::AssetTooLarge:
+            _error = TooLarge;
+            break;
+        case AssetUtils::AssetServerError::PermissionDenied:
+            _error = PermissionDenied;
+            break;
+        case AssetUtils::AssetServerError::FileOperationFailed:
+            _error = ServerFileError;
+            break;
+        case AssetUtils::AssetServerError::InvalidByteRange:
+            _error = InvalidChunkError;
+            break;
+        default:
+            _error = NetworkError;
+            break;
+    }
+    finish(QString());
+}
+
+void AssetUpload::finish(const QString& hash) {
+    if (_isFinished) {
+        return;
+    }
+    _isFinished = true;
+
+    // the replies to the remaining chunks are no longer needed
+    auto assetClient = DependencyManager::get<AssetClient>();
+    for (auto messageID : _chunkRequests) {
+        assetClient->cancelUploadAssetRequest(messageID);
+    }
+    _chunkRequests.clear();
+    _sentChunks.clear();
+
+    if (!hash.isEmpty()) {
+        _error = NoError;
+        if (hash == AssetUtils::hashData(_data).toHex()) {
+            AssetUtils::saveToCache(AssetUtils::getATPUrl(hash), _data);
+        }
+    }
+
+    emit finished(this, hash);
+}
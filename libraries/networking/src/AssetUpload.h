@@ -15,9 +15,15 @@
 #define hifi_AssetUpload_h
 
 #include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QUuid>
+#include <QtCore/QVector>
 
 #include <cstdint>
 
+#include "AssetUtils.h"
+#include "ClientServerUtils.h"
+
 // You should be able to upload an asset from any thread, and handle the responses in a safe way
 // on your own thread. Everything should happen on AssetClient's thread, the caller should
 // receive events by connecting to signals on an object that lives on AssetClient's threads.
@@ -33,7 +39,8 @@ public:
         TooLarge,
         PermissionDenied,
         FileOpenError,
-        ServerFileError
+        ServerFileError,
+        InvalidChunkError
     };
     
     static const QString PERMISSION_DENIED_ERROR;
@@ -52,9 +59,27 @@ signals:
     void progress(uint64_t totalReceived, uint64_t total);
     
 private:
+    void startChunkedUpload();
+    void sendChunks();
+    void sendChunk(uint32_t index);
+    void queryReceivedChunks();
+    void retryChunks();
+    void updateReceivedChunks(const QByteArray& receivedChunks);
+    void handleChunkError(AssetUtils::AssetServerError error);
+    void finish(const QString& hash);
+
     QString _filename;
     QByteArray _data;
     Error _error;
+
+    // chunked uploads
+    QUuid _uploadID;
+    QVector<bool> _receivedChunks;
+    QSet<uint32_t> _sentChunks;
+    QSet<MessageID> _chunkRequests;
+    int _numRetries { 0 };
+    bool _isRetryScheduled { false };
+    bool _isFinished { false };
 };
 
 #endif // hifi_AssetUpload_h
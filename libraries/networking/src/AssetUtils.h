@@ -31,6 +31,15 @@ const size_t SHA256_HASH_LENGTH = 32;
 const size_t SHA256_HASH_HEX_LENGTH = 64;
 const uint64_t MAX_UPLOAD_SIZE = 1000 * 1000 * 1000; // 1GB
 
+// uploads larger than the threshold are sent as chunks, which the asset-server hashes and writes
+// as they arrive and which can be resumed from the chunks it already has
+const uint64_t UPLOAD_CHUNK_SIZE = 1024 * 1024; // 1MB
+const uint64_t CHUNKED_UPLOAD_THRESHOLD = 4 * UPLOAD_CHUNK_SIZE;
+const uint32_t UPLOAD_CHUNK_STATUS_QUERY = 0xFFFFFFFF; // in place of a chunk index, asks which chunks were received
+
+// the most mappings the asset-server returns for one page of a mappings listing
+const uint32_t MAX_MAPPINGS_PAGE_SIZE = 1000;
+
 const QString ASSET_FILE_PATH_REGEX_STRING = "^(\\/[^\\/\\0]+)+$";
 const QString ASSET_PATH_REGEX_STRING = "^\\/([^\\/\\0]+(\\/)?)+$";
 const QString ASSET_HASH_REGEX_STRING = QString("^[a-fA-F0-9]{%1}$").arg(SHA256_HASH_HEX_LENGTH);
@@ -46,7 +55,8 @@ enum AssetServerError : uint8_t {
     MappingOperationFailed,
     FileOperationFailed,
     NoAssetServer,
-    LostConnection
+    LostConnection,
+    ChunkTooFarAhead // a chunked upload's chunk arrived too far past the first missing one
 };
 
 enum AssetMappingOperationType : uint8_t {
@@ -55,7 +65,9 @@ enum AssetMappingOperationType : uint8_t {
     Set,
     Delete,
     Rename,
-    SetBakingEnabled
+    SetBakingEnabled,
+    GetPage,
+    GetManifest
 };
 
 enum BakingStatus {
@@ -510,6 +510,12 @@ qint64 LimitedNodeList::sendPacketList(std::unique_ptr<NLPacketList> packetList,
         fillPacketHeader(*nlPacket);
     }
 
+    if (packetList->isStreamed()) {
+        packetList->_writeStreamedPacketHeader = [this](udt::Packet& packet) {
+            fillPacketHeader(static_cast<NLPacket&>(packet));
+        };
+    }
+
     return _nodeSocket.writePacketList(std::move(packetList), sockAddr);
 }
 
@@ -524,6 +530,19 @@ qint64 LimitedNodeList::sendPacketList(std::unique_ptr<NLPacketList> packetList,
             fillPacketHeader(*nlPacket, destinationNode.getAuthenticateHash());
         }
 
+        if (packetList->isStreamed()) {
+            // the streamed packets are made on the send queue's thread, possibly after the node is gone,
+            // so they get their own copy of its authentication
+            std::shared_ptr<HMACAuth> hmacAuth;
+            if (destinationNode.getAuthenticateHash()) {
+                hmacAuth = std::make_shared<HMACAuth>();
+                hmacAuth->setKey(destinationNode.getConnectionSecret());
+            }
+            packetList->_writeStreamedPacketHeader = [this, hmacAuth](udt::Packet& packet) {
+                fillPacketHeader(static_cast<NLPacket&>(packet), hmacAuth.get());
+            };
+        }
+
         return _nodeSocket.writePacketList(std::move(packetList), *activeSocket);
     } else {
         qCDebug(networking) << "LimitedNodeList::sendPacketList called without active socket for node "
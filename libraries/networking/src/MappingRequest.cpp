@@ -98,46 +98,83 @@ void GetMappingRequest::doStart() {
                 _redirectedPath = message->readString();
             }
 
+            message->readPrimitive(&_assetSize);
+
         }
         emit finished(this);
     });
 };
 
+static MappingRequest::Error mappingPageError(bool responseReceived, AssetUtils::AssetServerError error) {
+    if (!responseReceived) {
+        return MappingRequest::NetworkError;
+    }
+    return error == AssetUtils::AssetServerError::NoError ? MappingRequest::NoError : MappingRequest::UnknownError;
+}
+
+static void readMappings(ReceivedMessage& message, AssetUtils::AssetMappings& mappings) {
+    uint32_t numberOfMappings;
+    message.readPrimitive(&numberOfMappings);
+    for (uint32_t i = 0; i < numberOfMappings; ++i) {
+        auto path = message.readString();
+        auto hash = message.read(AssetUtils::SHA256_HASH_LENGTH).toHex();
+        AssetUtils::BakingStatus status;
+        QString lastBakeErrors;
+        message.readPrimitive(&status);
+        if (status == AssetUtils::BakingStatus::Error) {
+            lastBakeErrors = message.readString();
+        }
+        mappings[path] = { hash, status, lastBakeErrors };
+    }
+}
+
 void GetAllMappingsRequest::doStart() {
+    requestPage(QString());
+};
+
+void GetAllMappingsRequest::requestPage(const AssetUtils::AssetPath& after) {
     auto assetClient = DependencyManager::get<AssetClient>();
-    _mappingRequestID = assetClient->getAllAssetMappings(
+    _mappingRequestID = assetClient->getAssetMappingsPage(QString(), after, AssetUtils::MAX_MAPPINGS_PAGE_SIZE,
             [this, assetClient](bool responseReceived, AssetUtils::AssetServerError error, QSharedPointer<ReceivedMessage> message) {
 
         _mappingRequestID = INVALID_MESSAGE_ID;
 
-        if (!responseReceived) {
-            _error = NetworkError;
-        } else {
-            switch (error) {
-                case AssetUtils::AssetServerError::NoError:
-                    _error = NoError;
-                    break;
-                default:
-                    _error = UnknownError;
-                    break;
+        _error = mappingPageError(responseReceived, error);
+
+        if (!_error) {
+            readMappings(*message, _mappings);
+
+            auto nextAfter = message->readString();
+            if (!nextAfter.isEmpty()) {
+                requestPage(nextAfter);
+                return;
             }
         }
+        emit finished(this);
+    });
+}
+
+GetMappingsPageRequest::GetMappingsPageRequest(const AssetUtils::AssetPath& prefix, const AssetUtils::AssetPath& after,
+                                               uint32_t limit) :
+    _prefix(prefix.trimmed()),
+    _after(after.trimmed()),
+    _limit(limit)
+{
+
+};
 
+void GetMappingsPageRequest::doStart() {
+    auto assetClient = DependencyManager::get<AssetClient>();
+    _mappingRequestID = assetClient->getAssetMappingsPage(_prefix, _after, _limit,
+            [this, assetClient](bool responseReceived, AssetUtils::AssetServerError error, QSharedPointer<ReceivedMessage> message) {
+
+        _mappingRequestID = INVALID_MESSAGE_ID;
+
+        _error = mappingPageError(responseReceived, error);
 
         if (!_error) {
-            uint32_t numberOfMappings;
-            message->readPrimitive(&numberOfMappings);
-            for (uint32_t i = 0; i < numberOfMappings; ++i) {
-                auto path = message->readString();
-                auto hash = message->read(AssetUtils::SHA256_HASH_LENGTH).toHex();
-                AssetUtils::BakingStatus status;
-                QString lastBakeErrors;
-                message->readPrimitive(&status);
-                if (status == AssetUtils::BakingStatus::Error) {
-                    lastBakeErrors = message->readString();
-                }
-                _mappings[path] = { hash, status, lastBakeErrors };
-            }
+            readMappings(*message, _mappings);
+            _nextAfter = message->readString();
         }
         emit finished(this);
     });
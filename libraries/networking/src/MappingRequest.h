@@ -55,6 +55,7 @@ public:
     AssetUtils::AssetHash getHash() const { return _hash;  }
     AssetUtils::AssetPath getRedirectedPath() const { return _redirectedPath; }
     bool wasRedirected() const { return _wasRedirected; }
+    qint64 getAssetSize() const { return _assetSize; }
 
 signals:
     void finished(GetMappingRequest* thisRequest);
@@ -68,6 +69,7 @@ private:
 
     AssetUtils::AssetPath _redirectedPath;
     bool _wasRedirected { false };
+    qint64 _assetSize { 0 };
 };
 
 class SetMappingRequest : public MappingRequest {
@@ -128,7 +130,35 @@ signals:
 private:
     virtual void doStart() override;
 
+    // the mappings are fetched a page at a time so no single reply has to hold all of them
+    void requestPage(const AssetUtils::AssetPath& after);
+
+    AssetUtils::AssetMappings _mappings;
+};
+
+/// A page of the mappings whose path starts with a prefix, in path order, starting after a given path.
+/// Pass getNextAfter() as the after path of the next request until it is empty.
+class GetMappingsPageRequest : public MappingRequest {
+    Q_OBJECT
+public:
+    GetMappingsPageRequest(const AssetUtils::AssetPath& prefix, const AssetUtils::AssetPath& after, uint32_t limit);
+
+    AssetUtils::AssetMappings getMappings() const { return _mappings;  }
+    AssetUtils::AssetPath getNextAfter() const { return _nextAfter; }
+    bool hasMore() const { return !_nextAfter.isEmpty(); }
+
+signals:
+    void finished(GetMappingsPageRequest* thisRequest);
+
+private:
+    virtual void doStart() override;
+
+    AssetUtils::AssetPath _prefix;
+    AssetUtils::AssetPath _after;
+    uint32_t _limit;
+
     AssetUtils::AssetMappings _mappings;
+    AssetUtils::AssetPath _nextAfter;
 };
 
 class SetBakingEnabledRequest : public MappingRequest {
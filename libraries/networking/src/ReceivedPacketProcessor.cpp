@@ -71,11 +71,7 @@ bool ReceivedPacketProcessor::process() {
     currentPackets.swap(_packets);
     unlock();
 
-    for(auto& packetPair : currentPackets) {
-        processPacket(packetPair.second, packetPair.first);
-        _lastWindowProcessedPackets++;
-        midProcess();
-    }
+    processPackets(currentPackets);
 
     lock();
     for(auto& packetPair : currentPackets) {
@@ -87,6 +83,14 @@ bool ReceivedPacketProcessor::process() {
     return isStillRunning();  // keep running till they terminate us
 }
 
+void ReceivedPacketProcessor::processPackets(const std::list<NodeSharedReceivedMessagePair>& packets) {
+    for (auto& packetPair : packets) {
+        processPacket(packetPair.second, packetPair.first);
+        _lastWindowProcessedPackets++;
+        midProcess();
+    }
+}
+
 void ReceivedPacketProcessor::nodeKilled(SharedNodePointer node) {
     lock();
     _nodePacketCounts.remove(node->getUUID());
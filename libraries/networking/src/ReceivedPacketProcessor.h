@@ -69,6 +69,10 @@ protected:
     /// Implements generic processing behavior for this thread.
     virtual bool process() override;
 
+    /// Processes the packets drained from the queue in one pass of process(). The default calls processPacket() and
+    /// midProcess() for each packet in turn; override to process the drained packets together.
+    virtual void processPackets(const std::list<NodeSharedReceivedMessagePair>& packets);
+
     /// Determines the timeout of the wait when there are no packets to process. Default value is 100ms to allow for regular event processing.
     virtual uint32_t getMaxWait() const { return MAX_WAIT_TIME; }
 
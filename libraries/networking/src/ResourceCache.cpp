@@ -224,6 +224,7 @@ ScriptableResource* ResourceCache::prefetch(const QUrl& url, void* extra, size_t
 
     result = new ScriptableResource(url);
 
+    prefetchHint(url, extraHash);
     auto resource = getResource(url, QUrl(), extra, extraHash);
     result->_resource = resource;
     result->setObjectName(url.toString());
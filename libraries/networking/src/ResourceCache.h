@@ -262,6 +262,10 @@ protected:
     virtual QSharedPointer<Resource> createResource(const QUrl& url) = 0;
     virtual QSharedPointer<Resource> createResourceCopy(const QSharedPointer<Resource>& resource) = 0;
 
+    /// Called when a resource is prefetched, so that a cache keeping the data of its resources on disk
+    /// can keep the data of this one from being evicted before it's needed
+    virtual void prefetchHint(const QUrl& url, size_t extraHash) {}
+
     void addUnusedResource(const QSharedPointer<Resource>& resource);
     void removeUnusedResource(const QSharedPointer<Resource>& resource);
 
@@ -36,6 +36,8 @@ const QString STAT_ATP_MAPPING_REQUEST_SUCCESS = "SuccessfulATPMappingRequest";
 const QString STAT_HTTP_RESOURCE_TOTAL_BYTES = "HTTPBytesDownloaded";
 const QString STAT_ATP_RESOURCE_TOTAL_BYTES = "ATPBytesDownloaded";
 const QString STAT_FILE_RESOURCE_TOTAL_BYTES = "FILEBytesDownloaded";
+const QString STAT_ATP_TRANSFER_DEDUP_REQUEST = "TransferDedupATPRequest";
+const QString STAT_ATP_TRANSFER_DEDUP_BYTES = "ATPTransferDedupBytesReused";
 
 class ResourceRequest : public QObject {
     Q_OBJECT
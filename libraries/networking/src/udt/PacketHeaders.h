@@ -135,6 +135,12 @@ public:
         AudioSoloRequest,
         BulkAvatarTraitsAck,
         StopInjector,
+        EntityDataDictionary,
+        AssetUploadChunk,
+        AssetUploadChunkReply,
+        AssetGetChunkList,
+        AssetGetChunkListReply,
+        OctreeDataPersistChanges,
         NUM_PACKET_TYPE
     };
 
@@ -185,7 +191,8 @@ public:
             << PacketTypeEnum::Value::OctreeFileReplacement << PacketTypeEnum::Value::ReplicatedMicrophoneAudioNoEcho
             << PacketTypeEnum::Value::ReplicatedMicrophoneAudioWithEcho << PacketTypeEnum::Value::ReplicatedInjectAudio
             << PacketTypeEnum::Value::ReplicatedSilentAudioFrame << PacketTypeEnum::Value::ReplicatedAvatarIdentity
-            << PacketTypeEnum::Value::ReplicatedKillAvatar << PacketTypeEnum::Value::ReplicatedBulkAvatarData;
+            << PacketTypeEnum::Value::ReplicatedKillAvatar << PacketTypeEnum::Value::ReplicatedBulkAvatarData
+            << PacketTypeEnum::Value::OctreeDataPersistChanges;
         return NON_SOURCED_PACKETS;
     }
 
@@ -193,7 +200,8 @@ public:
         const static QSet<PacketTypeEnum::Value> DOMAIN_SOURCED_PACKETS = QSet<PacketTypeEnum::Value>()
             << PacketTypeEnum::Value::AssetMappingOperation
             << PacketTypeEnum::Value::AssetGet
-            << PacketTypeEnum::Value::AssetUpload;
+            << PacketTypeEnum::Value::AssetUpload
+            << PacketTypeEnum::Value::AssetUploadChunk;
         return DOMAIN_SOURCED_PACKETS;
     }
 
@@ -201,7 +209,8 @@ public:
         const static QSet<PacketTypeEnum::Value> DOMAIN_IGNORED_VERIFICATION_PACKETS = QSet<PacketTypeEnum::Value>()
             << PacketTypeEnum::Value::AssetMappingOperationReply
             << PacketTypeEnum::Value::AssetGetReply
-            << PacketTypeEnum::Value::AssetUploadReply;
+            << PacketTypeEnum::Value::AssetUploadReply
+            << PacketTypeEnum::Value::AssetUploadChunkReply;
         return DOMAIN_IGNORED_VERIFICATION_PACKETS;
     }
 };
@@ -288,14 +297,21 @@ enum class EntityQueryPacketVersion: PacketVersion {
     ConnectionIdentifier = 20,
     RemovedJurisdictions = 21,
     MultiFrustumQuery = 22,
-    ConicalFrustums = 23
+    ConicalFrustums = 23,
+    DataDictionary = 24,
+    InitialInterest = 25
 };
 
 enum class AssetServerPacketVersion: PacketVersion {
     VegasCongestionControl = 19,
     RangeRequestSupport,
     RedirectedMappings,
-    BakingTextureMeta
+    BakingTextureMeta,
+    ChunkedUploads,
+    MappingPages,
+    PrefetchManifest,
+    ChunkLists,
+    MappingAssetSizes
 };
 
 enum class AvatarMixerPacketVersion : PacketVersion {
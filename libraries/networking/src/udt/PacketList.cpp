@@ -142,23 +142,103 @@ QByteArray PacketList::getMessage() const {
 }
 
 void PacketList::preparePackets(MessageNumber messageNumber) {
-    Q_ASSERT(_packets.size() > 0);
-    
-    if (_packets.size() == 1) {
-        _packets.front()->writeMessageNumber(messageNumber, Packet::PacketPosition::ONLY, 0);
+    Q_ASSERT(getNumPackets() > 0);
+
+    // streamed packets are numbered as they are made
+    _messageNumber = messageNumber;
+    _numMessageParts = (Packet::MessagePartNumber)(_packets.size() + _numStreamedPackets);
+    _nextMessagePartNumber = 0;
+    for (auto& packet : _packets) {
+        writeMessagePart(*packet);
+    }
+}
+
+void PacketList::writeMessagePart(Packet& packet) {
+    Packet::MessagePartNumber messagePartNumber = _nextMessagePartNumber++;
+
+    Packet::PacketPosition position = Packet::PacketPosition::MIDDLE;
+    if (_numMessageParts == 1) {
+        position = Packet::PacketPosition::ONLY;
+    } else if (messagePartNumber == 0) {
+        position = Packet::PacketPosition::FIRST;
+    } else if (messagePartNumber == _numMessageParts - 1) {
+        position = Packet::PacketPosition::LAST;
+    }
+    packet.writeMessageNumber(_messageNumber, position, messagePartNumber);
+}
+
+qint64 PacketList::readStream(Packet& packet, qint64 size) {
+    size = std::min(size, std::min(packet.bytesAvailableForWrite(), _streamSizeRemaining));
+    qint64 start = packet.pos();
+
+    qint64 numBytesRead = _stream(packet.getPayload() + start, size);
+    if (numBytesRead < size) {
+        // the message size was already sent, the receiver will find the content doesn't match
+        qCWarning(networking) << "PacketList::readStream could only read" << numBytesRead << "of" << size << "bytes";
+        numBytesRead = std::max(numBytesRead, (qint64)0);
+        memset(packet.getPayload() + start + numBytesRead, 0, size - numBytesRead);
+    }
+
+    packet.setPayloadSize(start + size);
+    packet.seek(start + size);
+    _streamSizeRemaining -= size;
+    return size;
+}
+
+void PacketList::writeStream(qint64 size, DataStream stream) {
+    Q_ASSERT_X(_isReliable, "PacketList::writeStream", "Only reliable PacketLists can be streamed");
+    Q_ASSERT_X(_numStreamedPackets == 0, "PacketList::writeStream", "A PacketList can only be streamed once");
+
+    _stream = stream;
+    _streamSizeRemaining = size;
+
+    // the start of the stream goes out with whatever was written before it
+    if (_currentPacket) {
+        readStream(*_currentPacket, _streamSizeRemaining);
+    }
+    closeCurrentPacket();
+
+    if (_streamSizeRemaining > 0) {
+        qint64 packetCapacity = getMaxSegmentSize() - _extendedHeader.size();
+        _numStreamedPackets = (size_t)((_streamSizeRemaining + packetCapacity - 1) / packetCapacity);
     } else {
-        const auto second = ++_packets.begin();
-        const auto last = --_packets.end();
-        Packet::MessagePartNumber messagePartNumber = 0;
-        std::for_each(second, last, [&](const PacketPointer& packet) {
-            packet->writeMessageNumber(messageNumber, Packet::PacketPosition::MIDDLE, ++messagePartNumber);
-        });
-        
-        _packets.front()->writeMessageNumber(messageNumber, Packet::PacketPosition::FIRST, 0);
-        _packets.back()->writeMessageNumber(messageNumber, Packet::PacketPosition::LAST, ++messagePartNumber);
+        _stream = nullptr;
     }
 }
 
+std::unique_ptr<Packet> PacketList::takeNextPacket() {
+    if (!_packets.empty()) {
+        return takeFront<Packet>();
+    }
+    if (_numStreamedPackets > 0) {
+        --_numStreamedPackets;
+        ++_numReservedPackets;
+    }
+    return nullptr;
+}
+
+std::unique_ptr<Packet> PacketList::makeStreamedPacket() {
+    Q_ASSERT_X(_numReservedPackets > 0, "PacketList::makeStreamedPacket", "No streamed packet was taken");
+
+    auto packet = createPacketWithExtendedHeader();
+    readStream(*packet, _streamSizeRemaining);
+    --_numReservedPackets;
+
+    if (_isOrdered) {
+        writeMessagePart(*packet);
+    }
+    if (_writeStreamedPacketHeader) {
+        _writeStreamedPacketHeader(*packet);
+    }
+
+    if (_streamSizeRemaining == 0) {
+        // let go of whatever the stream reads from as soon as we're done with it
+        _stream = nullptr;
+        _writeStreamedPacketHeader = nullptr;
+    }
+    return packet;
+}
+
 const qint64 PACKET_LIST_WRITE_ERROR = -1;
 
 qint64 PacketList::writeString(const QString& string) {
@@ -168,6 +248,7 @@ qint64 PacketList::writeString(const QString& string) {
 }
 
 qint64 PacketList::writeData(const char* data, qint64 maxSize) {
+    Q_ASSERT_X(_numStreamedPackets == 0, "PacketList::writeData", "Can't write to a PacketList after its stream");
     auto sizeRemaining = maxSize;
 
     while (sizeRemaining > 0) {
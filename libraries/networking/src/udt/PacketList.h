@@ -12,6 +12,7 @@
 #ifndef hifi_PacketList_h
 #define hifi_PacketList_h
 
+#include <functional>
 #include <memory>
 
 #include "../ExtendedIODevice.h"
@@ -29,6 +30,9 @@ class PacketList : public ExtendedIODevice {
 public:
     using MessageNumber = uint32_t;
     using PacketPointer = std::unique_ptr<Packet>;
+
+    // reads up to size bytes of a streamed write into destination, returns the number of bytes read
+    using DataStream = std::function<qint64(char* destination, qint64 size)>;
     
     static std::unique_ptr<PacketList> create(PacketType packetType, QByteArray extendedHeader = QByteArray(),
                                               bool isReliable = false, bool isOrdered = false);
@@ -38,7 +42,7 @@ public:
     bool isReliable() const { return _isReliable; }
     bool isOrdered() const { return _isOrdered; }
     
-    size_t getNumPackets() const { return _packets.size() + (_currentPacket ? 1 : 0); }
+    size_t getNumPackets() const { return _packets.size() + (_currentPacket ? 1 : 0) + _numStreamedPackets; }
     size_t getDataSize() const;
     size_t getMessageSize() const;
     QByteArray getMessage() const;
@@ -60,6 +64,12 @@ public:
     
     qint64 writeString(const QString& string);
 
+    // Writes size bytes that are only read from the stream as the packets carrying them are sent, so that
+    // a large message never holds more than the packets in flight. Reliable lists only, since the others are sent
+    // right away; it must be the last write.
+    void writeStream(qint64 size, DataStream stream);
+    bool isStreamed() const { return _numStreamedPackets > 0; }
+
     p_high_resolution_clock::time_point getFirstPacketReceiveTime() const;
     
     
@@ -89,13 +99,31 @@ private:
     
     // Takes the first packet of the list and returns it.
     template<typename T> std::unique_ptr<T> takeFront();
+
+    // Takes the next packet written to the list. Once they are gone, it returns null and takes the next streamed packet
+    // instead, which makeStreamedPacket then makes: reading the stream and signing the packet can be slow, so the
+    // PacketQueue does that without its lock. Only one thread takes packets, so they are made in the order taken.
+    bool hasPacketsToTake() const { return !_packets.empty() || _numStreamedPackets > 0; }
+    std::unique_ptr<Packet> takeNextPacket();
+    std::unique_ptr<Packet> makeStreamedPacket();
+
+    void writeMessagePart(Packet& packet);
+    qint64 readStream(Packet& packet, qint64 size);
     
     // Creates a new packet, can be overriden to change return underlying type
     virtual std::unique_ptr<Packet> createPacket();
     std::unique_ptr<Packet> createPacketWithExtendedHeader();
     
     Packet::MessageNumber _messageNumber;
+    Packet::MessagePartNumber _numMessageParts { 0 };
+    Packet::MessagePartNumber _nextMessagePartNumber { 0 };
     bool _isReliable = false;
+
+    DataStream _stream;
+    qint64 _streamSizeRemaining { 0 };
+    size_t _numStreamedPackets { 0 }; // not taken yet
+    size_t _numReservedPackets { 0 }; // taken but not made yet
+    std::function<void(Packet& packet)> _writeStreamedPacketHeader; // set by the LimitedNodeList sending us
     
     std::unique_ptr<Packet> _currentPacket;
     
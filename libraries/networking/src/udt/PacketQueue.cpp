@@ -16,7 +16,7 @@
 using namespace udt;
 
 PacketQueue::PacketQueue(MessageNumber messageNumber) : _currentMessageNumber(messageNumber) {
-    _channels.emplace_front(new std::list<PacketPointer>());
+    _channels.emplace_front(PacketListPointer(new PacketList(PacketType::Unknown)));
     _currentChannel = _channels.begin();
 }
 
@@ -30,18 +30,35 @@ bool PacketQueue::isEmpty() const {
     LockGuard locker(_packetsLock);
 
     // Only the main channel and it is empty
-    return _channels.size() == 1 && _channels.front()->empty();
+    return _channels.size() == 1 && !_channels.front()->hasPacketsToTake();
 }
 
 PacketQueue::PacketPointer PacketQueue::takePacket() {
-    LockGuard locker(_packetsLock);
+    PacketList* streamedChannel = nullptr;
+    // a streamed channel removed from the queue lives until its last packet is made
+    PacketListPointer finishedChannel;
+    PacketPointer packet;
+
+    {
+        LockGuard locker(_packetsLock);
+
+        if (isEmpty()) {
+            return PacketPointer();
+        }
+
+        packet = takeChannelPacket(streamedChannel, finishedChannel);
+    }
 
-    if (isEmpty()) {
-        return PacketPointer();
+    if (streamedChannel) {
+        // only the send queue's thread takes packets, so the channel is ours to read from without the lock
+        packet = streamedChannel->makeStreamedPacket();
     }
+    return packet;
+}
 
+PacketQueue::PacketPointer PacketQueue::takeChannelPacket(PacketList*& streamedChannel, PacketListPointer& finishedChannel) {
     // handle the case where we are looking at the first channel and it is empty
-    if (_currentChannel == _channels.begin() && (*_currentChannel)->empty()) {
+    if (_currentChannel == _channels.begin() && !(*_currentChannel)->hasPacketsToTake()) {
         ++_currentChannel;
     }
 
@@ -50,14 +67,19 @@ PacketQueue::PacketPointer PacketQueue::takePacket() {
 
     auto& channel = *_currentChannel;
 
-    Q_ASSERT(!channel->empty());
+    Q_ASSERT(channel->hasPacketsToTake());
 
-    // Take front packet
-    auto packet = std::move(channel->front());
-    channel->pop_front();
+    // Take front packet, or the next one to make from the channel's stream
+    auto packet = channel->takeNextPacket();
+    if (!packet) {
+        streamedChannel = channel.get();
+    }
 
     // Remove now empty channel (Don't remove the main channel)
-    if (channel->empty() && _currentChannel != _channels.begin()) {
+    if (!channel->hasPacketsToTake() && _currentChannel != _channels.begin()) {
+        if (streamedChannel) {
+            finishedChannel = std::move(channel);
+        }
         // erase the current channel and slide the iterator to the next channel
         _currentChannel = _channels.erase(_currentChannel);
     } else {
@@ -81,7 +103,7 @@ PacketQueue::PacketPointer PacketQueue::takePacket() {
 
 void PacketQueue::queuePacket(PacketPointer packet) {
     LockGuard locker(_packetsLock);
-    _channels.front()->push_back(std::move(packet));
+    _channels.front()->_packets.push_back(std::move(packet));
 }
 
 void PacketQueue::queuePacketList(PacketListPointer packetList) {
@@ -90,6 +112,5 @@ void PacketQueue::queuePacketList(PacketListPointer packetList) {
     }
 
     LockGuard locker(_packetsLock);
-    _channels.emplace_back(new std::list<PacketPointer>());
-    _channels.back()->swap(packetList->_packets);
+    _channels.push_back(std::move(packetList));
 }
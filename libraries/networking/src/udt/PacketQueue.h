@@ -30,8 +30,7 @@ class PacketQueue {
     using LockGuard = std::lock_guard<Mutex>;
     using PacketPointer = std::unique_ptr<Packet>;
     using PacketListPointer = std::unique_ptr<PacketList>;
-    using RawChannel = std::list<PacketPointer>;
-    using Channel = std::unique_ptr<RawChannel>;
+    using Channel = PacketListPointer; // a streamed packet list only makes its packets as we take them
     using Channels = std::list<Channel>;
     
 public:
@@ -48,11 +47,13 @@ public:
     
 private:
     MessageNumber getNextMessageNumber();
+    // takes the next packet from the channels, or sets streamedChannel when it must be made from that channel's stream
+    PacketPointer takeChannelPacket(PacketList*& streamedChannel, PacketListPointer& finishedChannel);
 
     MessageNumber _currentMessageNumber { 0 };
     
     mutable Mutex _packetsLock; // Protects the packets to be sent.
-    Channels _channels; // One channel per packet list + Main channel
+    Channels _channels; // One channel per packet list + Main channel, for the single packets
 
     Channels::iterator _currentChannel;
     unsigned int _channelsVisitedCount { 0 };
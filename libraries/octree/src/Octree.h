@@ -30,6 +30,7 @@
 #include "OctreeSceneStats.h"
 #include "OctreeUtils.h"
 
+class QIODevice;
 class ReadBitstreamToTreeParams;
 class Octree;
 class OctreeElement;
@@ -223,6 +224,15 @@ public:
     bool readJSONFromGzippedFile(QString qFileName);
     virtual bool readFromMap(QVariantMap& entityDescription) = 0;
 
+    // Incremental persistence between full saves, for trees that keep track of their own changes
+    virtual void setChangeLogEnabled(bool enabled) { }
+    virtual bool appendChangesToLog(QIODevice& log) { return false; }
+    virtual int replayChangeLog(QIODevice& log) { return 0; } // callers must lock the tree, returns records replayed
+
+    // Binary snapshot of the tree's content, written next to the JSON file so it can be loaded without parsing it
+    virtual bool writeToSnapshot(QIODevice& snapshot) { return false; }
+    virtual bool readFromSnapshot(const QByteArray& snapshot) { return false; } // callers must lock the tree
+
     uint64_t getOctreeElementsCount();
 
     bool getShouldReaverage() const { return _shouldReaverage; }
@@ -259,6 +269,8 @@ public:
     virtual quint64 getAverageLoggingTime() const { return 0;  }
     virtual quint64 getAverageFilterTime() const { return 0; }
 
+    QUuid getPersistID() const { return _persistID; }
+    int getPersistDataVersion() const { return _persistDataVersion; }
     void incrementPersistDataVersion() { _persistDataVersion++; }
 
 
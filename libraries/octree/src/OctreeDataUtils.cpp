@@ -11,6 +11,8 @@
 #include "OctreeDataUtils.h"
 #include "OctreeEntitiesFileParser.h"
 
+#include <algorithm>
+
 #include <Gzip.h>
 #include <udt/PacketHeaders.h>
 
@@ -18,6 +20,10 @@
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QFile>
+#include <QHash>
+
+const QString OctreeUtils::CHANGE_LOG_EDIT_KEY = "edit";
+const QString OctreeUtils::CHANGE_LOG_DELETE_KEY = "delete";
 
 bool OctreeUtils::RawOctreeData::readOctreeDataInfoFromMap(const QVariantMap& map) {
     if (map.contains("Id") && map.contains("DataVersion") && map.contains("Version")) {
@@ -114,3 +120,55 @@ void OctreeUtils::RawEntityData::writeSubclassData(QByteArray& root) const {
 }
 
 PacketType OctreeUtils::RawEntityData::dataPacketType() const { return PacketType::EntityData; }
+
+// Each edit record holds the full properties of an entity, so it replaces the entity rather than being merged into it.
+int OctreeUtils::RawEntityData::applyChangeLog(const QByteArray& changeLog) {
+    QHash<QUuid, int> entityIndices;
+    for (int i = 0; i < variantEntityData.size(); ++i) {
+        entityIndices[variantEntityData[i].toMap()["id"].toUuid()] = i;
+    }
+
+    int numRecords = 0;
+    for (const QByteArray& line : changeLog.split('\n')) {
+        if (line.trimmed().isEmpty()) {
+            continue;
+        }
+        QJsonParseError parseError;
+        QJsonDocument record = QJsonDocument::fromJson(line, &parseError);
+        if (parseError.error != QJsonParseError::NoError || !record.isObject()) {
+            qWarning() << "Skipping malformed entity change log record:" << parseError.errorString();
+            continue;
+        }
+
+        QJsonObject recordObject = record.object();
+        if (recordObject.contains(CHANGE_LOG_DELETE_KEY)) {
+            auto it = entityIndices.find(QUuid(recordObject[CHANGE_LOG_DELETE_KEY].toString()));
+            if (it != entityIndices.end()) {
+                // leave a hole so the other indices stay valid, it is removed below
+                variantEntityData[it.value()] = QVariant();
+                entityIndices.erase(it);
+            }
+        } else if (recordObject.contains(CHANGE_LOG_EDIT_KEY)) {
+            QVariantMap entity = recordObject[CHANGE_LOG_EDIT_KEY].toObject().toVariantMap();
+            QUuid entityID = entity["id"].toUuid();
+            if (entityID.isNull()) {
+                continue;
+            }
+            auto it = entityIndices.find(entityID);
+            if (it != entityIndices.end()) {
+                variantEntityData[it.value()] = entity;
+            } else {
+                entityIndices[entityID] = variantEntityData.size();
+                variantEntityData.push_back(entity);
+            }
+        } else {
+            continue;
+        }
+        ++numRecords;
+    }
+
+    variantEntityData.erase(std::remove_if(variantEntityData.begin(), variantEntityData.end(),
+                                           [](const QVariant& entity) { return !entity.isValid(); }),
+                            variantEntityData.end());
+    return numRecords;
+}
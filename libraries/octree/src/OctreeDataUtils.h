@@ -22,6 +22,10 @@ namespace OctreeUtils {
 using Version = int64_t;
 constexpr Version INITIAL_VERSION = 0;
 
+// keys of the records in an entity change log, one JSON object per line
+extern const QString CHANGE_LOG_EDIT_KEY;
+extern const QString CHANGE_LOG_DELETE_KEY;
+
 //using PacketType = uint8_t;
 
 // RawOctreeData is an intermediate format between JSON and a fully deserialized Octree.
@@ -51,6 +55,9 @@ public:
     void readSubclassData(const QVariantMap& root) override;
     void writeSubclassData(QByteArray& root) const override;
 
+    // applies the records of an entity change log, returns the number applied
+    int applyChangeLog(const QByteArray& changeLog);
+
     QVariantList variantEntityData;
 };
 
@@ -1,6 +1,6 @@
 //
 //  OctreeInboundPacketProcessor.cpp
-//  assignment-client/src/octree
+//  libraries/octree/src
 //
 //  Created by Brad Hefta-Gaub on 8/21/13.
 //  Copyright 2013 High Fidelity, Inc.
@@ -17,20 +17,28 @@
 #include <udt/PacketHeaders.h>
 #include <PerfStat.h>
 
-#include "OctreeServer.h"
-#include "OctreeServerConsts.h"
+#include <NLPacketList.h>
+#include <NodeList.h>
 
 static QUuid DEFAULT_NODE_ID_REF;
 const quint64 TOO_LONG_SINCE_LAST_NACK = 1 * USECS_PER_SECOND;
 
-OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServer) :
-    _myServer(myServer),
+// how long a batch of edits may hold the tree write lock before we let the send threads back in
+const quint64 MAX_EDIT_BATCH_TIME = 2 * USECS_PER_MSEC;
+
+OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(const OctreePointer& tree, PacketType editNackType,
+                                                           bool debugReceiving, bool verboseDebug) :
+    _tree(tree),
+    _editNackType(editNackType),
+    _debugReceiving(debugReceiving),
+    _verboseDebug(verboseDebug),
     _receivedPacketCount(0),
     _totalTransitTime(0),
     _totalProcessTime(0),
     _totalLockWaitTime(0),
     _totalElementsInPacket(0),
     _totalPackets(0),
+    _totalBatches(0),
     _lastNackTime(usecTimestampNow()),
     _shuttingDown(false)
 {
@@ -42,6 +50,7 @@ void OctreeInboundPacketProcessor::resetStats() {
     _totalLockWaitTime = 0;
     _totalElementsInPacket = 0;
     _totalPackets = 0;
+    _totalBatches = 0;
     _lastNackTime = usecTimestampNow();
 
     QWriteLocker locker(&_senderStatsLock);
@@ -76,13 +85,34 @@ void OctreeInboundPacketProcessor::midProcess() {
     }
 }
 
+void OctreeInboundPacketProcessor::processPackets(const std::list<NodeSharedReceivedMessagePair>& packets) {
+    // Apply the drained packets in batches, each under a single acquisition of the tree write lock, rather than
+    // taking the lock once per edit. A batch ends once it has held the lock for MAX_EDIT_BATCH_TIME so that a flood
+    // of edits can't starve the send threads.
+    auto packetPair = packets.begin();
+    while (packetPair != packets.end()) {
+        quint64 startLock = usecTimestampNow();
+        _tree->withWriteLock([&] {
+            quint64 startBatch = usecTimestampNow();
+            _batchLockWaitTime = startBatch - startLock;
+            do {
+                processPacket(packetPair->second, packetPair->first);
+                _lastWindowProcessedPackets++;
+                ++packetPair;
+            } while (packetPair != packets.end() && usecTimestampNow() - startBatch < MAX_EDIT_BATCH_TIME);
+        });
+        _totalBatches++;
+        midProcess();
+    }
+}
+
 void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
     if (_shuttingDown) {
         qDebug() << "OctreeInboundPacketProcessor::processPacket() while shutting down... ignoring incoming packet";
         return;
     }
 
-    bool debugProcessPacket = _myServer->wantsVerboseDebug();
+    bool debugProcessPacket = _verboseDebug;
 
     if (debugProcessPacket) {
         qDebug("OctreeInboundPacketProcessor::processPacket() payload=%p payloadLength=%lld",
@@ -93,19 +123,14 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
     // Ask our tree subclass if it can handle the incoming packet...
     PacketType packetType = message->getType();
     
+    // processPackets() holds the tree write lock for us
     if (packetType == PacketType::ChallengeOwnership) {
-        _myServer->getOctree()->withWriteLock([&] {
-            _myServer->getOctree()->processChallengeOwnershipPacket(*message, sendingNode);
-        });
+        _tree->processChallengeOwnershipPacket(*message, sendingNode);
     } else if (packetType == PacketType::ChallengeOwnershipRequest) {
-        _myServer->getOctree()->withWriteLock([&] {
-            _myServer->getOctree()->processChallengeOwnershipRequestPacket(*message, sendingNode);
-        });
+        _tree->processChallengeOwnershipRequestPacket(*message, sendingNode);
     } else if (packetType == PacketType::ChallengeOwnershipReply) {
-        _myServer->getOctree()->withWriteLock([&] {
-            _myServer->getOctree()->processChallengeOwnershipReplyPacket(*message, sendingNode);
-        });
-    } else if (_myServer->getOctree()->handlesEditPacketType(packetType)) {
+        _tree->processChallengeOwnershipReplyPacket(*message, sendingNode);
+    } else if (_tree->handlesEditPacketType(packetType)) {
         PerformanceWarning warn(debugProcessPacket, "processPacket KNOWN TYPE", debugProcessPacket);
         _receivedPacketCount++;
 
@@ -117,7 +142,7 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
         
         quint64 arrivedAt = usecTimestampNow();
         if (sentAt > arrivedAt) {
-            if (debugProcessPacket || _myServer->wantsDebugReceiving()) {
+            if (debugProcessPacket || _debugReceiving) {
                 qDebug() << "unreasonable sentAt=" << sentAt << " usecs";
                 qDebug() << "setting sentAt to arrivedAt=" << arrivedAt << " usecs";
             }
@@ -127,9 +152,12 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
         quint64 transitTime = arrivedAt - sentAt;
         int editsInPacket = 0;
         quint64 processTime = 0;
-        quint64 lockWaitTime = 0;
 
-        if (debugProcessPacket || _myServer->wantsDebugReceiving()) {
+        // the wait for the batch's lock is charged to the first edit packet in the batch
+        quint64 lockWaitTime = _batchLockWaitTime;
+        _batchLockWaitTime = 0;
+
+        if (debugProcessPacket || _debugReceiving) {
             qDebug() << "PROCESSING THREAD: got '" << packetType << "' packet - " << _receivedPacketCount << " command from client";
             qDebug() << "    receivedBytes=" << message->getSize();
             qDebug() << "         sequence=" << sequence;
@@ -170,13 +198,9 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
                         message->getPosition(), maxSize);
             }
 
-            quint64 startProcess, startLock = usecTimestampNow();
-            int editDataBytesRead;
-            _myServer->getOctree()->withWriteLock([&] {
-                startProcess = usecTimestampNow();
-                editDataBytesRead =
-                    _myServer->getOctree()->processEditPacketData(*message, editData, maxSize, sendingNode);
-            });
+            quint64 startProcess = usecTimestampNow();
+            int editDataBytesRead =
+                _tree->processEditPacketData(*message, editData, maxSize, sendingNode);
             quint64 endProcess = usecTimestampNow();
 
             if (debugProcessPacket) {
@@ -185,10 +209,7 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
             }
 
             editsInPacket++;
-            quint64 thisProcessTime = endProcess - startProcess;
-            quint64 thisLockWaitTime = startProcess - startLock;
-            processTime += thisProcessTime;
-            lockWaitTime += thisLockWaitTime;
+            processTime += endProcess - startProcess;
 
             // skip to next edit record in the packet
             message->seek(message->getPosition() + editDataBytesRead);
@@ -296,7 +317,7 @@ int OctreeInboundPacketProcessor::sendNackPackets() {
         auto it = missingSequenceNumbers.constBegin();
 
         if (it != missingSequenceNumbers.constEnd()) {
-            auto nackPacketList = NLPacketList::create(_myServer->getMyEditNackType());
+            auto nackPacketList = NLPacketList::create(_editNackType);
 
             while (it != missingSequenceNumbers.constEnd()) {
                 unsigned short int sequenceNumber = *it;
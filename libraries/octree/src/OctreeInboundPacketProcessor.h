@@ -1,6 +1,6 @@
 //
 //  OctreeInboundPacketProcessor.h
-//  assignment-client/src/octree
+//  libraries/octree/src
 //
 //  Created by Brad Hefta-Gaub on 8/21/13.
 //  Copyright 2013 High Fidelity, Inc.
@@ -16,10 +16,9 @@
 
 #include <ReceivedPacketProcessor.h>
 
+#include "Octree.h"
 #include "SequenceNumberStats.h"
 
-class OctreeServer;
-
 class SingleSenderStats {
 public:
     SingleSenderStats();
@@ -58,7 +57,8 @@ typedef QHash<QUuid, SingleSenderStats>::const_iterator NodeToSenderStatsMapCons
 class OctreeInboundPacketProcessor : public ReceivedPacketProcessor {
     Q_OBJECT
 public:
-    OctreeInboundPacketProcessor(OctreeServer* myServer);
+    OctreeInboundPacketProcessor(const OctreePointer& tree, PacketType editNackType,
+                                 bool debugReceiving = false, bool verboseDebug = false);
 
     quint64 getAverageTransitTimePerPacket() const { return _totalPackets == 0 ? 0 : _totalTransitTime / _totalPackets; }
     quint64 getAverageProcessTimePerPacket() const { return _totalPackets == 0 ? 0 : _totalProcessTime / _totalPackets; }
@@ -69,6 +69,9 @@ public:
                 { return _totalElementsInPacket == 0 ? 0 : _totalProcessTime / _totalElementsInPacket; }
     quint64 getAverageLockWaitTimePerElement() const
                 { return _totalElementsInPacket == 0 ? 0 : _totalLockWaitTime / _totalElementsInPacket; }
+    quint64 getTotalBatchesProcessed() const { return _totalBatches; }
+    float getAverageElementsPerBatch() const
+                { return _totalBatches == 0 ? 0.0f : (float)_totalElementsInPacket / _totalBatches; }
 
     void resetStats();
 
@@ -78,6 +81,9 @@ public:
 
 protected:
 
+    virtual void processPackets(const std::list<NodeSharedReceivedMessagePair>& packets) override;
+
+    /// Called by processPackets() with the tree write lock held.
     virtual void processPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) override;
 
     virtual uint32_t getMaxWait() const override;
@@ -91,7 +97,10 @@ private:
     void trackInboundPacket(const QUuid& nodeUUID, unsigned short int sequence, quint64 transitTime,
             int elementsInPacket, quint64 processTime, quint64 lockWaitTime);
 
-    OctreeServer* _myServer;
+    OctreePointer _tree;
+    PacketType _editNackType;
+    bool _debugReceiving;
+    bool _verboseDebug;
     int _receivedPacketCount;
     
     std::atomic<uint64_t> _totalTransitTime;
@@ -99,7 +108,9 @@ private:
     std::atomic<uint64_t> _totalLockWaitTime;
     std::atomic<uint64_t> _totalElementsInPacket;
     std::atomic<uint64_t> _totalPackets;
-    
+    std::atomic<uint64_t> _totalBatches;
+    quint64 _batchLockWaitTime { 0 };
+
     NodeToSenderStatsMap _singleSenderStats;
     QReadWriteLock _senderStatsLock;
 
@@ -12,6 +12,7 @@
 #include "OctreePacketData.h"
 
 #include <GLMHelpers.h>
+#include <Gzip.h>
 #include <PerfStat.h>
 
 #include "OctreeLogging.h"
@@ -605,9 +606,11 @@ bool OctreePacketData::compressContent() {
     const uchar* uncompressedData = &_uncompressed[0];
     int uncompressedSize = _bytesInUse;
 
-    QByteArray compressedData = qCompress(uncompressedData, uncompressedSize, MAX_COMPRESSION);
+    QByteArray compressedData = _compressionDictionary.isEmpty() ?
+        qCompress(uncompressedData, uncompressedSize, MAX_COMPRESSION) :
+        deflateWithDictionary(uncompressedData, uncompressedSize, _compressionDictionary, MAX_COMPRESSION);
 
-    if (compressedData.size() < _compressedByteArray.size()) {
+    if (!compressedData.isEmpty() && compressedData.size() < _compressedByteArray.size()) {
         _compressedBytes = compressedData.size();
         memcpy(_compressed, compressedData.constData(), _compressedBytes);
         _dirty = false;
@@ -629,11 +632,16 @@ void OctreePacketData::loadFinalizedContent(const unsigned char* data, int lengt
             _compressedBytes = length;
             memcpy(_compressed, data, _compressedBytes);
 
-            QByteArray compressedData;
-            compressedData.resize(_compressedBytes);
-            memcpy(compressedData.data(), data, _compressedBytes);
+            QByteArray uncompressedData;
+            if (_compressionDictionary.isEmpty()) {
+                QByteArray compressedData;
+                compressedData.resize(_compressedBytes);
+                memcpy(compressedData.data(), data, _compressedBytes);
 
-            QByteArray uncompressedData = qUncompress(compressedData);
+                uncompressedData = qUncompress(compressedData);
+            } else {
+                uncompressedData = inflateWithDictionary(data, _compressedBytes, _compressionDictionary);
+            }
             if (uncompressedData.size() > _bytesAvailable) {
                 int moreNeeded = uncompressedData.size() - _bytesAvailable;
                 _uncompressedByteArray.resize(_uncompressedByteArray.size() + moreNeeded);
@@ -66,6 +66,10 @@ const int REASONABLE_NUMBER_OF_PACKING_ATTEMPTS = 5;
 
 const int PACKET_IS_COLOR_BIT = 0;
 const int PACKET_IS_COMPRESSED_BIT = 1;
+const int PACKET_HAS_DATA_DICTIONARY_BIT = 2; // sections are compressed with the data dictionary whose ID follows the header
+
+typedef uint32_t OCTREE_PACKET_DATA_DICTIONARY_ID;
+const OCTREE_PACKET_DATA_DICTIONARY_ID NO_DATA_DICTIONARY = 0;
 
 /// An opaque key used when starting, ending, and discarding encoding/packing levels of OctreePacketData
 class LevelDetails {
@@ -239,6 +243,10 @@ public:
     
     /// returns whether or not zlib compression enabled on finalization
     bool isCompressed() const { return _enableCompression; }
+
+    /// preset dictionary used by zlib compression on finalization and when loading, survives changeSettings() and reset()
+    void setCompressionDictionary(const QByteArray& dictionary) { _compressionDictionary = dictionary; }
+    const QByteArray& getCompressionDictionary() const { return _compressionDictionary; }
     
     /// returns the target uncompressed size
     unsigned int getTargetSize() const { return _targetSize; }
@@ -307,6 +315,7 @@ private:
     bool compressContent();
     
     QByteArray _compressedByteArray;
+    QByteArray _compressionDictionary;
     unsigned char* _compressed { nullptr };
     int _compressedBytes;
     int _bytesInUseLastCheck;
@@ -23,10 +23,12 @@
 #include <QDir>
 #include <QDirIterator>
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QRegExp>
+#include <QSaveFile>
 
 #include <NumericalConstants.h>
 #include <PerfStat.h>
@@ -38,13 +40,19 @@
 #include "OctreeDataUtils.h"
 
 constexpr std::chrono::seconds OctreePersistThread::DEFAULT_PERSIST_INTERVAL { 30 };
+constexpr std::chrono::milliseconds OctreePersistThread::DEFAULT_CHANGE_LOG_INTERVAL { 1000 };
+constexpr qint64 OctreePersistThread::DEFAULT_CHANGE_LOG_MAX_SIZE { 16 * 1000 * 1000 };
 constexpr std::chrono::milliseconds TIME_BETWEEN_PROCESSING { 10 };
 
+constexpr quint32 SNAPSHOT_MAGIC { 0x48464f53 }; // "HFOS"
+constexpr quint32 SNAPSHOT_FORMAT_VERSION { 1 };
+
 constexpr int MAX_OCTREE_REPLACEMENT_BACKUP_FILES_COUNT { 20 };
 constexpr int64_t MAX_OCTREE_REPLACEMENT_BACKUP_FILES_SIZE_BYTES { 50 * 1000 * 1000 };
 
 OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& filename, std::chrono::milliseconds persistInterval,
-                                         bool debugTimestampNow, QString persistAsFileType) :
+                                         bool debugTimestampNow, QString persistAsFileType,
+                                         std::chrono::milliseconds changeLogInterval, qint64 changeLogMaxSize) :
     _tree(tree),
     _filename(filename),
     _persistInterval(persistInterval),
@@ -53,11 +61,16 @@ OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& file
     _loadTimeUSecs(0),
     _debugTimestampNow(debugTimestampNow),
     _lastTimeDebug(0),
-    _persistAsFileType(persistAsFileType)
+    _persistAsFileType(persistAsFileType),
+    _changeLogInterval(changeLogInterval),
+    _lastChangeLogAppend(std::chrono::steady_clock::now()),
+    _changeLogMaxSize(changeLogMaxSize)
 {
     // in case the persist filename has an extension that doesn't match the file type
     QString sansExt = fileNameWithoutExtension(_filename, PERSIST_EXTENSIONS);
     _filename = sansExt + "." + _persistAsFileType;
+    _changeLogFilename = _filename + ".log";
+    _snapshotFilename = _filename + ".snapshot";
 }
 
 void OctreePersistThread::start() {
@@ -72,9 +85,22 @@ void OctreePersistThread::start() {
     auto packet = NLPacket::create(PacketType::OctreeDataFileRequest, -1, true, false);
 
     OctreeUtils::RawOctreeData data;
-    qCDebug(octree) << "Reading octree data from" << _filename;
+    QFile snapshotFile(_snapshotFilename);
+    if (snapshotFile.open(QIODevice::ReadOnly)) {
+        QDataStream snapshotStream(&snapshotFile);
+        _loadFromSnapshot = readSnapshotInfo(snapshotStream, _snapshotInfo);
+    }
+
     QFile file(_filename);
-    if (file.open(QIODevice::ReadOnly)) {
+    if (_loadFromSnapshot) {
+        // the snapshot matches the persist file and has everything the DS needs to know, so skip parsing the latter
+        qCDebug(octree) << "Current octree data from snapshot: ID(" << _snapshotInfo.id << ") DataVersion("
+                        << _snapshotInfo.dataVersion << ")";
+        packet->writePrimitive(true);
+        packet->write(_snapshotInfo.id.toRfc4122());
+        packet->writePrimitive(_snapshotInfo.dataVersion);
+    } else if (file.open(QIODevice::ReadOnly)) {
+        qCDebug(octree) << "Reading octree data from" << _filename;
         QByteArray jsonData(file.readAll());
         file.close();
         if (!gunzip(jsonData, _cachedJSONData)) {
@@ -116,8 +142,16 @@ void OctreePersistThread::handleOctreeDataFileReply(QSharedPointer<ReceivedMessa
         _cachedJSONData.clear();
         replacementData = message->readAll();
         replaceData(replacementData);
+        // changes logged against our previous data don't apply to the replacement
+        discardChangeLog();
+        _loadFromSnapshot = false;
         hasValidOctreeData = data.readOctreeDataInfoFromFile(_filename);
         qDebug() << "Got OctreeDataFileReply, new data sent";
+    } else if (_loadFromSnapshot) {
+        qDebug() << "Got OctreeDataFileReply, current entity data is sufficient";
+        data.id = _snapshotInfo.id;
+        data.dataVersion = _snapshotInfo.dataVersion;
+        hasValidOctreeData = true;
     } else {
         qDebug() << "Got OctreeDataFileReply, current entity data is sufficient";
         
@@ -148,17 +182,28 @@ void OctreePersistThread::handleOctreeDataFileReply(QSharedPointer<ReceivedMessa
         _tree->setOctreeVersionInfo(data.id, data.dataVersion);
     }
 
-    bool persistentFileRead;
+    bool persistentFileRead = false;
 
     _tree->withWriteLock([&] {
         PerformanceWarning warn(true, "Loading Octree File", true);
 
-        if (_cachedJSONData.isEmpty()) {
-            persistentFileRead = _tree->readFromFile(_filename.toLocal8Bit().constData());
-        } else {
-            QDataStream jsonStream(_cachedJSONData);
-            persistentFileRead = _tree->readFromStream(-1, jsonStream);
+        if (_loadFromSnapshot) {
+            persistentFileRead = readSnapshot();
+            if (!persistentFileRead) {
+                qCWarning(octree) << "Failed to load snapshot" << _snapshotFilename << "- falling back to" << _filename;
+                _tree->eraseAllOctreeElements();
+            }
         }
+
+        if (!persistentFileRead) {
+            if (_cachedJSONData.isEmpty()) {
+                persistentFileRead = _tree->readFromFile(_filename.toLocal8Bit().constData());
+            } else {
+                QDataStream jsonStream(_cachedJSONData);
+                persistentFileRead = _tree->readFromStream(-1, jsonStream);
+            }
+        }
+        replayChangeLog();
         _tree->pruneTree();
     });
 
@@ -168,6 +213,11 @@ void OctreePersistThread::handleOctreeDataFileReply(QSharedPointer<ReceivedMessa
 
     _tree->clearDirtyBit(); // the tree is clean since we just loaded it
 
+    if (persistentFileRead && !_loadFromSnapshot) {
+        // so that the next start doesn't have to parse the persist file again
+        writeSnapshot();
+    }
+
     unsigned long nodeCount = OctreeElement::getNodeCount();
     unsigned long internalNodeCount = OctreeElement::getInternalNodeCount();
     unsigned long leafNodeCount = OctreeElement::getLeafNodeCount();
@@ -191,6 +241,11 @@ void OctreePersistThread::handleOctreeDataFileReply(QSharedPointer<ReceivedMessa
     // Since we just loaded the persistent file, we can consider ourselves as having just persisted
     _lastPersistCheck = std::chrono::steady_clock::now();
 
+    if (isChangeLogEnabled()) {
+        _tree->setChangeLogEnabled(true);
+        _lastChangeLogAppend = _lastPersistCheck;
+    }
+
     if (replacementData.isNull()) {
         sendLatestEntityDataToDS();
     }
@@ -212,6 +267,7 @@ QString OctreePersistThread::getPersistFileMimeType() const {
 
 void OctreePersistThread::replaceData(QByteArray data) {
     backupCurrentFile();
+    discardSnapshot();
 
     QFile currentFile { _filename };
     if (currentFile.open(QIODevice::WriteOnly)) {
@@ -245,12 +301,28 @@ void OctreePersistThread::process() {
     _tree->preUpdate();
     _tree->update();
 
+    if (_persistResult.valid() && _persistResult.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        finishPersist();
+    }
+
     auto now = std::chrono::steady_clock::now();
+
+    if (isChangeLogEnabled() && now - _lastChangeLogAppend > _changeLogInterval) {
+        _lastChangeLogAppend = now;
+        appendChangeLog();
+    }
+
     auto timeSinceLastPersist = now - _lastPersistCheck;
 
-    if (timeSinceLastPersist > _persistInterval) {
+    // changes logged while a save is in progress are sent to the DS once it has the saved data
+    if (timeSinceLastPersist > _persistInterval && !_persistResult.valid()) {
         _lastPersistCheck = now;
-        persist();
+        // with a change log, a full save is only needed to compact the log
+        if (!isChangeLogEnabled() || QFileInfo(_changeLogFilename).size() > _changeLogMaxSize) {
+            persist();
+        } else if (_initialLoadComplete) {
+            sendChangesToDS();
+        }
     }
 
     QTimer::singleShot(TIME_BETWEEN_PROCESSING.count(), this, &OctreePersistThread::process);
@@ -258,7 +330,16 @@ void OctreePersistThread::process() {
 
 void OctreePersistThread::aboutToFinish() {
     qCDebug(octree) << "Persist thread about to finish...";
+    // let a save in progress finish, then save whatever changed since it started
+    if (_persistResult.valid()) {
+        _persistResult.wait();
+        finishPersist();
+    }
     persist();
+    if (_persistResult.valid()) {
+        _persistResult.wait();
+        finishPersist();
+    }
     qCDebug(octree) << "Persist thread done with about to finish...";
 }
 
@@ -301,8 +382,10 @@ void OctreePersistThread::cleanupOldReplacementBackups() {
     qDebug() << "Found" << count << "backups";
 }
 
+// Saves the tree on a worker thread, so that the change log keeps being appended while the tree is serialized,
+// compressed and written. Only the serialization holds the tree's read lock.
 void OctreePersistThread::persist() {
-    if (_tree->isDirty() && _initialLoadComplete) {
+    if (_tree->isDirty() && _initialLoadComplete && !_persistResult.valid()) {
 
         _tree->withWriteLock([&] {
             qCDebug(octree) << "pruning Octree before saving...";
@@ -311,30 +394,253 @@ void OctreePersistThread::persist() {
         });
 
         _tree->incrementPersistDataVersion();
+        _tree->clearDirtyBit(); // changes made from here on are saved next time
+
+        // everything logged so far is in the data saved now, changes logged meanwhile are appended after it
+        _persistedChangeLogSize = QFileInfo(_changeLogFilename).size();
 
         qCDebug(octree) << "Saving Octree data to:" << _filename;
-        if (_tree->writeToFile(_filename.toLocal8Bit().constData(), nullptr, _persistAsFileType)) {
-            _tree->clearDirtyBit(); // tree is clean after saving
-            qCDebug(octree) << "DONE persisting Octree data to" << _filename;
-        } else {
-            qCWarning(octree) << "Failed to persist Octree data to" << _filename;
-        }
+        _persistResult = std::async(std::launch::async, [this] { return writePersistFile(); });
+    }
+}
 
-        sendLatestEntityDataToDS();
+QByteArray OctreePersistThread::writePersistFile() {
+    bool doGzip = _persistAsFileType == "json.gz";
+    if (!doGzip && _persistAsFileType != "json") {
+        qCWarning(octree) << "unable to write octree to file of type" << _persistAsFileType;
+        return QByteArray();
     }
+
+    QByteArray data;
+    if (!_tree->toJSON(&data, nullptr, doGzip)) {
+        return QByteArray();
+    }
+
+    QSaveFile persistFile(_filename);
+    if (!persistFile.open(QIODevice::WriteOnly) || persistFile.write(data) != data.size() || !persistFile.commit()) {
+        qCWarning(octree) << "Failed to write" << _filename << persistFile.errorString();
+        return QByteArray();
+    }
+    writeSnapshot();
+
+    // the DS always gets the compressed data
+    QByteArray gzippedData;
+    if (!doGzip && gzip(data, gzippedData, -1)) {
+        return gzippedData;
+    }
+    return data;
 }
 
-void OctreePersistThread::sendLatestEntityDataToDS() {
-    qDebug() << "Sending latest entity data to DS";
-    auto nodeList = DependencyManager::get<NodeList>();
-    const DomainHandler& domainHandler = nodeList->getDomainHandler();
+void OctreePersistThread::finishPersist() {
+    QByteArray persistData = _persistResult.get();
+    if (persistData.isEmpty()) {
+        qCWarning(octree) << "Failed to persist Octree data to" << _filename;
+        _tree->setDirtyBit(); // try again at the next interval
+        return;
+    }
+    qCDebug(octree) << "DONE persisting Octree data to" << _filename;
+
+    trimChangeLog(_persistedChangeLogSize);
+    sendEntityDataToDS(persistData);
+
+    // what is left in the log was logged after the DS's new data was taken
+    _changeLogSentSize = 0;
+}
+
+void OctreePersistThread::appendChangeLog() {
+    QFile logFile(_changeLogFilename);
+    if (!logFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCWarning(octree) << "Could not open change log" << _changeLogFilename << logFile.errorString();
+        return;
+    }
+    if (!_tree->appendChangesToLog(logFile)) {
+        qCWarning(octree) << "Failed to append to change log" << _changeLogFilename;
+    }
+    logFile.flush();
+}
+
+void OctreePersistThread::replayChangeLog() {
+    QFile logFile(_changeLogFilename);
+    if (!logFile.exists()) {
+        return;
+    }
+    if (logFile.open(QIODevice::ReadOnly)) {
+        PerformanceWarning warn(true, "Replaying Octree change log", true);
+        int numRecords = _tree->replayChangeLog(logFile);
+        qCDebug(octree) << "Replayed" << numRecords << "changes from" << _changeLogFilename;
+    } else {
+        qCWarning(octree) << "Could not open change log" << _changeLogFilename << logFile.errorString();
+    }
+}
+
+void OctreePersistThread::discardChangeLog() {
+    QFile logFile(_changeLogFilename);
+    if (logFile.exists() && !logFile.remove()) {
+        qCWarning(octree) << "Could not remove change log" << _changeLogFilename << logFile.errorString();
+    }
+    _changeLogSentSize = 0;
+}
 
+// Removes the first size bytes of the change log. Records are complete entity states, so if we don't get
+// that far the records that stay behind are harmlessly replayed over the saved file.
+void OctreePersistThread::trimChangeLog(qint64 size) {
+    QFile logFile(_changeLogFilename);
+    if (logFile.size() <= size) {
+        discardChangeLog();
+        return;
+    }
+    if (size <= 0) {
+        return;
+    }
+
+    if (!logFile.open(QIODevice::ReadOnly) || !logFile.seek(size)) {
+        qCWarning(octree) << "Could not open change log" << _changeLogFilename << logFile.errorString();
+        return;
+    }
+    QByteArray remaining = logFile.readAll();
+    logFile.close();
+
+    QSaveFile trimmedLogFile(_changeLogFilename);
+    if (!trimmedLogFile.open(QIODevice::WriteOnly) || trimmedLogFile.write(remaining) != remaining.size() ||
+        !trimmedLogFile.commit()) {
+        qCWarning(octree) << "Could not trim change log" << _changeLogFilename << trimmedLogFile.errorString();
+    }
+}
+
+// The snapshot header records the persist file it was written with, so that a persist file that was replaced or
+// edited while we weren't running is never shadowed by an out of date snapshot.
+bool OctreePersistThread::readSnapshotInfo(QDataStream& snapshot, OctreeUtils::RawOctreeData& data) const {
+    quint32 magic;
+    quint32 formatVersion;
+    quint8 version;
+    qint64 persistFileSize;
+    qint64 persistFileModified;
+    qint64 dataVersion;
+    snapshot >> magic >> formatVersion >> version >> persistFileSize >> persistFileModified >> data.id >> dataVersion;
+
+    if (snapshot.status() != QDataStream::Ok || magic != SNAPSHOT_MAGIC || formatVersion != SNAPSHOT_FORMAT_VERSION) {
+        qCWarning(octree) << "Ignoring unreadable snapshot" << _snapshotFilename;
+        return false;
+    }
+    if (version != _tree->expectedVersion()) {
+        qCDebug(octree) << "Ignoring snapshot" << _snapshotFilename << "written with data version" << version;
+        return false;
+    }
+
+    QFileInfo persistFile(_filename);
+    if (!persistFile.exists() || persistFile.size() != persistFileSize ||
+        persistFile.lastModified().toMSecsSinceEpoch() != persistFileModified) {
+        qCDebug(octree) << "Ignoring snapshot" << _snapshotFilename << "that doesn't match" << _filename;
+        return false;
+    }
+
+    data.dataVersion = dataVersion;
+    data.version = version;
+    return !data.id.isNull();
+}
+
+bool OctreePersistThread::readSnapshot() {
+    // NOTE: callers must lock the tree before using this method
+    QFile snapshotFile(_snapshotFilename);
+    if (!snapshotFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    // decode straight out of the mapped file when we can
+    QByteArray snapshotData;
+    uchar* mappedData = snapshotFile.map(0, snapshotFile.size());
+    if (mappedData) {
+        snapshotData = QByteArray::fromRawData(reinterpret_cast<const char*>(mappedData), snapshotFile.size());
+    } else {
+        snapshotData = snapshotFile.readAll();
+    }
+
+    QDataStream snapshotStream(snapshotData);
+    OctreeUtils::RawOctreeData data;
+    if (!readSnapshotInfo(snapshotStream, data)) {
+        return false;
+    }
+
+    int headerSize = (int)snapshotStream.device()->pos();
+    bool success = _tree->readFromSnapshot(QByteArray::fromRawData(snapshotData.constData() + headerSize,
+                                                                   snapshotData.size() - headerSize));
+    if (success) {
+        _tree->setOctreeVersionInfo(data.id, data.dataVersion);
+    }
+    return success;
+}
+
+void OctreePersistThread::writeSnapshot() {
+    QFileInfo persistFile(_filename);
+    QSaveFile snapshotFile(_snapshotFilename);
+    if (!snapshotFile.open(QIODevice::WriteOnly)) {
+        qCWarning(octree) << "Could not open snapshot" << _snapshotFilename << snapshotFile.errorString();
+        discardSnapshot();
+        return;
+    }
+
+    QDataStream snapshotStream(&snapshotFile);
+    snapshotStream << SNAPSHOT_MAGIC << SNAPSHOT_FORMAT_VERSION << (quint8)_tree->expectedVersion()
+                   << (qint64)persistFile.size() << (qint64)persistFile.lastModified().toMSecsSinceEpoch()
+                   << _tree->getPersistID() << (qint64)_tree->getPersistDataVersion();
+
+    if (snapshotStream.status() == QDataStream::Ok && _tree->writeToSnapshot(snapshotFile) && snapshotFile.commit()) {
+        qCDebug(octree) << "DONE writing snapshot to" << _snapshotFilename;
+    } else {
+        snapshotFile.cancelWriting();
+        // a snapshot left over from an earlier save no longer matches the persist file, but don't leave it around
+        discardSnapshot();
+    }
+}
+
+void OctreePersistThread::discardSnapshot() {
+    QFile snapshotFile(_snapshotFilename);
+    if (snapshotFile.exists() && !snapshotFile.remove()) {
+        qCWarning(octree) << "Could not remove snapshot" << _snapshotFilename << snapshotFile.errorString();
+    }
+}
+
+void OctreePersistThread::sendLatestEntityDataToDS() {
     QByteArray data;
     if (_tree->toJSON(&data, nullptr, true)) {
-        auto message = NLPacketList::create(PacketType::OctreeDataPersist, QByteArray(), true, true);
-        message->write(data);
-        nodeList->sendPacketList(std::move(message), domainHandler.getSockAddr());
+        sendEntityDataToDS(data);
+        // the data includes everything logged so far
+        _changeLogSentSize = QFileInfo(_changeLogFilename).size();
     } else {
         qCWarning(octree) << "Failed to persist octree to DS";
     }
 }
+
+void OctreePersistThread::sendEntityDataToDS(const QByteArray& data) {
+    qDebug() << "Sending latest entity data to DS";
+    auto nodeList = DependencyManager::get<NodeList>();
+    const DomainHandler& domainHandler = nodeList->getDomainHandler();
+
+    auto message = NLPacketList::create(PacketType::OctreeDataPersist, QByteArray(), true, true);
+    message->write(data);
+    nodeList->sendPacketList(std::move(message), domainHandler.getSockAddr());
+}
+
+// In between full saves the DS gets the records appended to the change log, which it applies to the data it has
+// as long as that is the data they were logged against.
+void OctreePersistThread::sendChangesToDS() {
+    QFile logFile(_changeLogFilename);
+    if (logFile.size() <= _changeLogSentSize) {
+        return;
+    }
+    if (!logFile.open(QIODevice::ReadOnly) || !logFile.seek(_changeLogSentSize)) {
+        qCWarning(octree) << "Could not open change log" << _changeLogFilename << logFile.errorString();
+        return;
+    }
+    QByteArray changes = logFile.readAll();
+    _changeLogSentSize += changes.size();
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    const DomainHandler& domainHandler = nodeList->getDomainHandler();
+
+    auto message = NLPacketList::create(PacketType::OctreeDataPersistChanges, QByteArray(), true, true);
+    message->write(_tree->getPersistID().toRfc4122());
+    message->writePrimitive((OctreeUtils::Version)_tree->getPersistDataVersion());
+    message->write(changes);
+    nodeList->sendPacketList(std::move(message), domainHandler.getSockAddr());
+}
@@ -14,9 +14,12 @@
 #ifndef hifi_OctreePersistThread_h
 #define hifi_OctreePersistThread_h
 
+#include <future>
+
 #include <QString>
 #include <GenericThread.h>
 #include "Octree.h"
+#include "OctreeDataUtils.h"
 
 class OctreePersistThread : public QObject {
     Q_OBJECT
@@ -31,12 +34,16 @@ public:
     };
 
     static const std::chrono::seconds DEFAULT_PERSIST_INTERVAL;
+    static const std::chrono::milliseconds DEFAULT_CHANGE_LOG_INTERVAL;
+    static const qint64 DEFAULT_CHANGE_LOG_MAX_SIZE;
 
     OctreePersistThread(OctreePointer tree,
                         const QString& filename,
                         std::chrono::milliseconds persistInterval = DEFAULT_PERSIST_INTERVAL,
                         bool debugTimestampNow = false,
-                        QString persistAsFileType = "json.gz");
+                        QString persistAsFileType = "json.gz",
+                        std::chrono::milliseconds changeLogInterval = std::chrono::milliseconds(0),
+                        qint64 changeLogMaxSize = DEFAULT_CHANGE_LOG_MAX_SIZE);
 
     bool isInitialLoadComplete() const { return _initialLoadComplete; }
     quint64 getLoadElapsedTime() const { return _loadTimeUSecs; }
@@ -59,11 +66,26 @@ protected slots:
 
 protected:
     void persist();
+    QByteArray writePersistFile();
+    void finishPersist();
     bool backupCurrentFile();
+
+    bool isChangeLogEnabled() const { return _changeLogInterval.count() > 0; }
+    void appendChangeLog();
+    void replayChangeLog();
+    void discardChangeLog();
+    void trimChangeLog(qint64 size);
+
+    bool readSnapshotInfo(QDataStream& snapshot, OctreeUtils::RawOctreeData& data) const;
+    bool readSnapshot();
+    void writeSnapshot();
+    void discardSnapshot();
     void cleanupOldReplacementBackups();
 
     void replaceData(QByteArray data);
     void sendLatestEntityDataToDS();
+    void sendEntityDataToDS(const QByteArray& data);
+    void sendChangesToDS();
 
 private:
     OctreePointer _tree;
@@ -79,6 +101,22 @@ private:
 
     QString _persistAsFileType;
     QByteArray _cachedJSONData;
+
+    // changes are appended to the log in between full saves, which then only happen once it has grown too large
+    QString _changeLogFilename;
+    std::chrono::milliseconds _changeLogInterval;
+    std::chrono::steady_clock::time_point _lastChangeLogAppend;
+    qint64 _changeLogMaxSize;
+    qint64 _changeLogSentSize { 0 }; // how much of the change log the DS has
+
+    // a full save in progress on a worker thread, holds the compressed data for the DS once done
+    std::future<QByteArray> _persistResult;
+    qint64 _persistedChangeLogSize { 0 }; // how much of the change log the save in progress includes
+
+    // binary copy of the persist file that loads without parsing JSON, only trusted while the persist file is unchanged
+    QString _snapshotFilename;
+    OctreeUtils::RawOctreeData _snapshotInfo;
+    bool _loadFromSnapshot { false };
 };
 
 #endif // hifi_OctreePersistThread_h
@@ -69,6 +69,22 @@ void OctreeProcessor::processDatagram(ReceivedMessage& message, SharedNodePointe
         bool packetIsColored = oneAtBit(flags, PACKET_IS_COLOR_BIT);
         bool packetIsCompressed = oneAtBit(flags, PACKET_IS_COMPRESSED_BIT);
 
+        QByteArray dataDictionary;
+        if (oneAtBit(flags, PACKET_HAS_DATA_DICTIONARY_BIT)) {
+            OCTREE_PACKET_DATA_DICTIONARY_ID dataDictionaryID;
+            message.readPrimitive(&dataDictionaryID);
+
+            if (dataDictionaryID == _dataDictionaryID) {
+                dataDictionary = _dataDictionary;
+            } else if (dataDictionaryID == _previousDataDictionaryID) {
+                dataDictionary = _previousDataDictionary;
+            } else {
+                qCWarning(octree) << "OctreeProcessor::processDatagram() dropping packet compressed with unknown data dictionary"
+                    << dataDictionaryID;
+                return;
+            }
+        }
+
         OCTREE_PACKET_SENT_TIME arrivedAt = usecTimestampNow();
         qint64 clockSkew = sourceNode ? sourceNode->getClockSkewUsec() : 0;
         qint64 flightTime = arrivedAt - sentAt + clockSkew;
@@ -124,6 +140,7 @@ void OctreeProcessor::processDatagram(ReceivedMessage& message, SharedNodePointe
                     startUncompress = usecTimestampNow();
 
                     OctreePacketData packetData(packetIsCompressed);
+                    packetData.setCompressionDictionary(dataDictionary);
                     packetData.loadFinalizedContent(reinterpret_cast<const unsigned char*>(message.getRawMessage() + message.getPosition()),
                         sectionLength);
                     if (extraDebugging) {
@@ -213,3 +230,15 @@ void OctreeProcessor::clear() {
     }
 }
 
+void OctreeProcessor::processDataDictionaryMessage(ReceivedMessage& message) {
+    OCTREE_PACKET_DATA_DICTIONARY_ID dataDictionaryID;
+    message.readPrimitive(&dataDictionaryID);
+    if (dataDictionaryID == NO_DATA_DICTIONARY || dataDictionaryID == _dataDictionaryID) {
+        return;
+    }
+
+    _previousDataDictionaryID = _dataDictionaryID;
+    _previousDataDictionary = _dataDictionary;
+    _dataDictionary = message.readAll();
+    _dataDictionaryID = dataDictionaryID;
+}
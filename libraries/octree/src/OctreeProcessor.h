@@ -59,6 +59,12 @@ public:
 
     OCTREE_PACKET_SEQUENCE getLastOctreeMessageSequence() const { return _lastOctreeMessageSequence; }
 
+    /// takes a data dictionary from the server, process it on the same thread as the datagrams
+    void processDataDictionaryMessage(ReceivedMessage& message);
+
+    /// the dictionary our query should report having, so the server knows it can compress with it
+    uint32_t getDataDictionaryID() const { return _dataDictionaryID; }
+
 protected:
     virtual OctreePointer createTree() = 0;
 
@@ -82,6 +88,12 @@ protected:
     int _entitiesInLastWindow = 0;
     std::atomic<OCTREE_PACKET_SEQUENCE> _lastOctreeMessageSequence;
 
+    // the previous dictionary is kept for the packets the server compressed before it heard we switched
+    std::atomic<uint32_t> _dataDictionaryID { NO_DATA_DICTIONARY };
+    QByteArray _dataDictionary;
+    uint32_t _previousDataDictionaryID { NO_DATA_DICTIONARY };
+    QByteArray _previousDataDictionary;
+
 };
 
 #endif // hifi_OctreeProcessor_h
@@ -18,6 +18,10 @@
 #include <GLMHelpers.h>
 #include <udt/PacketHeaders.h>
 
+// interest regions only ever need to cover the surroundings of a viewer, so a client can't use them to pull the whole
+// tree ahead of everyone else
+const float MAX_INTEREST_REGION_RADIUS = 100.0f; // meters
+
 OctreeQuery::OctreeQuery(bool randomizeConnectionID) {
     if (randomizeConnectionID) {
         // randomize our initial octree query connection ID using random_device
@@ -83,9 +87,34 @@ int OctreeQuery::getBroadcastData(unsigned char* destinationBuffer) {
 
     OctreeQueryFlags queryFlags { NoFlags };
     queryFlags |= (_reportInitialCompletion ? OctreeQuery::WantInitialCompletion : 0);
+    queryFlags |= (_wantDataDictionary ? OctreeQuery::WantDataDictionary : 0);
     memcpy(destinationBuffer, &queryFlags, sizeof(queryFlags));
     destinationBuffer += sizeof(queryFlags);
 
+    // the data dictionary we have, the server only compresses with it once we have it
+    uint32_t dataDictionaryID = _dataDictionaryID;
+    memcpy(destinationBuffer, &dataDictionaryID, sizeof(dataDictionaryID));
+    destinationBuffer += sizeof(dataDictionaryID);
+
+    // what we'd like first while we load
+    uint8_t interestClasses = _interestClasses;
+    memcpy(destinationBuffer, &interestClasses, sizeof(interestClasses));
+    destinationBuffer += sizeof(interestClasses);
+
+    {
+        QMutexLocker lock(&_conicalViewsLock);
+        uint8_t numRegions = (uint8_t)std::min((int)_interestRegions.size(), MAX_INTEREST_REGIONS);
+        memcpy(destinationBuffer, &numRegions, sizeof(numRegions));
+        destinationBuffer += sizeof(numRegions);
+
+        for (int i = 0; i < numRegions; ++i) {
+            memcpy(destinationBuffer, &_interestRegions[i].position, sizeof(glm::vec3));
+            destinationBuffer += sizeof(glm::vec3);
+            memcpy(destinationBuffer, &_interestRegions[i].radius, sizeof(float));
+            destinationBuffer += sizeof(float);
+        }
+    }
+
     return destinationBuffer - bufferStart;
 }
 
@@ -165,6 +194,38 @@ int OctreeQuery::parseData(ReceivedMessage& message) {
     sourceBuffer += sizeof(queryFlags);
 
     _reportInitialCompletion = bool(queryFlags & OctreeQueryFlags::WantInitialCompletion);
+    _wantDataDictionary = bool(queryFlags & OctreeQueryFlags::WantDataDictionary);
+
+    uint32_t dataDictionaryID;
+    memcpy(&dataDictionaryID, sourceBuffer, sizeof(dataDictionaryID));
+    sourceBuffer += sizeof(dataDictionaryID);
+    _dataDictionaryID = dataDictionaryID;
+
+    uint8_t interestClasses;
+    memcpy(&interestClasses, sourceBuffer, sizeof(interestClasses));
+    sourceBuffer += sizeof(interestClasses);
+    _interestClasses = interestClasses;
+
+    uint8_t numRegions = 0;
+    memcpy(&numRegions, sourceBuffer, sizeof(numRegions));
+    sourceBuffer += sizeof(numRegions);
+
+    {
+        QMutexLocker lock(&_conicalViewsLock);
+        _interestRegions.clear();
+        for (int i = 0; i < numRegions && i < MAX_INTEREST_REGIONS; ++i) {
+            InterestRegion region;
+            memcpy(&region.position, sourceBuffer, sizeof(glm::vec3));
+            sourceBuffer += sizeof(glm::vec3);
+            memcpy(&region.radius, sourceBuffer, sizeof(float));
+            sourceBuffer += sizeof(float);
+            if (isNaN(region.position) || !(region.radius > 0.0f)) {
+                continue;
+            }
+            region.radius = std::min(region.radius, MAX_INTEREST_REGION_RADIUS);
+            _interestRegions.push_back(region);
+        }
+    }
 
     return sourceBuffer - startPosition;
 }
@@ -12,6 +12,9 @@
 #ifndef hifi_OctreeQuery_h
 #define hifi_OctreeQuery_h
 
+#include <atomic>
+#include <vector>
+
 #include <QtCore/QJsonObject>
 #include <QtCore/QReadWriteLock>
 
@@ -24,6 +27,16 @@ class OctreeQuery : public NodeData {
     Q_OBJECT
 
 public:
+    // While it loads its initial scene a viewer can ask for some of it ahead of the rest: everything around the
+    // places it is interested in (where it spawns, where it is looking) and classes of entities it can't do without.
+    enum InterestClass : uint8_t { NoInterest = 0x0, InterestInZones = 0x1, InterestInCollidables = 0x2 };
+    struct InterestRegion {
+        glm::vec3 position;
+        float radius;
+    };
+    using InterestRegions = std::vector<InterestRegion>;
+    static const int MAX_INTEREST_REGIONS = 8;
+
     OctreeQuery(bool randomizeConnectionID = false);
     virtual ~OctreeQuery() {}
 
@@ -38,6 +51,12 @@ public:
         { QMutexLocker lock(&_conicalViewsLock); _conicalViews = views; }
     void clearConicalViews() { QMutexLocker lock(&_conicalViewsLock); _conicalViews.clear(); }
 
+    uint8_t getInterestClasses() const { return _interestClasses; }
+    void setInterestClasses(uint8_t interestClasses) { _interestClasses = interestClasses; }
+    InterestRegions getInterestRegions() const { QMutexLocker lock(&_conicalViewsLock); return _interestRegions; }
+    void setInterestRegions(InterestRegions regions)
+        { QMutexLocker lock(&_conicalViewsLock); _interestRegions = regions; }
+
     // getters/setters for JSON filter
     QJsonObject getJSONParameters() { QReadLocker locker { &_jsonParametersLock }; return _jsonParameters; }
     void setJSONParameters(const QJsonObject& jsonParameters)
@@ -56,6 +75,12 @@ public:
     bool wantReportInitialCompletion() const { return _reportInitialCompletion; }
     void setReportInitialCompletion(bool reportInitialCompletion) { _reportInitialCompletion = reportInitialCompletion; }
 
+    // Want octree data compressed with the server's data dictionary, once we have the one with the given ID.
+    bool wantDataDictionary() const { return _wantDataDictionary; }
+    void setWantDataDictionary(bool wantDataDictionary) { _wantDataDictionary = wantDataDictionary; }
+    uint32_t getDataDictionaryID() const { return _dataDictionaryID; }
+    void setDataDictionaryID(uint32_t dataDictionaryID) { _dataDictionaryID = dataDictionaryID; }
+
 signals:
     void incomingConnectionIDChanged();
 
@@ -67,6 +92,8 @@ public slots:
 protected:
     mutable QMutex _conicalViewsLock;
     ConicalViewFrustums _conicalViews;
+    InterestRegions _interestRegions; // also guarded by _conicalViewsLock
+    std::atomic<uint8_t> _interestClasses { NoInterest };
 
     // octree server sending items
     int _maxQueryPPS = DEFAULT_MAX_OCTREE_PPS;
@@ -78,11 +105,13 @@ protected:
     QJsonObject _jsonParameters;
     QReadWriteLock _jsonParametersLock;
     
-    enum OctreeQueryFlags : uint16_t { NoFlags = 0x0, WantInitialCompletion = 0x1 };
+    enum OctreeQueryFlags : uint16_t { NoFlags = 0x0, WantInitialCompletion = 0x1, WantDataDictionary = 0x2 };
     friend OctreeQuery::OctreeQueryFlags operator|=(OctreeQuery::OctreeQueryFlags& lhs, const int rhs);
 
     bool _hasReceivedFirstQuery { false };
     bool _reportInitialCompletion { false };
+    bool _wantDataDictionary { false };
+    std::atomic<uint32_t> _dataDictionaryID { 0 }; // 0 when we have none
 };
 
 #endif // hifi_OctreeQuery_h
@@ -106,6 +106,9 @@ void OctreeQueryNode::resetOctreePacket() {
     OCTREE_PACKET_FLAGS flags = 0;
     setAtBit(flags, PACKET_IS_COLOR_BIT); // always color
     setAtBit(flags, PACKET_IS_COMPRESSED_BIT); // always compressed
+    if (_packetDataDictionaryID != NO_DATA_DICTIONARY) {
+        setAtBit(flags, PACKET_HAS_DATA_DICTIONARY_BIT);
+    }
 
     _octreePacket->reset();
 
@@ -119,9 +122,22 @@ void OctreeQueryNode::resetOctreePacket() {
     OCTREE_PACKET_SENT_TIME now = usecTimestampNow();
     _octreePacket->writePrimitive(now);
 
+    if (_packetDataDictionaryID != NO_DATA_DICTIONARY) {
+        _octreePacket->writePrimitive(_packetDataDictionaryID);
+    }
+
     _octreePacketWaiting = false;
 }
 
+void OctreeQueryNode::setPacketDataDictionary(uint32_t dataDictionaryID, const QByteArray& dataDictionary) {
+    assert(!_octreePacketWaiting);
+    _packetDataDictionaryID = dataDictionaryID;
+    _packetDataDictionary = dataDictionary;
+
+    // rewrite the header of the empty packet
+    resetOctreePacket();
+}
+
 void OctreeQueryNode::writeToPacket(const unsigned char* buffer, unsigned int bytes) {
     // if shutting down, return immediately
     if (_isShuttingDown) {
@@ -39,6 +39,11 @@ public:
 
     void writeToPacket(const unsigned char* buffer, unsigned int bytes); // writes to end of packet
 
+    // the data dictionary the sections of our octree packets are compressed with, only change it between packets
+    void setPacketDataDictionary(uint32_t dataDictionaryID, const QByteArray& dataDictionary);
+    uint32_t getPacketDataDictionaryID() const { return _packetDataDictionaryID; }
+    const QByteArray& getPacketDataDictionary() const { return _packetDataDictionary; }
+
     NLPacket& getPacket() const { return *_octreePacket; }
     bool isPacketWaiting() const { return _octreePacketWaiting; }
 
@@ -107,6 +112,9 @@ private:
 
     OCTREE_PACKET_SEQUENCE _sequenceNumber { 0 };
 
+    uint32_t _packetDataDictionaryID { NO_DATA_DICTIONARY };
+    QByteArray _packetDataDictionary;
+
     PacketType _myPacketType { PacketType::Unknown };
     bool _isShuttingDown { false };
 
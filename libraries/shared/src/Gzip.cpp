@@ -11,6 +11,8 @@
 
 #include "Gzip.h"
 
+#include <QtEndian>
+
 #include <zlib.h>
 
 const int GZIP_WINDOWS_BIT = 31;
@@ -153,3 +155,75 @@ bool gzip(QByteArray source, QByteArray &destination, int compressionLevel) {
     deflateEnd(&strm);
     return status == Z_STREAM_END;
 }
+
+static const int UNCOMPRESSED_SIZE_BYTES = sizeof(quint32);
+static const quint32 MAX_INFLATED_SIZE = 16 * 1024 * 1024; // don't trust the size prefix of a corrupt stream
+
+QByteArray deflateWithDictionary(const unsigned char* source, int sourceLength, const QByteArray& dictionary,
+                                 int compressionLevel) {
+    z_stream strm;
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+
+    if (deflateInit(&strm, qMax(Z_DEFAULT_COMPRESSION, qMin(9, compressionLevel))) != Z_OK) {
+        return QByteArray();
+    }
+    if (deflateSetDictionary(&strm, (const Bytef*)dictionary.constData(), dictionary.size()) != Z_OK) {
+        deflateEnd(&strm);
+        return QByteArray();
+    }
+
+    QByteArray destination;
+    destination.resize(UNCOMPRESSED_SIZE_BYTES + (int)deflateBound(&strm, sourceLength));
+    qToBigEndian<quint32>(sourceLength, destination.data());
+
+    strm.next_in = (Bytef*)source;
+    strm.avail_in = sourceLength;
+    strm.next_out = (Bytef*)destination.data() + UNCOMPRESSED_SIZE_BYTES;
+    strm.avail_out = destination.size() - UNCOMPRESSED_SIZE_BYTES;
+
+    int status = deflate(&strm, Z_FINISH);
+    destination.resize(UNCOMPRESSED_SIZE_BYTES + (int)strm.total_out);
+    deflateEnd(&strm);
+
+    return status == Z_STREAM_END ? destination : QByteArray();
+}
+
+QByteArray inflateWithDictionary(const unsigned char* source, int sourceLength, const QByteArray& dictionary) {
+    if (sourceLength <= UNCOMPRESSED_SIZE_BYTES) {
+        return QByteArray();
+    }
+
+    quint32 uncompressedSize = qFromBigEndian<quint32>(source);
+    if (uncompressedSize > MAX_INFLATED_SIZE) {
+        return QByteArray();
+    }
+
+    QByteArray destination;
+    destination.resize(uncompressedSize);
+
+    z_stream strm;
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+    strm.next_in = (Bytef*)source + UNCOMPRESSED_SIZE_BYTES;
+    strm.avail_in = sourceLength - UNCOMPRESSED_SIZE_BYTES;
+    strm.next_out = (Bytef*)destination.data();
+    strm.avail_out = destination.size();
+
+    if (inflateInit(&strm) != Z_OK) {
+        return QByteArray();
+    }
+
+    int status = inflate(&strm, Z_FINISH);
+    if (status == Z_NEED_DICT) {
+        if (inflateSetDictionary(&strm, (const Bytef*)dictionary.constData(), dictionary.size()) == Z_OK) {
+            status = inflate(&strm, Z_FINISH);
+        }
+    }
+    bool complete = status == Z_STREAM_END && strm.total_out == (uLong)destination.size();
+    inflateEnd(&strm);
+
+    return complete ? destination : QByteArray();
+}
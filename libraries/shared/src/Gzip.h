@@ -24,4 +24,11 @@ bool gzip(QByteArray source, QByteArray &destination, int compressionLevel = -1)
 
 bool gunzip(QByteArray source, QByteArray &destination);
 
+// zlib streams primed with a preset dictionary, framed like qCompress() with the uncompressed size in the first
+// four bytes. Both ends must use the same dictionary, an empty array is returned on failure.
+QByteArray deflateWithDictionary(const unsigned char* source, int sourceLength, const QByteArray& dictionary,
+                                 int compressionLevel = -1);
+
+QByteArray inflateWithDictionary(const unsigned char* source, int sourceLength, const QByteArray& dictionary);
+
 #endif
@@ -0,0 +1,167 @@
+//
+//  JointPacking.cpp
+//  libraries/shared/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "JointPacking.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "CPUDetect.h"
+#include "GLMHelpers.h"
+#include "NumericalConstants.h"
+
+static const int SIX_BYTES = 6;
+
+static_assert(sizeof(glm::quat) == 4 * sizeof(float), "glm::quat size doesn't match.");
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "glm::vec3 size doesn't match.");
+static_assert(sizeof(JointData) % sizeof(float) == 0, "JointData is not a whole number of floats.");
+
+static const int JOINT_DATA_STRIDE = sizeof(JointData) / sizeof(float);
+static const int JOINT_ROTATION_OFFSET = offsetof(JointData, rotation) / sizeof(float);
+static const int JOINT_TRANSLATION_OFFSET = offsetof(JointData, translation) / sizeof(float);
+
+//
+// Portable reference code, also used for the remainder after the AVX2 blocks
+//
+static void packOrientationQuatsToSixBytes_ref(unsigned char* buffer, const glm::quat* quats, int start, int end) {
+    for (int i = start; i < end; ++i) {
+        packOrientationQuatToSixBytes(buffer + SIX_BYTES * i, quats[i]);
+    }
+}
+
+static void unpackOrientationQuatsFromSixBytes_ref(const unsigned char* buffer, glm::quat* quats, int start, int end) {
+    for (int i = start; i < end; ++i) {
+        unpackOrientationQuatFromSixBytes(buffer + SIX_BYTES * i, quats[i]);
+    }
+}
+
+static void packFloatsToSignedTwoByteFixed_ref(unsigned char* buffer, const float* source, int start, int end,
+                                               float divisor, int radix) {
+    for (int i = start; i < end; ++i) {
+        packFloatScalarToSignedTwoByteFixed(buffer + sizeof(int16_t) * i, source[i] / divisor, radix);
+    }
+}
+
+static void unpackFloatsFromSignedTwoByteFixed_ref(const unsigned char* buffer, float* destination, int start, int end,
+                                                   int radix) {
+    for (int i = start; i < end; ++i) {
+        unpackFloatScalarFromSignedTwoByteFixed((const int16_t*)(buffer + sizeof(int16_t) * i), &destination[i], radix);
+    }
+}
+
+// start must be a multiple of 8
+template <typename F>
+static void writeChangeBits_ref(uint8_t* changedBits, int start, int end, const F& changed) {
+    int numBytes = (end + BITS_IN_BYTE - 1) / BITS_IN_BYTE - start / BITS_IN_BYTE;
+    memset(changedBits + start / BITS_IN_BYTE, 0, numBytes);
+    for (int i = start; i < end; ++i) {
+        if (changed(i)) {
+            changedBits[i / BITS_IN_BYTE] |= 1 << (i % BITS_IN_BYTE);
+        }
+    }
+}
+
+#ifdef ARCH_X86
+//
+// Runtime CPU dispatch
+//
+int packOrientationQuatsToSixBytes_AVX2(const float (*quats)[4], unsigned char* buffer, int size);
+int unpackOrientationQuatsFromSixBytes_AVX2(const unsigned char* buffer, float (*quats)[4], int size);
+int packFloatsToSignedTwoByteFixed_AVX2(const float* source, unsigned char* buffer, int size, float divisor, int radix);
+int unpackFloatsFromSignedTwoByteFixed_AVX2(const unsigned char* buffer, float* destination, int size, int radix);
+int computeRotationChangeBits_AVX2(const float* current, const float* last, int stride, int size,
+                                   float minDot, uint8_t* changedBits);
+int computeTranslationChangeBits_AVX2(const float* current, const float* last, int stride, int size,
+                                      float minDistance, uint8_t* changedBits);
+
+static bool useAVX2() {
+    static bool _cpuSupportsAVX2 = cpuSupportsAVX2();
+    return _cpuSupportsAVX2;
+}
+#endif
+
+int packOrientationQuatsToSixBytes(unsigned char* buffer, const glm::quat* quats, int numQuats) {
+    int i = 0;
+#ifdef ARCH_X86
+    if (useAVX2()) {
+        i = packOrientationQuatsToSixBytes_AVX2((const float(*)[4])quats, buffer, numQuats);
+    }
+#endif
+    packOrientationQuatsToSixBytes_ref(buffer, quats, i, numQuats);
+    return SIX_BYTES * numQuats;
+}
+
+int unpackOrientationQuatsFromSixBytes(const unsigned char* buffer, glm::quat* quats, int numQuats) {
+    int i = 0;
+#ifdef ARCH_X86
+    if (useAVX2()) {
+        i = unpackOrientationQuatsFromSixBytes_AVX2(buffer, (float(*)[4])quats, numQuats);
+    }
+#endif
+    unpackOrientationQuatsFromSixBytes_ref(buffer, quats, i, numQuats);
+    return SIX_BYTES * numQuats;
+}
+
+int packFloatVec3sToSignedTwoByteFixed(unsigned char* buffer, const glm::vec3* vectors, int numVectors,
+                                       float divisor, int radix) {
+    const float* source = (const float*)vectors;
+    int numFloats = 3 * numVectors;
+    int i = 0;
+#ifdef ARCH_X86
+    if (useAVX2()) {
+        i = packFloatsToSignedTwoByteFixed_AVX2(source, buffer, numFloats, divisor, radix);
+    }
+#endif
+    packFloatsToSignedTwoByteFixed_ref(buffer, source, i, numFloats, divisor, radix);
+    return SIX_BYTES * numVectors;
+}
+
+int unpackFloatVec3sFromSignedTwoByteFixed(const unsigned char* buffer, glm::vec3* vectors, int numVectors, int radix) {
+    float* destination = (float*)vectors;
+    int numFloats = 3 * numVectors;
+    int i = 0;
+#ifdef ARCH_X86
+    if (useAVX2()) {
+        i = unpackFloatsFromSignedTwoByteFixed_AVX2(buffer, destination, numFloats, radix);
+    }
+#endif
+    unpackFloatsFromSignedTwoByteFixed_ref(buffer, destination, i, numFloats, radix);
+    return SIX_BYTES * numVectors;
+}
+
+void computeJointRotationChangeBits(const JointData* current, const JointData* last, int numJoints,
+                                    float minDot, uint8_t* changedBits) {
+    int i = 0;
+#ifdef ARCH_X86
+    if (useAVX2()) {
+        i = computeRotationChangeBits_AVX2((const float*)current + JOINT_ROTATION_OFFSET,
+                                           (const float*)last + JOINT_ROTATION_OFFSET,
+                                           JOINT_DATA_STRIDE, numJoints, minDot, changedBits);
+    }
+#endif
+    writeChangeBits_ref(changedBits, i, numJoints, [&](int index) {
+        return fabsf(glm::dot(current[index].rotation, last[index].rotation)) < minDot;
+    });
+}
+
+void computeJointTranslationChangeBits(const JointData* current, const JointData* last, int numJoints,
+                                       float minDistance, uint8_t* changedBits) {
+    int i = 0;
+#ifdef ARCH_X86
+    if (useAVX2()) {
+        i = computeTranslationChangeBits_AVX2((const float*)current + JOINT_TRANSLATION_OFFSET,
+                                              (const float*)last + JOINT_TRANSLATION_OFFSET,
+                                              JOINT_DATA_STRIDE, numJoints, minDistance, changedBits);
+    }
+#endif
+    writeChangeBits_ref(changedBits, i, numJoints, [&](int index) {
+        return glm::distance(current[index].translation, last[index].translation) > minDistance;
+    });
+}
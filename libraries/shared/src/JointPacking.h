@@ -0,0 +1,46 @@
+//
+//  JointPacking.h
+//  libraries/shared/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_JointPacking_h
+#define hifi_JointPacking_h
+
+#include <stdint.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "JointData.h"
+
+//
+// Batch versions of the GLMHelpers joint compression functions, for packing a whole skeleton per call.
+// The output is identical to calling packOrientationQuatToSixBytes() etc. once per element,
+// but uses AVX2 kernels when the CPU supports them.
+//
+
+// returns the number of bytes written (6 per quat)
+int packOrientationQuatsToSixBytes(unsigned char* buffer, const glm::quat* quats, int numQuats);
+int unpackOrientationQuatsFromSixBytes(const unsigned char* buffer, glm::quat* quats, int numQuats);
+
+// each vector is divided by divisor before being packed, as the avatar joint translations are
+// returns the number of bytes written (6 per vector)
+int packFloatVec3sToSignedTwoByteFixed(unsigned char* buffer, const glm::vec3* vectors, int numVectors,
+                                       float divisor, int radix);
+int unpackFloatVec3sFromSignedTwoByteFixed(const unsigned char* buffer, glm::vec3* vectors, int numVectors, int radix);
+
+// Small-change culling: sets bit i of changedBits (LSB first, as in the avatar joint validity bits) when
+// fabsf(glm::dot(current[i].rotation, last[i].rotation)) < minDot, or for translations when
+// glm::distance(current[i].translation, last[i].translation) > minDistance. The default pose flags are ignored.
+// changedBits must hold (numJoints + 7) / 8 bytes, all of which are written.
+void computeJointRotationChangeBits(const JointData* current, const JointData* last, int numJoints,
+                                    float minDot, uint8_t* changedBits);
+void computeJointTranslationChangeBits(const JointData* current, const JointData* last, int numJoints,
+                                       float minDistance, uint8_t* changedBits);
+
+#endif // hifi_JointPacking_h
@@ -0,0 +1,295 @@
+//
+//  JointPacking_avx2.cpp
+//  libraries/shared/src/avx2
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifdef __AVX2__
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <immintrin.h>
+
+//
+// Each kernel processes whole blocks of 8 and returns the number of elements it handled.
+// The caller finishes the remainder with the scalar reference code.
+//
+
+// deinterleave 8 quats (4x8 to 8x4 matrix transpose)
+static inline void loadQuats8(const float (*quats)[4], __m256& qx, __m256& qy, __m256& qz, __m256& qw) {
+    __m256 l0 = _mm256_loadu_ps(quats[0]);  // q0 q1
+    __m256 l1 = _mm256_loadu_ps(quats[2]);  // q2 q3
+    __m256 l2 = _mm256_loadu_ps(quats[4]);  // q4 q5
+    __m256 l3 = _mm256_loadu_ps(quats[6]);  // q6 q7
+
+    __m256 s0 = _mm256_permute2f128_ps(l0, l2, 0x20);   // q0 q4
+    __m256 s1 = _mm256_permute2f128_ps(l0, l2, 0x31);   // q1 q5
+    __m256 s2 = _mm256_permute2f128_ps(l1, l3, 0x20);   // q2 q6
+    __m256 s3 = _mm256_permute2f128_ps(l1, l3, 0x31);   // q3 q7
+
+    __m256 t0 = _mm256_unpacklo_ps(s0, s1);
+    __m256 t1 = _mm256_unpackhi_ps(s0, s1);
+    __m256 t2 = _mm256_unpacklo_ps(s2, s3);
+    __m256 t3 = _mm256_unpackhi_ps(s2, s3);
+
+    qx = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1,0,1,0));
+    qy = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3,2,3,2));
+    qz = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1,0,1,0));
+    qw = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3,2,3,2));
+}
+
+// interleave 8 quats (8x4 to 4x8 matrix transpose)
+static inline void storeQuats8(float (*quats)[4], __m256 qx, __m256 qy, __m256 qz, __m256 qw) {
+    __m256 t0 = _mm256_unpacklo_ps(qx, qy);
+    __m256 t1 = _mm256_unpackhi_ps(qx, qy);
+    __m256 t2 = _mm256_unpacklo_ps(qz, qw);
+    __m256 t3 = _mm256_unpackhi_ps(qz, qw);
+
+    __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1,0,1,0));  // q0 q4
+    __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3,2,3,2));  // q1 q5
+    __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1,0,1,0));  // q2 q6
+    __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3,2,3,2));  // q3 q7
+
+    _mm256_storeu_ps(quats[0], _mm256_permute2f128_ps(s0, s1, 0x20));
+    _mm256_storeu_ps(quats[2], _mm256_permute2f128_ps(s2, s3, 0x20));
+    _mm256_storeu_ps(quats[4], _mm256_permute2f128_ps(s0, s1, 0x31));
+    _mm256_storeu_ps(quats[6], _mm256_permute2f128_ps(s2, s3, 0x31));
+}
+
+// swap the bytes of the low 16 bits of each lane
+static inline __m256i byteSwap16(__m256i v) {
+    return _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(v, 8), _mm256_set1_epi32(0xff)),
+                           _mm256_slli_epi32(_mm256_and_si256(v, _mm256_set1_epi32(0xff)), 8));
+}
+
+int packOrientationQuatsToSixBytes_AVX2(const float (*quats)[4], unsigned char* buffer, int size) {
+
+    const float MAGNITUDE = 1.0f / sqrtf(2.0f);
+    const float RANGE = (float)((1 << 15) - 1);
+
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+    int i = 0;
+    for (; i + 8 < size; i += 8) {  // blocks of 8, leaving at least one for the 8-byte stores below to overrun
+
+        __m256 qx, qy, qz, qw;
+        loadQuats8(&quats[i], qx, qy, qz, qw);
+
+        // find largest component, first one wins on ties
+        __m256 largestAbs = _mm256_andnot_ps(signMask, qx);
+        __m256 largestValue = qx;
+        __m256 largest = _mm256_setzero_ps();
+
+        __m256 a = _mm256_andnot_ps(signMask, qy);
+        __m256 mask = _mm256_cmp_ps(a, largestAbs, _CMP_GT_OQ);
+        largestAbs = _mm256_blendv_ps(largestAbs, a, mask);
+        largestValue = _mm256_blendv_ps(largestValue, qy, mask);
+        largest = _mm256_blendv_ps(largest, _mm256_set1_ps(1.0f), mask);
+
+        a = _mm256_andnot_ps(signMask, qz);
+        mask = _mm256_cmp_ps(a, largestAbs, _CMP_GT_OQ);
+        largestAbs = _mm256_blendv_ps(largestAbs, a, mask);
+        largestValue = _mm256_blendv_ps(largestValue, qz, mask);
+        largest = _mm256_blendv_ps(largest, _mm256_set1_ps(2.0f), mask);
+
+        a = _mm256_andnot_ps(signMask, qw);
+        mask = _mm256_cmp_ps(a, largestAbs, _CMP_GT_OQ);
+        largestValue = _mm256_blendv_ps(largestValue, qw, mask);
+        largest = _mm256_blendv_ps(largest, _mm256_set1_ps(3.0f), mask);
+
+        // ensure that the sign of the dropped component is always negative
+        __m256 flip = _mm256_and_ps(_mm256_cmp_ps(largestValue, _mm256_setzero_ps(), _CMP_GT_OQ), signMask);
+        qx = _mm256_xor_ps(qx, flip);
+        qy = _mm256_xor_ps(qy, flip);
+        qz = _mm256_xor_ps(qz, flip);
+        qw = _mm256_xor_ps(qw, flip);
+
+        // select the smallest three components, in order
+        __m256 c0 = _mm256_blendv_ps(qx, qy, _mm256_cmp_ps(largest, _mm256_set1_ps(0.0f), _CMP_EQ_OQ));
+        __m256 c1 = _mm256_blendv_ps(qy, qz, _mm256_cmp_ps(largest, _mm256_set1_ps(1.0f), _CMP_LE_OQ));
+        __m256 c2 = _mm256_blendv_ps(qz, qw, _mm256_cmp_ps(largest, _mm256_set1_ps(2.0f), _CMP_LE_OQ));
+
+        // transform into 0..1 range, then quantize into 0..range
+        c0 = _mm256_mul_ps(_mm256_div_ps(_mm256_add_ps(c0, _mm256_set1_ps(MAGNITUDE)), _mm256_set1_ps(2.0f * MAGNITUDE)), _mm256_set1_ps(RANGE));
+        c1 = _mm256_mul_ps(_mm256_div_ps(_mm256_add_ps(c1, _mm256_set1_ps(MAGNITUDE)), _mm256_set1_ps(2.0f * MAGNITUDE)), _mm256_set1_ps(RANGE));
+        c2 = _mm256_mul_ps(_mm256_div_ps(_mm256_add_ps(c2, _mm256_set1_ps(MAGNITUDE)), _mm256_set1_ps(2.0f * MAGNITUDE)), _mm256_set1_ps(RANGE));
+
+        __m256i li = _mm256_cvtps_epi32(largest);
+        __m256i i0 = _mm256_cvttps_epi32(c0);
+        __m256i i1 = _mm256_cvttps_epi32(c1);
+        __m256i i2 = _mm256_cvttps_epi32(c2);
+
+        // encode the largest component into the high bits of the first two components
+        i0 = _mm256_or_si256(_mm256_and_si256(i0, _mm256_set1_epi32(0x7fff)), _mm256_slli_epi32(_mm256_and_si256(li, _mm256_set1_epi32(1)), 15));
+        i1 = _mm256_or_si256(_mm256_and_si256(i1, _mm256_set1_epi32(0x7fff)), _mm256_slli_epi32(_mm256_and_si256(li, _mm256_set1_epi32(2)), 14));
+
+        // big-endian components, 6 bytes per quat in the low bytes of a 64-bit lane
+        __m256i lo = _mm256_or_si256(byteSwap16(i0), _mm256_slli_epi32(byteSwap16(i1), 16));
+        __m256i hi = byteSwap16(i2);
+
+        __m256i e0 = _mm256_unpacklo_epi32(lo, hi);  // q0 q1 q4 q5
+        __m256i e1 = _mm256_unpackhi_epi32(lo, hi);  // q2 q3 q6 q7
+
+        uint64_t out[8];
+        _mm256_storeu_si256((__m256i*)&out[0], _mm256_permute2x128_si256(e0, e1, 0x20));
+        _mm256_storeu_si256((__m256i*)&out[4], _mm256_permute2x128_si256(e0, e1, 0x31));
+
+        // store pack x 8, each store overwrites the 2 spare bytes of the previous one
+        unsigned char* dest = buffer + 6 * i;
+        for (int j = 0; j < 8; j++) {
+            memcpy(dest + 6 * j, &out[j], sizeof(uint64_t));
+        }
+    }
+
+    _mm256_zeroupper();
+    return i;
+}
+
+int unpackOrientationQuatsFromSixBytes_AVX2(const unsigned char* buffer, float (*quats)[4], int size) {
+
+    const float MAGNITUDE = 1.0f / sqrtf(2.0f);
+    const float RANGE = (float)((1 << 15) - 1);
+
+    const __m256i offsets = _mm256_setr_epi32(0, 6, 12, 18, 24, 30, 36, 42);
+    const __m256i byteMask = _mm256_set1_epi32(0xff);
+    const __m256i highMask = _mm256_set1_epi32(0x7f);
+
+    int i = 0;
+    for (; i + 8 < size; i += 8) {  // blocks of 8, leaving at least one for the 4-byte gathers below to overrun
+
+        const unsigned char* source = buffer + 6 * i;
+        __m256i g0 = _mm256_i32gather_epi32((const int*)source, offsets, 1);        // bytes 0..3
+        __m256i g1 = _mm256_i32gather_epi32((const int*)(source + 4), offsets, 1);  // bytes 4..5
+
+        __m256i i0 = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(g0, highMask), 8),
+                                     _mm256_and_si256(_mm256_srli_epi32(g0, 8), byteMask));
+        __m256i i1 = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(g0, 16), highMask), 8),
+                                     _mm256_and_si256(_mm256_srli_epi32(g0, 24), byteMask));
+        __m256i i2 = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(g1, highMask), 8),
+                                     _mm256_and_si256(_mm256_srli_epi32(g1, 8), byteMask));
+
+        // largest component is encoded into the highest bits of the first 2 components
+        __m256i largest = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(g0, 22), _mm256_set1_epi32(2)),
+                                          _mm256_and_si256(_mm256_srli_epi32(g0, 7), _mm256_set1_epi32(1)));
+
+        __m256 f0 = _mm256_sub_ps(_mm256_mul_ps(_mm256_div_ps(_mm256_cvtepi32_ps(i0), _mm256_set1_ps(RANGE)), _mm256_set1_ps(2.0f * MAGNITUDE)), _mm256_set1_ps(MAGNITUDE));
+        __m256 f1 = _mm256_sub_ps(_mm256_mul_ps(_mm256_div_ps(_mm256_cvtepi32_ps(i1), _mm256_set1_ps(RANGE)), _mm256_set1_ps(2.0f * MAGNITUDE)), _mm256_set1_ps(MAGNITUDE));
+        __m256 f2 = _mm256_sub_ps(_mm256_mul_ps(_mm256_div_ps(_mm256_cvtepi32_ps(i2), _mm256_set1_ps(RANGE)), _mm256_set1_ps(2.0f * MAGNITUDE)), _mm256_set1_ps(MAGNITUDE));
+
+        // missing component is always negative
+        __m256 missing = _mm256_sub_ps(_mm256_sub_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(f0, f0)), _mm256_mul_ps(f1, f1)), _mm256_mul_ps(f2, f2));
+        missing = _mm256_xor_ps(_mm256_sqrt_ps(missing), _mm256_set1_ps(-0.0f));
+
+        __m256 is0 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(largest, _mm256_set1_epi32(0)));
+        __m256 is1 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(largest, _mm256_set1_epi32(1)));
+        __m256 is2 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(largest, _mm256_set1_epi32(2)));
+        __m256 is3 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(largest, _mm256_set1_epi32(3)));
+        __m256 below2 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(2), largest));
+
+        // re-insert the missing component
+        __m256 qx = _mm256_blendv_ps(f0, missing, is0);
+        __m256 qy = _mm256_blendv_ps(_mm256_blendv_ps(f1, missing, is1), f0, is0);
+        __m256 qz = _mm256_blendv_ps(_mm256_blendv_ps(f2, missing, is2), f1, below2);
+        __m256 qw = _mm256_blendv_ps(f2, missing, is3);
+
+        storeQuats8(&quats[i], qx, qy, qz, qw);
+    }
+
+    _mm256_zeroupper();
+    return i;
+}
+
+int packFloatsToSignedTwoByteFixed_AVX2(const float* source, unsigned char* buffer, int size, float divisor, int radix) {
+
+    const __m256 scale = _mm256_set1_ps((float)(1 << radix));
+    const __m256 minValue = _mm256_set1_ps((float)INT16_MIN);
+    const __m256 maxValue = _mm256_set1_ps((float)INT16_MAX);
+
+    int i = 0;
+    for (; i + 8 <= size; i += 8) {  // blocks of 8
+
+        __m256 v = _mm256_mul_ps(_mm256_div_ps(_mm256_loadu_ps(&source[i]), _mm256_set1_ps(divisor)), scale);
+
+        // clamp(vec, INT16_MIN, INT16_MAX)
+        v = _mm256_min_ps(_mm256_max_ps(v, minValue), maxValue);
+
+        __m256i vi = _mm256_cvttps_epi32(v);
+        __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(vi), _mm256_extracti128_si256(vi, 1));
+        _mm_storeu_si128((__m128i*)(buffer + 2 * i), packed);
+    }
+
+    _mm256_zeroupper();
+    return i;
+}
+
+int unpackFloatsFromSignedTwoByteFixed_AVX2(const unsigned char* buffer, float* destination, int size, int radix) {
+
+    const __m256 scale = _mm256_set1_ps((float)(1 << radix));
+
+    int i = 0;
+    for (; i + 8 <= size; i += 8) {  // blocks of 8
+
+        __m256i vi = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(buffer + 2 * i)));
+        _mm256_storeu_ps(&destination[i], _mm256_div_ps(_mm256_cvtepi32_ps(vi), scale));
+    }
+
+    _mm256_zeroupper();
+    return i;
+}
+
+int computeRotationChangeBits_AVX2(const float* current, const float* last, int stride, int size,
+                                   float minDot, uint8_t* changedBits) {
+
+    const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(stride));
+
+    int i = 0;
+    for (; i + 8 <= size; i += 8) {  // blocks of 8, one byte of bits each
+
+        const float* c = current + i * stride;
+        const float* l = last + i * stride;
+
+        __m256 dot = _mm256_mul_ps(_mm256_i32gather_ps(c + 0, offsets, sizeof(float)), _mm256_i32gather_ps(l + 0, offsets, sizeof(float)));
+        dot = _mm256_add_ps(dot, _mm256_mul_ps(_mm256_i32gather_ps(c + 1, offsets, sizeof(float)), _mm256_i32gather_ps(l + 1, offsets, sizeof(float))));
+        dot = _mm256_add_ps(dot, _mm256_mul_ps(_mm256_i32gather_ps(c + 2, offsets, sizeof(float)), _mm256_i32gather_ps(l + 2, offsets, sizeof(float))));
+        dot = _mm256_add_ps(dot, _mm256_mul_ps(_mm256_i32gather_ps(c + 3, offsets, sizeof(float)), _mm256_i32gather_ps(l + 3, offsets, sizeof(float))));
+
+        // abs(dot) < minDot
+        __m256 changed = _mm256_cmp_ps(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), dot), _mm256_set1_ps(minDot), _CMP_LT_OQ);
+        changedBits[i / 8] = (uint8_t)_mm256_movemask_ps(changed);
+    }
+
+    _mm256_zeroupper();
+    return i;
+}
+
+int computeTranslationChangeBits_AVX2(const float* current, const float* last, int stride, int size,
+                                      float minDistance, uint8_t* changedBits) {
+
+    const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(stride));
+
+    int i = 0;
+    for (; i + 8 <= size; i += 8) {  // blocks of 8, one byte of bits each
+
+        const float* c = current + i * stride;
+        const float* l = last + i * stride;
+
+        __m256 dx = _mm256_sub_ps(_mm256_i32gather_ps(c + 0, offsets, sizeof(float)), _mm256_i32gather_ps(l + 0, offsets, sizeof(float)));
+        __m256 dy = _mm256_sub_ps(_mm256_i32gather_ps(c + 1, offsets, sizeof(float)), _mm256_i32gather_ps(l + 1, offsets, sizeof(float)));
+        __m256 dz = _mm256_sub_ps(_mm256_i32gather_ps(c + 2, offsets, sizeof(float)), _mm256_i32gather_ps(l + 2, offsets, sizeof(float)));
+
+        // distance(current, last) > minDistance
+        __m256 distance = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz)));
+        __m256 changed = _mm256_cmp_ps(distance, _mm256_set1_ps(minDistance), _CMP_GT_OQ);
+        changedBits[i / 8] = (uint8_t)_mm256_movemask_ps(changed);
+    }
+
+    _mm256_zeroupper();
+    return i;
+}
+
+#endif
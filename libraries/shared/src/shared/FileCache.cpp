@@ -13,11 +13,11 @@
 
 
 #include <unordered_set>
-#include <queue>
 #include <cassert>
 
-#include <QtCore/QDateTime>
+#include <QtCore/QDataStream>
 #include <QtCore/QDir>
+#include <QtCore/QFileInfo>
 #include <QtCore/QSaveFile>
 #include <QtCore/QStorageInfo>
 
@@ -40,6 +40,13 @@ using namespace cache;
 static const char DIR_SEP = '/';
 static const char EXT_SEP = '.';
 
+static const char* INDEX_FILENAME = "cache_index";
+static const quint32 INDEX_VERSION = 1;
+
+// the index is rewritten once it has this many times more records than there are files
+static const size_t INDEX_COMPACTION_RATIO = 4;
+static const size_t MIN_INDEX_RECORDS_BEFORE_COMPACTION = 1024;
+
 const size_t FileCache::DEFAULT_MAX_SIZE { GB_TO_BYTES(5) };
 const size_t FileCache::MAX_MAX_SIZE { GB_TO_BYTES(100) };
 const size_t FileCache::DEFAULT_MIN_FREE_STORAGE_SPACE { GB_TO_BYTES(1) };
@@ -79,7 +86,8 @@ FileCache::FileCache(const std::string& dirname, const std::string& ext, QObject
     QObject(parent),
     _ext(ext),
     _dirname(getCacheName(dirname)),
-    _dirpath(getCachePath(dirname)) {
+    _dirpath(getCachePath(dirname)),
+    _indexFilepath(_dirpath + DIR_SEP + INDEX_FILENAME) {
 }
 
 FileCache::~FileCache() {
@@ -95,18 +103,18 @@ void FileCache::initialize() {
 
     QDir dir(_dirpath.c_str());
 
+    bool isIndexValid = false;
     if (dir.exists()) {
+        // listing the names of the files is cheap, it's looking at each of them that is slow for a large cache
         auto nameFilters = QStringList(("*." + _ext).c_str());
         auto filters = QDir::Filters(QDir::NoDotAndDotDot | QDir::Files);
-        auto sort = QDir::SortFlags(QDir::Time);
-        auto files = dir.entryList(nameFilters, filters, sort);
+        auto files = dir.entryList(nameFilters, filters, QDir::Unsorted);
+        files.removeOne(INDEX_FILENAME);
 
         // load persisted files
-        foreach(QString filename, files) {
-            const Key key = filename.section('.', 0, 0).toStdString();
-            const std::string filepath = dir.filePath(filename).toStdString();
-            const size_t length = QFileInfo(filepath.c_str()).size();
-            addFile(Metadata(key, length), filepath);
+        isIndexValid = restoreFromIndex(files);
+        if (!isIndexValid) {
+            restoreFromDirectory();
         }
 
         qCDebug(file_cache, "[%s] Initialized %s", _dirname.c_str(), _dirpath.c_str());
@@ -116,6 +124,179 @@ void FileCache::initialize() {
     }
 
     _initialized = true;
+
+    if (!isIndexValid || _numIndexRecords != _files.size()) {
+        compactIndex();
+    } else {
+        _indexFile.reset(new QFile(_indexFilepath.c_str()));
+        if (!_indexFile->open(QIODevice::WriteOnly | QIODevice::Append)) {
+            qCWarning(file_cache, "[%s] Failed to open %s", _dirname.c_str(), _indexFilepath.c_str());
+            _indexFile.reset();
+        }
+    }
+
+    clean();
+}
+
+bool FileCache::restoreFromIndex(const QStringList& filenames) {
+    QFile indexFile(_indexFilepath.c_str());
+    if (!indexFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&indexFile);
+    quint32 version;
+    stream >> version;
+    if (stream.status() != QDataStream::Ok || version != INDEX_VERSION) {
+        qCWarning(file_cache, "[%s] Ignoring invalid index %s", _dirname.c_str(), _indexFilepath.c_str());
+        return false;
+    }
+
+    // replay the log to find the files in the order they were last used
+    using Order = std::list<Metadata>;
+    Order order;
+    std::unordered_map<Key, Order::iterator> positions;
+    size_t numRecords = 0;
+    while (!stream.atEnd()) {
+        quint8 record;
+        QByteArray key;
+        quint64 length = 0;
+        stream >> record >> key;
+        if (record == (quint8)IndexRecord::Add) {
+            stream >> length;
+        }
+        if (stream.status() != QDataStream::Ok) {
+            // the last record was cut short by the application exiting
+            break;
+        }
+        ++numRecords;
+
+        auto position = positions.find(key.toStdString());
+        if (record == (quint8)IndexRecord::Add) {
+            if (position == positions.end()) {
+                positions[key.toStdString()] = order.insert(order.end(), Metadata(key.toStdString(), length));
+            } else {
+                position->second->length = length;
+                order.splice(order.end(), order, position->second);
+            }
+        } else if (position != positions.end()) {
+            if (record == (quint8)IndexRecord::Use) {
+                order.splice(order.end(), order, position->second);
+            } else {
+                order.erase(position->second);
+                positions.erase(position);
+            }
+        }
+    }
+
+    KeySet keys;
+    QDir dir(_dirpath.c_str());
+    for (const auto& filename : filenames) {
+        const Key key = filename.section('.', 0, 0).toStdString();
+        keys.insert(key);
+        if (positions.find(key) == positions.end()) {
+            // written right before the application exited, so it's one of the most recently used
+            const size_t length = QFileInfo(dir.filePath(filename)).size();
+            positions[key] = order.insert(order.end(), Metadata(key, length));
+        }
+    }
+
+    for (auto& metadata : order) {
+        // files removed right before the application exited can still be in the index
+        if (keys.find(metadata.key) != keys.end()) {
+            const std::string filepath = getFilepath(metadata.key);
+            restoreFile(std::move(metadata), filepath);
+        }
+    }
+
+    _numIndexRecords = numRecords;
+    return true;
+}
+
+void FileCache::restoreFromDirectory() {
+    QDir dir(_dirpath.c_str());
+    auto nameFilters = QStringList(("*." + _ext).c_str());
+    auto filters = QDir::Filters(QDir::NoDotAndDotDot | QDir::Files);
+    // least recently used first
+    auto sort = QDir::SortFlags(QDir::Time | QDir::Reversed);
+
+    foreach(QFileInfo fileInfo, dir.entryInfoList(nameFilters, filters, sort)) {
+        if (fileInfo.fileName() == INDEX_FILENAME) {
+            continue;
+        }
+        const Key key = fileInfo.fileName().section('.', 0, 0).toStdString();
+        restoreFile(Metadata(key, fileInfo.size()), fileInfo.filePath().toStdString());
+    }
+}
+
+void FileCache::restoreFile(Metadata&& metadata, const std::string& filepath) {
+    auto file = addFile(std::move(metadata), filepath);
+    if (file) {
+        addUnusedFile(file);
+    }
+}
+
+void FileCache::appendIndexRecord(IndexRecord record, const Key& key, size_t length) {
+    if (!_indexFile) {
+        return;
+    }
+
+    {
+        QDataStream stream(_indexFile.get());
+        stream << (quint8)record << QByteArray::fromStdString(key);
+        if (record == IndexRecord::Add) {
+            stream << (quint64)length;
+        }
+    }
+    _indexFile->flush();
+
+    if (++_numIndexRecords > std::max(MIN_INDEX_RECORDS_BEFORE_COMPACTION, INDEX_COMPACTION_RATIO * _files.size())) {
+        compactIndex();
+    }
+}
+
+void FileCache::compactIndex() {
+    if (!_initialized) {
+        return;
+    }
+
+    // the files in use are written last, as the most recently used, and are only released once the index is written
+    std::vector<FilePointer> usedFiles;
+    for (const auto& entry : _files) {
+        auto file = entry.second.lock();
+        if (file && !file->_cached) {
+            usedFiles.push_back(file);
+        }
+    }
+
+    _indexFile.reset();
+
+    QSaveFile indexFile(_indexFilepath.c_str());
+    bool isWritten = false;
+    if (indexFile.open(QIODevice::WriteOnly)) {
+        QDataStream stream(&indexFile);
+        stream << INDEX_VERSION;
+        auto writeRecord = [&stream](const FilePointer& file) {
+            stream << (quint8)IndexRecord::Add << QByteArray::fromStdString(file->getKey()) << (quint64)file->getLength();
+        };
+        for (const auto& file : _unusedFiles) {
+            writeRecord(file);
+        }
+        for (const auto& file : usedFiles) {
+            writeRecord(file);
+        }
+        isWritten = indexFile.commit();
+    }
+    if (!isWritten) {
+        qCWarning(file_cache, "[%s] Failed to write %s", _dirname.c_str(), _indexFilepath.c_str());
+    }
+    _numIndexRecords = _unusedFiles.size() + usedFiles.size();
+
+    _indexFile.reset(new QFile(_indexFilepath.c_str()));
+    if (!_indexFile->open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCWarning(file_cache, "[%s] Failed to open %s", _dirname.c_str(), _indexFilepath.c_str());
+        _indexFile.reset();
+    }
 }
 
 std::unique_ptr<File> FileCache::createFile(Metadata&& metadata, const std::string& filepath) {
@@ -156,7 +337,7 @@ FilePointer FileCache::writeFile(const char* data, File::Metadata&& metadata, bo
     std::string filepath = getFilepath(metadata.key);
 
     // if file already exists, return it
-    file = getFile(metadata.key);
+    file = findFile(metadata.key);
     if (file) {
         if (!overwrite) {
             qCWarning(file_cache, "[%s] Attempted to overwrite %s", _dirname.c_str(), metadata.key.c_str());
@@ -173,6 +354,9 @@ FilePointer FileCache::writeFile(const char* data, File::Metadata&& metadata, bo
         && saveFile.commit()) {
 
         file = addFile(std::move(metadata), filepath);
+        if (file) {
+            appendIndexRecord(IndexRecord::Add, file->getKey(), file->getLength());
+        }
     } else {
         qCWarning(file_cache, "[%s] Failed to write %s", _dirname.c_str(), metadata.key.c_str());
     }
@@ -190,6 +374,18 @@ FilePointer FileCache::getFile(const Key& key) {
         return file;
     }
 
+    file = findFile(key);
+    if (file) {
+        _numHits += 1;
+    } else {
+        _numMisses += 1;
+    }
+    return file;
+}
+
+FilePointer FileCache::findFile(const Key& key) {
+    FilePointer file;
+
     // check if file exists
     const auto it = _files.find(key);
     if (it != _files.cend()) {
@@ -197,8 +393,10 @@ FilePointer FileCache::getFile(const Key& key) {
         if (file) {
             file->touch();
             // if it exists, it is active - remove it from the cache
-            if (_unusedFiles.erase(file)) {
+            if (file->_cached) {
                 assert(!file->_locked);
+                _unusedFiles.erase(file->_position);
+                file->_cached = false;
                 file->_locked = true;
                 _numUnusedFiles -= 1;
                 _unusedFilesSize -= file->getLength();
@@ -217,22 +415,44 @@ FilePointer FileCache::getFile(const Key& key) {
     return file;
 }
 
+bool FileCache::hint(const Key& key) {
+    Lock lock(_mutex);
+
+    if (!_initialized) {
+        return false;
+    }
+
+    const auto it = _files.find(key);
+    if (it == _files.cend()) {
+        return false;
+    }
+    auto file = it->second.lock();
+    if (!file) {
+        return false;
+    }
+
+    // a file in use is not ejected, an unused one becomes the most recently used
+    if (file->_cached) {
+        _unusedFiles.splice(_unusedFiles.end(), _unusedFiles, file->_position);
+        appendIndexRecord(IndexRecord::Use, key);
+    }
+    _numHints += 1;
+    emit dirty();
+    return true;
+}
+
 std::string FileCache::getFilepath(const Key& key) {
     return _dirpath + DIR_SEP + key + EXT_SEP + _ext;
 }
 
-// This is a non-public function that uses the mutex because it's 
-// essentially a public function specifically to a File object
 void FileCache::addUnusedFile(const FilePointer& file) {
-    assert(file->_locked);
+    assert(file->_locked && !file->_cached);
     file->_locked = false;
     _files[file->getKey()] = file;
-    _unusedFiles.insert(file);
+    file->_position = _unusedFiles.insert(_unusedFiles.end(), file);
+    file->_cached = true;
     _numUnusedFiles += 1;
     _unusedFilesSize += file->getLength();
-    clean();
-
-    emit dirty();
 }
 
 size_t FileCache::getOverbudgetAmount() const {
@@ -250,14 +470,6 @@ size_t FileCache::getOverbudgetAmount() const {
     return result;
 }
 
-namespace cache {
-    struct FilePointerComparator {
-        bool operator()(const FilePointer& a, const FilePointer& b) {
-            return a->_modified > b->_modified;
-        }
-    };
-}
-
 // Take file pointer by value to insure it doesn't get destructed during the "erase()" calls
 void FileCache::eject(FilePointer file) {
     file->_locked = false;
@@ -267,8 +479,11 @@ void FileCache::eject(FilePointer file) {
     if (0 != _files.erase(key)) {
         _numTotalFiles -= 1;
         _totalFilesSize -= length;
+        appendIndexRecord(IndexRecord::Remove, key);
     }
-    if (0 != _unusedFiles.erase(file)) {
+    if (file->_cached) {
+        _unusedFiles.erase(file->_position);
+        file->_cached = false;
         _numUnusedFiles -= 1;
         _unusedFilesSize -= length;
     }
@@ -277,21 +492,11 @@ void FileCache::eject(FilePointer file) {
 void FileCache::clean() {
     size_t overbudgetAmount = getOverbudgetAmount();
 
-    // Avoid sorting the unused files by LRU if we're not over budget / under free space
-    if (0 == overbudgetAmount) {
-        return;
-    }
-
-    using Queue = std::priority_queue<FilePointer, std::vector<FilePointer>, FilePointerComparator>;
-    Queue queue;
-    for (const auto& file : _unusedFiles) {
-        queue.push(file);
-    }
-
-    while (!queue.empty() && overbudgetAmount > 0) {
-        auto file = queue.top();
-        queue.pop();
+    // The unused files are kept in LRU order, so the least recently used is always at the front
+    while (!_unusedFiles.empty() && overbudgetAmount > 0) {
+        auto file = _unusedFiles.front();
         eject(file);
+        _numEvictions += 1;
         auto length = file->getLength();
         overbudgetAmount -= std::min(length, overbudgetAmount);
     }
@@ -300,7 +505,7 @@ void FileCache::clean() {
 void FileCache::wipe() {
     Lock lock(_mutex);
     while (!_unusedFiles.empty()) {
-        eject(*_unusedFiles.begin());
+        eject(_unusedFiles.front());
     }
 }
 
@@ -310,10 +515,15 @@ void FileCache::clear() {
     // Eliminate any overbudget files
     clean();
 
+    // Save the LRU order of everything remaining for the next time the cache is initialized
+    compactIndex();
+    _indexFile.reset();
+
     // Mark everything remaining as persisted while effectively ejecting from the cache
     for (auto& file : _unusedFiles) {
         file->_shouldPersist = true;
         file->_parent.reset();
+        file->_cached = false;
         qCDebug(file_cache, "[%s] Persisting %s", _dirname.c_str(), file->getKey().c_str());
     }
     _unusedFiles.clear();
@@ -323,6 +533,10 @@ void FileCache::releaseFile(File* file) {
     Lock lock(_mutex);
     if (file->_locked) {
         addUnusedFile(FilePointer(file, std::bind(&File::deleter, file)));
+        appendIndexRecord(IndexRecord::Use, file->getKey());
+        clean();
+
+        emit dirty();
     } else {
         delete file;
     }
@@ -344,8 +558,7 @@ void File::deleter(File* file) {
 File::File(Metadata&& metadata, const std::string& filepath) :
     _key(std::move(metadata.key)),
     _length(metadata.length),
-    _filepath(filepath),
-    _modified(QFileInfo(_filepath.c_str()).lastRead().toMSecsSinceEpoch()) {
+    _filepath(filepath) {
 }
 
 File::~File() {
@@ -357,7 +570,7 @@ File::~File() {
 }
 
 void File::touch() {
+    // keeps the modification times in LRU order, for when the cache has no index to restore from
     utime(_filepath.c_str(), nullptr);
-    _modified = std::max<int64_t>(QFileInfo(_filepath.c_str()).lastRead().toMSecsSinceEpoch(), _modified);
 }
 
@@ -13,6 +13,7 @@
 #include <atomic>
 #include <memory>
 #include <cstddef>
+#include <list>
 #include <map>
 #include <unordered_set>
 #include <mutex>
@@ -20,7 +21,9 @@
 #include <unordered_map>
 
 #include <QObject>
+#include <QFile>
 #include <QLoggingCategory>
+#include <QStringList>
 
 Q_DECLARE_LOGGING_CATEGORY(file_cache)
 
@@ -40,6 +43,10 @@ class FileCache : public QObject, public std::enable_shared_from_this<FileCache>
     Q_PROPERTY(size_t numCached READ getNumCachedFiles NOTIFY dirty)
     Q_PROPERTY(size_t sizeTotal READ getSizeTotalFiles NOTIFY dirty)
     Q_PROPERTY(size_t sizeCached READ getSizeCachedFiles NOTIFY dirty)
+    Q_PROPERTY(size_t numHits READ getNumHits NOTIFY dirty)
+    Q_PROPERTY(size_t numMisses READ getNumMisses NOTIFY dirty)
+    Q_PROPERTY(size_t numEvictions READ getNumEvictions NOTIFY dirty)
+    Q_PROPERTY(size_t numHints READ getNumHints NOTIFY dirty)
 
     static const size_t DEFAULT_MAX_SIZE;
     static const size_t MAX_MAX_SIZE;
@@ -60,6 +67,10 @@ public:
     size_t getNumCachedFiles() const { return _numUnusedFiles; }
     size_t getSizeTotalFiles() const { return _totalFilesSize; }
     size_t getSizeCachedFiles() const { return _unusedFilesSize; }
+    size_t getNumHits() const { return _numHits; }
+    size_t getNumMisses() const { return _numMisses; }
+    size_t getNumEvictions() const { return _numEvictions; }
+    size_t getNumHints() const { return _numHints; }
 
     // Set the maximum amount of disk space to use on disk
     void setMaxSize(size_t maxCacheSize);
@@ -99,20 +110,29 @@ public:
     FilePointer writeFile(const char* data, Metadata&& metadata, bool overwrite = false);
     FilePointer getFile(const Key& key);
 
+    // Hint that the file is likely to be needed soon, so that it is the last to be ejected.
+    // Returns false if the file is not in the cache.
+    bool hint(const Key& key);
+
     /// create a file
     virtual std::unique_ptr<File> createFile(Metadata&& metadata, const std::string& filepath);
 
+protected:
+    const std::string& getDirpath() const { return _dirpath; }
+
 private:
     using Mutex = std::recursive_mutex;
     using Lock = std::unique_lock<Mutex>;
     using Map = std::unordered_map<Key, std::weak_ptr<File>>;
-    using Set = std::unordered_set<FilePointer>;
     using KeySet = std::unordered_set<Key>;
+    // unused files, least recently used first
+    using LRU = std::list<FilePointer>;
 
     friend class File;
 
     std::string getFilepath(const Key& key);
 
+    FilePointer findFile(const Key& key);
     FilePointer addFile(Metadata&& metadata, const std::string& filepath);
     void addUnusedFile(const FilePointer& file);
     void releaseFile(File* file);
@@ -123,6 +143,19 @@ private:
 
     size_t getOverbudgetAmount() const;
 
+    // The index is a log of the files added, used and removed, so the cache can be restored at startup
+    // in LRU order without sorting the files of the directory by time
+    enum class IndexRecord : uint8_t {
+        Add,
+        Use,
+        Remove
+    };
+    bool restoreFromIndex(const QStringList& filenames);
+    void restoreFromDirectory();
+    void restoreFile(Metadata&& metadata, const std::string& filepath);
+    void appendIndexRecord(IndexRecord record, const Key& key, size_t length = 0);
+    void compactIndex();
+
     // FIXME it might be desirable to have the min free space variable be static so it can be
     // shared among multiple instances of FileCache
     std::atomic<size_t> _minFreeSpaceSize { DEFAULT_MIN_FREE_STORAGE_SPACE };
@@ -131,15 +164,23 @@ private:
     std::atomic<size_t> _numUnusedFiles { 0 };
     std::atomic<size_t> _totalFilesSize { 0 };
     std::atomic<size_t> _unusedFilesSize { 0 };
+    std::atomic<size_t> _numHits { 0 };
+    std::atomic<size_t> _numMisses { 0 };
+    std::atomic<size_t> _numEvictions { 0 };
+    std::atomic<size_t> _numHints { 0 };
 
     const std::string _ext;
     const std::string _dirname;
     const std::string _dirpath;
+    const std::string _indexFilepath;
     bool _initialized { false };
 
     Mutex _mutex;
     Map _files;
-    Set _unusedFiles;
+    LRU _unusedFiles;
+
+    std::unique_ptr<QFile> _indexFile;
+    size_t _numIndexRecords { 0 };
 };
 
 class File {
@@ -161,7 +202,6 @@ protected:
 
 private:
     friend class FileCache;
-    friend struct FilePointerComparator;
     friend class ::FileCacheTests;
 
     const Key _key;
@@ -170,9 +210,12 @@ private:
 
     void touch();
     FileCacheWeakPointer _parent;
-    int64_t _modified { 0 };
     bool _locked { false };
 
+    // where the file is in the LRU of its cache while it's unused
+    FileCache::LRU::iterator _position;
+    bool _cached { false };
+
     bool _shouldPersist { false };
 };
 
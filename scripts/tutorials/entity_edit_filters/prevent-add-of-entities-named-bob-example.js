@@ -23,4 +23,5 @@ filter.wantsToFilterAdd = true;  // do run on add
 filter.wantsToFilterEdit = false;  // do not run on edit
 filter.wantsToFilterPhysics = false;  // do not run on physics
 filter.wantsToFilterDelete = false;  // do not run on delete
+filter.wantsToFilterProperties = ["name"];  // only run on adds that set a name
 filter;
\ No newline at end of file
@@ -0,0 +1,122 @@
+//
+//  AssetMappingStoreTests.cpp
+//  tests/assignment-client/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetMappingStoreTests.h"
+#include <test-utils/QTestExtensions.h>
+
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTemporaryDir>
+
+#include <AssetMappingStore.h>
+#include <AssetUtils.h>
+
+QTEST_MAIN(AssetMappingStoreTests)
+
+static AssetUtils::AssetHash makeHash(const QByteArray& content) {
+    return AssetUtils::hashData(content).toHex();
+}
+
+static void writeFile(const QString& path, const QByteArray& contents) {
+    QFile file { path };
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QCOMPARE(file.write(contents), (qint64)contents.size());
+}
+
+void AssetMappingStoreTests::replayTest() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto mapFilePath = dir.filePath("map.json");
+    auto journalFilePath = mapFilePath + ".journal";
+
+    auto hashA = makeHash("a");
+    auto hashB = makeHash("b");
+    auto hashC = makeHash("c");
+
+    writeFile(mapFilePath, "{ \"/a\": \"" + hashA.toUtf8() + "\", \"/old\": \"" + hashA.toUtf8() + "\" }");
+
+    QByteArray journal;
+    journal += "[[\"/b\",\"" + hashB.toUtf8() + "\"]]\n";
+    // the invalid change is skipped, the valid one in the same transaction is kept
+    journal += "[[\"no-slash\",\"" + hashB.toUtf8() + "\"],[\"/c\",\"" + hashC.toUtf8() + "\"]]\n";
+    journal += "[[\"/d\",\"not a hash\"]]\n";
+    journal += "not json\n";
+    journal += "[[\"/old\",\"\"]]\n";
+    // the process stopped while writing this one
+    journal += "[[\"/e\",\"" + hashC.toUtf8();
+    writeFile(journalFilePath, journal);
+
+    AssetMappingStore store;
+    QVERIFY(store.load(mapFilePath));
+
+    AssetUtils::Mappings expected {
+        { "/a", hashA },
+        { "/b", hashB },
+        { "/c", hashC }
+    };
+    QCOMPARE(store.getMappings(), expected);
+
+    // the journal was folded into the mapping file and starts over
+    QCOMPARE(QFileInfo(journalFilePath).size(), (qint64)0);
+    AssetMappingStore reloaded;
+    QVERIFY(reloaded.load(mapFilePath));
+    QCOMPARE(reloaded.getMappings(), expected);
+
+    // a committed change is replayed from the journal by the next load
+    AssetMappingStore::Transaction transaction;
+    transaction.set("/f", hashA);
+    transaction.remove("/a");
+    QVERIFY(reloaded.commit(transaction));
+    QCOMPARE(reloaded.getJournalLength(), 1);
+    reloaded.sync();
+
+    expected.erase("/a");
+    expected["/f"] = hashA;
+    AssetMappingStore replayed;
+    QVERIFY(replayed.load(mapFilePath));
+    QCOMPARE(replayed.getMappings(), expected);
+}
+
+void AssetMappingStoreTests::compactionTest() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto mapFilePath = dir.filePath("map.json");
+    auto journalFilePath = mapFilePath + ".journal";
+
+    AssetMappingStore store;
+    QVERIFY(store.load(mapFilePath));
+
+    // a few mappings changed over and over, so the journal soon outgrows them
+    const int NUM_PATHS = 4;
+    int numCommits = 0;
+    bool compacted = false;
+    while (!compacted && numCommits < 10000) {
+        AssetMappingStore::Transaction transaction;
+        transaction.set("/path" + QString::number(numCommits % NUM_PATHS), makeHash(QByteArray::number(numCommits)));
+        QVERIFY(store.commit(transaction));
+        ++numCommits;
+        compacted = store.getJournalLength() == 0;
+    }
+    QVERIFY(compacted);
+    QCOMPARE(QFileInfo(journalFilePath).size(), (qint64)0);
+    QCOMPARE((int)store.size(), NUM_PATHS);
+
+    // the mapping file alone holds every change
+    AssetMappingStore reloaded;
+    QVERIFY(reloaded.load(mapFilePath));
+    QCOMPARE(reloaded.getMappings(), store.getMappings());
+
+    // and later changes go to the journal again
+    AssetMappingStore::Transaction transaction;
+    transaction.remove("/path0");
+    QVERIFY(store.commit(transaction));
+    QCOMPARE(store.getJournalLength(), 1);
+    QVERIFY(QFileInfo(journalFilePath).size() > 0);
+}
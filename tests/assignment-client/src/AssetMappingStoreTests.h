@@ -0,0 +1,28 @@
+//
+//  AssetMappingStoreTests.h
+//  tests/assignment-client/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetMappingStoreTests_h
+#define hifi_AssetMappingStoreTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class AssetMappingStoreTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test loading replays the journal over the mapping file, skipping invalid changes and a torn last line
+    void replayTest();
+
+    // Test the journal is folded into the mapping file once it grows long enough
+    void compactionTest();
+};
+
+#endif // hifi_AssetMappingStoreTests_h
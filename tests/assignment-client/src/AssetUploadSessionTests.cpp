@@ -0,0 +1,104 @@
+//
+//  AssetUploadSessionTests.cpp
+//  tests/assignment-client/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetUploadSessionTests.h"
+#include <test-utils/QTestExtensions.h>
+
+#include <AssetUploadSession.h>
+#include <AssetUtils.h>
+
+QTEST_MAIN(AssetUploadSessionTests)
+
+// the session doesn't check chunk sizes, the upload task does, so small chunks stand in for full ones here
+static QByteArray makeChunk(uint32_t index) {
+    return QByteArray("chunk ") + QByteArray::number(index);
+}
+
+static AssetUploadSessionPointer makeSession(uint32_t numChunks, uint64_t lastChunkSize = AssetUtils::UPLOAD_CHUNK_SIZE) {
+    uint64_t totalSize = (numChunks - 1) * AssetUtils::UPLOAD_CHUNK_SIZE + lastChunkSize;
+    return std::make_shared<AssetUploadSession>(QUuid::createUuid(), totalSize, QString());
+}
+
+void AssetUploadSessionTests::chunkOrderingTest() {
+    const uint64_t LAST_CHUNK_SIZE = 100;
+    auto session = makeSession(4, LAST_CHUNK_SIZE);
+    QCOMPARE(session->getNumChunks(), (uint32_t)4);
+    QCOMPARE(session->getChunkOffset(3), (qint64)(3 * AssetUtils::UPLOAD_CHUNK_SIZE));
+    QCOMPARE(session->getChunkSize(2), (qint64)AssetUtils::UPLOAD_CHUNK_SIZE);
+    QCOMPARE(session->getChunkSize(3), (qint64)LAST_CHUNK_SIZE);
+
+    QCOMPARE(session->receiveChunk(2, makeChunk(2)), AssetUploadSession::Accepted);
+    QCOMPARE(session->receiveChunk(0, makeChunk(0)), AssetUploadSession::Accepted);
+    QCOMPARE(session->receiveChunk(2, makeChunk(2)), AssetUploadSession::AlreadyReceived);
+    QCOMPARE(session->receiveChunk(3, makeChunk(3)), AssetUploadSession::Accepted);
+
+    // chunk 1 is still missing, so the ones after it wait to be hashed
+    QVERIFY(session->getHash().isEmpty());
+    QCOMPARE(session->getBufferedBytes(), (qint64)(makeChunk(2).size() + makeChunk(3).size()));
+
+    QCOMPARE(session->receiveChunk(1, makeChunk(1)), AssetUploadSession::Accepted);
+    QCOMPARE(session->getBufferedBytes(), (qint64)0);
+
+    QByteArray data = makeChunk(0) + makeChunk(1) + makeChunk(2) + makeChunk(3);
+    QCOMPARE(session->getHash(), AssetUtils::hashData(data));
+}
+
+void AssetUploadSessionTests::tooFarAheadTest() {
+    const uint32_t MAX_CHUNKS_AHEAD = AssetUploadSession::MAX_CHUNKS_AHEAD;
+    auto session = makeSession(2 * MAX_CHUNKS_AHEAD);
+
+    QCOMPARE(session->receiveChunk(MAX_CHUNKS_AHEAD, makeChunk(MAX_CHUNKS_AHEAD)), AssetUploadSession::TooFarAhead);
+    QCOMPARE(session->receiveChunk(MAX_CHUNKS_AHEAD - 1, makeChunk(MAX_CHUNKS_AHEAD - 1)), AssetUploadSession::Accepted);
+
+    // a refused chunk was not taken, so it is accepted once the first missing chunk arrives
+    QCOMPARE(session->receiveChunk(0, makeChunk(0)), AssetUploadSession::Accepted);
+    QCOMPARE(session->receiveChunk(MAX_CHUNKS_AHEAD, makeChunk(MAX_CHUNKS_AHEAD)), AssetUploadSession::Accepted);
+    QCOMPARE(session->receiveChunk(MAX_CHUNKS_AHEAD + 1, makeChunk(MAX_CHUNKS_AHEAD + 1)), AssetUploadSession::TooFarAhead);
+}
+
+void AssetUploadSessionTests::writtenChunksTest() {
+    const uint32_t NUM_CHUNKS = 10;
+    auto session = makeSession(NUM_CHUNKS);
+    for (uint32_t i = 0; i < NUM_CHUNKS; ++i) {
+        QCOMPARE(session->receiveChunk(i, makeChunk(i)), AssetUploadSession::Accepted);
+    }
+
+    QCOMPARE(session->getWrittenChunks(), QByteArray(2, 0));
+
+    QVERIFY(!session->chunkWritten(0));
+    QVERIFY(!session->chunkWritten(3));
+    QVERIFY(!session->chunkWritten(9));
+    QVERIFY(!session->chunkWritten(3));
+
+    QByteArray written = session->getWrittenChunks();
+    QCOMPARE(written.size(), 2);
+    QCOMPARE((quint8)written[0], (quint8)((1 << 0) | (1 << 3)));
+    QCOMPARE((quint8)written[1], (quint8)(1 << 1));
+
+    for (uint32_t i : { 1, 2, 4, 5, 6, 7 }) {
+        QVERIFY(!session->chunkWritten(i));
+    }
+
+    // only the write of the last missing chunk completes the upload
+    QVERIFY(session->chunkWritten(8));
+    QVERIFY(!session->chunkWritten(8));
+    QCOMPARE(session->getWrittenChunks(), QByteArray("\xFF\x03", 2));
+}
+
+void AssetUploadSessionTests::removedTest() {
+    auto nodeID = QUuid::createUuid();
+    AssetUploadSession session(QUuid::createUuid(), AssetUtils::UPLOAD_CHUNK_SIZE, QString(), nodeID);
+    QCOMPARE(session.getNodeID(), nodeID);
+
+    // the writes still queued for a dropped session check this before touching its file
+    QVERIFY(!session.isRemoved());
+    session.setRemoved();
+    QVERIFY(session.isRemoved());
+}
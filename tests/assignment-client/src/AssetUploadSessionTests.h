@@ -0,0 +1,34 @@
+//
+//  AssetUploadSessionTests.h
+//  tests/assignment-client/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetUploadSessionTests_h
+#define hifi_AssetUploadSessionTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class AssetUploadSessionTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test chunks arriving out of order are hashed in order, and a chunk received twice is only taken once
+    void chunkOrderingTest();
+
+    // Test chunks too far past the first missing one are refused until it arrives
+    void tooFarAheadTest();
+
+    // Test the written chunk bitmap and that only the last write completes the upload
+    void writtenChunksTest();
+
+    // Test a session knows the node that started it and whether it was dropped
+    void removedTest();
+};
+
+#endif // hifi_AssetUploadSessionTests_h
@@ -0,0 +1,98 @@
+//
+//  AssetChunkingTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetChunkingTests.h"
+#include <test-utils/QTestExtensions.h>
+
+#include <random>
+
+#include <AssetChunking.h>
+
+QTEST_MAIN(AssetChunkingTests)
+
+static QByteArray makeRandomData(int size, unsigned int seed) {
+    std::mt19937 generator(seed);
+    QByteArray data(size, 0);
+    for (int i = 0; i < size; ++i) {
+        data[i] = (char)generator();
+    }
+    return data;
+}
+
+void AssetChunkingTests::chunkSizeTest() {
+    QByteArray data = makeRandomData(4 * 1024 * 1024, 1);
+    auto lengths = AssetUtils::findChunkLengths(data.constData(), data.size());
+
+    QVERIFY(lengths.size() > 1);
+    int64_t total = 0;
+    for (size_t i = 0; i < lengths.size(); ++i) {
+        QVERIFY(lengths[i] <= AssetUtils::MAX_CONTENT_CHUNK_SIZE);
+        if (i + 1 < lengths.size()) {
+            QVERIFY(lengths[i] >= AssetUtils::MIN_CONTENT_CHUNK_SIZE);
+        }
+        total += lengths[i];
+    }
+    QCOMPARE(total, (int64_t)data.size());
+
+    // the average stays near the target
+    auto average = data.size() / (int64_t)lengths.size();
+    QVERIFY(average > AssetUtils::AVERAGE_CONTENT_CHUNK_SIZE / 2);
+    QVERIFY(average < AssetUtils::AVERAGE_CONTENT_CHUNK_SIZE * 2);
+
+    // data without any content to cut on is cut at the maximum size
+    QByteArray zeros(1024 * 1024, 0);
+    for (auto length : AssetUtils::findChunkLengths(zeros.constData(), zeros.size())) {
+        QCOMPARE(length, AssetUtils::MAX_CONTENT_CHUNK_SIZE);
+    }
+
+    QVERIFY(AssetUtils::findChunkLengths(data.constData(), 0).empty());
+}
+
+void AssetChunkingTests::insertionTest() {
+    QByteArray original = makeRandomData(2 * 1024 * 1024, 2);
+    QByteArray edited = original;
+    edited.insert(original.size() / 2, QByteArray(100, 'x'));
+
+    auto originalChunks = AssetUtils::chunkData(original.constData(), original.size());
+    auto editedChunks = AssetUtils::chunkData(edited.constData(), edited.size());
+
+    QSet<QByteArray> originalHashes;
+    for (const auto& chunk : originalChunks) {
+        originalHashes.insert(chunk.hash);
+    }
+
+    size_t numShared = 0;
+    for (const auto& chunk : editedChunks) {
+        if (originalHashes.contains(chunk.hash)) {
+            ++numShared;
+        }
+    }
+
+    // only the chunk holding the insertion, and maybe the one after it, differ
+    QVERIFY(numShared + 2 >= editedChunks.size());
+    QVERIFY(numShared < editedChunks.size());
+}
+
+void AssetChunkingTests::serializationTest() {
+    QByteArray data = makeRandomData(1024 * 1024, 3);
+    auto chunks = AssetUtils::chunkData(data.constData(), data.size());
+
+    AssetUtils::AssetChunkList deserialized;
+    auto serialized = AssetUtils::serializeChunkList(chunks);
+    QVERIFY(AssetUtils::deserializeChunkList(serialized, deserialized));
+    QCOMPARE(deserialized.size(), chunks.size());
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        QCOMPARE(deserialized[i].length, chunks[i].length);
+        QCOMPARE(deserialized[i].hash, chunks[i].hash);
+    }
+
+    QVERIFY(!AssetUtils::deserializeChunkList(serialized.left(serialized.size() - 1), deserialized));
+    QVERIFY(!AssetUtils::deserializeChunkList(QByteArray(), deserialized));
+}
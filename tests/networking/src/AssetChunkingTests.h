@@ -0,0 +1,31 @@
+//
+//  AssetChunkingTests.h
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetChunkingTests_h
+#define hifi_AssetChunkingTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class AssetChunkingTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test chunks cover the data and respect the size limits
+    void chunkSizeTest();
+
+    // Test an insertion only changes the chunks around it
+    void insertionTest();
+
+    // Test a chunk list survives serialization and malformed lists are refused
+    void serializationTest();
+};
+
+#endif // hifi_AssetChunkingTests_h
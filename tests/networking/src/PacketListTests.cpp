@@ -0,0 +1,144 @@
+//
+//  PacketListTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketListTests.h"
+#include <test-utils/QTestExtensions.h>
+
+#include <thread>
+
+#include <NLPacketList.h>
+#include <udt/PacketQueue.h>
+
+QTEST_MAIN(PacketListTests)
+
+// takes every packet of the queued lists and returns their payloads, counting the ones numbered in order
+static QByteArray takeMessage(udt::PacketQueue& queue, int& numPackets, int& numInOrder) {
+    QByteArray message;
+    numPackets = 0;
+    numInOrder = 0;
+    while (!queue.isEmpty()) {
+        auto packet = queue.takePacket();
+        if (!packet) {
+            break;
+        }
+        if (packet->getMessagePartNumber() == (udt::Packet::MessagePartNumber)numPackets) {
+            ++numInOrder;
+        }
+        message.append(packet->getPayload(), (int)packet->getPayloadSize());
+        ++numPackets;
+    }
+    return message;
+}
+
+static QByteArray makeData(int size) {
+    QByteArray data(size, 0);
+    for (int i = 0; i < size; ++i) {
+        data[i] = (char)(i * 7 + i / 251);
+    }
+    return data;
+}
+
+void PacketListTests::writtenListTest() {
+    auto packetList = NLPacketList::create(PacketType::AssetGetReply, QByteArray(), true, true);
+    QByteArray data = makeData(10000);
+    packetList->write(data);
+    packetList->closeCurrentPacket();
+    size_t expectedPackets = packetList->getNumPackets();
+
+    udt::PacketQueue queue;
+    queue.queuePacketList(std::move(packetList));
+
+    int numPackets = 0;
+    int numInOrder = 0;
+    QByteArray message = takeMessage(queue, numPackets, numInOrder);
+    QCOMPARE((size_t)numPackets, expectedPackets);
+    QCOMPARE(numInOrder, numPackets);
+    QCOMPARE(message, data);
+}
+
+void PacketListTests::streamedListTest() {
+    auto packetList = NLPacketList::create(PacketType::AssetGetReply, QByteArray(), true, true);
+    QByteArray header = makeData(41);
+    QByteArray data = makeData(1000000);
+    packetList->write(header);
+
+    qint64 numBytesRead = 0;
+    packetList->writeStream(data.size(), [&](char* destination, qint64 size) -> qint64 {
+        memcpy(destination, data.constData() + numBytesRead, size);
+        numBytesRead += size;
+        return size;
+    });
+
+    // only the part of the first packet that followed the header has been read
+    qint64 packetCapacity = packetList->getMaxSegmentSize();
+    QVERIFY(numBytesRead <= packetCapacity);
+    QVERIFY(packetList->isStreamed());
+    size_t expectedPackets = (size_t)((header.size() + data.size() + packetCapacity - 1) / packetCapacity);
+    QCOMPARE(packetList->getNumPackets(), expectedPackets);
+
+    udt::PacketQueue queue;
+    queue.queuePacketList(std::move(packetList));
+    QCOMPARE(numBytesRead, std::min((qint64)data.size(), packetCapacity - header.size()));
+
+    // taking a packet reads no more than that packet carries
+    auto first = queue.takePacket();
+    QCOMPARE(first->getPacketPosition(), udt::Packet::PacketPosition::FIRST);
+    qint64 numBytesReadBefore = numBytesRead;
+    auto second = queue.takePacket();
+    QCOMPARE(numBytesRead - numBytesReadBefore, second->getPayloadSize());
+
+    QByteArray message;
+    message.append(first->getPayload(), (int)first->getPayloadSize());
+    message.append(second->getPayload(), (int)second->getPayloadSize());
+
+    std::unique_ptr<udt::Packet> last;
+    int numPackets = 2;
+    while (!queue.isEmpty()) {
+        last = queue.takePacket();
+        QCOMPARE(last->getMessagePartNumber(), (udt::Packet::MessagePartNumber)numPackets);
+        message.append(last->getPayload(), (int)last->getPayloadSize());
+        ++numPackets;
+    }
+    QVERIFY(last);
+    QCOMPARE(last->getPacketPosition(), udt::Packet::PacketPosition::LAST);
+    QCOMPARE((size_t)numPackets, expectedPackets);
+    QCOMPARE(message, header + data);
+}
+
+void PacketListTests::streamedWithoutLockTest() {
+    auto packetList = NLPacketList::create(PacketType::AssetGetReply, QByteArray(), true, true);
+    QByteArray data = makeData(100000);
+
+    udt::PacketQueue queue;
+    qint64 numBytesRead = 0;
+    int numReadsUnderLock = 0;
+    packetList->writeStream(data.size(), [&](char* destination, qint64 size) -> qint64 {
+        // the threads queueing packets must not wait on a stream read
+        std::thread([&] {
+            if (queue.getLock().try_lock()) {
+                queue.getLock().unlock();
+            } else {
+                ++numReadsUnderLock;
+            }
+        }).join();
+        memcpy(destination, data.constData() + numBytesRead, size);
+        numBytesRead += size;
+        return size;
+    });
+    queue.queuePacketList(std::move(packetList));
+
+    QByteArray message;
+    while (!queue.isEmpty()) {
+        auto packet = queue.takePacket();
+        message.append(packet->getPayload(), (int)packet->getPayloadSize());
+    }
+    QCOMPARE(numReadsUnderLock, 0);
+    QCOMPARE(message, data);
+}
@@ -0,0 +1,31 @@
+//
+//  PacketListTests.h
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketListTests_h
+#define hifi_PacketListTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PacketListTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test a written list goes through the send queue's packet queue as one message
+    void writtenListTest();
+
+    // Test a streamed list only reads its stream as its packets are taken, and makes the same message
+    void streamedListTest();
+
+    // Test a streamed packet is read from its stream without holding the packet queue's lock
+    void streamedWithoutLockTest();
+};
+
+#endif // hifi_PacketListTests_h
@@ -0,0 +1,93 @@
+//
+//  EntityChangeLogTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityChangeLogTests.h"
+
+#include <QtCore/QJsonDocument>
+
+#include <test-utils/QTestExtensions.h>
+
+#include <OctreeDataUtils.h>
+
+QTEST_MAIN(EntityChangeLogTests)
+
+static QVariantMap makeEntity(const QUuid& id, const QString& name) {
+    QVariantMap entity;
+    entity["id"] = id.toString();
+    entity["type"] = "Box";
+    entity["name"] = name;
+    return entity;
+}
+
+static QByteArray editRecord(const QVariantMap& entity) {
+    QJsonObject record;
+    record[OctreeUtils::CHANGE_LOG_EDIT_KEY] = QJsonObject::fromVariantMap(entity);
+    return QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n';
+}
+
+static QByteArray deleteRecord(const QUuid& id) {
+    QJsonObject record;
+    record[OctreeUtils::CHANGE_LOG_DELETE_KEY] = id.toString();
+    return QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n';
+}
+
+static QVariantMap findEntity(const OctreeUtils::RawEntityData& data, const QUuid& id) {
+    for (const auto& entity : data.variantEntityData) {
+        if (entity.toMap()["id"].toUuid() == id) {
+            return entity.toMap();
+        }
+    }
+    return QVariantMap();
+}
+
+void EntityChangeLogTests::applyChangeLogTest() {
+    QUuid kept = QUuid::createUuid();
+    QUuid edited = QUuid::createUuid();
+    QUuid deleted = QUuid::createUuid();
+    QUuid added = QUuid::createUuid();
+
+    OctreeUtils::RawEntityData data;
+    data.variantEntityData << makeEntity(kept, "kept") << makeEntity(edited, "before") << makeEntity(deleted, "deleted");
+
+    QByteArray changeLog = editRecord(makeEntity(edited, "first edit")) + deleteRecord(deleted) +
+        editRecord(makeEntity(added, "added")) + editRecord(makeEntity(edited, "after"));
+    QCOMPARE(data.applyChangeLog(changeLog), 4);
+
+    QCOMPARE(data.variantEntityData.size(), 3);
+    QCOMPARE(findEntity(data, kept)["name"].toString(), QString("kept"));
+    QCOMPARE(findEntity(data, edited)["name"].toString(), QString("after"));
+    QCOMPARE(findEntity(data, added)["name"].toString(), QString("added"));
+    QVERIFY(findEntity(data, deleted).isEmpty());
+
+    // records are complete states, so the same log applied again changes nothing
+    QCOMPARE(data.applyChangeLog(changeLog), 4);
+    QCOMPARE(data.variantEntityData.size(), 3);
+    QCOMPARE(findEntity(data, edited)["name"].toString(), QString("after"));
+
+    // the folded data survives being written out and read back, as the domain server does with it
+    OctreeUtils::RawEntityData readData;
+    QVERIFY(readData.readOctreeDataInfoFromData(data.toGzippedByteArray()));
+    QCOMPARE(readData.variantEntityData.size(), 3);
+    QCOMPARE(findEntity(readData, added)["name"].toString(), QString("added"));
+}
+
+void EntityChangeLogTests::malformedRecordTest() {
+    QUuid id = QUuid::createUuid();
+    OctreeUtils::RawEntityData data;
+    data.variantEntityData << makeEntity(id, "before");
+
+    // a record torn by a crash is skipped without affecting the ones around it
+    QByteArray tornRecord = editRecord(makeEntity(id, "torn"));
+    tornRecord.chop(tornRecord.size() / 2);
+    QByteArray changeLog = tornRecord + '\n' + editRecord(makeEntity(id, "after")) + "{\"unknown\":1}\n";
+    QCOMPARE(data.applyChangeLog(changeLog), 1);
+    QCOMPARE(data.variantEntityData.size(), 1);
+    QCOMPARE(findEntity(data, id)["name"].toString(), QString("after"));
+}
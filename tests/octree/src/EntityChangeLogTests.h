@@ -0,0 +1,24 @@
+//
+//  EntityChangeLogTests.h
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityChangeLogTests_h
+#define hifi_EntityChangeLogTests_h
+
+#include <QtTest/QtTest>
+
+class EntityChangeLogTests : public QObject {
+    Q_OBJECT
+private slots:
+    // the domain server's fold of the records the entity server sends
+    void applyChangeLogTest();
+    void malformedRecordTest();
+};
+
+#endif // hifi_EntityChangeLogTests_h
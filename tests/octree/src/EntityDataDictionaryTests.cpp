@@ -0,0 +1,180 @@
+//
+//  EntityDataDictionaryTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityDataDictionaryTests.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <vector>
+
+#include <test-utils/QTestExtensions.h>
+
+#include <DependencyManager.h>
+#include <EntityDataDictionary.h>
+#include <EntityItemProperties.h>
+#include <EntityTree.h>
+#include <LimitedNodeList.h>
+#include <NodeList.h>
+#include <OctreePacketData.h>
+
+QTEST_MAIN(EntityDataDictionaryTests)
+
+// set this to the models.json.gz of a captured domain to measure against real content
+static const char* CAPTURE_ENVIRONMENT_VARIABLE = "HIFI_ENTITY_DATA_CAPTURE";
+
+static const int NUM_SYNTHETIC_ENTITIES = 5000;
+static const int SECTION_SIZE = MAX_OCTREE_PACKET_DATA_SIZE - sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
+
+// a domain built out of a kit of parts: many entities share a few hundred models, textures and scripts
+static EntityTreePointer createSyntheticTree() {
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    tree->withWriteLock([&] {
+        for (int i = 0; i < NUM_SYNTHETIC_ENTITIES; ++i) {
+            EntityItemProperties properties;
+            properties.setType(EntityTypes::Model);
+            properties.setPosition(glm::vec3((float)(i % 100), 0.0f, (float)(i / 100)));
+            properties.setName(QString("Kit Part %1").arg(i % 40));
+            properties.setModelURL(QString("https://content.example.com/kits/village/models/part-%1.fbx").arg(i % 200));
+            properties.setTextures(QString("{\"diffuse\":\"https://content.example.com/kits/village/textures/wood-%1.png\"}")
+                .arg(i % 25));
+            if (i % 3 == 0) {
+                properties.setScript(QString("https://content.example.com/kits/village/scripts/door-%1.js").arg(i % 10));
+            }
+            properties.setUserData(QString("{\"grabbableKey\":{\"grabbable\":%1},\"kit\":\"village\"}")
+                .arg(i % 2 ? "true" : "false"));
+            tree->addEntity(EntityItemID(QUuid::createUuid()), properties);
+        }
+    });
+    return tree;
+}
+
+static EntityTreePointer createTree() {
+    QByteArray capture = qgetenv(CAPTURE_ENVIRONMENT_VARIABLE);
+    if (!capture.isEmpty()) {
+        EntityTreePointer tree = std::make_shared<EntityTree>();
+        tree->createRootElement();
+        if (tree->readFromFile(capture.constData())) {
+            qDebug() << "Measuring against" << capture;
+            return tree;
+        }
+        qWarning() << "Couldn't read" << capture << "- falling back to a synthetic domain";
+    }
+    return createSyntheticTree();
+}
+
+// the entities as the server sends them: full encodings packed into sections of about a packet each
+static std::vector<QByteArray> createSections(const QVector<EntityItemPointer>& entities) {
+    std::vector<QByteArray> sections;
+    OctreePacketData packetData(false, SECTION_SIZE);
+    for (const auto& entity : entities) {
+        QByteArray buffer(NLPacket::maxPayloadSize(PacketType::EntityAdd), 0);
+        EntityItemProperties properties = entity->getProperties();
+        EntityPropertyFlags didntFit;
+        EntityItemProperties::encodeEntityEditPacket(PacketType::EntityAdd, entity->getEntityItemID(), properties, buffer,
+                                                     properties.getChangedProperties(), didntFit);
+        if (!packetData.appendRawData(buffer)) {
+            if (packetData.hasContent()) {
+                sections.emplace_back((const char*)packetData.getUncompressedData(), packetData.getUncompressedSize());
+                packetData.reset();
+            }
+            packetData.appendRawData(buffer);
+        }
+    }
+    if (packetData.hasContent()) {
+        sections.emplace_back((const char*)packetData.getUncompressedData(), packetData.getUncompressedSize());
+    }
+    return sections;
+}
+
+static int compressSections(const std::vector<QByteArray>& sections, const QByteArray& dictionary) {
+    int compressedSize = 0;
+    OctreePacketData packetData(true, SECTION_SIZE);
+    packetData.setCompressionDictionary(dictionary);
+    for (const auto& section : sections) {
+        packetData.reset();
+        packetData.appendRawData(section);
+        compressedSize += packetData.getFinalizedSize();
+    }
+    return compressedSize;
+}
+
+void EntityDataDictionaryTests::initTestCase() {
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<NodeList>(NodeType::Agent, INVALID_PORT);
+}
+
+void EntityDataDictionaryTests::testRoundTrip() {
+    EntityTreePointer tree = createSyntheticTree();
+    QVector<EntityItemPointer> entities = tree->sampleEntities(EntityDataDictionary::MAX_SAMPLED_ENTITIES);
+    QCOMPARE(entities.size(), NUM_SYNTHETIC_ENTITIES);
+
+    auto dictionary = EntityDataDictionary::build(entities);
+    QVERIFY(dictionary);
+    QVERIFY(dictionary->getData().size() <= EntityDataDictionary::MAX_SIZE);
+    QVERIFY(dictionary->getID() != NO_DATA_DICTIONARY);
+
+    // the same content makes the same dictionary, whatever order it's read in
+    std::reverse(entities.begin(), entities.end());
+    QCOMPARE(EntityDataDictionary::build(entities)->getID(), dictionary->getID());
+
+    std::vector<QByteArray> sections = createSections(entities);
+    for (const auto& section : sections) {
+        OctreePacketData sent(true, SECTION_SIZE);
+        sent.setCompressionDictionary(dictionary->getData());
+        QVERIFY(sent.appendRawData(section));
+        QByteArray finalized((const char*)sent.getFinalizedData(), sent.getFinalizedSize());
+
+        OctreePacketData received(true);
+        received.setCompressionDictionary(dictionary->getData());
+        received.loadFinalizedContent((const unsigned char*)finalized.constData(), finalized.size());
+        QCOMPARE(QByteArray((const char*)received.getUncompressedData(), received.getUncompressedSize()), section);
+    }
+
+    QVERIFY(compressSections(sections, dictionary->getData()) < compressSections(sections, QByteArray()));
+}
+
+void EntityDataDictionaryTests::compressionPerf() {
+    EntityTreePointer tree = createTree();
+    QVector<EntityItemPointer> entities = tree->sampleEntities(std::numeric_limits<int>::max());
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto dictionary = EntityDataDictionary::build(tree->sampleEntities(EntityDataDictionary::MAX_SAMPLED_ENTITIES));
+    auto buildTime = std::chrono::high_resolution_clock::now() - start;
+    if (!dictionary) {
+        QSKIP("The domain doesn't repeat enough strings for a data dictionary");
+    }
+
+    std::vector<QByteArray> sections = createSections(entities);
+    int uncompressedSize = 0;
+    for (const auto& section : sections) {
+        uncompressedSize += section.size();
+    }
+
+    start = std::chrono::high_resolution_clock::now();
+    int plainSize = compressSections(sections, QByteArray());
+    auto plainTime = std::chrono::high_resolution_clock::now() - start;
+
+    start = std::chrono::high_resolution_clock::now();
+    int dictionarySize = compressSections(sections, dictionary->getData());
+    auto dictionaryTime = std::chrono::high_resolution_clock::now() - start;
+
+    auto usecs = [](std::chrono::high_resolution_clock::duration duration) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    };
+    qDebug() << entities.size() << "entities in" << sections.size() << "sections," << uncompressedSize << "bytes uncompressed";
+    qDebug() << "dictionary:" << dictionary->getData().size() << "bytes," << dictionary->getNumStrings() << "strings, built in"
+        << usecs(buildTime) << "usecs";
+    qDebug() << "zlib:" << plainSize << "bytes in" << usecs(plainTime) << "usecs";
+    qDebug() << "zlib with dictionary:" << dictionarySize << "bytes in" << usecs(dictionaryTime) << "usecs,"
+        << (float)dictionarySize / (float)plainSize << "of the size (plus one" << dictionary->getData().size()
+        << "byte dictionary download)";
+}
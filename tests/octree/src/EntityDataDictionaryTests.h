@@ -0,0 +1,24 @@
+//
+//  EntityDataDictionaryTests.h
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityDataDictionaryTests_h
+#define hifi_EntityDataDictionaryTests_h
+
+#include <QtTest/QtTest>
+
+class EntityDataDictionaryTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void testRoundTrip();
+    void compressionPerf();
+};
+
+#endif // hifi_EntityDataDictionaryTests_h
@@ -0,0 +1,139 @@
+//
+//  EntityEditFiltersTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityEditFiltersTests.h"
+
+#include <DependencyManager.h>
+#include <EntityEditFilters.h>
+#include <EntityItemProperties.h>
+#include <EntityTree.h>
+#include <LimitedNodeList.h>
+#include <NodeList.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(EntityEditFiltersTests)
+
+// rejects entities named bob, and counts its calls so a test can tell a cached result from a new one
+#define NAME_FILTER_FUNCTION \
+    "var calls = 0;\n" \
+    "function filter(properties, type) {\n" \
+    "    calls++;\n" \
+    "    if (properties.name == 'bob') {\n" \
+    "        return false;\n" \
+    "    }\n" \
+    "    properties.name = properties.name + calls;\n" \
+    "    return properties;\n" \
+    "}\n" \
+    "filter.wantsToFilterProperties = ['name'];\n"
+
+static const QString NAME_FILTER_SCRIPT { NAME_FILTER_FUNCTION "filter;\n" };
+static const QString CACHING_NAME_FILTER_SCRIPT { NAME_FILTER_FUNCTION "filter.wantsResultCaching = true;\nfilter;\n" };
+
+static bool filterEdit(EntityEditFilters& filters, EntityItemProperties& properties, EntityItemProperties& propertiesOut,
+                       const EntityItemID& editedID = EntityItemID(QUuid::createUuid())) {
+    glm::vec3 position;
+    bool wasChanged = false;
+    EntityItemID entityID = editedID;
+    EntityItemPointer existingEntity;
+    properties.setLastEdited(usecTimestampNow());
+    return filters.filter(position, properties, propertiesOut, wasChanged, EntityTree::FilterType::Edit, entityID,
+                          existingEntity);
+}
+
+void EntityEditFiltersTests::initTestCase() {
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<NodeList>(NodeType::EntityServer, INVALID_PORT);
+}
+
+void EntityEditFiltersTests::testSkippedEdits() {
+    auto tree = std::make_shared<EntityTree>(true);
+    EntityEditFilters filters(tree);
+    // the null ID is the domain wide filter
+    QVERIFY(filters.setFilterScript(EntityItemID(), NAME_FILTER_SCRIPT, "nameFilter.js"));
+
+    // an edit that doesn't change any property the filter looks at doesn't run it
+    EntityItemProperties properties;
+    properties.setPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    EntityItemProperties propertiesOut;
+    QVERIFY(filterEdit(filters, properties, propertiesOut));
+    QCOMPARE(filters.getSkippedCount(), (quint64)1);
+    QCOMPARE(filters.getEvaluatedCount(), (quint64)0);
+
+    // one that does runs it
+    properties.setName("alice");
+    QVERIFY(filterEdit(filters, properties, propertiesOut));
+    QCOMPARE(filters.getSkippedCount(), (quint64)1);
+    QCOMPARE(filters.getEvaluatedCount(), (quint64)1);
+}
+
+void EntityEditFiltersTests::testCachedResults() {
+    auto tree = std::make_shared<EntityTree>(true);
+    EntityEditFilters filters(tree);
+    QVERIFY(filters.setFilterScript(EntityItemID(), CACHING_NAME_FILTER_SCRIPT, "nameFilter.js"));
+    EntityItemID entityID(QUuid::createUuid());
+
+    // an identical edit to the same entity reuses the first call's modified properties
+    for (int i = 0; i < 2; ++i) {
+        EntityItemProperties properties;
+        properties.setName("alice");
+        EntityItemProperties propertiesOut;
+        QVERIFY(filterEdit(filters, properties, propertiesOut, entityID));
+        QCOMPARE(propertiesOut.getName(), QString("alice1"));
+    }
+    QCOMPARE(filters.getEvaluatedCount(), (quint64)1);
+    QCOMPARE(filters.getCachedCount(), (quint64)1);
+
+    // and so does a rejected one
+    for (int i = 0; i < 2; ++i) {
+        EntityItemProperties properties;
+        properties.setName("bob");
+        EntityItemProperties propertiesOut;
+        QVERIFY(!filterEdit(filters, properties, propertiesOut, entityID));
+    }
+    QCOMPARE(filters.getEvaluatedCount(), (quint64)2);
+    QCOMPARE(filters.getCachedCount(), (quint64)2);
+
+    // a different edit runs the filter again
+    {
+        EntityItemProperties properties;
+        properties.setName("carol");
+        EntityItemProperties propertiesOut;
+        QVERIFY(filterEdit(filters, properties, propertiesOut, entityID));
+        QCOMPARE(propertiesOut.getName(), QString("carol3"));
+        QCOMPARE(filters.getEvaluatedCount(), (quint64)3);
+    }
+
+    // and so does the same edit to another entity
+    EntityItemProperties properties;
+    properties.setName("alice");
+    EntityItemProperties propertiesOut;
+    QVERIFY(filterEdit(filters, properties, propertiesOut));
+    QCOMPARE(propertiesOut.getName(), QString("alice4"));
+    QCOMPARE(filters.getEvaluatedCount(), (quint64)4);
+    QCOMPARE(filters.getCachedCount(), (quint64)2);
+}
+
+void EntityEditFiltersTests::testUncachedByDefault() {
+    auto tree = std::make_shared<EntityTree>(true);
+    EntityEditFilters filters(tree);
+    QVERIFY(filters.setFilterScript(EntityItemID(), NAME_FILTER_SCRIPT, "nameFilter.js"));
+    EntityItemID entityID(QUuid::createUuid());
+
+    // filters that didn't opt in to caching run for every edit
+    for (int i = 1; i <= 2; ++i) {
+        EntityItemProperties properties;
+        properties.setName("alice");
+        EntityItemProperties propertiesOut;
+        QVERIFY(filterEdit(filters, properties, propertiesOut, entityID));
+        QCOMPARE(propertiesOut.getName(), QString("alice") + QString::number(i));
+    }
+    QCOMPARE(filters.getEvaluatedCount(), (quint64)2);
+    QCOMPARE(filters.getCachedCount(), (quint64)0);
+}
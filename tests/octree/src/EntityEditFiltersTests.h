@@ -0,0 +1,25 @@
+//
+//  EntityEditFiltersTests.h
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityEditFiltersTests_h
+#define hifi_EntityEditFiltersTests_h
+
+#include <QtTest/QtTest>
+
+class EntityEditFiltersTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void testSkippedEdits();
+    void testCachedResults();
+    void testUncachedByDefault();
+};
+
+#endif // hifi_EntityEditFiltersTests_h
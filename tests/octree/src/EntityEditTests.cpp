@@ -0,0 +1,219 @@
+//
+//  EntityEditTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityEditTests.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <test-utils/QTestExtensions.h>
+
+#include <DependencyManager.h>
+#include <EntityItemProperties.h>
+#include <EntityTree.h>
+#include <LimitedNodeList.h>
+#include <NodeList.h>
+#include <OctreeInboundPacketProcessor.h>
+#include <ReceivedMessage.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(EntityEditTests)
+
+static const int NUM_ENTITIES = 1000;
+
+using ReceivedMessagePointer = QSharedPointer<ReceivedMessage>;
+
+static SharedNodePointer createSender() {
+    SharedNodePointer sender(new Node(QUuid::createUuid(), NodeType::Agent, HifiSockAddr(), HifiSockAddr()));
+    NodePermissions permissions;
+    permissions.setAll(true);
+    sender->setPermissions(permissions);
+    return sender;
+}
+
+static EntityTreePointer createServerTree(std::vector<EntityItemID>& entityIDs) {
+    EntityTreePointer tree = std::make_shared<EntityTree>(true);
+    tree->setIsServer(true);
+    tree->createRootElement();
+
+    tree->withWriteLock([&] {
+        for (int i = 0; i < NUM_ENTITIES; ++i) {
+            EntityItemProperties properties;
+            properties.setType(EntityTypes::Box);
+            properties.setPosition(glm::vec3((float)(i % 10), (float)(i / 10 % 10), (float)(i / 100)));
+            EntityItemID entityID(QUuid::createUuid());
+            if (tree->addEntity(entityID, properties)) {
+                entityIDs.push_back(entityID);
+            }
+        }
+    });
+    return tree;
+}
+
+// one edit record per entity, each moving it a long way so that every edit also moves it between elements, packed
+// into EntityEdit packets the way OctreeEditPacketSender packs them
+static std::vector<ReceivedMessagePointer> createEditFlood(const std::vector<EntityItemID>& entityIDs, float offset,
+                                                           unsigned short int& sequence) {
+    const int MAX_PAYLOAD_SIZE = NLPacket::maxPayloadSize(PacketType::EntityEdit);
+
+    std::vector<ReceivedMessagePointer> packets;
+    QByteArray payload;
+    quint64 now = usecTimestampNow();
+
+    auto finishPacket = [&] {
+        packets.push_back(ReceivedMessagePointer::create(payload, PacketType::EntityEdit,
+                                                         versionForPacketType(PacketType::EntityEdit), HifiSockAddr()));
+        payload.clear();
+    };
+
+    for (size_t i = 0; i < entityIDs.size(); ++i) {
+        EntityItemProperties properties;
+        properties.setPosition(glm::vec3(offset + (float)(i % 10), (float)(i / 10 % 10), (float)(i / 100)));
+        properties.setLastEdited(now);
+
+        QByteArray edit(MAX_PAYLOAD_SIZE, 0);
+        EntityPropertyFlags didntFit;
+        EntityItemProperties::encodeEntityEditPacket(PacketType::EntityEdit, entityIDs[i], properties, edit,
+                                                     properties.getChangedProperties(), didntFit);
+
+        if (!payload.isEmpty() && payload.size() + edit.size() > MAX_PAYLOAD_SIZE) {
+            finishPacket();
+        }
+        if (payload.isEmpty()) {
+            payload.append(reinterpret_cast<const char*>(&sequence), sizeof(sequence));
+            payload.append(reinterpret_cast<const char*>(&now), sizeof(now));
+            ++sequence;
+        }
+        payload.append(edit);
+    }
+    if (!payload.isEmpty()) {
+        finishPacket();
+    }
+    return packets;
+}
+
+// queues the packets on a threaded processor, as the entity server does, and waits for them to be applied
+static quint64 processEditPackets(OctreeInboundPacketProcessor& processor, const std::vector<ReceivedMessagePointer>& packets,
+                                  const SharedNodePointer& sender) {
+    const quint64 TIMEOUT_USECS = 60 * USECS_PER_SECOND;
+
+    auto expectedPackets = processor.getTotalPacketsProcessed() + packets.size();
+    auto start = usecTimestampNow();
+    for (auto& packet : packets) {
+        processor.queueReceivedPacket(packet, sender);
+    }
+    while (processor.getTotalPacketsProcessed() < expectedPackets && usecTimestampNow() - start < TIMEOUT_USECS) {
+        std::this_thread::yield();
+    }
+    return usecTimestampNow() - start;
+}
+
+void EntityEditTests::initTestCase() {
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<NodeList>(NodeType::EntityServer, INVALID_PORT);
+}
+
+void EntityEditTests::testBatchedEdits() {
+    std::vector<EntityItemID> entityIDs;
+    EntityTreePointer tree = createServerTree(entityIDs);
+    QCOMPARE((int)entityIDs.size(), NUM_ENTITIES);
+
+    const float OFFSET = 1000.0f;
+    unsigned short int sequence = 0;
+    std::vector<ReceivedMessagePointer> packets = createEditFlood(entityIDs, OFFSET, sequence);
+    QVERIFY(packets.size() > 1);
+
+    OctreeInboundPacketProcessor processor(tree, PacketType::EntityEditNack);
+    processor.initialize(true);
+    processEditPackets(processor, packets, createSender());
+    processor.terminating();
+    processor.terminate();
+
+    QCOMPARE(processor.getTotalPacketsProcessed(), (quint64)packets.size());
+    QCOMPARE(processor.getTotalElementsProcessed(), (quint64)NUM_ENTITIES);
+    QVERIFY(processor.getTotalBatchesProcessed() >= 1);
+    QVERIFY(processor.getTotalBatchesProcessed() <= processor.getTotalPacketsProcessed());
+
+    for (size_t i = 0; i < entityIDs.size(); ++i) {
+        EntityItemPointer entity = tree->findEntityByEntityItemID(entityIDs[i]);
+        QVERIFY(entity);
+        QCOMPARE(entity->getWorldPosition().x, OFFSET + (float)(i % 10));
+    }
+}
+
+// Measures edits/sec for floods of edits queued on the inbound packet processor while other threads keep taking
+// the tree read lock, as the send threads do, and how long those readers wait for it.
+void EntityEditTests::editFloodPerf() {
+    const int NUM_ROUNDS = 20;
+    const int NUM_READERS = 4;
+
+    std::vector<EntityItemID> entityIDs;
+    EntityTreePointer tree = createServerTree(entityIDs);
+    SharedNodePointer sender = createSender();
+
+    unsigned short int sequence = 0;
+    std::vector<std::vector<ReceivedMessagePointer>> floods;
+    for (int round = 0; round < NUM_ROUNDS; ++round) {
+        floods.push_back(createEditFlood(entityIDs, (float)(round % 2) * 1000.0f, sequence));
+    }
+
+    std::atomic<bool> stopReaders { false };
+    std::atomic<quint64> numReads { 0 };
+    std::atomic<quint64> totalReadWait { 0 };
+    std::atomic<quint64> maxReadWait { 0 };
+    std::vector<std::thread> readers;
+    for (int i = 0; i < NUM_READERS; ++i) {
+        readers.emplace_back([&, i] {
+            size_t next = i;
+            while (!stopReaders) {
+                auto startWait = usecTimestampNow();
+                tree->withReadLock([&] {
+                    auto wait = usecTimestampNow() - startWait;
+                    totalReadWait += wait;
+                    quint64 max = maxReadWait;
+                    while (wait > max && !maxReadWait.compare_exchange_weak(max, wait)) {}
+
+                    // look at a few entities, as a send thread encoding them would
+                    const size_t ENTITIES_PER_READ = 16;
+                    for (size_t j = 0; j < ENTITIES_PER_READ; ++j) {
+                        tree->findEntityByEntityItemID(entityIDs[next++ % entityIDs.size()]);
+                    }
+                });
+                ++numReads;
+            }
+        });
+    }
+
+    OctreeInboundPacketProcessor processor(tree, PacketType::EntityEditNack);
+    processor.initialize(true);
+
+    quint64 editTime = 0;
+    for (auto& flood : floods) {
+        editTime += processEditPackets(processor, flood, sender);
+    }
+
+    stopReaders = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    processor.terminating();
+    processor.terminate();
+
+    QCOMPARE(processor.getTotalElementsProcessed(), (quint64)(NUM_ROUNDS * entityIDs.size()));
+
+    double editsPerSecond = editTime > 0 ? (double)processor.getTotalElementsProcessed() * USECS_PER_SECOND / editTime : 0.0;
+    qDebug() << "applied" << NUM_ROUNDS << "floods of" << entityIDs.size() << "edits in"
+        << processor.getTotalBatchesProcessed() << "batches:" << editsPerSecond << "edits/sec,"
+        << processor.getAverageLockWaitTimePerPacket() << "usecs write lock wait per packet;"
+        << NUM_READERS << "readers took the read lock" << (quint64)numReads << "times, waiting"
+        << (numReads > 0 ? totalReadWait / numReads : 0) << "usecs on average and" << (quint64)maxReadWait << "at most";
+}
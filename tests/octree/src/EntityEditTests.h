@@ -0,0 +1,24 @@
+//
+//  EntityEditTests.h
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityEditTests_h
+#define hifi_EntityEditTests_h
+
+#include <QtTest/QtTest>
+
+class EntityEditTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void testBatchedEdits();
+    void editFloodPerf();
+};
+
+#endif // hifi_EntityEditTests_h
@@ -0,0 +1,181 @@
+//
+//  EntityQueryTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityQueryTests.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <glm/gtc/random.hpp>
+
+#include <test-utils/QTestExtensions.h>
+
+#include <DependencyManager.h>
+#include <EntityItemProperties.h>
+#include <EntityTree.h>
+#include <EntityTreeElement.h>
+#include <LimitedNodeList.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+
+QTEST_MAIN(EntityQueryTests)
+
+static const float DOMAIN_SIZE = 1000.0f;
+
+static EntityTreePointer createTree(int numEntities) {
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    tree->withWriteLock([&] {
+        for (int i = 0; i < numEntities; ++i) {
+            EntityItemProperties properties;
+            properties.setType(EntityTypes::Box);
+            properties.setPosition(glm::linearRand(glm::vec3(-DOMAIN_SIZE / 2.0f), glm::vec3(DOMAIN_SIZE / 2.0f)));
+            properties.setDimensions(glm::linearRand(glm::vec3(0.1f), glm::vec3(4.0f)));
+            tree->addEntity(EntityItemID(QUuid::createUuid()), properties);
+        }
+    });
+    return tree;
+}
+
+// the sphere query as it was done before the spatial index, by recursing the octree
+struct SphereArgs {
+    glm::vec3 position;
+    float radius;
+    QVector<QUuid> entities;
+};
+
+static bool sphereOperation(const OctreeElementPointer& element, void* extraData) {
+    SphereArgs* args = static_cast<SphereArgs*>(extraData);
+    glm::vec3 penetration;
+    if (element->getAACube().findSpherePenetration(args->position, args->radius, penetration)) {
+        EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
+        entityTreeElement->evalEntitiesInSphere(args->position, args->radius, PickFilter(), args->entities);
+        return true;
+    }
+    return false;
+}
+
+static QVector<QUuid> recurseEntitiesInSphere(EntityTreePointer tree, const glm::vec3& position, float radius) {
+    SphereArgs args { position, radius, QVector<QUuid>() };
+    tree->recurseTreeWithOperation(sphereOperation, &args);
+    return args.entities;
+}
+
+static QVector<QUuid> sorted(QVector<QUuid> ids) {
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+void EntityQueryTests::initTestCase() {
+    // updateEntity() checks edit rights with the NodeList when there's no sender
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<NodeList>(NodeType::Agent, INVALID_PORT);
+}
+
+void EntityQueryTests::testSpatialIndex() {
+    const int NUM_ENTITIES = 5000;
+    const int NUM_QUERIES = 200;
+
+    EntityTreePointer tree = createTree(NUM_ENTITIES);
+    QCOMPARE(tree->getSpatialIndex().size(), NUM_ENTITIES);
+
+    tree->withReadLock([&] {
+        for (int i = 0; i < NUM_QUERIES; ++i) {
+            glm::vec3 position = glm::linearRand(glm::vec3(-DOMAIN_SIZE / 2.0f), glm::vec3(DOMAIN_SIZE / 2.0f));
+            float radius = glm::linearRand(1.0f, 100.0f);
+
+            QVector<QUuid> found;
+            tree->evalEntitiesInSphere(position, radius, PickFilter(), found);
+            QCOMPARE(sorted(found), sorted(recurseEntitiesInSphere(tree, position, radius)));
+
+            QVector<QUuid> inBox;
+            AABox box(position - glm::vec3(radius), 2.0f * radius);
+            tree->evalEntitiesInBox(box, PickFilter(), inBox);
+            for (auto& id : found) {
+                QVERIFY(inBox.contains(id));
+            }
+        }
+    });
+
+    // moving entities across cells and deleting them keeps the index in step with the tree
+    QVector<QUuid> entityIDs;
+    tree->withReadLock([&] {
+        tree->evalEntitiesInSphere(glm::vec3(0.0f), DOMAIN_SIZE, PickFilter(), entityIDs);
+    });
+    QCOMPARE(entityIDs.size(), NUM_ENTITIES);
+
+    tree->withWriteLock([&] {
+        for (int i = 0; i < NUM_ENTITIES / 2; ++i) {
+            EntityItemProperties properties;
+            properties.setPosition(glm::linearRand(glm::vec3(-DOMAIN_SIZE / 2.0f), glm::vec3(DOMAIN_SIZE / 2.0f)));
+            tree->updateEntity(entityIDs[i], properties);
+        }
+        for (int i = NUM_ENTITIES / 2; i < NUM_ENTITIES / 2 + NUM_ENTITIES / 4; ++i) {
+            tree->deleteEntity(entityIDs[i], true);
+        }
+    });
+    QCOMPARE(tree->getSpatialIndex().size(), NUM_ENTITIES - NUM_ENTITIES / 4);
+
+    tree->withReadLock([&] {
+        for (int i = 0; i < NUM_QUERIES; ++i) {
+            glm::vec3 position = glm::linearRand(glm::vec3(-DOMAIN_SIZE / 2.0f), glm::vec3(DOMAIN_SIZE / 2.0f));
+            float radius = glm::linearRand(1.0f, 100.0f);
+
+            QVector<QUuid> found;
+            tree->evalEntitiesInSphere(position, radius, PickFilter(), found);
+            QCOMPARE(sorted(found), sorted(recurseEntitiesInSphere(tree, position, radius)));
+        }
+    });
+
+    tree->eraseAllOctreeElements();
+    QCOMPARE(tree->getSpatialIndex().size(), 0);
+}
+
+// Measures sphere query throughput on a 100k-entity tree with the spatial index vs recursing the octree.
+void EntityQueryTests::queryPerf() {
+    const int NUM_ENTITIES = 100000;
+    const int NUM_QUERIES = 2000;
+    const float QUERY_RADIUS = 20.0f;
+
+    EntityTreePointer tree = createTree(NUM_ENTITIES);
+    std::vector<glm::vec3> positions;
+    for (int i = 0; i < NUM_QUERIES; ++i) {
+        positions.push_back(glm::linearRand(glm::vec3(-DOMAIN_SIZE / 2.0f), glm::vec3(DOMAIN_SIZE / 2.0f)));
+    }
+
+    int recursedFound = 0;
+    int indexedFound = 0;
+    std::chrono::high_resolution_clock::duration recurseTime;
+    std::chrono::high_resolution_clock::duration indexTime;
+    tree->withReadLock([&] {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (auto& position : positions) {
+            recursedFound += recurseEntitiesInSphere(tree, position, QUERY_RADIUS).size();
+        }
+        recurseTime = std::chrono::high_resolution_clock::now() - start;
+
+        start = std::chrono::high_resolution_clock::now();
+        for (auto& position : positions) {
+            QVector<QUuid> found;
+            tree->evalEntitiesInSphere(position, QUERY_RADIUS, PickFilter(), found);
+            indexedFound += found.size();
+        }
+        indexTime = std::chrono::high_resolution_clock::now() - start;
+    });
+    QCOMPARE(indexedFound, recursedFound);
+
+    auto queriesPerSecond = [&](std::chrono::high_resolution_clock::duration time) {
+        auto usecs = std::chrono::duration_cast<std::chrono::microseconds>(time).count();
+        return usecs > 0 ? (double)NUM_QUERIES * USECS_PER_SECOND / usecs : 0.0;
+    };
+    qDebug() << "ran" << NUM_QUERIES << "sphere queries on" << NUM_ENTITIES << "entities,"
+        << "octree:" << queriesPerSecond(recurseTime) << "queries/sec,"
+        << "spatial index:" << queriesPerSecond(indexTime) << "queries/sec";
+}
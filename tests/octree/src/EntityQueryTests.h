@@ -0,0 +1,24 @@
+//
+//  EntityQueryTests.h
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityQueryTests_h
+#define hifi_EntityQueryTests_h
+
+#include <QtTest/QtTest>
+
+class EntityQueryTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void testSpatialIndex();
+    void queryPerf();
+};
+
+#endif // hifi_EntityQueryTests_h
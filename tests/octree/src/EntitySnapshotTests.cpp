@@ -0,0 +1,116 @@
+//
+//  EntitySnapshotTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySnapshotTests.h"
+
+#include <QtCore/QBuffer>
+
+#include <test-utils/QTestExtensions.h>
+
+#include <DependencyManager.h>
+#include <EntityItemProperties.h>
+#include <EntityTree.h>
+#include <LimitedNodeList.h>
+#include <NodeList.h>
+
+QTEST_MAIN(EntitySnapshotTests)
+
+static const int NUM_ENTITIES = 20;
+
+static EntityTreePointer createTree() {
+    EntityTreePointer tree = std::make_shared<EntityTree>(true);
+    tree->setIsServer(true);
+    tree->createRootElement();
+    return tree;
+}
+
+static QByteArray writeSnapshot(const EntityTreePointer& tree) {
+    QByteArray snapshot;
+    QBuffer buffer(&snapshot);
+    buffer.open(QIODevice::WriteOnly);
+    if (!tree->writeToSnapshot(buffer)) {
+        return QByteArray();
+    }
+    return snapshot;
+}
+
+void EntitySnapshotTests::initTestCase() {
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<NodeList>(NodeType::EntityServer, INVALID_PORT);
+}
+
+void EntitySnapshotTests::roundTripTest() {
+    EntityTreePointer tree = createTree();
+    QVector<EntityItemID> entityIDs;
+    tree->withWriteLock([&] {
+        for (int i = 0; i < NUM_ENTITIES; ++i) {
+            EntityItemProperties properties;
+            properties.setType(i % 2 ? EntityTypes::Box : EntityTypes::Sphere);
+            properties.setName(QString("entity %1").arg(i));
+            properties.setUserData(QString("{\"index\":%1}").arg(i));
+            properties.setPosition(glm::vec3((float)i, 2.0f * (float)i, -(float)i));
+            properties.setDimensions(glm::vec3(0.5f + (float)i, 1.0f, 2.0f));
+            properties.setColor(glm::u8vec3(i, 255 - i, 128));
+            EntityItemID entityID(QUuid::createUuid());
+            QVERIFY(tree->addEntity(entityID, properties));
+            entityIDs.push_back(entityID);
+        }
+    });
+
+    QByteArray snapshot = writeSnapshot(tree);
+    QVERIFY(!snapshot.isEmpty());
+
+    EntityTreePointer loadedTree = createTree();
+    bool success = false;
+    loadedTree->withWriteLock([&] {
+        success = loadedTree->readFromSnapshot(snapshot);
+    });
+    QVERIFY(success);
+
+    for (const auto& entityID : entityIDs) {
+        EntityItemPointer original = tree->findEntityByEntityItemID(entityID);
+        EntityItemPointer loaded = loadedTree->findEntityByEntityItemID(entityID);
+        QVERIFY(original);
+        QVERIFY(loaded);
+
+        EntityItemProperties originalProperties = original->getProperties();
+        EntityItemProperties loadedProperties = loaded->getProperties();
+        QCOMPARE(loadedProperties.getType(), originalProperties.getType());
+        QCOMPARE(loadedProperties.getName(), originalProperties.getName());
+        QCOMPARE(loadedProperties.getUserData(), originalProperties.getUserData());
+        QCOMPARE(loadedProperties.getPosition(), originalProperties.getPosition());
+        QCOMPARE(loadedProperties.getDimensions(), originalProperties.getDimensions());
+        QCOMPARE(loadedProperties.getColor(), originalProperties.getColor());
+    }
+
+    // a tree loaded from a snapshot writes the same snapshot back, so restarts don't lose anything
+    QCOMPARE(writeSnapshot(loadedTree).size(), snapshot.size());
+}
+
+void EntitySnapshotTests::truncatedSnapshotTest() {
+    EntityTreePointer tree = createTree();
+    tree->withWriteLock([&] {
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setName("truncated");
+        tree->addEntity(EntityItemID(QUuid::createUuid()), properties);
+    });
+
+    QByteArray snapshot = writeSnapshot(tree);
+    QVERIFY(!snapshot.isEmpty());
+    snapshot.chop(1);
+
+    EntityTreePointer loadedTree = createTree();
+    bool success = true;
+    loadedTree->withWriteLock([&] {
+        success = loadedTree->readFromSnapshot(snapshot);
+    });
+    QVERIFY(!success);
+}
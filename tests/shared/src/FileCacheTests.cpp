@@ -156,6 +156,36 @@ void FileCacheTests::testWipe() {
     QCOMPARE(getCacheDirectorySize(), (size_t)0);
 }
 
+void FileCacheTests::testHints() {
+    QString location = _testDir.path() + "/hints";
+    auto cache = makeFileCache(location);
+    for (int i = 0; i < 10; ++i) {
+        cache->writeFile(TEST_DATA.data(), FileCache::Metadata(getFileKey(i), TEST_DATA.size()));
+    }
+    QCOMPARE(cache->getNumCachedFiles(), (size_t)10);
+
+    // The hinted file becomes the most recently used, so the next oldest one is ejected instead
+    QVERIFY(cache->hint(getFileKey(0)));
+    QVERIFY(!cache->hint(getFileKey(10)));
+    cache->writeFile(TEST_DATA.data(), FileCache::Metadata(getFileKey(10), TEST_DATA.size()));
+    QCOMPARE(cache->getNumHints(), (size_t)1);
+    QCOMPARE(cache->getNumEvictions(), (size_t)1);
+    QVERIFY(!cache->getFile(getFileKey(1)).get());
+    QVERIFY(cache->getFile(getFileKey(0)).get());
+    QCOMPARE(cache->getNumHits(), (size_t)1);
+    QCOMPARE(cache->getNumMisses(), (size_t)1);
+
+    // The LRU order is restored from the index, file 2 is now the least recently used
+    cache = makeFileCache(location);
+    QCOMPARE(cache->getNumCachedFiles(), (size_t)10);
+    cache->setMaxSize(MAX_UNUSED_SIZE - TEST_DATA.size());
+    QCOMPARE(cache->getNumCachedFiles(), (size_t)9);
+    QVERIFY(!cache->getFile(getFileKey(2)).get());
+    for (int i = 3; i <= 10; ++i) {
+        QVERIFY(cache->getFile(getFileKey(i)).get());
+    }
+    QVERIFY(cache->getFile(getFileKey(0)).get());
+}
 
 void FileCacheTests::cleanupTestCase() {
 }
@@ -0,0 +1,188 @@
+//
+//  JointPackingTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "JointPackingTests.h"
+
+#include <chrono>
+#include <vector>
+
+#include <test-utils/QTestExtensions.h>
+
+#include <GLMHelpers.h>
+#include <JointPacking.h>
+#include <glm/gtc/random.hpp>
+
+QTEST_MAIN(JointPackingTests)
+
+static const int MAX_JOINTS = 256;
+static const int TRANSLATION_COMPRESSION_RADIX = 14;
+
+static glm::quat randomRotation() {
+    return glm::normalize(glm::quat(glm::linearRand(glm::vec4(-1.0f), glm::vec4(1.0f))));
+}
+
+void JointPackingTests::testRotationPacking() {
+    const float MAX_COMPONENT_ERROR = 4.3e-5f;
+
+    for (int numJoints = 0; numJoints < MAX_JOINTS; ++numJoints) {
+        std::vector<glm::quat> rotations(numJoints);
+        for (auto& rotation : rotations) {
+            rotation = randomRotation();
+        }
+        if (numJoints > 1) {
+            // ties between the largest components must match the scalar code
+            rotations[1] = glm::quat(0.5f, 0.5f, -0.5f, -0.5f);
+        }
+
+        // batch packing must be byte-identical to the per-joint version
+        std::vector<uint8_t> reference(6 * numJoints);
+        std::vector<uint8_t> packed(6 * numJoints);
+        for (int i = 0; i < numJoints; ++i) {
+            packOrientationQuatToSixBytes(&reference[6 * i], rotations[i]);
+        }
+        int bytesWritten = packOrientationQuatsToSixBytes(packed.data(), rotations.data(), numJoints);
+        QCOMPARE(bytesWritten, 6 * numJoints);
+        QVERIFY(packed == reference);
+
+        // round trip
+        std::vector<glm::quat> unpacked(numJoints);
+        int bytesRead = unpackOrientationQuatsFromSixBytes(packed.data(), unpacked.data(), numJoints);
+        QCOMPARE(bytesRead, 6 * numJoints);
+        for (int i = 0; i < numJoints; ++i) {
+            glm::quat expected;
+            unpackOrientationQuatFromSixBytes(&reference[6 * i], expected);
+            for (int j = 0; j < 4; ++j) {
+                QCOMPARE_WITH_ABS_ERROR(unpacked[i][j], expected[j], EPSILON);
+            }
+
+            glm::quat q = unpacked[i];
+            if (glm::dot(q, rotations[i]) < 0.0f) {
+                q = -q;
+            }
+            for (int j = 0; j < 4; ++j) {
+                QCOMPARE_WITH_ABS_ERROR(q[j], rotations[i][j], MAX_COMPONENT_ERROR);
+            }
+        }
+    }
+}
+
+void JointPackingTests::testTranslationPacking() {
+    const float MAX_TRANSLATION_DIMENSION = 3.0f;
+    const float MAX_COMPONENT_ERROR = MAX_TRANSLATION_DIMENSION / (1 << TRANSLATION_COMPRESSION_RADIX);
+
+    for (int numJoints = 0; numJoints < MAX_JOINTS; ++numJoints) {
+        std::vector<glm::vec3> translations(numJoints);
+        for (auto& translation : translations) {
+            translation = glm::linearRand(glm::vec3(-MAX_TRANSLATION_DIMENSION), glm::vec3(MAX_TRANSLATION_DIMENSION));
+        }
+
+        std::vector<uint8_t> reference(6 * numJoints);
+        std::vector<uint8_t> packed(6 * numJoints);
+        for (int i = 0; i < numJoints; ++i) {
+            packFloatVec3ToSignedTwoByteFixed(&reference[6 * i], translations[i] / MAX_TRANSLATION_DIMENSION,
+                                              TRANSLATION_COMPRESSION_RADIX);
+        }
+        int bytesWritten = packFloatVec3sToSignedTwoByteFixed(packed.data(), translations.data(), numJoints,
+                                                              MAX_TRANSLATION_DIMENSION, TRANSLATION_COMPRESSION_RADIX);
+        QCOMPARE(bytesWritten, 6 * numJoints);
+        QVERIFY(packed == reference);
+
+        std::vector<glm::vec3> unpacked(numJoints);
+        int bytesRead = unpackFloatVec3sFromSignedTwoByteFixed(packed.data(), unpacked.data(), numJoints,
+                                                               TRANSLATION_COMPRESSION_RADIX);
+        QCOMPARE(bytesRead, 6 * numJoints);
+        for (int i = 0; i < numJoints; ++i) {
+            glm::vec3 expected;
+            unpackFloatVec3FromSignedTwoByteFixed(&reference[6 * i], expected, TRANSLATION_COMPRESSION_RADIX);
+            for (int j = 0; j < 3; ++j) {
+                QCOMPARE(unpacked[i][j], expected[j]);
+                QCOMPARE_WITH_ABS_ERROR(unpacked[i][j] * MAX_TRANSLATION_DIMENSION, translations[i][j], MAX_COMPONENT_ERROR);
+            }
+        }
+    }
+}
+
+void JointPackingTests::testChangeBits() {
+    const float MIN_ROTATION_DOT = 0.9999f;
+    const float MIN_TRANSLATION = 0.005f;
+
+    for (int numJoints = 0; numJoints < MAX_JOINTS; ++numJoints) {
+        std::vector<JointData> current(numJoints);
+        std::vector<JointData> last(numJoints);
+        for (int i = 0; i < numJoints; ++i) {
+            current[i].rotation = randomRotation();
+            current[i].translation = glm::linearRand(glm::vec3(-1.0f), glm::vec3(1.0f));
+
+            // roughly half of the joints move by more than the thresholds
+            bool moved = (i % 2) == 0;
+            glm::quat delta = glm::angleAxis(moved ? 0.1f : 0.001f, glm::vec3(0.0f, 1.0f, 0.0f));
+            last[i].rotation = current[i].rotation * delta;
+            last[i].translation = current[i].translation + glm::vec3(moved ? 0.01f : 0.001f);
+        }
+
+        const int numBytes = (numJoints + BITS_IN_BYTE - 1) / BITS_IN_BYTE;
+        std::vector<uint8_t> rotationBits(numBytes, 0xff);
+        std::vector<uint8_t> translationBits(numBytes, 0xff);
+        computeJointRotationChangeBits(current.data(), last.data(), numJoints, MIN_ROTATION_DOT, rotationBits.data());
+        computeJointTranslationChangeBits(current.data(), last.data(), numJoints, MIN_TRANSLATION, translationBits.data());
+
+        for (int i = 0; i < numJoints; ++i) {
+            bool rotationChanged = fabsf(glm::dot(current[i].rotation, last[i].rotation)) < MIN_ROTATION_DOT;
+            bool translationChanged = glm::distance(current[i].translation, last[i].translation) > MIN_TRANSLATION;
+            QCOMPARE((bool)(rotationBits[i / BITS_IN_BYTE] & (1 << (i % BITS_IN_BYTE))), rotationChanged);
+            QCOMPARE((bool)(translationBits[i / BITS_IN_BYTE] & (1 << (i % BITS_IN_BYTE))), translationChanged);
+        }
+
+        // unused bits in the last byte are cleared
+        if (numJoints % BITS_IN_BYTE) {
+            QCOMPARE(rotationBits.back() >> (numJoints % BITS_IN_BYTE), 0);
+            QCOMPARE(translationBits.back() >> (numJoints % BITS_IN_BYTE), 0);
+        }
+    }
+}
+
+void JointPackingTests::packingPerf() {
+    const int NUM_JOINTS = 150;
+    const int NUM_ITERATIONS = 20000;
+
+    std::vector<glm::quat> rotations(NUM_JOINTS);
+    std::vector<glm::vec3> translations(NUM_JOINTS);
+    for (int i = 0; i < NUM_JOINTS; ++i) {
+        rotations[i] = randomRotation();
+        translations[i] = glm::linearRand(glm::vec3(-1.0f), glm::vec3(1.0f));
+    }
+    std::vector<uint8_t> buffer(12 * NUM_JOINTS);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int n = 0; n < NUM_ITERATIONS; ++n) {
+        uint8_t* destination = buffer.data();
+        for (int i = 0; i < NUM_JOINTS; ++i) {
+            destination += packOrientationQuatToSixBytes(destination, rotations[i]);
+        }
+        for (int i = 0; i < NUM_JOINTS; ++i) {
+            destination += packFloatVec3ToSignedTwoByteFixed(destination, translations[i] / 1.0f, TRANSLATION_COMPRESSION_RADIX);
+        }
+    }
+    auto scalarTime = std::chrono::high_resolution_clock::now() - start;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int n = 0; n < NUM_ITERATIONS; ++n) {
+        uint8_t* destination = buffer.data();
+        destination += packOrientationQuatsToSixBytes(destination, rotations.data(), NUM_JOINTS);
+        destination += packFloatVec3sToSignedTwoByteFixed(destination, translations.data(), NUM_JOINTS,
+                                                          1.0f, TRANSLATION_COMPRESSION_RADIX);
+    }
+    auto batchTime = std::chrono::high_resolution_clock::now() - start;
+
+    qDebug() << "packed" << NUM_ITERATIONS << "skeletons of" << NUM_JOINTS << "joints,"
+        << "scalar:" << std::chrono::duration_cast<std::chrono::microseconds>(scalarTime).count() << "us,"
+        << "batch:" << std::chrono::duration_cast<std::chrono::microseconds>(batchTime).count() << "us,"
+        << "ratio:" << (float)scalarTime.count() / (float)batchTime.count();
+}
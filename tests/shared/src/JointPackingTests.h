@@ -0,0 +1,25 @@
+//
+//  JointPackingTests.h
+//  tests/shared/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_JointPackingTests_h
+#define hifi_JointPackingTests_h
+
+#include <QtTest/QtTest>
+
+class JointPackingTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testRotationPacking();
+    void testTranslationPacking();
+    void testChangeBits();
+    void packingPerf();
+};
+
+#endif // hifi_JointPackingTests_h
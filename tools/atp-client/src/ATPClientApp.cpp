@@ -11,18 +11,22 @@
 
 #include "ATPClientApp.h"
 
+#include <memory>
+
 #include <QDataStream>
 #include <QTextStream>
 #include <QThread>
 #include <QFile>
 #include <QLoggingCategory>
 #include <QCommandLineParser>
+#include <QElapsedTimer>
 
 #include <NetworkLogging.h>
 #include <NetworkingConstants.h>
 #include <SharedLogging.h>
 #include <AddressManager.h>
 #include <DependencyManager.h>
+#include <NumericalConstants.h>
 #include <SettingHandle.h>
 #include <AssetUpload.h>
 #include <StatTracker.h>
@@ -57,6 +61,10 @@ ATPClientApp::ATPClientApp(int argc, char* argv[]) :
     const QCommandLineOption listenPortOption("listenPort", "listen port", QString::number(INVALID_PORT));
     parser.addOption(listenPortOption);
 
+    const QCommandLineOption benchmarkOption("benchmark", "download the asset this many times at once and report throughput",
+                                             "concurrent-downloads");
+    parser.addOption(benchmarkOption);
+
     if (!parser.parse(QCoreApplication::arguments())) {
         qCritical() << parser.errorText() << endl;
         parser.showHelp();
@@ -125,6 +133,15 @@ ATPClientApp::ATPClientApp(int argc, char* argv[]) :
         _listenPort = parser.value(listenPortOption).toInt();
     }
 
+    if (parser.isSet(benchmarkOption)) {
+        _benchmarkDownloads = parser.value(benchmarkOption).toInt();
+        if (_benchmarkDownloads < 1) {
+            qDebug() << "--benchmark should be followed by the number of concurrent downloads";
+            parser.showHelp();
+            Q_UNREACHABLE();
+        }
+    }
+
     _domainServerAddress = QString("127.0.0.1") + ":" + QString::number(domainPort);
     if (parser.isSet(domainAddressOption)) {
         _domainServerAddress = parser.value(domainAddressOption);
@@ -197,7 +214,10 @@ ATPClientApp::ATPClientApp(int argc, char* argv[]) :
     }
 
     auto assetClient = DependencyManager::set<AssetClient>();
-    assetClient->initCaching();
+    if (_benchmarkDownloads == 0) {
+        // a benchmark has to hit the asset-server every time
+        assetClient->initCaching();
+    }
 
     if (_verbose) {
         qDebug() << "domain-server address is" << _domainServerAddress;
@@ -205,7 +225,7 @@ ATPClientApp::ATPClientApp(int argc, char* argv[]) :
 
     DependencyManager::get<AddressManager>()->handleLookupString(_domainServerAddress, false);
 
-    QTimer* _timeoutTimer = new QTimer(this);
+    _timeoutTimer = new QTimer(this);
     _timeoutTimer->setSingleShot(true);
     connect(_timeoutTimer, &QTimer::timeout, this, &ATPClientApp::timedOut);
     _timeoutTimer->start(TIMEOUT_MILLISECONDS);
@@ -351,7 +371,11 @@ void ATPClientApp::lookupAsset() {
             qDebug() << "not found: " << request->getErrorString();
         } else if (result == GetMappingRequest::NoError) {
             qDebug() << "found, hash is " << request->getHash();
-            download(request->getHash());
+            if (_benchmarkDownloads > 0) {
+                benchmarkDownloads(request->getHash());
+            } else {
+                download(request->getHash());
+            }
         } else {
             qDebug() << "error -- " << request->getError() << " -- " << request->getErrorString();
         }
@@ -390,6 +414,51 @@ void ATPClientApp::download(AssetUtils::AssetHash hash) {
     assetRequest->start();
 }
 
+void ATPClientApp::benchmarkDownloads(AssetUtils::AssetHash hash) {
+    // downloads can take a lot longer than we'd wait for the domain
+    if (_timeoutTimer) {
+        _timeoutTimer->stop();
+    }
+
+    auto elapsed = std::make_shared<QElapsedTimer>();
+    auto remaining = std::make_shared<int>(_benchmarkDownloads);
+    auto failed = std::make_shared<int>(0);
+    auto totalBytes = std::make_shared<qint64>(0);
+    auto totalMsecs = std::make_shared<qint64>(0);
+
+    elapsed->start();
+    for (int i = 0; i < _benchmarkDownloads; ++i) {
+        auto assetRequest = new AssetRequest(hash);
+
+        connect(assetRequest, &AssetRequest::finished, this, [=](AssetRequest* request) mutable {
+            if (request->getError() == AssetRequest::Error::NoError) {
+                *totalBytes += request->getData().size();
+                *totalMsecs += elapsed->elapsed();
+            } else {
+                ++*failed;
+                qDebug() << "download failed:" << request->getError();
+            }
+            request->deleteLater();
+
+            if (--*remaining == 0) {
+                qint64 msecs = std::max(elapsed->elapsed(), (qint64)1);
+                int succeeded = _benchmarkDownloads - *failed;
+                QTextStream cout(stdout);
+                cout << "downloads: " << succeeded << " ok, " << *failed << " failed" << endl;
+                cout << "bytes: " << *totalBytes << " in " << msecs << " ms" << endl;
+                cout << "throughput: " << (double)*totalBytes / (1024.0 * 1024.0) / ((double)msecs / MSECS_PER_SECOND)
+                     << " MB/s" << endl;
+                if (succeeded > 0) {
+                    cout << "mean time to complete a download: " << *totalMsecs / succeeded << " ms" << endl;
+                }
+                finish(*failed > 0 ? 1 : 0);
+            }
+        });
+
+        assetRequest->start();
+    }
+}
+
 void ATPClientApp::finish(int exitCode) {
     auto nodeList = DependencyManager::get<NodeList>();
 
@@ -46,6 +46,7 @@ private:
     void lookupAsset();
     void listAssets();
     void download(AssetUtils::AssetHash hash);
+    void benchmarkDownloads(AssetUtils::AssetHash hash);
     void finish(int exitCode);
     bool _verbose;
 
@@ -54,6 +55,7 @@ private:
     QString _localUploadFile;
 
     int _listenPort { INVALID_PORT };
+    int _benchmarkDownloads { 0 };
 
     QString _domainServerAddress;
 